@@ -80,5 +80,30 @@ void reduce(type_t type, reduce_t op,
     }
 }
 
+void reduce_init(type_t type, char* result, len_type* idx)
+{
+    const len_type ts = type_size[type];
+
+    for (auto op : range(TBLIS_NUM_REDUCE_OPS))
+    {
+        scalar value(0, type);
+        reduce_init((reduce_t)op, value, idx[op]);
+        value.to(result + op*ts);
+    }
+}
+
+void reduce(type_t type, unsigned ops,
+            const char* A, const len_type* idx_A,
+                  char* B,       len_type* idx_B)
+{
+    const len_type ts = type_size[type];
+
+    for (auto op : range(TBLIS_NUM_REDUCE_OPS))
+    {
+        if ((ops >> op) & 1)
+            reduce(type, (reduce_t)op, A + op*ts, idx_A[op], B + op*ts, idx_B[op]);
+    }
+}
+
 }
 }
@@ -13,6 +13,19 @@ void reduce(type_t type, reduce_t op,
             const char* A, len_type  idx_A,
                   char* B, len_type& idx_B);
 
+/*
+ * Initialize one value and index for each of the TBLIS_NUM_REDUCE_OPS
+ * reductions.
+ */
+void reduce_init(type_t type, char* result, len_type* idx);
+
+/*
+ * Combine each reduction whose bit is set in ops, as above.
+ */
+void reduce(type_t type, unsigned ops,
+            const char* A, const len_type* idx_A,
+                  char* B,       len_type* idx_B);
+
 }
 }
 
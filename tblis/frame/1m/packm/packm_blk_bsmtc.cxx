@@ -4,6 +4,7 @@
 
 #include "tblis/frame/base/alignment.hpp"
 #include "tblis/frame/base/block_scatter.hpp"
+#include "tblis/frame/base/stats.hpp"
 
 namespace tblis
 {
@@ -61,6 +62,19 @@ void packm_blk_bsmtc(const obj_t*     c,
     auto  params        = static_cast<const bsmtc_params*>(bli_packm_def_cntl_ukr_params(cntl));
     auto  packm_ker     = reinterpret_cast<packm_bsmtc_ft>(bli_cntx_get_ukr2_dt(dt_c, dt_p, PACKM_BSMTC_UKR, cntx));
 
+    // Half precision data is described to BLIS as float; the actual element
+    // size is needed for the scatter vectors, and the packing kernel converts.
+    if (params->storage_type == TYPE_BFLOAT16)
+    {
+        dt_c_size = 2;
+        packm_ker = reinterpret_cast<packm_bsmtc_ft>(bli_cntx_get_ukr_dt(dt_p, PACKM_BSMTC_BF16_UKR, cntx));
+    }
+    else if (params->storage_type == TYPE_FLOAT16)
+    {
+        dt_c_size = 2;
+        packm_ker = reinterpret_cast<packm_bsmtc_ft>(bli_cntx_get_ukr_dt(dt_p, PACKM_BSMTC_F16_UKR, cntx));
+    }
+
     auto  rscat_c       = convert_and_align<stride_type>(p_cast + panel_size);
     auto  cscat_c       = rscat_c + n_iter*panel_dim_max;
     auto  rbs_c         = cscat_c + k_blocks*panel_len_block;
@@ -77,33 +91,37 @@ void packm_blk_bsmtc(const obj_t*     c,
     dim_t k_start, k_end, k_inc;
     bli_thread_range_sl(tid, nt, k_blocks, 1, FALSE, &k_start, &k_end, &k_inc);
 
-    if (m_start < n_iter)
-    fill_block_scatter(dt_c_size,
-                       params->nblock[0],
-                       params->block_off[0],
-                       params->ndim[0],
-                       params->len[0],
-                       params->stride[0],
-                       panel_dim_max,
-                       panel_dim_off + m_start*panel_dim_max,
-                       std::min(m_end*panel_dim_max, iter_dim) - m_start*panel_dim_max,
-                       rscat_c + m_start*panel_dim_max,
-                       rbs_c + m_start,
-                       params->pack_3d[0]);
-
-    if (k_start < k_blocks)
-    fill_block_scatter(dt_c_size,
-                       params->nblock[1],
-                       params->block_off[1],
-                       params->ndim[1],
-                       params->len[1],
-                       params->stride[1],
-                       panel_len_block,
-                       panel_len_off + k_start*panel_len_block,
-                       std::min(k_end*panel_len_block, panel_len) - k_start*panel_len_block,
-                       cscat_c + k_start*panel_len_block,
-                       cbs_c + k_start,
-                       params->pack_3d[1]);
+    {
+        internal::stats_timer timer(internal::STATS_SCATTER);
+
+        if (m_start < n_iter)
+        fill_block_scatter(dt_c_size,
+                           params->nblock[0],
+                           params->block_off[0],
+                           params->ndim[0],
+                           params->len[0],
+                           params->stride[0],
+                           panel_dim_max,
+                           panel_dim_off + m_start*panel_dim_max,
+                           std::min(m_end*panel_dim_max, iter_dim) - m_start*panel_dim_max,
+                           rscat_c + m_start*panel_dim_max,
+                           rbs_c + m_start,
+                           params->pack_3d[0]);
+
+        if (k_start < k_blocks)
+        fill_block_scatter(dt_c_size,
+                           params->nblock[1],
+                           params->block_off[1],
+                           params->ndim[1],
+                           params->len[1],
+                           params->stride[1],
+                           panel_len_block,
+                           panel_len_off + k_start*panel_len_block,
+                           std::min(k_end*panel_len_block, panel_len) - k_start*panel_len_block,
+                           cscat_c + k_start*panel_len_block,
+                           cbs_c + k_start,
+                           params->pack_3d[1]);
+    }
 
     bli_thrinfo_barrier(thread);
 
@@ -114,6 +132,10 @@ void packm_blk_bsmtc(const obj_t*     c,
     dim_t it_start, it_end, it_inc;
     bli_thread_range_slrr(tid, nt, n_iter, 1, FALSE, &it_start, &it_end, &it_inc);
 
+    internal::stats_timer timer(internal::STATS_PACK);
+
+    if (tid == 0) internal::record_bytes_packed(panel_size);
+
     // Iterate over every logical micropanel in the source matrix.
     for (auto it : range(n_iter))
     {
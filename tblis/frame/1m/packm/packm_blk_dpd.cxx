@@ -3,8 +3,11 @@
 #include "tblis/plugin/bli_plugin_tblis.h"
 
 #include "tblis/frame/base/alignment.hpp"
+#include "tblis/frame/base/stats.hpp"
 #include "tblis/frame/base/dpd_block_scatter.hpp"
 
+#include <vector>
+
 namespace tblis
 {
 
@@ -56,8 +59,37 @@ void packm_blk_dpd(const obj_t*     c,
              k_patch0,
              k_patch_off0) = get_patches(panel_len, panel_len_off, panel_len_block, params.patch_size[1]);
 
+    // Enumerate the irrep patches spanned by this panel.
+    struct patch_range { len_type patch, size, off, scat_off, bs_off; };
+    std::vector<patch_range> m_patches, k_patches;
+
+    auto add_patch = [](std::vector<patch_range>& patches, len_type BS)
+    {
+        return [&patches,BS](len_type patch, len_type size, len_type off)
+        {
+            len_type scat_off = 0, bs_off = 0;
+            if (!patches.empty())
+            {
+                scat_off = patches.back().scat_off + patches.back().size;
+                bs_off = patches.back().bs_off + ceil_div(patches.back().size, BS);
+            }
+            patches.push_back({patch, size, off, scat_off, bs_off});
+        };
+    };
+
+    for_each_patch(iter_dim, params.patch_size[0], n_patch0, n_patch_off0,
+                   add_patch(m_patches, panel_dim_max));
+    for_each_patch(panel_len, params.patch_size[1], k_patch0, k_patch_off0,
+                   add_patch(k_patches, panel_len_block));
+
+    len_type m_npatch = m_patches.size();
+    len_type k_npatch = k_patches.size();
+
+    // The scatter vectors of every (m, k) patch pair are stored side by
+    // side, so that they can all be filled before packing starts.
     auto panel_size = n_iter * ps_p * dt_p_size;
-    size_p += size_as_type<stride_type>(iter_dim + panel_len + n_iter + k_blocks, dt_p) * dt_p_size;
+    size_p += size_as_type<stride_type>((iter_dim + n_iter) * k_npatch +
+                                        (panel_len + k_blocks) * m_npatch, dt_p) * dt_p_size;
 
     // Update the buffer address in p to point to the buffer associated
     // with the mem_t entry acquired from the memory broker (now cached in
@@ -67,51 +99,97 @@ void packm_blk_dpd(const obj_t*     c,
 
     auto p_cast  = static_cast<char*>(bli_obj_buffer(p));
     auto rscat_c = convert_and_align<stride_type>(p_cast + panel_size);
-    auto cscat_c = rscat_c + iter_dim;
-    auto rbs_c   = cscat_c + panel_len;
-    auto cbs_c   = rbs_c   + n_iter;
+    auto cscat_c = rscat_c + iter_dim * k_npatch;
+    auto rbs_c   = cscat_c + panel_len * m_npatch;
+    auto cbs_c   = rbs_c   + n_iter * k_npatch;
+
+    auto rscat = [&](len_type mi, len_type ki) { return rscat_c + ki*iter_dim + m_patches[mi].scat_off; };
+    auto cscat = [&](len_type mi, len_type ki) { return cscat_c + mi*panel_len + k_patches[ki].scat_off; };
+    auto rbs   = [&](len_type mi, len_type ki) { return rbs_c + ki*n_iter + m_patches[mi].bs_off; };
+    auto cbs   = [&](len_type mi, len_type ki) { return cbs_c + mi*k_blocks + k_patches[ki].bs_off; };
 
     // Query the number of threads (single-member thread teams) and the thread
     // team ids from the current thread's packm thrinfo_t node.
     const auto nt  = bli_thrinfo_num_threads(thread);
     const auto tid = bli_thrinfo_thread_id(thread);
 
+    if (tid == 0) internal::record_bytes_packed(panel_size);
+
+    // Each thread fills its share of the row and column scatter vectors of
+    // every patch pair, and also records the base address of each pair.
+    std::vector<char*> c_patch(m_npatch * k_npatch);
+
+    // The 3d packing order depends on the whole range, so in that
+    // case a single thread fills the corresponding vectors.
+    auto split = [&](len_type size, len_type BS, bool pack_3d)
+    {
+        auto nblock = ceil_div(size, BS);
+        dim_t start = 0, end = tid == 0 ? nblock : 0, inc;
+        if (!pack_3d)
+            bli_thread_range_sl(tid, nt, nblock, 1, FALSE, &start, &end, &inc);
+        return std::make_pair(len_type(start), std::max<len_type>(0, std::min<len_type>(end*BS, size) - start*BS));
+    };
+
+    {
+        internal::stats_timer timer(internal::STATS_SCATTER);
+
+        for (auto mi : range(m_npatch))
+        for (auto ki : range(k_npatch))
+        {
+            auto& m = m_patches[mi];
+            auto& k = k_patches[ki];
+
+            len_type m_start, m_size, k_start, k_size;
+            std::tie(m_start, m_size) = split(m.size, panel_dim_max, params.pack_3d[0]);
+            std::tie(k_start, k_size) = split(k.size, panel_len_block, params.pack_3d[1]);
+
+            c_patch[mi*k_npatch + ki] =
+                fill_block_scatter(dt_c_size, true, params,
+                                   panel_dim_max, panel_len_block,
+                                   m.patch, m.off + m_start*panel_dim_max, m_size,
+                                   k.patch, k.off + k_start*panel_len_block, k_size,
+                                   rscat(mi, ki) + m_start*panel_dim_max,
+                                   cscat(mi, ki) + k_start*panel_len_block,
+                                   rbs(mi, ki) + m_start,
+                                   cbs(mi, ki) + k_start);
+        }
+    }
+
+    bli_thrinfo_barrier(thread);
+
+    // Determine the thread range and increment using the current thread's
+    // packm thrinfo_t node. NOTE: The definition of bli_thread_range_slrr()
+    // will depend on whether slab or round-robin partitioning was requested
+    // at configure-time.
+    dim_t it_start, it_end, it_inc;
+    bli_thread_range_slrr(tid, nt, n_iter, 1, FALSE, &it_start, &it_end, &it_inc);
+
+    internal::stats_timer timer(internal::STATS_PACK);
+
     auto p0 = p_cast;
 
-    for_each_patch(iter_dim, params.patch_size[0], n_patch0, n_patch_off0,
-    [&](auto n_patch, auto n_patch_size, auto n_patch_off)
+    for (auto mi : range(m_npatch))
     {
+        auto& m = m_patches[mi];
         char* p1 = p0;
 
-        for_each_patch(panel_len, params.patch_size[1], k_patch0, k_patch_off0,
-        [&](int k_patch, len_type k_patch_size, len_type k_patch_off)
+        for (auto ki : range(k_npatch))
         {
+            auto& k = k_patches[ki];
+
             TBLIS_ASSERT(p1 >= p_cast);
-            TBLIS_ASSERT(p1 + k_patch_size * panel_dim_pack * dt_p_size <=
+            TBLIS_ASSERT(p1 + k.size * panel_dim_pack * dt_p_size <=
                          p0 + panel_size * dt_p_size);
 
-            bli_thrinfo_barrier(thread);
-
-            auto p2 = p1;
-            auto c2 = fill_block_scatter(dt_c_size, bli_thrinfo_am_chief(thread), params,
-                                         panel_dim_max, panel_len_block,
-                                         n_patch, n_patch_off, n_patch_size,
-                                         k_patch, k_patch_off, k_patch_size,
-                                         rscat_c, cscat_c, rbs_c, cbs_c);
-            auto rscat_c2 = rscat_c;
-            auto rbs_c2   = rbs_c;
-
-            bli_thrinfo_barrier(thread);
-
-            // Determine the thread range and increment using the current thread's
-            // packm thrinfo_t node. NOTE: The definition of bli_thread_range_slrr()
-            // will depend on whether slab or round-robin partitioning was requested
-            // at configure-time.
-            dim_t it_start, it_end, it_inc;
-            bli_thread_range_slrr(tid, nt, n_iter, 1, FALSE, &it_start, &it_end, &it_inc);
+            auto p2       = p1;
+            auto c2       = c_patch[mi*k_npatch + ki];
+            auto rscat_c2 = rscat(mi, ki);
+            auto rbs_c2   = rbs(mi, ki);
+            auto cscat_c2 = cscat(mi, ki);
+            auto cbs_c2   = cbs(mi, ki);
 
             // Iterate over every logical micropanel in the source matrix.
-            auto left = n_patch_size;
+            auto left = m.size;
             for (auto it = 0; left > 0; it++)
             {
                 auto panel_dim = std::min<len_type>(panel_dim_max, left);
@@ -126,12 +204,12 @@ void packm_blk_dpd(const obj_t*     c,
                         conjc,
                         schema,
                         panel_dim,
-                        k_patch_size,
+                        k.size,
                         panel_dim_max,
-                        k_patch_size,
+                        k.size,
                         bcast_p,
                         kappa_cast,
-                        c2, rscat_c2, *rbs_c2, cscat_c, cbs_c,
+                        c2, rscat_c2, *rbs_c2, cscat_c2, cbs_c2,
                         p2, ldp
                     );
                 }
@@ -142,11 +220,11 @@ void packm_blk_dpd(const obj_t*     c,
                 left     -= panel_dim;
             }
 
-            p1 += k_patch_size * panel_dim_pack * dt_p_size;
-        });
+            p1 += k.size * panel_dim_pack * dt_p_size;
+        }
 
-        p0 += ceil_div(n_patch_size, panel_dim_max) * ps_p * dt_p_size;
-    });
+        p0 += ceil_div(m.size, panel_dim_max) * ps_p * dt_p_size;
+    }
 }
 
 }
@@ -3,8 +3,11 @@
 #include "tblis/plugin/bli_plugin_tblis.h"
 
 #include "tblis/frame/base/tensor.hpp"
+#include "tblis/frame/base/stats.hpp"
+#include "tblis/frame/base/async.hpp"
 
 #include "tblis/frame/1t/dense/add.hpp"
+#include "tblis/frame/1t/dense/convert.hpp"
 #include "tblis/frame/1t/dense/scale.hpp"
 #include "tblis/frame/1t/dense/set.hpp"
 #include "tblis/frame/1t/dpd/add.hpp"
@@ -29,8 +32,15 @@ void tblis_tensor_add(const tblis_comm* comm,
                       const label_type* idx_B_)
 {
     internal::initialize_once();
+    internal::stats_scope stats(comm);
 
-    TBLIS_ASSERT(A->type == B->type);
+    /*
+     * Half precision operands are converted fiber by fiber, and may be
+     * mixed with each other and with float.
+     */
+    auto half = internal::is_half(A->type) || internal::is_half(B->type);
+
+    TBLIS_ASSERT(internal::value_type(A->type) == internal::value_type(B->type));
 
     auto ndim_A = A->ndim;
     len_vector len_A;
@@ -78,7 +88,18 @@ void tblis_tensor_add(const tblis_comm* comm,
     parallelize_if(
     [&](const communicator& comm)
     {
-        if (A->scalar.is_zero())
+        if (half)
+        {
+            if (!A->scalar.is_zero() || !B->scalar.is_one())
+                internal::add_half(A->type, B->type, comm,
+                                   len_A_only, len_B_only, len_AB,
+                                   A->scalar.as<float>(),
+                                   A->scalar.is_zero() ? nullptr : reinterpret_cast<const char*>(A->data),
+                                   stride_A_only, stride_A_AB,
+                                   B->scalar.as<float>(), reinterpret_cast<char*>(B->data),
+                                   stride_B_only, stride_B_AB);
+        }
+        else if (A->scalar.is_zero())
         {
             if (B->scalar.is_zero())
             {
@@ -110,12 +131,146 @@ void tblis_tensor_add(const tblis_comm* comm,
     B->conj = false;
 }
 
+TBLIS_EXPORT
+void tblis_tensor_add_n(const tblis_comm* comm,
+                        const tblis_config* cntx,
+                        int nterm,
+                        const tblis_tensor* const* A,
+                        const label_type* const* idx_A_,
+                              tblis_tensor* B,
+                        const label_type* idx_B_)
+{
+    internal::initialize_once();
+
+    auto ndim_B = B->ndim;
+    len_vector len_B;
+    stride_vector stride_B;
+    label_vector idx_B;
+    diagonal(ndim_B, B->len, B->stride, idx_B_, len_B, stride_B, idx_B);
+
+    auto scalar_B = idx_B.empty();
+    if (scalar_B)
+    {
+        len_B.push_back(1);
+        stride_B.push_back(0);
+        idx_B.push_back(internal::free_idx(idx_B));
+    }
+
+    /*
+     * Terms which are a permutation of B are fused, with their strides
+     * reordered to match B.
+     */
+    std::vector<scalar> alpha;
+    std::vector<bool> conj_A;
+    std::vector<const char*> data_A;
+    std::vector<stride_vector> stride_A;
+    std::vector<int> unfused;
+
+    for (auto k : range(nterm))
+    {
+        TBLIS_ASSERT(A[k]->type == B->type);
+
+        auto ndim_A = A[k]->ndim;
+        len_vector len_A;
+        stride_vector stride_A_;
+        label_vector idx_A;
+        diagonal(ndim_A, A[k]->len, A[k]->stride, idx_A_[k], len_A, stride_A_, idx_A);
+
+        if (A[k]->scalar.is_zero()) continue;
+
+        if (scalar_B && idx_A.empty())
+        {
+            len_A.push_back(1);
+            stride_A_.push_back(0);
+            idx_A.push_back(idx_B[0]);
+        }
+
+        if (stl_ext::exclusion(idx_A, idx_B).empty() &&
+            stl_ext::exclusion(idx_B, idx_A).empty())
+        {
+            TBLIS_ASSERT(stl_ext::select_from(len_A, idx_A, idx_B) == len_B);
+
+            alpha.push_back(A[k]->scalar);
+            conj_A.push_back(A[k]->conj);
+            data_A.push_back(reinterpret_cast<const char*>(A[k]->data));
+            stride_A.push_back(stl_ext::select_from(stride_A_, idx_A, idx_B));
+        }
+        else
+        {
+            unfused.push_back(k);
+        }
+    }
+
+    {
+        internal::stats_scope stats(comm);
+
+        parallelize_if(
+        [&](const communicator& comm)
+        {
+            if (alpha.empty())
+            {
+                if (B->scalar.is_zero())
+                {
+                    internal::set(B->type, comm, bli_gks_query_cntx(),
+                                  len_B, B->scalar,
+                                  reinterpret_cast<char*>(B->data), stride_B);
+                }
+                else if (!B->scalar.is_one() || (B->scalar.is_complex() && B->conj))
+                {
+                    internal::scale(B->type, comm, bli_gks_query_cntx(),
+                                    len_B, B->scalar, B->conj,
+                                    reinterpret_cast<char*>(B->data), stride_B);
+                }
+            }
+            else
+            {
+                internal::add_n(B->type, comm, bli_gks_query_cntx(),
+                                len_B, alpha, conj_A, data_A, stride_A,
+                                B->scalar, B->conj, reinterpret_cast<char*>(B->data),
+                                stride_B);
+            }
+        }, comm);
+    }
+
+    B->scalar = 1;
+    B->conj = false;
+
+    for (auto k : unfused)
+        tblis_tensor_add(comm, cntx, A[k], idx_A_[k], B, idx_B_);
+}
+
+TBLIS_EXPORT
+tblis_async* tblis_tensor_add_async(const tblis_config* cntx,
+                                    const tblis_tensor* A,
+                                    const label_type* idx_A,
+                                          tblis_tensor* B,
+                                    const label_type* idx_B)
+{
+    internal::initialize_once();
+
+    internal::async_tensor A_(A, idx_A);
+    internal::async_tensor B_(B, idx_B);
+
+    auto req = internal::async_submit({&A_}, {&B_},
+    [=](const tblis_comm* comm) mutable
+    {
+        tblis_tensor_add(comm, cntx, A_.get(), A_.idx.data(),
+                                     B_.get(), B_.idx.data());
+    });
+
+    B->scalar = 1;
+    B->conj = false;
+
+    return req;
+}
+
 template <typename T>
 void add(const communicator& comm,
          T alpha, dpd_marray_view<const T> A, const label_vector& idx_A,
          T  beta, dpd_marray_view<      T> B, const label_vector& idx_B)
 {
     internal::initialize_once();
+    internal::stats_scope stats(comm);
 
     auto nirrep = A.num_irreps();
     TBLIS_ASSERT(B.num_irreps() == nirrep);
@@ -191,6 +346,7 @@ void add(const communicator& comm,
          T  beta, indexed_marray_view<      T> B, const label_vector& idx_B)
 {
     internal::initialize_once();
+    internal::stats_scope stats(comm);
 
     auto ndim_A = A.dimension();
     auto ndim_B = B.dimension();
@@ -262,6 +418,7 @@ void add(const communicator& comm,
          T  beta, indexed_dpd_marray_view<      T> B, const label_vector& idx_B)
 {
     internal::initialize_once();
+    internal::stats_scope stats(comm);
 
     auto nirrep = A.num_irreps();
     TBLIS_ASSERT(B.num_irreps() == nirrep);
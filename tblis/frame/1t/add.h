@@ -3,6 +3,11 @@
 
 #include "../base/thread.h"
 #include "../base/basic_types.h"
+#include "../base/async.h"
+
+#if TBLIS_ENABLE_CPLUSPLUS
+#include <vector>
+#endif
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wnull-dereference"
@@ -17,6 +22,30 @@ void tblis_tensor_add(const tblis_comm* comm,
                             tblis_tensor* B,
                       const label_type* idx_B);
 
+/*
+ * As tblis_tensor_add, but executed asynchronously; see async.h.
+ */
+TBLIS_EXPORT
+tblis_async* tblis_tensor_add_async(const tblis_config* cntx,
+                                    const tblis_tensor* A,
+                                    const label_type* idx_A,
+                                          tblis_tensor* B,
+                                    const label_type* idx_B);
+
+/*
+ * B = sum_k A[k].scalar*A[k] + B.scalar*B in a single pass over B. Terms
+ * whose indices are a permutation of those of B are fused; any other terms
+ * (traces, replications) are added afterwards as by tblis_tensor_add.
+ */
+TBLIS_EXPORT
+void tblis_tensor_add_n(const tblis_comm* comm,
+                        const tblis_config* cntx,
+                        int nterm,
+                        const tblis_tensor* const* A,
+                        const label_type* const* idx_A,
+                              tblis_tensor* B,
+                        const label_type* idx_B);
+
 #if TBLIS_ENABLE_CPLUSPLUS
 
 inline
@@ -174,6 +203,73 @@ void add(const tensor_wrapper& A,
     add({1.0, A.type}, A, {0.0, A.type}, std::move(B));
 }
 
+inline
+future add_async(const scalar& alpha,
+                 const tensor_wrapper& A_,
+                 const label_vector& idx_A,
+                 const scalar& beta,
+                       tensor_wrapper&& B,
+                 const label_vector& idx_B)
+{
+    auto A(A_);
+    A.scalar *= alpha.convert(A.type);
+    B.scalar *= beta.convert(B.type);
+    return future(tblis_tensor_add_async(nullptr, &A, idx_A.data(), &B, idx_B.data()));
+}
+
+inline
+future add_async(const tensor_wrapper& A,
+                 const label_vector& idx_A,
+                       tensor_wrapper&& B,
+                 const label_vector& idx_B)
+{
+    return add_async({1.0, A.type}, A, idx_A, {0.0, A.type}, std::move(B), idx_B);
+}
+
+/*
+ * One term alpha*A of an n-ary add.
+ */
+struct add_term
+{
+    scalar alpha;
+    tensor_wrapper A;
+    label_vector idx_A;
+};
+
+inline
+void add(const communicator& comm,
+         const std::vector<add_term>& terms,
+         const scalar& beta,
+               tensor_wrapper&& B,
+         const label_vector& idx_B)
+{
+    std::vector<tblis_tensor> A;
+    std::vector<const tblis_tensor*> A_ptr;
+    std::vector<const label_type*> idx_A;
+
+    A.reserve(terms.size());
+    for (auto& term : terms)
+    {
+        TBLIS_ASSERT(term.A.ndim == term.idx_A.size());
+        A.push_back(term.A);
+        A.back().scalar *= term.alpha.convert(A.back().type);
+        A_ptr.push_back(&A.back());
+        idx_A.push_back(term.idx_A.data());
+    }
+
+    B.scalar *= beta.convert(B.type);
+    tblis_tensor_add_n(comm, nullptr, terms.size(), A_ptr.data(), idx_A.data(), &B, idx_B.data());
+}
+
+TBLIS_COMPAT_INLINE
+void add(const std::vector<add_term>& terms,
+         const scalar& beta,
+               tensor_wrapper&& B,
+         const label_vector& idx_B)
+{
+    add(*(communicator*)nullptr, terms, beta, std::move(B), idx_B);
+}
+
 #ifdef MARRAY_DPD_MARRAY_HPP
 
 template <typename T>
@@ -6,6 +6,7 @@
 #include "tblis/frame/0/add.hpp"
 
 #include "tblis/frame/base/tensor.hpp"
+#include "tblis/frame/base/streaming.hpp"
 
 #include "tblis/plugin/bli_plugin_tblis.h"
 
@@ -250,6 +251,15 @@ void add(type_t type, const communicator& comm, const cntx_t* cntx,
             std::swap(rs_B, cs_B);
         }
 
+        /*
+         * When B is too large to stay in cache and its old values are not
+         * needed, each panel of MS x NR elements is transposed into a
+         * buffer and then written to B with streaming stores, so that B is
+         * never read.
+         */
+        auto stream = beta.is_zero() && rs_B == 1 && use_streaming(m*n*mn1*ts);
+        const len_type MS = std::max(MR, (4096/(ts*MR))*MR);
+
         subcomm.distribute_over_gangs(mn1,
         [&](len_type mn1_min, len_type mn1_max)
         {
@@ -259,6 +269,8 @@ void add(type_t type, const communicator& comm, const cntx_t* cntx,
             viterator<2> iter_AB(len1, stride_A1, stride_B1);
             iter_AB.position(mn1_min, A1, B1);
 
+            std::vector<char> buf(stream ? MS*NR*ts : 0);
+
             for (len_type i = mn1_min;i < mn1_max;i++)
             {
                 iter_AB.next(A1, B1);
@@ -266,6 +278,28 @@ void add(type_t type, const communicator& comm, const cntx_t* cntx,
                 subcomm.distribute_over_threads({m, MR}, {n, NR},
                 [&](len_type m_min, len_type m_max, len_type n_min, len_type n_max)
                 {
+                    if (stream)
+                    {
+                        for (len_type j = n_min;j < n_max;j += NR)
+                        for (len_type i = m_min;i < m_max;i += MS)
+                        {
+                            len_type m_pan = std::min(m_max-i, MS);
+                            len_type n_loc = std::min(n_max-j, NR);
+
+                            for (len_type ii = 0;ii < m_pan;ii += MR)
+                                trans_ukr(std::min(m_pan-ii, MR), n_loc,
+                                          &alpha, conj_A, A1 + (i+ii)*rs_A*ts + j*cs_A*ts, rs_A, cs_A,
+                                           &beta, false, buf.data() + ii*ts, 1, MS);
+
+                            for (len_type jj = 0;jj < n_loc;jj++)
+                                stream_copy(ts, m_pan, buf.data() + jj*MS*ts,
+                                            B1 + i*ts + (j+jj)*cs_B*ts);
+                        }
+
+                        stream_fence();
+                        return;
+                    }
+
                     for (len_type i = m_min;i < m_max;i += MR)
                     for (len_type j = n_min;j < n_max;j += NR)
                     {
@@ -365,5 +399,145 @@ void add(type_t type, const communicator& comm, const cntx_t* cntx,
     comm.barrier();
 }
 
+void add_n(type_t type, const communicator& comm, const cntx_t* cntx,
+           const len_vector& len_B_,
+           const std::vector<scalar>& alpha,
+           const std::vector<bool>& conj_A,
+           const std::vector<const char*>& A,
+           const std::vector<stride_vector>& stride_A_,
+           const scalar&  beta, bool conj_B, char* B,
+           const stride_vector& stride_B_)
+{
+    bli_init();
+
+    const len_type ts = type_size[type];
+    const int nterm = A.size();
+
+    TBLIS_ASSERT(nterm > 0);
+
+    if (stl_ext::prod(len_B_) == 0) return;
+
+    /*
+     * Tile B over its smallest stride and over the dimension along which
+     * the most terms have unit stride (B's next smallest stride if none
+     * do), padding with unit dimensions if needed. As in the transpose add
+     * of a single A, every term then reads its tiles along a unit stride.
+     * Within each tile, every term is added by the transpose microkernel
+     * while the tile of B stays in cache.
+     */
+    auto perm = internal::sort_by_stride(stride_B_);
+    auto len_B = stl_ext::permuted(len_B_, perm);
+    auto stride_B = stl_ext::permuted(stride_B_, perm);
+    std::vector<stride_vector> stride_A;
+    for (auto& s : stride_A_) stride_A.push_back(stl_ext::permuted(s, perm));
+
+    while (len_B.size() < 2)
+    {
+        len_B.push_back(1);
+        stride_B.push_back(0);
+        for (auto& s : stride_A) s.push_back(0);
+    }
+
+    auto unit_A = 1;
+    auto nunit_A = 0;
+    for (auto i : range(1,len_B.size()))
+    {
+        if (len_B[i] == 1) continue;
+
+        auto nunit = 0;
+        for (auto& s : stride_A)
+            if (s[i] == 1) nunit++;
+
+        if (nunit > nunit_A)
+        {
+            unit_A = i;
+            nunit_A = nunit;
+        }
+    }
+
+    std::swap(len_B[1], len_B[unit_A]);
+    std::swap(stride_B[1], stride_B[unit_A]);
+    for (auto& s : stride_A) std::swap(s[1], s[unit_A]);
+
+    const len_type MR = bli_cntx_get_blksz_def_dt((num_t)type, (bszid_t)MRT_BSZ, cntx);
+    const len_type NR = bli_cntx_get_blksz_def_dt((num_t)type, (bszid_t)NRT_BSZ, cntx);
+
+    len_type m = len_B[0];
+    len_type n = len_B[1];
+    len_vector len1(len_B.begin()+2, len_B.end());
+    len_type mn1 = stl_ext::prod(len1);
+
+    stride_type rs_B = stride_B[0];
+    stride_type cs_B = stride_B[1];
+    stride_vector stride_B1;
+    for (auto i : range(2,stride_B.size())) stride_B1.push_back(stride_B[i]*ts);
+
+    std::vector<stride_type> rs_A, cs_A;
+    std::vector<stride_vector> stride_A1(nterm);
+    for (auto k : range(nterm))
+    {
+        rs_A.push_back(stride_A[k][0]);
+        cs_A.push_back(stride_A[k][1]);
+        for (auto i : range(2,stride_A[k].size())) stride_A1[k].push_back(stride_A[k][i]*ts);
+    }
+
+    scalar one(1.0, type);
+
+    unsigned nt_mn1, nt_mn;
+    std::tie(nt_mn1, nt_mn) = partition_2x2(comm.num_threads(), mn1, m*n);
+
+    auto trans_ukr = reinterpret_cast<trans_ft>(bli_cntx_get_ukr_dt((num_t)type, TRANS_KER, cntx));
+
+    auto subcomm = comm.gang(TCI_EVENLY, nt_mn1);
+
+    subcomm.distribute_over_gangs(mn1,
+    [&](len_type mn1_min, len_type mn1_max)
+    {
+        /*
+         * All operands have the same outer dimensions, so one iterator per
+         * operand is advanced in lock step.
+         */
+        auto B1 = B;
+        viterator<1> iter_B(len1, stride_B1);
+        iter_B.position(mn1_min, B1);
+
+        std::vector<const char*> A1(A);
+        std::vector<viterator<1>> iter_A;
+        for (auto k : range(nterm))
+        {
+            iter_A.emplace_back(len1, stride_A1[k]);
+            iter_A[k].position(mn1_min, A1[k]);
+        }
+
+        for (len_type l = mn1_min;l < mn1_max;l++)
+        {
+            iter_B.next(B1);
+            for (auto k : range(nterm)) iter_A[k].next(A1[k]);
+
+            subcomm.distribute_over_threads({m, MR}, {n, NR},
+            [&](len_type m_min, len_type m_max, len_type n_min, len_type n_max)
+            {
+                for (len_type i = m_min;i < m_max;i += MR)
+                for (len_type j = n_min;j < n_max;j += NR)
+                {
+                    len_type m_loc = std::min(m_max-i, MR);
+                    len_type n_loc = std::min(n_max-j, NR);
+
+                    auto B_ij = B1 + i*rs_B*ts + j*cs_B*ts;
+
+                    for (auto k : range(nterm))
+                    {
+                        trans_ukr(m_loc, n_loc,
+                                  &alpha[k], conj_A[k], A1[k] + i*rs_A[k]*ts + j*cs_A[k]*ts, rs_A[k], cs_A[k],
+                                  k == 0 ? &beta : &one, k == 0 && conj_B, B_ij, rs_B, cs_B);
+                    }
+                }
+            });
+        }
+    });
+
+    comm.barrier();
+}
+
 }
 }
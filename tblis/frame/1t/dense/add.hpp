@@ -4,6 +4,8 @@
 #include "tblis/frame/base/thread.h"
 #include "tblis/frame/base/basic_types.h"
 
+#include <vector>
+
 namespace tblis
 {
 namespace internal
@@ -20,6 +22,21 @@ void add(type_t type, const communicator& comm, const cntx_t* cntx,
          const stride_vector& stride_B,
          const stride_vector& stride_B_AB);
 
+/*
+ * B = sum_k alpha[k]*A[k] + beta*B, where every A[k] has the same
+ * dimensions as B (stride_A[k] is given in the order of stride_B). B is
+ * written once per tile rather than once per term. There must be at least
+ * one term.
+ */
+void add_n(type_t type, const communicator& comm, const cntx_t* cntx,
+           const len_vector& len_B,
+           const std::vector<scalar>& alpha,
+           const std::vector<bool>& conj_A,
+           const std::vector<const char*>& A,
+           const std::vector<stride_vector>& stride_A,
+           const scalar&  beta, bool conj_B, char* B,
+           const stride_vector& stride_B);
+
 }
 }
 
@@ -0,0 +1,362 @@
+#include "convert.hpp"
+
+#include "tblis/frame/base/tensor.hpp"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define TBLIS_CONVERT_X86 1
+#include <immintrin.h>
+#endif
+
+namespace tblis
+{
+namespace internal
+{
+
+template <typename T, typename U>
+static void convert_fiber(len_type n, const T* A, stride_type inc_A,
+                                            U* B, stride_type inc_B)
+{
+    for (len_type i = 0;i < n;i++)
+        B[i*inc_B] = U(A[i*inc_A]);
+}
+
+#if TBLIS_CONVERT_X86
+
+/*
+ * The half precision conversions of contiguous fibers are vectorized with
+ * AVX2 and F16C when the processor supports both (a virtual machine may
+ * expose one without the other), independently of the flags the library
+ * is compiled with.
+ */
+static bool has_avx2_f16c()
+{
+    static bool avx2_f16c = (__builtin_cpu_init(),
+                             __builtin_cpu_supports("avx2") &&
+                             __builtin_cpu_supports("f16c"));
+    return avx2_f16c;
+}
+
+__attribute__((target("avx2")))
+static void convert_avx2(len_type n, const bfloat16* A, float* B)
+{
+    len_type i = 0;
+    for (;i+8 <= n;i += 8)
+    {
+        auto a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(A+i));
+        auto b = _mm256_slli_epi32(_mm256_cvtepu16_epi32(a), 16);
+        _mm256_storeu_ps(B+i, _mm256_castsi256_ps(b));
+    }
+
+    for (;i < n;i++) B[i] = A[i];
+}
+
+__attribute__((target("avx2")))
+static void convert_avx2(len_type n, const float* A, bfloat16* B)
+{
+    auto one = _mm256_set1_epi32(1);
+    auto bias = _mm256_set1_epi32(0x7fff);
+    auto quiet = _mm256_set1_epi32(0x40);
+
+    len_type i = 0;
+    for (;i+8 <= n;i += 8)
+    {
+        auto x = _mm256_loadu_ps(A+i);
+        auto a = _mm256_castps_si256(x);
+        auto hi = _mm256_srli_epi32(a, 16);
+
+        // Round to nearest even, but keep NaNs quiet NaNs.
+        auto b = _mm256_srli_epi32(_mm256_add_epi32(_mm256_add_epi32(a, bias),
+                                                    _mm256_and_si256(hi, one)), 16);
+        auto nan = _mm256_castps_si256(_mm256_cmp_ps(x, x, _CMP_UNORD_Q));
+        b = _mm256_blendv_epi8(b, _mm256_or_si256(hi, quiet), nan);
+
+        auto p = _mm_packus_epi32(_mm256_castsi256_si128(b), _mm256_extracti128_si256(b, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(B+i), p);
+    }
+
+    for (;i < n;i++) B[i] = A[i];
+}
+
+__attribute__((target("avx2,f16c")))
+static void convert_avx2(len_type n, const float16* A, float* B)
+{
+    len_type i = 0;
+    for (;i+8 <= n;i += 8)
+    {
+        auto a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(A+i));
+        _mm256_storeu_ps(B+i, _mm256_cvtph_ps(a));
+    }
+
+    for (;i < n;i++) B[i] = A[i];
+}
+
+__attribute__((target("avx2,f16c")))
+static void convert_avx2(len_type n, const float* A, float16* B)
+{
+    len_type i = 0;
+    for (;i+8 <= n;i += 8)
+    {
+        auto a = _mm256_cvtps_ph(_mm256_loadu_ps(A+i), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(B+i), a);
+    }
+
+    for (;i < n;i++) B[i] = A[i];
+}
+
+#define TBLIS_CONVERT_HALF_FIBER(T, U) \
+static void convert_fiber(len_type n, const T* A, stride_type inc_A, \
+                                            U* B, stride_type inc_B) \
+{ \
+    if (inc_A == 1 && inc_B == 1 && has_avx2_f16c()) \
+    { \
+        convert_avx2(n, A, B); \
+        return; \
+    } \
+\
+    for (len_type i = 0;i < n;i++) \
+        B[i*inc_B] = U(A[i*inc_A]); \
+}
+
+TBLIS_CONVERT_HALF_FIBER(bfloat16, float)
+TBLIS_CONVERT_HALF_FIBER(float, bfloat16)
+TBLIS_CONVERT_HALF_FIBER(float16, float)
+TBLIS_CONVERT_HALF_FIBER(float, float16)
+
+#endif
+
+template <typename T, typename U>
+static void convert(const communicator& comm, const len_vector& len_,
+                    const T* A, const stride_vector& stride_A_,
+                          U* B, const stride_vector& stride_B_)
+{
+    auto len = len_;
+    auto stride_A = stride_A_;
+    auto stride_B = stride_B_;
+
+    if (len.empty())
+    {
+        len.push_back(1);
+        stride_A.push_back(0);
+        stride_B.push_back(0);
+    }
+
+    /*
+     * The fiber is the dimension with the smallest stride in B.
+     */
+    auto reorder = sort_by_stride(stride_B, stride_A);
+    len = stl_ext::permuted(len, reorder);
+    stride_A = stl_ext::permuted(stride_A, reorder);
+    stride_B = stl_ext::permuted(stride_B, reorder);
+
+    auto n0 = len[0];
+    auto inc_A = stride_A[0];
+    auto inc_B = stride_B[0];
+    len_vector len1(len.begin()+1, len.end());
+    stride_vector stride_A1(stride_A.begin()+1, stride_A.end());
+    stride_vector stride_B1(stride_B.begin()+1, stride_B.end());
+    auto n1 = stl_ext::prod(len1);
+
+    comm.distribute_over_threads(n0, n1,
+    [&](len_type n0_min, len_type n0_max, len_type n1_min, len_type n1_max)
+    {
+        auto A1 = A + n0_min*inc_A;
+        auto B1 = B + n0_min*inc_B;
+
+        viterator<2> iter_AB(len1, stride_A1, stride_B1);
+        iter_AB.position(n1_min, A1, B1);
+
+        for (len_type i = n1_min;i < n1_max;i++)
+        {
+            iter_AB.next(A1, B1);
+            convert_fiber(n0_max-n0_min, A1, inc_A, B1, inc_B);
+        }
+    });
+
+    comm.barrier();
+}
+
+#define TBLIS_FOREACH_CONVERSION \
+    TBLIS_CONVERT_CASE(   float,    float) \
+    TBLIS_CONVERT_CASE(   float,   double) \
+    TBLIS_CONVERT_CASE(  double,    float) \
+    TBLIS_CONVERT_CASE(  double,   double) \
+    TBLIS_CONVERT_CASE(scomplex, scomplex) \
+    TBLIS_CONVERT_CASE(scomplex, dcomplex) \
+    TBLIS_CONVERT_CASE(dcomplex, scomplex) \
+    TBLIS_CONVERT_CASE(dcomplex, dcomplex) \
+    TBLIS_CONVERT_CASE(bfloat16,    float) \
+    TBLIS_CONVERT_CASE(   float, bfloat16) \
+    TBLIS_CONVERT_CASE( float16,    float) \
+    TBLIS_CONVERT_CASE(   float,  float16) \
+    TBLIS_CONVERT_CASE(bfloat16,   double) \
+    TBLIS_CONVERT_CASE(  double, bfloat16) \
+    TBLIS_CONVERT_CASE( float16,   double) \
+    TBLIS_CONVERT_CASE(  double,  float16)
+
+void convert(type_t type_A, type_t type_B, const communicator& comm,
+             const len_vector& len,
+             const char* A, const stride_vector& stride_A,
+                   char* B, const stride_vector& stride_B)
+{
+    #define TBLIS_CONVERT_CASE(T, U) \
+    if (type_A == type_tag<T>::value && type_B == type_tag<U>::value) \
+    { \
+        convert(comm, len, reinterpret_cast<const T*>(A), stride_A, \
+                           reinterpret_cast<      U*>(B), stride_B); \
+        return; \
+    }
+
+    TBLIS_FOREACH_CONVERSION
+
+    #undef TBLIS_CONVERT_CASE
+
+    TBLIS_ASSERT(0, "Unsupported conversion");
+}
+
+void convert(type_t type_A, type_t type_B, len_type n,
+             const char* A, stride_type inc_A,
+                   char* B, stride_type inc_B)
+{
+    #define TBLIS_CONVERT_CASE(T, U) \
+    if (type_A == type_tag<T>::value && type_B == type_tag<U>::value) \
+    { \
+        convert_fiber(n, reinterpret_cast<const T*>(A), inc_A, \
+                         reinterpret_cast<      U*>(B), inc_B); \
+        return; \
+    }
+
+    TBLIS_FOREACH_CONVERSION
+
+    #undef TBLIS_CONVERT_CASE
+
+    TBLIS_ASSERT(0, "Unsupported conversion");
+}
+
+#undef TBLIS_FOREACH_CONVERSION
+
+template <typename T, typename U>
+static void add_half(const communicator& comm,
+                     const len_vector& len_A_only,
+                     const len_vector& len_B_only,
+                     const len_vector& len_AB,
+                     float alpha, const T* A,
+                     const stride_vector& stride_A_only,
+                     const stride_vector& stride_A_AB,
+                     float  beta,       U* B,
+                     const stride_vector& stride_B_only,
+                     const stride_vector& stride_B_AB)
+{
+    auto len = len_B_only + len_AB;
+    auto stride_A = stride_vector(len_B_only.size(), 0) + stride_A_AB;
+    auto stride_B = stride_B_only + stride_B_AB;
+
+    if (len.empty())
+    {
+        len.push_back(1);
+        stride_A.push_back(0);
+        stride_B.push_back(0);
+    }
+
+    /*
+     * The fiber is the dimension with the smallest stride in B.
+     */
+    auto reorder = sort_by_stride(stride_B, stride_A);
+    len = stl_ext::permuted(len, reorder);
+    stride_A = stl_ext::permuted(stride_A, reorder);
+    stride_B = stl_ext::permuted(stride_B, reorder);
+
+    auto n0 = len[0];
+    auto inc_A = stride_A[0];
+    auto inc_B = stride_B[0];
+    len_vector len1(len.begin()+1, len.end());
+    stride_vector stride_A1(stride_A.begin()+1, stride_A.end());
+    stride_vector stride_B1(stride_B.begin()+1, stride_B.end());
+    auto n1 = stl_ext::prod(len1);
+
+    comm.distribute_over_threads(n0, n1,
+    [&](len_type n0_min, len_type n0_max, len_type n1_min, len_type n1_max)
+    {
+        float a[convert_block];
+        float b[convert_block];
+
+        stride_type A1 = n0_min*inc_A;
+        stride_type B1 = n0_min*inc_B;
+
+        viterator<1> iter_A(len_A_only, stride_A_only);
+        viterator<2> iter_AB(len1, stride_A1, stride_B1);
+        iter_AB.position(n1_min, A1, B1);
+
+        for (len_type i = n1_min;i < n1_max;i++)
+        {
+            iter_AB.next(A1, B1);
+
+            for (len_type j = 0;j < n0_max-n0_min;j += convert_block)
+            {
+                auto n = std::min(convert_block, n0_max-n0_min-j);
+                auto A2 = A1 + j*inc_A;
+                auto B2 = B1 + j*inc_B;
+
+                std::fill_n(b, n, 0.0f);
+
+                if (A)
+                {
+                    while (iter_A.next(A2))
+                    {
+                        convert_fiber(n, A+A2, inc_A, a, 1);
+                        for (len_type k = 0;k < n;k++) b[k] += a[k];
+                    }
+
+                    for (len_type k = 0;k < n;k++) b[k] *= alpha;
+                }
+
+                if (beta != 0.0f)
+                {
+                    convert_fiber(n, B+B2, inc_B, a, 1);
+                    for (len_type k = 0;k < n;k++) b[k] += beta*a[k];
+                }
+
+                convert_fiber(n, b, 1, B+B2, inc_B);
+            }
+        }
+    });
+
+    comm.barrier();
+}
+
+void add_half(type_t type_A, type_t type_B, const communicator& comm,
+              const len_vector& len_A_only,
+              const len_vector& len_B_only,
+              const len_vector& len_AB,
+              float alpha, const char* A,
+              const stride_vector& stride_A_only,
+              const stride_vector& stride_A_AB,
+              float  beta,       char* B,
+              const stride_vector& stride_B_only,
+              const stride_vector& stride_B_AB)
+{
+    #define TBLIS_ADD_HALF_CASE(T, U) \
+    if (type_A == type_tag<T>::value && type_B == type_tag<U>::value) \
+    { \
+        add_half(comm, len_A_only, len_B_only, len_AB, \
+                 alpha, reinterpret_cast<const T*>(A), stride_A_only, stride_A_AB, \
+                  beta, reinterpret_cast<      U*>(B), stride_B_only, stride_B_AB); \
+        return; \
+    }
+
+    TBLIS_ADD_HALF_CASE(   float,    float)
+    TBLIS_ADD_HALF_CASE(   float, bfloat16)
+    TBLIS_ADD_HALF_CASE(   float,  float16)
+    TBLIS_ADD_HALF_CASE(bfloat16,    float)
+    TBLIS_ADD_HALF_CASE(bfloat16, bfloat16)
+    TBLIS_ADD_HALF_CASE(bfloat16,  float16)
+    TBLIS_ADD_HALF_CASE( float16,    float)
+    TBLIS_ADD_HALF_CASE( float16, bfloat16)
+    TBLIS_ADD_HALF_CASE( float16,  float16)
+
+    #undef TBLIS_ADD_HALF_CASE
+
+    TBLIS_ASSERT(0, "Unsupported conversion");
+}
+
+}
+}
@@ -0,0 +1,79 @@
+#ifndef _TBLIS_INTERNAL_1T_CONVERT_HPP_
+#define _TBLIS_INTERNAL_1T_CONVERT_HPP_
+
+#include "tblis/frame/base/thread.h"
+#include "tblis/frame/base/basic_types.h"
+
+namespace tblis
+{
+namespace internal
+{
+
+inline bool is_half(type_t type)
+{
+    return type == TYPE_BFLOAT16 || type == TYPE_FLOAT16;
+}
+
+/*
+ * B = A, converting between the precisions of one domain, or between a half
+ * precision storage type and float or double.
+ */
+void convert(type_t type_A, type_t type_B, const communicator& comm,
+             const len_vector& len,
+             const char* A, const stride_vector& stride_A,
+                   char* B, const stride_vector& stride_B);
+
+/*
+ * B = A for a single fiber of n elements.
+ */
+void convert(type_t type_A, type_t type_B, len_type n,
+             const char* A, stride_type inc_A,
+                   char* B, stride_type inc_B);
+
+/*
+ * The number of elements of a half precision fiber which are converted at
+ * a time, through a buffer on the stack.
+ */
+constexpr len_type convert_block = 256;
+
+/*
+ * The type of the scalars of a tensor of the given type, in which its
+ * values are computed.
+ */
+inline type_t value_type(type_t type)
+{
+    return is_half(type) ? TYPE_FLOAT : type;
+}
+
+/*
+ * B = alpha*A + beta*B, where each of A and B is float or half precision.
+ * A is summed over the dimensions not in B and broadcast over those not
+ * in A. The fibers of B are converted in blocks of convert_block elements;
+ * A is not read if it is null and B is not read if beta is zero.
+ */
+void add_half(type_t type_A, type_t type_B, const communicator& comm,
+              const len_vector& len_A_only,
+              const len_vector& len_B_only,
+              const len_vector& len_AB,
+              float alpha, const char* A,
+              const stride_vector& stride_A_only,
+              const stride_vector& stride_A_AB,
+              float  beta,       char* B,
+              const stride_vector& stride_B_only,
+              const stride_vector& stride_B_AB);
+
+/*
+ * B = beta*B for a half precision B.
+ */
+inline void scale_half(type_t type_B, const communicator& comm,
+                       const len_vector& len_B,
+                       float beta, char* B, const stride_vector& stride_B)
+{
+    add_half(type_B, type_B, comm, {}, {}, len_B, 0.0f, nullptr, {}, {},
+             beta, B, {}, stride_B);
+}
+
+}
+}
+
+#endif
@@ -1,5 +1,6 @@
 #include "dot.hpp"
 
+#include "tblis/frame/base/env.hpp"
 #include "tblis/frame/base/tensor.hpp"
 
 #include "tblis/plugin/bli_plugin_tblis.h"
@@ -31,6 +32,44 @@ void dot(type_t type, const communicator& comm, const cntx_t* cntx,
     for (auto i : range(1,len_AB.size())) stride_A1.push_back(stride_A_AB[i]*ts);
     for (auto i : range(1,len_AB.size())) stride_B1.push_back(stride_B_AB[i]*ts);
 
+    if (get_compensated_sum())
+    {
+        auto dot_ukr = reinterpret_cast<kahan_dot_ft>(bli_cntx_get_ukr_dt((num_t)type, KAHAN_DOT_KER, cntx));
+
+        scalar sum(0, type);
+        scalar comp(0, type);
+
+        comm.distribute_over_threads(n0, n1,
+        [&](len_type n0_min, len_type n0_max, len_type n1_min, len_type n1_max)
+        {
+            auto A1 = A;
+            auto B1 = B;
+
+            viterator<2> iter_AB(len1, stride_A1, stride_B1);
+            iter_AB.position(n1_min, A1, B1);
+            A1 += n0_min*stride_A0*ts;
+            B1 += n0_min*stride_B0*ts;
+
+            for (len_type i = n1_min;i < n1_max;i++)
+            {
+                iter_AB.next(A1, B1);
+                dot_ukr(n0_max-n0_min, conj_A, A1, stride_A0,
+                                       conj_B, B1, stride_B0, sum.raw(), comp.raw());
+            }
+        });
+
+        reduce(type, comm, sum, comp);
+
+        if (comm.master())
+        {
+            sum -= comp;
+            sum.to(result);
+        }
+
+        comm.barrier();
+        return;
+    }
+
     atomic_accumulator local_result;
 
     auto dot_ukr = reinterpret_cast<dotv_ker_ft>(bli_cntx_get_ukr_dt((num_t)type, BLIS_DOTV_KER, cntx));
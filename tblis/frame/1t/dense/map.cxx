@@ -0,0 +1,122 @@
+#include "map.hpp"
+
+#include "tblis/frame/base/tensor.hpp"
+
+namespace tblis
+{
+namespace internal
+{
+
+void map(type_t type, const communicator& comm, const cntx_t*,
+         tblis_map_func func, void* data,
+         const len_vector& len_AB_,
+         const scalar& alpha, bool conj_A, const char* A,
+         const stride_vector& stride_A_AB_,
+         const scalar&  beta, bool conj_B,       char* B,
+         const stride_vector& stride_B_AB_)
+{
+    const len_type ts = type_size[type];
+
+    /*
+     * The fibers run along the dimension of smallest stride in B (ties
+     * broken by A), so that the output is written contiguously when
+     * possible.
+     */
+    auto reorder_AB = sort_by_stride(stride_B_AB_, stride_A_AB_);
+    auto len_AB = stl_ext::permuted(len_AB_, reorder_AB);
+    auto stride_A_AB = stl_ext::permuted(stride_A_AB_, reorder_AB);
+    auto stride_B_AB = stl_ext::permuted(stride_B_AB_, reorder_AB);
+
+    bool empty = len_AB.size() == 0;
+
+    len_type n0 = (empty ? 1 : len_AB[0]);
+    len_vector len1(len_AB.begin() + !empty, len_AB.end());
+    len_type n1 = stl_ext::prod(len1);
+
+    stride_type stride_A0 = (empty ? 1 : stride_A_AB[0]);
+    stride_type stride_B0 = (empty ? 1 : stride_B_AB[0]);
+    stride_vector stride_A1, stride_B1;
+    for (auto i : range(1,len_AB.size())) stride_A1.push_back(stride_A_AB[i]*ts);
+    for (auto i : range(1,len_AB.size())) stride_B1.push_back(stride_B_AB[i]*ts);
+
+    comm.distribute_over_threads(n0, n1,
+    [&](len_type n0_min, len_type n0_max, len_type n1_min, len_type n1_max)
+    {
+        auto A1 = A;
+        auto B1 = B;
+
+        viterator<2> iter_AB(len1, stride_A1, stride_B1);
+        iter_AB.position(n1_min, A1, B1);
+        A1 += n0_min*stride_A0*ts;
+        B1 += n0_min*stride_B0*ts;
+
+        for (len_type i = n1_min;i < n1_max;i++)
+        {
+            iter_AB.next(A1, B1);
+            func(n0_max-n0_min, alpha.raw(), conj_A, A1, stride_A0,
+                                 beta.raw(), conj_B, B1, stride_B0, data);
+        }
+    });
+
+    comm.barrier();
+}
+
+void zip(type_t type, const communicator& comm, const cntx_t*,
+         tblis_zip_func func, void* data,
+         const len_vector& len_ABC_,
+         const scalar& alpha, bool conj_A, const char* A,
+         const stride_vector& stride_A_ABC_,
+         const scalar&  beta, bool conj_B, const char* B,
+         const stride_vector& stride_B_ABC_,
+         const scalar& gamma, bool conj_C,       char* C,
+         const stride_vector& stride_C_ABC_)
+{
+    const len_type ts = type_size[type];
+
+    auto reorder_ABC = sort_by_stride(stride_C_ABC_, stride_A_ABC_, stride_B_ABC_);
+    auto len_ABC = stl_ext::permuted(len_ABC_, reorder_ABC);
+    auto stride_A_ABC = stl_ext::permuted(stride_A_ABC_, reorder_ABC);
+    auto stride_B_ABC = stl_ext::permuted(stride_B_ABC_, reorder_ABC);
+    auto stride_C_ABC = stl_ext::permuted(stride_C_ABC_, reorder_ABC);
+
+    bool empty = len_ABC.size() == 0;
+
+    len_type n0 = (empty ? 1 : len_ABC[0]);
+    len_vector len1(len_ABC.begin() + !empty, len_ABC.end());
+    len_type n1 = stl_ext::prod(len1);
+
+    stride_type stride_A0 = (empty ? 1 : stride_A_ABC[0]);
+    stride_type stride_B0 = (empty ? 1 : stride_B_ABC[0]);
+    stride_type stride_C0 = (empty ? 1 : stride_C_ABC[0]);
+    stride_vector stride_A1, stride_B1, stride_C1;
+    for (auto i : range(1,len_ABC.size())) stride_A1.push_back(stride_A_ABC[i]*ts);
+    for (auto i : range(1,len_ABC.size())) stride_B1.push_back(stride_B_ABC[i]*ts);
+    for (auto i : range(1,len_ABC.size())) stride_C1.push_back(stride_C_ABC[i]*ts);
+
+    comm.distribute_over_threads(n0, n1,
+    [&](len_type n0_min, len_type n0_max, len_type n1_min, len_type n1_max)
+    {
+        auto A1 = A;
+        auto B1 = B;
+        auto C1 = C;
+
+        viterator<3> iter_ABC(len1, stride_A1, stride_B1, stride_C1);
+        iter_ABC.position(n1_min, A1, B1, C1);
+        A1 += n0_min*stride_A0*ts;
+        B1 += n0_min*stride_B0*ts;
+        C1 += n0_min*stride_C0*ts;
+
+        for (len_type i = n1_min;i < n1_max;i++)
+        {
+            iter_ABC.next(A1, B1, C1);
+            func(n0_max-n0_min, alpha.raw(), conj_A, A1, stride_A0,
+                                 beta.raw(), conj_B, B1, stride_B0,
+                                gamma.raw(), conj_C, C1, stride_C0, data);
+        }
+    });
+
+    comm.barrier();
+}
+
+}
+}
@@ -0,0 +1,40 @@
+#ifndef _TBLIS_INTERNAL_1T_MAP_HPP_
+#define _TBLIS_INTERNAL_1T_MAP_HPP_
+
+#include "tblis/frame/base/thread.h"
+#include "tblis/frame/base/basic_types.h"
+
+namespace tblis
+{
+namespace internal
+{
+
+/*
+ * B = f(alpha*A) + beta*B elementwise, where f is applied one fiber at a
+ * time by func (see tblis_map_func).
+ */
+void map(type_t type, const communicator& comm, const cntx_t* cntx,
+         tblis_map_func func, void* data,
+         const len_vector& len_AB,
+         const scalar& alpha, bool conj_A, const char* A,
+         const stride_vector& stride_A_AB,
+         const scalar&  beta, bool conj_B,       char* B,
+         const stride_vector& stride_B_AB);
+
+/*
+ * C = f(alpha*A, beta*B) + gamma*C elementwise (see tblis_zip_func).
+ */
+void zip(type_t type, const communicator& comm, const cntx_t* cntx,
+         tblis_zip_func func, void* data,
+         const len_vector& len_ABC,
+         const scalar& alpha, bool conj_A, const char* A,
+         const stride_vector& stride_A_ABC,
+         const scalar&  beta, bool conj_B, const char* B,
+         const stride_vector& stride_B_ABC,
+         const scalar& gamma, bool conj_C,       char* C,
+         const stride_vector& stride_C_ABC);
+
+}
+}
+
+#endif
@@ -0,0 +1,256 @@
+#include "permute.hpp"
+
+#include "tblis/frame/base/tensor.hpp"
+
+#include "tblis/plugin/bli_plugin_tblis.h"
+
+#include <cstring>
+#include <numeric>
+
+namespace tblis
+{
+namespace internal
+{
+
+/*
+ * The largest tile used when transposing unit-stride dimensions.
+ */
+constexpr len_type max_tile = 32;
+
+/*
+ * Position pos of the q x p transpose of a p x q column-major matrix holds
+ * this element of the original.
+ */
+static inline len_type transpose_source(len_type pos, len_type p, len_type q)
+{
+    return pos/q + (pos%q)*p;
+}
+
+/*
+ * Apart from the first and last positions, which are fixed, the element
+ * at position pos moves to pos*q mod (n-1), where n = p*q. Each cycle is
+ * identified by its smallest position (its leader). Return the length of
+ * the cycle containing start if start is its leader, and otherwise 0 as
+ * soon as a smaller position is reached.
+ */
+static len_type cycle_leader(len_type p, len_type q, len_type start)
+{
+    len_type len = 0;
+    auto pos = start;
+    do
+    {
+        pos = transpose_source(pos, p, q);
+        if (pos < start) return 0;
+        len++;
+    }
+    while (pos != start);
+
+    return len;
+}
+
+/*
+ * Move the elements (of es bytes each) on the cycle containing start to
+ * their positions in the transpose. buf holds one element.
+ */
+static void follow_cycle(len_type es, len_type p, len_type q, char* A,
+                         len_type start, char* buf)
+{
+    memcpy(buf, A + start*es, es);
+
+    auto pos = start;
+    for (auto src = transpose_source(pos, p, q);src != start;
+              src = transpose_source(pos, p, q))
+    {
+        memcpy(A + pos*es, A + src*es, es);
+        pos = src;
+    }
+
+    memcpy(A + pos*es, buf, es);
+}
+
+/*
+ * Transpose each of nz consecutive p x q column-major matrices in place,
+ * where each element is a contiguous block of es bytes. The auxiliary
+ * memory is one element per thread.
+ */
+static void transpose_cycles(const communicator& comm, len_type es,
+                             len_type p, len_type q, len_type nz, char* A)
+{
+    if (p == 1 || q == 1 || nz == 0) return;
+
+    auto n = p*q;
+
+    /*
+     * Each cycle is followed by the thread which finds its leader, so no
+     * positions are marked. Finding a leader only walks positions, and
+     * cycles are disjoint, so threads never touch the same elements.
+     */
+    auto follow_leaders = [&](char* A, len_type start_min, len_type start_max, char* buf)
+    {
+        for (auto start : range(start_min, start_max))
+            if (cycle_leader(p, q, start) > 1)
+                follow_cycle(es, p, q, A, start, buf);
+    };
+
+    if (nz >= (len_type)comm.num_threads())
+    {
+        /*
+         * With enough matrices, each is transposed by a single thread.
+         */
+        comm.distribute_over_threads(nz,
+        [&](len_type z_min, len_type z_max)
+        {
+            std::vector<char> buf(es);
+
+            for (auto z : range(z_min, z_max))
+                follow_leaders(A + z*n*es, 1, n-1, buf.data());
+        });
+    }
+    else
+    {
+        /*
+         * Otherwise each thread looks for leaders among its own range of
+         * the positions of each matrix.
+         */
+        for (auto z : range(nz))
+        {
+            comm.distribute_over_threads(n-2,
+            [&](len_type start_min, len_type start_max)
+            {
+                std::vector<char> buf(es);
+                follow_leaders(A + z*n*es, start_min+1, start_max+1, buf.data());
+            });
+        }
+    }
+
+    comm.barrier();
+}
+
+/*
+ * Transpose each of ntile consecutive t x t tiles in place with the
+ * transpose microkernel.
+ */
+static void transpose_tiles(type_t type, const communicator& comm, const cntx_t* cntx,
+                            len_type t, len_type ntile, char* A)
+{
+    const len_type ts = type_size[type];
+
+    const len_type MR = bli_cntx_get_blksz_def_dt((num_t)type, (bszid_t)MRT_BSZ, cntx);
+    const len_type NR = bli_cntx_get_blksz_def_dt((num_t)type, (bszid_t)NRT_BSZ, cntx);
+
+    auto trans_ukr = reinterpret_cast<trans_ft>(bli_cntx_get_ukr_dt((num_t)type, TRANS_KER, cntx));
+
+    scalar one(1.0, type);
+    scalar zero(0.0, type);
+
+    comm.distribute_over_threads(ntile,
+    [&](len_type tile_min, len_type tile_max)
+    {
+        std::vector<char> buf(t*t*ts);
+
+        for (auto tile : range(tile_min, tile_max))
+        {
+            auto A1 = A + tile*t*t*ts;
+            memcpy(buf.data(), A1, t*t*ts);
+
+            for (len_type i = 0;i < t;i += MR)
+            for (len_type j = 0;j < t;j += NR)
+            {
+                trans_ukr(std::min(t-i, MR), std::min(t-j, NR),
+                           &one, false, buf.data() + (i + j*t)*ts, 1, t,
+                          &zero, false,        A1 + (j + i*t)*ts, t, 1);
+            }
+        }
+    });
+
+    comm.barrier();
+}
+
+/*
+ * Transpose each of nz consecutive p x q column-major matrices in place,
+ * where each element is a contiguous block of w elements.
+ *
+ * When w == 1, and p and q have a common factor t which is large enough,
+ * the transpose is blocked into t x t tiles:
+ *
+ * 1. Each panel of t columns is reordered so that its tiles are contiguous.
+ * 2. The M x N matrix of tiles is transposed, moving whole tiles.
+ * 3. Each tile is transposed in cache.
+ * 4. Each panel of the result is reordered back to column-major.
+ *
+ * Each step only moves blocks of at least t elements at a time.
+ */
+static void transpose(type_t type, const communicator& comm, const cntx_t* cntx,
+                      len_type w, len_type p, len_type q, len_type nz, char* A)
+{
+    const len_type ts = type_size[type];
+
+    if (p == 1 || q == 1) return;
+
+    if (w == 1)
+    {
+        auto g = std::gcd(p, q);
+        auto t = std::min(g, max_tile);
+        while (g % t) t--;
+
+        if (t >= 4)
+        {
+            auto M = p/t;
+            auto N = q/t;
+
+            transpose_cycles(comm, t*ts, M, t, nz*N, A);
+            transpose_cycles(comm, t*t*ts, M, N, nz, A);
+            transpose_tiles(type, comm, cntx, t, nz*M*N, A);
+            transpose_cycles(comm, t*ts, t, N, nz*M, A);
+            return;
+        }
+    }
+
+    transpose_cycles(comm, w*ts, p, q, nz, A);
+}
+
+void permute(type_t type, const communicator& comm, const cntx_t* cntx,
+             const len_vector& len_A, const dim_vector& perm, char* A)
+{
+    bli_init();
+
+    int ndim = len_A.size();
+    TBLIS_ASSERT(perm.size() == ndim);
+
+    /*
+     * The dimensions of A in the current storage order. At each step, the
+     * next dimensions needed at position i (and any which already follow
+     * them) are moved there by exchanging them with the block of
+     * dimensions in between, which is a batch of transposes.
+     */
+    dim_vector cur = range(ndim);
+
+    for (int i = 0;i < ndim;)
+    {
+        if (cur[i] == perm[i])
+        {
+            i++;
+            continue;
+        }
+
+        auto k = i+1;
+        while (cur[k] != perm[i]) k++;
+
+        auto r = 1;
+        while (k+r < ndim && cur[k+r] == perm[i+r]) r++;
+
+        len_type w = 1, p = 1, q = 1, nz = 1;
+        for (auto j : range(    i)) w *= len_A[cur[j]];
+        for (auto j : range(i,  k)) p *= len_A[cur[j]];
+        for (auto j : range(k,k+r)) q *= len_A[cur[j]];
+        for (auto j : range(k+r,ndim)) nz *= len_A[cur[j]];
+
+        transpose(type, comm, cntx, w, p, q, nz, A);
+
+        std::rotate(cur.begin()+i, cur.begin()+k, cur.begin()+k+r);
+        i += r;
+    }
+}
+
+}
+}
@@ -0,0 +1,23 @@
+#ifndef _TBLIS_INTERNAL_1T_PERMUTE_HPP_
+#define _TBLIS_INTERNAL_1T_PERMUTE_HPP_
+
+#include "tblis/frame/base/thread.h"
+#include "tblis/frame/base/basic_types.h"
+
+namespace tblis
+{
+namespace internal
+{
+
+/*
+ * Permute the dimensions of the densely-packed tensor A in place. len_A is
+ * given in storage order (unit stride first), and dimension k of the result
+ * in storage order is dimension perm[k] of A.
+ */
+void permute(type_t type, const communicator& comm, const cntx_t* cntx,
+             const len_vector& len_A, const dim_vector& perm, char* A);
+
+}
+}
+
+#endif
@@ -1,5 +1,8 @@
 #include "reduce.hpp"
+#include "convert.hpp"
 
+#include "tblis/frame/0/reduce.hpp"
+#include "tblis/frame/base/env.hpp"
 #include "tblis/frame/base/tensor.hpp"
 
 #include "tblis/plugin/bli_plugin_tblis.h"
@@ -9,7 +12,27 @@ namespace tblis
 namespace internal
 {
 
-void reduce(type_t type, const communicator& comm, const cntx_t* cntx, reduce_t op,
+/*
+ * Call ukr(n, A, off) on successive blocks of a fiber of a half precision
+ * tensor, converted to contiguous floats; off is the offset in elements of
+ * the block from the start of the fiber.
+ */
+template <typename Ukr>
+static void half_fiber(type_t type_A, len_type n, const char* A, stride_type inc_A, Ukr&& ukr)
+{
+    float buf[convert_block];
+
+    const len_type ts = storage_size(type_A);
+
+    for (len_type i = 0;i < n;i += convert_block)
+    {
+        auto m = std::min(convert_block, n-i);
+        convert(type_A, TYPE_FLOAT, m, A + i*inc_A*ts, inc_A, reinterpret_cast<char*>(buf), 1);
+        ukr(m, buf, i*inc_A);
+    }
+}
+
+void reduce(type_t type_A, const communicator& comm, const cntx_t* cntx, reduce_t op,
             const len_vector& len_A,
             const char* A, const stride_vector& stride_A,
             char* result, len_type& idx)
@@ -18,7 +41,13 @@ void reduce(type_t type, const communicator& comm, const cntx_t* cntx, reduce_t
 
     bool empty = len_A.size() == 0;
 
-    const len_type ts = type_size[type];
+    /*
+     * Half precision fibers are converted to float in blocks and reduced in
+     * float, which is also the type of the result.
+     */
+    auto half = is_half(type_A);
+    auto type = value_type(type_A);
+    const len_type ts = storage_size(type_A);
 
     len_type n0 = (empty ? 1 : len_A[0]);
     len_vector len1(len_A.begin() + !empty, len_A.end());
@@ -28,6 +57,55 @@ void reduce(type_t type, const communicator& comm, const cntx_t* cntx, reduce_t
     len_vector stride1;
     for (auto i : range(1,len_A.size())) stride1.push_back(stride_A[i]*ts);
 
+    if (op == REDUCE_SUM && get_compensated_sum())
+    {
+        auto sum_ukr = reinterpret_cast<kahan_sum_ft>(bli_cntx_get_ukr_dt((num_t)type, KAHAN_SUM_KER, cntx));
+
+        scalar sum(0, type);
+        scalar comp(0, type);
+
+        comm.distribute_over_threads(n0, n1,
+        [&](len_type n0_min, len_type n0_max, len_type n1_min, len_type n1_max)
+        {
+            auto A1 = A;
+
+            viterator<1> iter_A(len1, stride1);
+            iter_A.position(n1_min, A1);
+
+            A1 += n0_min*stride0*ts;
+
+            for (len_type i = n1_min;i < n1_max;i++)
+            {
+                iter_A.next(A1);
+
+                if (half)
+                {
+                    half_fiber(type_A, n0_max-n0_min, A1, stride0,
+                    [&](len_type m, const float* buf, stride_type)
+                    {
+                        sum_ukr(m, buf, 1, sum.raw(), comp.raw());
+                    });
+                }
+                else
+                {
+                    sum_ukr(n0_max-n0_min, A1, stride0, sum.raw(), comp.raw());
+                }
+            }
+        });
+
+        reduce(type, comm, sum, comp);
+
+        if (comm.master())
+        {
+            sum -= comp;
+            sum.to(result);
+            idx = -1;
+        }
+
+        comm.barrier();
+        return;
+    }
+
     atomic_reducer local_result(op);
 
     auto reduce_ukr = reinterpret_cast<reduce_ft>(bli_cntx_get_ukr_dt((num_t)type, REDUCE_KER, cntx));
@@ -52,7 +130,21 @@ void reduce(type_t type, const communicator& comm, const cntx_t* cntx, reduce_t
             micro_idx = -1;
 
             iter_A.next(A1);
-            reduce_ukr(op, n0_max-n0_min, A1, stride0, &micro_result, micro_idx);
+
+            if (half)
+            {
+                half_fiber(type_A, n0_max-n0_min, A1, stride0,
+                [&](len_type m, const float* buf, stride_type off)
+                {
+                    len_type block_idx = -1;
+                    reduce_ukr(op, m, buf, 1, &micro_result, block_idx);
+                    if (block_idx != -1) micro_idx = off + block_idx*stride0;
+                });
+            }
+            else
+            {
+                reduce_ukr(op, n0_max-n0_min, A1, stride0, &micro_result, micro_idx);
+            }
 
             if (micro_idx != -1) micro_idx += (A1-A)/ts;
             else micro_idx = old_idx;
@@ -68,5 +160,130 @@ void reduce(type_t type, const communicator& comm, const cntx_t* cntx, reduce_t
     comm.barrier();
 }
 
+void reduce_multi(type_t type_A, const communicator& comm, const cntx_t* cntx, unsigned ops,
+                  const len_vector& len_A,
+                  const char* A, const stride_vector& stride_A,
+                  char* result, len_type* idx)
+{
+    bli_init();
+
+    constexpr auto nop = TBLIS_NUM_REDUCE_OPS;
+
+    bool empty = len_A.size() == 0;
+
+    auto half = is_half(type_A);
+    auto type = value_type(type_A);
+    const len_type ts = storage_size(type_A);
+    const len_type ts_r = type_size[type];
+
+    len_type n0 = (empty ? 1 : len_A[0]);
+    len_vector len1(len_A.begin() + !empty, len_A.end());
+    len_type n1 = stl_ext::prod(len1);
+
+    stride_type stride0 = (empty ? 1 : stride_A[0]);
+    len_vector stride1;
+    for (auto i : range(1,len_A.size())) stride1.push_back(stride_A[i]*ts);
+
+    std::vector<char> local_result(nop*ts_r);
+    len_type local_idx[nop];
+    reduce_init(type, local_result.data(), local_idx);
+
+    auto reduce_ukr = reinterpret_cast<reduce_multi_ft>(bli_cntx_get_ukr_dt((num_t)type, REDUCE_MULTI_KER, cntx));
+
+    comm.distribute_over_threads(n0, n1,
+    [&](len_type n0_min, len_type n0_max, len_type n1_min, len_type n1_max)
+    {
+        auto A1 = A;
+
+        viterator<1> iter_A(len1, stride1);
+        iter_A.position(n1_min, A1);
+
+        A1 += n0_min*stride0*ts;
+
+        len_type old_idx[nop];
+
+        for (len_type i = n1_min;i < n1_max;i++)
+        {
+            std::copy_n(local_idx, nop, old_idx);
+            std::fill_n(local_idx, nop, -1);
+
+            iter_A.next(A1);
+
+            if (half)
+            {
+                half_fiber(type_A, n0_max-n0_min, A1, stride0,
+                [&](len_type m, const float* buf, stride_type off)
+                {
+                    len_type block_idx[nop];
+                    std::fill_n(block_idx, nop, -1);
+                    reduce_ukr(ops, m, buf, 1, local_result.data(), block_idx);
+                    for (auto op : range(nop))
+                        if (block_idx[op] != -1) local_idx[op] = off + block_idx[op]*stride0;
+                });
+            }
+            else
+            {
+                reduce_ukr(ops, n0_max-n0_min, A1, stride0, local_result.data(), local_idx);
+            }
+
+            for (auto op : range(nop))
+            {
+                if (local_idx[op] != -1) local_idx[op] += (A1-A)/ts;
+                else local_idx[op] = old_idx[op];
+            }
+        }
+    });
+
+    /*
+     * All of the partial results are combined at once. The sums of squares
+     * are added before the square root is taken.
+     */
+    std::vector<char> thread_results;
+    std::vector<len_type> thread_idx;
+    if (comm.master())
+    {
+        thread_results.resize(comm.num_threads()*nop*ts_r);
+        thread_idx.resize(comm.num_threads()*nop);
+    }
+
+    comm.broadcast(
+    [&](std::vector<char>& thread_results, std::vector<len_type>& thread_idx)
+    {
+        std::copy_n(local_result.data(), nop*ts_r, thread_results.data() + comm.thread_num()*nop*ts_r);
+        std::copy_n(local_idx, nop, thread_idx.data() + comm.thread_num()*nop);
+    },
+    thread_results, thread_idx);
+
+    if (comm.master())
+    {
+        auto sum_ops = ops & ~(1u << REDUCE_NORM_2);
+
+        for (unsigned t = 1;t < comm.num_threads();t++)
+        {
+            auto result_t = thread_results.data() + t*nop*ts_r;
+            auto idx_t = thread_idx.data() + t*nop;
+
+            reduce(type, sum_ops, result_t, idx_t, thread_results.data(), thread_idx.data());
+
+            if ((ops >> REDUCE_NORM_2) & 1)
+                reduce(type, REDUCE_SUM, result_t + REDUCE_NORM_2*ts_r, idx_t[REDUCE_NORM_2],
+                       thread_results.data() + REDUCE_NORM_2*ts_r, thread_idx[REDUCE_NORM_2]);
+        }
+
+        for (auto op : range(nop))
+        {
+            if (!((ops >> op) & 1)) continue;
+
+            scalar value(0, type);
+            value.from(thread_results.data() + op*ts_r);
+            if (op == REDUCE_NORM_2) value.sqrt();
+            value.to(result + op*ts_r);
+            idx[op] = thread_idx[op];
+        }
+    }
+
+    comm.barrier();
+}
+
 }
 }
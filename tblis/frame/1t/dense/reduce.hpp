@@ -9,11 +9,23 @@ namespace tblis
 namespace internal
 {
 
+/*
+ * A may be of a half precision type, in which case the result is a float.
+ */
 void reduce(type_t type, const communicator& comm, const cntx_t* cntx, reduce_t op,
             const len_vector& len_A,
             const char* A, const stride_vector& stride_A,
             char* result, len_type& idx);
 
+/*
+ * Compute every reduction whose bit is set in ops in a single pass. result
+ * holds TBLIS_NUM_REDUCE_OPS values and idx as many indices, one per op.
+ */
+void reduce_multi(type_t type, const communicator& comm, const cntx_t* cntx, unsigned ops,
+                  const len_vector& len_A,
+                  const char* A, const stride_vector& stride_A,
+                  char* result, len_type* idx);
+
 }
 }
 
@@ -1,6 +1,7 @@
 #include "set.hpp"
 
 #include "tblis/frame/base/tensor.hpp"
+#include "tblis/frame/base/streaming.hpp"
 
 #include "tblis/plugin/bli_plugin_tblis.h"
 
@@ -34,6 +35,12 @@ void set(type_t type, const communicator& comm, const cntx_t* cntx,
 
     auto set_ukr = reinterpret_cast<setv_ker_ft>(bli_cntx_get_ukr_dt((num_t)type, BLIS_SETV_KER, cntx));
 
+    /*
+     * Large tensors are written with streaming stores, which avoid reading
+     * each cache line in before overwriting it.
+     */
+    auto stream = stride0 == 1 && use_streaming(n0*n1*ts);
+
     comm.distribute_over_threads(n0, n1,
     [&](len_type n0_min, len_type n0_max, len_type n1_min, len_type n1_max)
     {
@@ -46,8 +53,13 @@ void set(type_t type, const communicator& comm, const cntx_t* cntx,
         for (len_type i = n1_min;i < n1_max;i++)
         {
             iter_A.next(A1);
-            set_ukr(BLIS_NO_CONJUGATE, n0_max-n0_min, &alpha, A1, stride0, cntx);
+            if (stream)
+                stream_set(ts, n0_max-n0_min, alpha, A1);
+            else
+                set_ukr(BLIS_NO_CONJUGATE, n0_max-n0_min, &alpha, A1, stride0, cntx);
         }
+
+        if (stream) stream_fence();
     });
 
     comm.barrier();
@@ -1,6 +1,7 @@
 #include "shift.hpp"
 
 #include "tblis/frame/base/tensor.hpp"
+#include "tblis/frame/base/streaming.hpp"
 
 #include "tblis/plugin/bli_plugin_tblis.h"
 
@@ -30,6 +31,12 @@ void shift(type_t type, const communicator& comm, const cntx_t* cntx,
 
     auto shift_ukr = reinterpret_cast<shift_ft>(bli_cntx_get_ukr_dt((num_t)type, SHIFT_KER, cntx));
 
+    /*
+     * With beta == 0 the old values are not needed, so large tensors are
+     * written with streaming stores.
+     */
+    auto stream = beta.is_zero() && stride0 == 1 && use_streaming(n0*n1*ts);
+
     comm.distribute_over_threads(n0, n1,
     [&](len_type n0_min, len_type n0_max, len_type n1_min, len_type n1_max)
     {
@@ -42,8 +49,13 @@ void shift(type_t type, const communicator& comm, const cntx_t* cntx,
         for (len_type i = n1_min;i < n1_max;i++)
         {
             iter_A.next(A1);
-            shift_ukr(n0_max-n0_min, &alpha, &beta, conj_A, A1, stride0);
+            if (stream)
+                stream_set(ts, n0_max-n0_min, alpha, A1);
+            else
+                shift_ukr(n0_max-n0_min, &alpha, &beta, conj_A, A1, stride0);
         }
+
+        if (stream) stream_fence();
     });
 
     comm.barrier();
@@ -3,7 +3,9 @@
 #include "tblis/plugin/bli_plugin_tblis.h"
 
 #include "tblis/frame/base/tensor.hpp"
+#include "tblis/frame/base/stats.hpp"
 
+#include "tblis/frame/1t/dense/convert.hpp"
 #include "tblis/frame/1t/dense/dot.hpp"
 #include "tblis/frame/1t/dpd/dot.hpp"
 #include "tblis/frame/1t/indexed/dot.hpp"
@@ -22,7 +24,9 @@ void tblis_tensor_dot(const tblis_comm* comm,
                       tblis_scalar* result)
 {
     internal::initialize_once();
+    internal::stats_scope stats(comm);
 
+    TBLIS_ASSERT(!internal::is_half(A->type), "Half precision tensors are not supported by this operation");
     TBLIS_ASSERT(A->type == B->type);
     TBLIS_ASSERT(A->type == result->type);
 
@@ -81,6 +85,7 @@ void dot(const communicator& comm,
          dpd_marray_view<const T> B, const label_vector& idx_B, T& result)
 {
     internal::initialize_once();
+    internal::stats_scope stats(comm);
 
     auto nirrep = A.num_irreps();
     TBLIS_ASSERT(B.num_irreps() == nirrep);
@@ -135,6 +140,7 @@ void dot(const communicator& comm,
          indexed_marray_view<const T> B, const label_vector& idx_B, T& result)
 {
     internal::initialize_once();
+    internal::stats_scope stats(comm);
 
     auto ndim_A = A.dimension();
     auto ndim_B = B.dimension();
@@ -185,6 +191,7 @@ void dot(const communicator& comm,
          indexed_dpd_marray_view<const T> B, const label_vector& idx_B, T& result)
 {
     internal::initialize_once();
+    internal::stats_scope stats(comm);
 
     auto nirrep = A.num_irreps();
     TBLIS_ASSERT(B.num_irreps() == nirrep);
@@ -4,6 +4,13 @@
 #include "tblis/frame/1t/dense/scale.hpp"
 #include "tblis/frame/1t/dense/set.hpp"
 
+#include "tblis/frame/base/tensor.hpp"
+
+#include "tblis/plugin/bli_plugin_tblis.h"
+
+#include <algorithm>
+#include <vector>
+
 namespace tblis
 {
 namespace internal
@@ -18,22 +25,95 @@ void add_full(type_t type, const communicator& comm, const cntx_t* cntx,
               const dim_vector& idx_B_B,
               const dim_vector& idx_B_AB)
 {
-    auto [A2, len_A2, stride_A2] = block_to_full(type, comm, cntx, A);
-    auto [B2, len_B2, stride_B2] = block_to_full(type, comm, cntx, B);
+    scalar one(1.0, type);
+
+    auto ts = type_size[type];
+    auto nirrep = A.num_irreps();
+
+    /*
+     * Number the distinct indices of the problem (A only, then B only, then
+     * AB), and record the per-irrep length of each and the index of each
+     * dimension of A and B.
+     */
+    std::vector<len_vector> len;
+    dim_vector idx_A(A.dimension()), idx_B(B.dimension());
+
+    auto add_index = [&](const dpd_marray_view<char>& T, int dim)
+    {
+        len_vector len_i(nirrep);
+        for (auto irrep : range(nirrep))
+            len_i[irrep] = T.length(dim, irrep);
+        len.push_back(len_i);
+        return len.size()-1;
+    };
+
+    for (auto i : idx_A_A)
+        idx_A[i] = add_index(A, i);
+    auto nidx_A = len.size();
+    for (auto i : idx_B_B)
+        idx_B[i] = add_index(B, i);
+    for (auto i : range(idx_A_AB.size()))
+        idx_A[idx_A_AB[i]] = idx_B[idx_B_AB[i]] = add_index(A, idx_A_AB[i]);
+
+    auto ranges = dpd_tile(type, len, {idx_A, idx_B});
+
+    char *A2, *B2;
+    if (comm.master())
+    {
+        A2 = new char[dpd_tile_size(ranges, idx_A)*ts];
+        B2 = new char[dpd_tile_size(ranges, idx_B)*ts];
+    }
+    comm.broadcast_value(A2);
+    comm.broadcast_value(B2);
+
+    /*
+     * Each tile of B is materialized once, and then all tiles of A along the
+     * A-only (traced) indices are summed into it.
+     */
+    len_vector pos(len.size());
+
+    for_each_dpd_tile(ranges, range(nidx_A, len.size()), pos,
+    [&]
+    {
+        len_vector off_B2, len_B2;
+        stride_vector stride_B2;
+        std::tie(off_B2, len_B2, stride_B2) = dpd_tile_extent(ranges, idx_B, pos);
+
+        if (!block_to_tile(type, comm, cntx, B, off_B2, len_B2, B2, stride_B2))
+            return;
+
+        auto first = true;
+
+        for_each_dpd_tile(ranges, range(nidx_A), pos,
+        [&]
+        {
+            auto [off_A2, len_A2, stride_A2] = dpd_tile_extent(ranges, idx_A, pos);
+
+            if (!block_to_tile(type, comm, cntx, A, off_A2, len_A2, A2, stride_A2))
+                return;
+
+            auto len_A = stl_ext::select_from(len_A2, idx_A_A);
+            auto len_B = stl_ext::select_from(len_B2, idx_B_B);
+            auto len_AB = stl_ext::select_from(len_A2, idx_A_AB);
+            auto stride_A_A = stl_ext::select_from(stride_A2, idx_A_A);
+            auto stride_B_B = stl_ext::select_from(stride_B2, idx_B_B);
+            auto stride_A_AB = stl_ext::select_from(stride_A2, idx_A_AB);
+            auto stride_B_AB = stl_ext::select_from(stride_B2, idx_B_AB);
 
-    auto len_A = stl_ext::select_from(len_A2, idx_A_A);
-    auto len_B = stl_ext::select_from(len_B2, idx_B_B);
-    auto len_AB = stl_ext::select_from(len_A2, idx_A_AB);
-    auto stride_A_A = stl_ext::select_from(stride_A2, idx_A_A);
-    auto stride_B_B = stl_ext::select_from(stride_B2, idx_B_B);
-    auto stride_A_AB = stl_ext::select_from(stride_A2, idx_A_AB);
-    auto stride_B_AB = stl_ext::select_from(stride_B2, idx_B_AB);
+            add(type, comm, cntx, len_A, len_B, len_AB,
+                alpha, conj_A, A2, stride_A_A, stride_A_AB,
+                first ? beta : one, first && conj_B, B2, stride_B_B, stride_B_AB);
 
-    add(type, comm, cntx, len_A, len_B, len_AB,
-        alpha, conj_A, A2, stride_A_A, stride_A_AB,
-         beta, conj_B, B2, stride_B_B, stride_B_AB);
+            first = false;
+        });
 
-    full_to_block(type, comm, cntx, B2, len_B2, stride_B2, B);
+        if (first)
+            scale(type, comm, cntx, len_B2, beta, conj_B, B2, stride_B2);
+
+        tile_to_block(type, comm, cntx, B2, off_B2, len_B2, stride_B2, B);
+    });
+
+    comm.barrier();
 
     if (comm.master())
     {
@@ -60,19 +140,17 @@ void trace_block(type_t type, const communicator& comm, const cntx_t* cntx,
     const int ndim_A_only = idx_A.size();
     const int ndim_AB = idx_A_AB.size();
 
-    stride_type nblock_A = ipow(nirrep, ndim_A_only-1);
-    stride_type nblock_AB = ipow(nirrep, ndim_AB-1);
+    auto blocks_A = dpd_nonempty_blocks(A, idx_A, irrep_A);
+    auto blocks_AB = dpd_nonempty_blocks(B, idx_B_AB, irrep_AB);
 
     irrep_vector irreps_A(ndim_A);
     irrep_vector irreps_B(ndim_B);
 
-    for (stride_type block_AB = 0;block_AB < nblock_AB;block_AB++)
+    for (auto block_AB : *blocks_AB)
     {
         assign_irreps(ndim_AB, irrep_AB, nirrep, block_AB,
                       irreps_A, idx_A_AB, irreps_B, idx_B_AB);
 
-        if (is_block_empty(B, irreps_B)) continue;
-
         marray_view<char> local_B = B(irreps_B);
 
         auto len_AB = stl_ext::select_from(local_B.lengths(), idx_B_AB);
@@ -81,12 +159,10 @@ void trace_block(type_t type, const communicator& comm, const cntx_t* cntx,
         auto local_beta = beta;
         auto local_conj_B = conj_B;
 
-        for (stride_type block_A = 0;block_A < nblock_A;block_A++)
+        for (auto block_A : *blocks_A)
         {
             assign_irreps(ndim_A_only, irrep_A, nirrep, block_A,
-                  irreps_A, idx_A);
-
-            if (is_block_empty(A, irreps_A)) continue;
+                          irreps_A, idx_A);
 
             marray_view<char> local_A = A(irreps_A);
 
@@ -133,31 +209,27 @@ void replicate_block(type_t type, const communicator& comm, const cntx_t* cntx,
     const int ndim_B_only = idx_B.size();
     const int ndim_AB = idx_A_AB.size();
 
-    stride_type nblock_B = ipow(nirrep, ndim_B_only-1);
-    stride_type nblock_AB = ipow(nirrep, ndim_AB-1);
+    auto blocks_B = dpd_nonempty_blocks(B, idx_B, irrep_B);
+    auto blocks_AB = dpd_nonempty_blocks(A, idx_A_AB, irrep_AB);
 
     irrep_vector irreps_A(ndim_A);
     irrep_vector irreps_B(ndim_B);
 
-    for (stride_type block_AB = 0;block_AB < nblock_AB;block_AB++)
+    for (auto block_AB : *blocks_AB)
     {
         assign_irreps(ndim_AB, irrep_AB, nirrep, block_AB,
-              irreps_A, idx_A_AB, irreps_B, idx_B_AB);
-
-        if (is_block_empty(A, irreps_A)) continue;
+                      irreps_A, idx_A_AB, irreps_B, idx_B_AB);
 
         marray_view<char> local_A = A(irreps_A);
 
         auto len_AB = stl_ext::select_from(local_A.lengths(), idx_A_AB);
         auto stride_A_AB = stl_ext::select_from(local_A.strides(), idx_A_AB);
 
-        for (stride_type block_B = 0;block_B < nblock_B;block_B++)
+        for (auto block_B : *blocks_B)
         {
             assign_irreps(ndim_B_only, irrep_B, nirrep, block_B,
                           irreps_B, idx_B);
 
-            if (is_block_empty(B, irreps_B)) continue;
-
             marray_view<char> local_B = B(irreps_B);
 
             auto len_B_only = stl_ext::select_from(local_B.lengths(), idx_B);
@@ -177,19 +249,18 @@ void replicate_block(type_t type, const communicator& comm, const cntx_t* cntx,
         if (irrep_AB == A.irrep()) continue;
 
         const auto irrep_B = B.irrep()^irrep_AB;
+        auto blocks_B = dpd_nonempty_blocks(B, idx_B, irrep_B);
 
-        for (stride_type block_AB = 0;block_AB < nblock_AB;block_AB++)
+        for (auto block_AB : *dpd_nonempty_blocks(B, idx_B_AB, irrep_AB))
         {
             assign_irreps(ndim_AB, irrep_AB, nirrep, block_AB,
                           irreps_B, idx_B_AB);
 
-            for (stride_type block_B = 0;block_B < nblock_B;block_B++)
+            for (auto block_B : *blocks_B)
             {
                 assign_irreps(ndim_B_only, irrep_B, nirrep, block_B,
                               irreps_B, idx_B);
 
-                if (is_block_empty(B, irreps_B)) continue;
-
                 marray_view<char> local_B = B(irreps_B);
 
                 if (beta.is_zero())
@@ -207,6 +278,21 @@ void replicate_block(type_t type, const communicator& comm, const cntx_t* cntx,
     }
 }
 
+/*
+ * A single block-to-block copy of a DPD transpose, split into an
+ * mn1 x ceil(m/TM) x ceil(n/TN) grid of tiles.
+ */
+struct block_transpose
+{
+    const char* A;
+    char* B;
+    len_type m, n, mt, nt;
+    stride_type rs_A, cs_A, rs_B, cs_B;
+    len_vector len1;
+    stride_vector stride_A1, stride_B1;
+    bool unit;
+};
+
 static
 void transpose_block(type_t type, const communicator& comm, const cntx_t* cntx,
                      const scalar& alpha, bool conj_A, const dpd_marray_view<char>& A,
@@ -214,37 +300,160 @@ void transpose_block(type_t type, const communicator& comm, const cntx_t* cntx,
                      const scalar&  beta, bool conj_B, const dpd_marray_view<char>& B,
                      const dim_vector& idx_B_AB)
 {
+    bli_init();
+
     const len_type ts = type_size[type];
 
+    const len_type MR = bli_cntx_get_blksz_def_dt((num_t)type, (bszid_t)MRT_BSZ, cntx);
+    const len_type NR = bli_cntx_get_blksz_def_dt((num_t)type, (bszid_t)NRT_BSZ, cntx);
+    const len_type TM = MR*ceil_div(32, MR);
+    const len_type TN = NR*ceil_div(32, NR);
+
     const auto nirrep = A.num_irreps();
     const auto irrep_AB = A.irrep();
     const auto ndim_A = A.dimension();
     const auto ndim_B = B.dimension();
     const int ndim_AB = idx_A_AB.size();
 
-    stride_type nblock_AB = ipow(nirrep, ndim_AB-1);
-
     irrep_vector irreps_A(ndim_A);
     irrep_vector irreps_B(ndim_B);
 
-    for (stride_type block_AB = 0;block_AB < nblock_AB;block_AB++)
+    /*
+     * Enumerate all of the block copies up front, so that the tiles of all
+     * blocks can be distributed over the threads at once.
+     */
+    std::vector<block_transpose> blocks;
+    std::vector<stride_type> item_off{0};
+
+    for (auto block_AB : *dpd_nonempty_blocks(A, idx_A_AB, irrep_AB))
     {
         assign_irreps(ndim_AB, irrep_AB, nirrep, block_AB,
                       irreps_A, idx_A_AB, irreps_B, idx_B_AB);
 
-        if (is_block_empty(A, irreps_A)) continue;
-
         marray_view<char> local_A = A(irreps_A);
         marray_view<char> local_B = B(irreps_B);
 
-        auto len_AB = stl_ext::select_from(local_A.lengths(), idx_A_AB);
-        auto stride_A_AB = stl_ext::select_from(local_A.strides(), idx_A_AB);
-        auto stride_B_AB = stl_ext::select_from(local_B.strides(), idx_B_AB);
+        auto len_AB_ = stl_ext::select_from(local_A.lengths(), idx_A_AB);
+        auto stride_A_AB_ = stl_ext::select_from(local_A.strides(), idx_A_AB);
+        auto stride_B_AB_ = stl_ext::select_from(local_B.strides(), idx_B_AB);
+
+        if (stl_ext::prod(len_AB_) == 0) continue;
 
-        add(type, comm, cntx, {}, {}, len_AB,
-            alpha, conj_A, A.data() + (local_A.data()-A.data())*ts, {}, stride_A_AB,
-             beta, conj_B, B.data() + (local_B.data()-B.data())*ts, {}, stride_B_AB);
+        auto perm_AB = sort_by_stride(stride_B_AB_, stride_A_AB_);
+        auto len_AB = stl_ext::permuted(len_AB_, perm_AB);
+        auto stride_A_AB = stl_ext::permuted(stride_A_AB_, perm_AB);
+        auto stride_B_AB = stl_ext::permuted(stride_B_AB_, perm_AB);
+
+        if (len_AB.empty())
+        {
+            len_AB.push_back(1);
+            stride_A_AB.push_back(1);
+            stride_B_AB.push_back(1);
+        }
+
+        auto unit_A_AB = 0;
+        auto unit_B_AB = 0;
+
+        for (auto i : range(1,len_AB.size()))
+        {
+            if (len_AB[i] == 1) continue;
+            if (stride_A_AB[i] == 1 && unit_A_AB == 0) unit_A_AB = i;
+            if (stride_B_AB[i] == 1 && unit_B_AB == 0) unit_B_AB = i;
+        }
+
+        block_transpose block;
+        block.A = A.data() + (local_A.data()-A.data())*ts;
+        block.B = B.data() + (local_B.data()-B.data())*ts;
+        block.unit = unit_A_AB == unit_B_AB;
+        block.m = len_AB[unit_A_AB];
+        block.n = block.unit ? 1 : len_AB[unit_B_AB];
+        block.rs_A = stride_A_AB[unit_A_AB];
+        block.cs_A = stride_A_AB[unit_B_AB];
+        block.rs_B = stride_B_AB[unit_A_AB];
+        block.cs_B = stride_B_AB[unit_B_AB];
+
+        for (auto i : range(len_AB.size()))
+        {
+            if (i == unit_A_AB || i == unit_B_AB) continue;
+            block.len1.push_back(len_AB[i]);
+            block.stride_A1.push_back(stride_A_AB[i]*ts);
+            block.stride_B1.push_back(stride_B_AB[i]*ts);
+        }
+
+        if (!block.unit && block.rs_B > block.cs_B)
+        {
+            std::swap(block.m, block.n);
+            std::swap(block.rs_A, block.cs_A);
+            std::swap(block.rs_B, block.cs_B);
+        }
+
+        block.mt = ceil_div(block.m, block.unit ? TM*TN : TM);
+        block.nt = ceil_div(block.n, TN);
+
+        blocks.push_back(block);
+        item_off.push_back(item_off.back() + stl_ext::prod(block.len1)*block.mt*block.nt);
     }
+
+    auto trans_ukr = reinterpret_cast<trans_ft>(bli_cntx_get_ukr_dt((num_t)type, TRANS_KER, cntx));
+    auto add_ukr = reinterpret_cast<axpbyv_ker_ft>(bli_cntx_get_ukr_dt((num_t)type, BLIS_AXPBYV_KER, cntx));
+    auto scal_ukr = reinterpret_cast<scalv_ker_ft>(bli_cntx_get_ukr_dt((num_t)type, BLIS_SCALV_KER, cntx));
+    auto one = bli_obj_buffer_for_const((num_t)type, &BLIS_ONE);
+
+    comm.distribute_over_threads(item_off.back(),
+    [&](len_type item_min, len_type item_max)
+    {
+        auto b = std::upper_bound(item_off.begin(), item_off.end(), item_min) - item_off.begin() - 1;
+
+        for (auto item = item_min;item < item_max;item++)
+        {
+            while (item >= item_off[b+1]) b++;
+
+            auto& block = blocks[b];
+
+            auto local = item - item_off[b];
+            auto i = (local % block.mt)*(block.unit ? TM*TN : TM);
+            local /= block.mt;
+            auto j = (local % block.nt)*TN;
+            local /= block.nt;
+
+            auto A1 = block.A;
+            auto B1 = block.B;
+            for (auto k : range(block.len1.size()))
+            {
+                A1 += (local % block.len1[k])*block.stride_A1[k];
+                B1 += (local % block.len1[k])*block.stride_B1[k];
+                local /= block.len1[k];
+            }
+
+            if (block.unit)
+            {
+                len_type m_loc = std::min(block.m-i, TM*TN);
+
+                if (conj_B)
+                    scal_ukr(BLIS_CONJUGATE, m_loc, one, B1 + i*block.rs_B*ts, block.rs_B, cntx);
+
+                add_ukr(conj_A ? BLIS_CONJUGATE : BLIS_NO_CONJUGATE, m_loc,
+                        &alpha, A1 + i*block.rs_A*ts, block.rs_A,
+                         &beta, B1 + i*block.rs_B*ts, block.rs_B,
+                        cntx);
+            }
+            else
+            {
+                for (auto i1 = i;i1 < std::min(block.m, i+TM);i1 += MR)
+                for (auto j1 = j;j1 < std::min(block.n, j+TN);j1 += NR)
+                {
+                    len_type m_loc = std::min(block.m-i1, MR);
+                    len_type n_loc = std::min(block.n-j1, NR);
+
+                    trans_ukr(m_loc, n_loc,
+                              &alpha, conj_A, A1 + i1*block.rs_A*ts + j1*block.cs_A*ts, block.rs_A, block.cs_A,
+                               &beta, conj_B, B1 + i1*block.rs_B*ts + j1*block.cs_B*ts, block.rs_B, block.cs_B);
+                }
+            }
+        }
+    });
+
+    comm.barrier();
 }
 
 void add(type_t type, const communicator& comm, const cntx_t* cntx,
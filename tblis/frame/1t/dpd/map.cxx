@@ -0,0 +1,88 @@
+#include "util.hpp"
+#include "map.hpp"
+#include "tblis/frame/1t/dense/map.hpp"
+
+namespace tblis
+{
+namespace internal
+{
+
+/*
+ * All operands have the same irrep, so each block of the output has a
+ * matching block in each input.
+ */
+void map(type_t type, const communicator& comm, const cntx_t* cntx,
+         tblis_map_func func, void* data,
+         const scalar& alpha, bool conj_A, const dpd_marray_view<char>& A,
+         const dim_vector& idx_A_AB,
+         const scalar&  beta, bool conj_B, const dpd_marray_view<char>& B,
+         const dim_vector& idx_B_AB)
+{
+    const len_type ts = type_size[type];
+
+    const auto nirrep = B.num_irreps();
+    const auto irrep = B.irrep();
+    const auto ndim = B.dimension();
+
+    irrep_vector irreps_A(ndim);
+    irrep_vector irreps_B(ndim);
+
+    for (auto block : *dpd_nonempty_blocks(B, idx_B_AB, irrep))
+    {
+        assign_irreps(ndim, irrep, nirrep, block,
+                      irreps_A, idx_A_AB, irreps_B, idx_B_AB);
+
+        marray_view<char> local_A = A(irreps_A);
+        marray_view<char> local_B = B(irreps_B);
+
+        map(type, comm, cntx, func, data,
+            stl_ext::select_from(local_B.lengths(), idx_B_AB),
+            alpha, conj_A, A.data() + (local_A.data()-A.data())*ts,
+            stl_ext::select_from(local_A.strides(), idx_A_AB),
+             beta, conj_B, B.data() + (local_B.data()-B.data())*ts,
+            stl_ext::select_from(local_B.strides(), idx_B_AB));
+    }
+}
+
+void zip(type_t type, const communicator& comm, const cntx_t* cntx,
+         tblis_zip_func func, void* data,
+         const scalar& alpha, bool conj_A, const dpd_marray_view<char>& A,
+         const dim_vector& idx_A_ABC,
+         const scalar&  beta, bool conj_B, const dpd_marray_view<char>& B,
+         const dim_vector& idx_B_ABC,
+         const scalar& gamma, bool conj_C, const dpd_marray_view<char>& C,
+         const dim_vector& idx_C_ABC)
+{
+    const len_type ts = type_size[type];
+
+    const auto nirrep = C.num_irreps();
+    const auto irrep = C.irrep();
+    const auto ndim = C.dimension();
+
+    irrep_vector irreps_A(ndim);
+    irrep_vector irreps_B(ndim);
+    irrep_vector irreps_C(ndim);
+
+    for (auto block : *dpd_nonempty_blocks(C, idx_C_ABC, irrep))
+    {
+        assign_irreps(ndim, irrep, nirrep, block,
+                      irreps_A, idx_A_ABC, irreps_B, idx_B_ABC,
+                      irreps_C, idx_C_ABC);
+
+        marray_view<char> local_A = A(irreps_A);
+        marray_view<char> local_B = B(irreps_B);
+        marray_view<char> local_C = C(irreps_C);
+
+        zip(type, comm, cntx, func, data,
+            stl_ext::select_from(local_C.lengths(), idx_C_ABC),
+            alpha, conj_A, A.data() + (local_A.data()-A.data())*ts,
+            stl_ext::select_from(local_A.strides(), idx_A_ABC),
+             beta, conj_B, B.data() + (local_B.data()-B.data())*ts,
+            stl_ext::select_from(local_B.strides(), idx_B_ABC),
+            gamma, conj_C, C.data() + (local_C.data()-C.data())*ts,
+            stl_ext::select_from(local_C.strides(), idx_C_ABC));
+    }
+}
+
+}
+}
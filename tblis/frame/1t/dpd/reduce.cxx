@@ -22,16 +22,12 @@ void reduce(type_t type, const communicator& comm, const cntx_t* cntx, reduce_t
     len_type local_idx;
     reduce_init(op, local_result, local_idx);
 
-    stride_type nblock = ipow(nirrep, ndim-1);
-
     irrep_vector irreps(ndim);
 
-    for (stride_type block = 0;block < nblock;block++)
+    for (auto block : *dpd_nonempty_blocks(A, idx_A, irrep))
     {
         assign_irreps(ndim, irrep, nirrep, block, irreps, idx_A);
 
-        if (is_block_empty(A, irreps)) continue;
-
         marray_view<char> local_A = A(irreps);
 
         scalar block_result(0, type);
@@ -56,5 +52,59 @@ void reduce(type_t type, const communicator& comm, const cntx_t* cntx, reduce_t
     comm.barrier();
 }
 
+void reduce_multi(type_t type, const communicator& comm, const cntx_t* cntx, unsigned ops,
+                  const dpd_marray_view<char>& A, const dim_vector& idx_A,
+                  char* result, len_type* idx)
+{
+    constexpr auto nop = TBLIS_NUM_REDUCE_OPS;
+
+    const len_type ts = type_size[type];
+
+    const auto nirrep = A.num_irreps();
+    const auto irrep = A.irrep();
+    const auto ndim = A.dimension();
+
+    std::vector<char> local_result(nop*ts);
+    len_type local_idx[nop];
+    reduce_init(type, local_result.data(), local_idx);
+
+    irrep_vector irreps(ndim);
+
+    for (auto block : *dpd_nonempty_blocks(A, idx_A, irrep))
+    {
+        assign_irreps(ndim, irrep, nirrep, block, irreps, idx_A);
+
+        marray_view<char> local_A = A(irreps);
+
+        std::vector<char> block_result(nop*ts);
+        len_type block_idx[nop];
+
+        reduce_multi(type, comm, cntx, ops, local_A.lengths(),
+                     A.data() + (local_A.data()-A.data())*ts,
+                     local_A.strides(), block_result.data(), block_idx);
+
+        for (auto op : range(nop))
+            block_idx[op] += local_A.data()-A.data();
+
+        reduce(type, ops, block_result.data(), block_idx, local_result.data(), local_idx);
+    }
+
+    if (comm.master())
+    {
+        for (auto op : range(nop))
+        {
+            if (!((ops >> op) & 1)) continue;
+
+            scalar value(0, type);
+            value.from(local_result.data() + op*ts);
+            if (op == REDUCE_NORM_2) value.sqrt();
+            value.to(result + op*ts);
+            idx[op] = local_idx[op];
+        }
+    }
+
+    comm.barrier();
+}
+
 }
 }
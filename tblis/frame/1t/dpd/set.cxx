@@ -16,16 +16,12 @@ void set(type_t type, const communicator& comm, const cntx_t* cntx,
     const auto irrep = A.irrep();
     const auto ndim = A.dimension();
 
-    stride_type nblock = ipow(nirrep, ndim-1);
-
     irrep_vector irreps(ndim);
 
-    for (stride_type block = 0;block < nblock;block++)
+    for (auto block : *dpd_nonempty_blocks(A, idx_A, irrep))
     {
         assign_irreps(ndim, irrep, nirrep, block, irreps, idx_A);
 
-        if (is_block_empty(A, irreps)) continue;
-
         marray_view<char> local_A = A(irreps);
 
         set(type, comm, cntx, local_A.lengths(), alpha, A.data() + (local_A.data()-A.data())*ts, local_A.strides());
@@ -17,16 +17,12 @@ void shift(type_t type, const communicator& comm, const cntx_t* cntx,
     const auto irrep = A.irrep();
     const auto ndim = A.dimension();
 
-    stride_type nblock = ipow(nirrep, ndim-1);
-
     irrep_vector irreps(ndim);
 
-    for (stride_type block = 0;block < nblock;block++)
+    for (auto block : *dpd_nonempty_blocks(A, idx_A, irrep))
     {
         assign_irreps(ndim, irrep, nirrep, block, irreps, idx_A);
 
-        if (is_block_empty(A, irreps)) continue;
-
         marray_view<char> local_A = A(irreps);
 
         shift(type, comm, cntx, local_A.lengths(), alpha, beta, conj_A,
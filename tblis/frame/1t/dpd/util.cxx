@@ -0,0 +1,164 @@
+#include "util.hpp"
+
+#include "tblis/frame/base/env.hpp"
+
+#include <cmath>
+#include <map>
+#include <mutex>
+
+namespace tblis
+{
+namespace internal
+{
+
+len_type dpd_layout_cache_size = envtol("TBLIS_DPD_LAYOUT_CACHE", 4096);
+
+double block_screening_tol = envtod("TBLIS_BLOCK_SCREENING_TOL", 0.0);
+
+std::shared_ptr<const std::vector<stride_type>>
+dpd_nonempty_blocks(const dpd_marray_view<char>& A, const dim_vector& idx, int irrep)
+{
+    const auto nirrep = A.num_irreps();
+    const int ndim = idx.size();
+
+    std::vector<len_type> key{nirrep, irrep, ndim};
+    for (auto i : idx)
+    for (auto j : range(nirrep))
+        key.push_back(A.length(i, j));
+
+    using entry = std::shared_ptr<const std::vector<stride_type>>;
+    static std::mutex lock;
+    static std::map<std::vector<len_type>,entry> cache;
+
+    if (dpd_layout_cache_size > 0)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        auto it = cache.find(key);
+        if (it != cache.end()) return it->second;
+    }
+
+    auto blocks = std::make_shared<std::vector<stride_type>>();
+
+    if (ndim == 0)
+    {
+        if (irrep == 0) blocks->push_back(0);
+    }
+    else
+    {
+        dim_vector dims = range(ndim);
+        irrep_vector irreps(ndim);
+        stride_type nblock = ipow(nirrep, ndim-1);
+
+        for (stride_type block = 0;block < nblock;block++)
+        {
+            assign_irreps(ndim, irrep, nirrep, block, irreps, dims);
+
+            auto empty = false;
+            for (auto i : range(ndim))
+                if (!A.length(idx[i], irreps[i])) empty = true;
+
+            if (!empty) blocks->push_back(block);
+        }
+    }
+
+    if (dpd_layout_cache_size > 0)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if ((len_type)cache.size() >= dpd_layout_cache_size) cache.clear();
+        cache.emplace(std::move(key), blocks);
+    }
+
+    return blocks;
+}
+
+template <typename T>
+static double block_norm(const len_vector& len, const T* A, const stride_vector& stride)
+{
+    double sum = 0;
+
+    viterator<1> it(len, stride);
+    while (it.next(A)) sum += std::norm(*A);
+
+    return std::sqrt(sum);
+}
+
+double block_norm(type_t type, const len_vector& len,
+                  const char* A, const stride_vector& stride)
+{
+    switch (type)
+    {
+        case TYPE_FLOAT:    return block_norm(len, reinterpret_cast<const    float*>(A), stride);
+        case TYPE_DOUBLE:   return block_norm(len, reinterpret_cast<const   double*>(A), stride);
+        case TYPE_SCOMPLEX: return block_norm(len, reinterpret_cast<const scomplex*>(A), stride);
+        case TYPE_DCOMPLEX: return block_norm(len, reinterpret_cast<const dcomplex*>(A), stride);
+    }
+
+    return 0;
+}
+
+std::vector<double> dpd_block_norms(type_t type, const communicator& comm,
+                                    const dpd_marray_view<char>& A)
+{
+    const len_type ts = type_size[type];
+    const auto nirrep = A.num_irreps();
+    const int ndim = A.dimension();
+
+    stride_type nblock = ndim ? ipow(nirrep, ndim-1) : 1;
+
+    double* norms;
+    if (comm.master()) norms = new double[nblock]();
+    comm.broadcast_value(norms);
+
+    comm.distribute_over_threads(nblock,
+    [&](len_type block_min, len_type block_max)
+    {
+        dim_vector dims = range(ndim);
+        irrep_vector irreps(ndim);
+
+        for (auto block : range(block_min, block_max))
+        {
+            assign_irreps(ndim, A.irrep(), nirrep, block, irreps, dims);
+
+            if (is_block_empty(A, irreps)) continue;
+
+            auto local_A = A(irreps);
+            norms[block] = block_norm(type, local_A.lengths(),
+                                      A.data() + (local_A.data()-A.data())*ts,
+                                      local_A.strides());
+        }
+    });
+
+    comm.barrier();
+
+    std::vector<double> result(norms, norms+nblock);
+
+    comm.barrier();
+
+    if (comm.master()) delete[] norms;
+
+    return result;
+}
+
+double block_norm_cache::operator()(const char* A, const len_vector& len, const stride_vector& stride)
+{
+    if (stl_ext::prod(len) == 0) return 0;
+
+    std::vector<stride_type> shape(len.begin(), len.end());
+    shape.insert(shape.end(), stride.begin(), stride.end());
+    auto key = std::make_pair(A, std::move(shape));
+
+    {
+        std::lock_guard<std::mutex> guard(lock_);
+        auto it = norms_.find(key);
+        if (it != norms_.end()) return it->second;
+    }
+
+    auto norm = block_norm(type_, len, A, stride);
+
+    std::lock_guard<std::mutex> guard(lock_);
+    norms_.emplace(std::move(key), norm);
+    return norm;
+}
+
+}
+}
@@ -8,6 +8,13 @@
 #include "marray/dpd/dpd_marray_view.hpp"
 
 #include "tblis/frame/1t/dense/add.hpp"
+#include "tblis/frame/1t/dense/set.hpp"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
 
 namespace tblis
 {
@@ -26,6 +33,12 @@ namespace internal
 enum dpd_impl_t {BLIS, BLOCKED, FULL};
 extern dpd_impl_t dpd_impl;
 
+/*
+ * Upper bound (in bytes) on the dense tiles which are materialized at once
+ * when dpd_impl == FULL.
+ */
+extern len_type dpd_full_memory_limit;
+
 inline
 auto block_to_full(type_t type, const communicator& comm, const cntx_t* cntx,
                    const dpd_marray_view<char>& A)
@@ -106,6 +119,243 @@ void full_to_block(type_t type, const communicator& comm, const cntx_t* cntx,
     });
 }
 
+/*
+ * For each problem index, a list of (offset, length) ranges of the dense
+ * (irrep-concatenated) index.
+ */
+using dpd_tile_ranges = std::vector<std::vector<std::pair<len_type,len_type>>>;
+
+/*
+ * Split the dense ranges of the problem indices (whose per-irrep lengths are
+ * given by len) into tiles such that one tile of each tensor together
+ * occupies at most dpd_full_memory_limit bytes. idx[k][i] is the problem
+ * index of dimension i of tensor k. Indices are split first at irrep
+ * boundaries, and then in halves, longest first.
+ */
+inline
+dpd_tile_ranges dpd_tile(type_t type, const std::vector<len_vector>& len,
+                         const std::vector<dim_vector>& idx)
+{
+    auto ts = type_size[type];
+    auto nidx = len.size();
+
+    dpd_tile_ranges ranges(nidx);
+    len_vector max_len(nidx);
+    std::vector<bool> irrep_split(nidx);
+
+    for (auto i : range(nidx))
+    {
+        for (auto l : len[i]) max_len[i] += l;
+        ranges[i].emplace_back(0, max_len[i]);
+    }
+
+    auto tile_bytes = [&]
+    {
+        stride_type bytes = 0;
+        for (auto& idx_k : idx)
+        {
+            stride_type size = ts;
+            for (auto i : idx_k) size *= max_len[i];
+            bytes += size;
+        }
+        return bytes;
+    };
+
+    while (dpd_full_memory_limit > 0 && tile_bytes() > dpd_full_memory_limit)
+    {
+        auto i = std::max_element(max_len.begin(), max_len.end()) - max_len.begin();
+        if (max_len[i] <= 1) break;
+
+        std::vector<std::pair<len_type,len_type>> new_ranges;
+
+        if (!irrep_split[i])
+        {
+            irrep_split[i] = true;
+
+            len_type off = 0;
+            for (auto l : len[i])
+            {
+                if (l) new_ranges.emplace_back(off, l);
+                off += l;
+            }
+        }
+        else
+        {
+            auto tile = (max_len[i]+1)/2;
+
+            for (auto& r : ranges[i])
+            for (len_type off = 0;off < r.second;off += tile)
+                new_ranges.emplace_back(r.first+off, std::min(tile, r.second-off));
+        }
+
+        ranges[i] = std::move(new_ranges);
+
+        max_len[i] = 0;
+        for (auto& r : ranges[i])
+            max_len[i] = std::max(max_len[i], r.second);
+    }
+
+    return ranges;
+}
+
+/*
+ * The maximum number of elements in a tile of a tensor with the given
+ * problem indices.
+ */
+inline
+stride_type dpd_tile_size(const dpd_tile_ranges& ranges, const dim_vector& idx)
+{
+    stride_type size = 1;
+    for (auto i : idx)
+    {
+        len_type max_len = 0;
+        for (auto& r : ranges[i])
+            max_len = std::max(max_len, r.second);
+        size *= max_len;
+    }
+    return size;
+}
+
+/*
+ * Call func() once for each combination of tiles of the problem indices in
+ * idx, with pos[i] set to the current tile of problem index i.
+ */
+template <typename Func>
+void for_each_dpd_tile(const dpd_tile_ranges& ranges, const dim_vector& idx,
+                       len_vector& pos, Func&& func)
+{
+    for (auto i : idx) pos[i] = 0;
+
+    while (true)
+    {
+        func();
+
+        auto j = 0;
+        for (;j < (int)idx.size();j++)
+        {
+            if (++pos[idx[j]] < (len_type)ranges[idx[j]].size()) break;
+            pos[idx[j]] = 0;
+        }
+
+        if (j == (int)idx.size()) break;
+    }
+}
+
+/*
+ * The offset and length of the current tile of a tensor with the given
+ * problem indices.
+ */
+inline
+auto dpd_tile_extent(const dpd_tile_ranges& ranges, const dim_vector& idx,
+                     const len_vector& pos)
+{
+    len_vector off(idx.size());
+    len_vector len(idx.size());
+
+    for (auto i : range(idx.size()))
+        std::tie(off[i], len[i]) = ranges[idx[i]][pos[idx[i]]];
+
+    return std::make_tuple(off, len, MArray::detail::strides(len));
+}
+
+template <typename Func>
+bool for_each_block_in_tile(type_t type, const dpd_marray_view<char>& A,
+                            const len_vector& off, const len_vector& len,
+                            const stride_vector& stride_A2, Func&& func)
+{
+    auto ts = type_size[type];
+    auto nirrep = A.num_irreps();
+    auto ndim_A = A.dimension();
+
+    matrix<len_type> off_A2{ndim_A, nirrep};
+    for (auto i : range(ndim_A))
+    {
+        len_type off_i = 0;
+        for (auto irrep : range(nirrep))
+        {
+            off_A2[i][irrep] = off_i;
+            off_i += A.length(i, irrep);
+        }
+    }
+
+    auto found = false;
+
+    A.for_each_block(
+    [&](auto&& local_A, auto&& irreps_A)
+    {
+        len_vector len_A(ndim_A);
+        auto data_A = A.data() + (local_A.data() - A.data())*ts;
+        stride_type off_A2_ = 0;
+
+        for (auto i : range(ndim_A))
+        {
+            auto lo = std::max(off[i], off_A2[i][irreps_A[i]]);
+            auto hi = std::min(off[i]+len[i], off_A2[i][irreps_A[i]] + local_A.length(i));
+            if (lo >= hi) return;
+
+            len_A[i] = hi-lo;
+            data_A += (lo-off_A2[i][irreps_A[i]])*local_A.stride(i)*ts;
+            off_A2_ += (lo-off[i])*stride_A2[i];
+        }
+
+        found = true;
+        func(len_A, data_A, local_A.strides(), off_A2_*ts);
+    });
+
+    return found;
+}
+
+/*
+ * Copy the parts of the blocks of A which overlap the given dense tile into
+ * A2, with zeros elsewhere. Returns false (and leaves A2 untouched) if no
+ * block overlaps the tile.
+ */
+inline
+bool block_to_tile(type_t type, const communicator& comm, const cntx_t* cntx,
+                   const dpd_marray_view<char>& A, const len_vector& off,
+                   const len_vector& len, char* A2, const stride_vector& stride_A2)
+{
+    scalar one(1.0, type);
+    scalar zero(0.0, type);
+
+    auto found = for_each_block_in_tile(type, A, off, len, stride_A2,
+    [&](auto&&...) {});
+
+    if (!found) return false;
+
+    set(type, comm, cntx, len, zero, A2, stride_A2);
+
+    for_each_block_in_tile(type, A, off, len, stride_A2,
+    [&](const len_vector& len_A, char* data_A, const stride_vector& stride_A, stride_type off_A2)
+    {
+        add(type, comm, cntx, {}, {}, len_A,
+             one, false,      data_A, {},  stride_A,
+            zero, false, A2 + off_A2, {}, stride_A2);
+    });
+
+    return true;
+}
+
+/*
+ * Copy a dense tile back into the overlapping parts of the blocks of A.
+ */
+inline
+void tile_to_block(type_t type, const communicator& comm, const cntx_t* cntx,
+                   const char* A2, const len_vector& off, const len_vector& len,
+                   const stride_vector& stride_A2, const dpd_marray_view<char>& A)
+{
+    scalar one(1.0, type);
+    scalar zero(0.0, type);
+
+    for_each_block_in_tile(type, A, off, len, stride_A2,
+    [&](const len_vector& len_A, char* data_A, const stride_vector& stride_A, stride_type off_A2)
+    {
+        add(type, comm, cntx, {}, {}, len_A,
+             one, false, A2 + off_A2, {}, stride_A2,
+            zero, false,      data_A, {},  stride_A);
+    });
+}
+
 template <int I, size_t N>
 void dense_total_lengths_and_strides_helper(std::array<len_vector,N>&,
                                             std::array<stride_vector,N>&) {}
@@ -191,6 +441,78 @@ void assign_irreps(int ndim, int irrep, int nirrep,
     if (ndim) assign_irrep(0, irrep0, args...);
 }
 
+/*
+ * Maximum number of shapes remembered by dpd_nonempty_blocks and
+ * dpd_params. Zero disables the cache.
+ */
+extern len_type dpd_layout_cache_size;
+
+/*
+ * The block numbers (as enumerated by assign_irreps) of the blocks of the
+ * dimensions idx of A with total irrep irrep whose lengths are all
+ * non-zero. The result only depends on the per-irrep lengths and is cached.
+ */
+std::shared_ptr<const std::vector<stride_type>>
+dpd_nonempty_blocks(const dpd_marray_view<char>& A, const dim_vector& idx, int irrep);
+
+/*
+ * The inverse of assign_irreps over all dimensions of a tensor.
+ */
+inline
+stride_type dpd_block_number(int nirrep, const irrep_vector& irreps)
+{
+    int shift = (nirrep>1) + (nirrep>2) + (nirrep>4);
+
+    stride_type block = 0;
+    for (auto i = (int)irreps.size()-1;i > 0;i--)
+        block = (block << shift) + irreps[i];
+    return block;
+}
+
+/*
+ * Block pairs for which |alpha|*||A_blk||*||B_blk|| (Frobenius norms) falls
+ * below this tolerance are skipped by the blocked DPD and indexed DPD
+ * contractions. Zero disables screening.
+ */
+extern double block_screening_tol;
+
+double block_norm(type_t type, const len_vector& len,
+                  const char* A, const stride_vector& stride);
+
+/*
+ * The norms of all blocks of A, indexed by dpd_block_number. All threads
+ * receive the same result.
+ */
+std::vector<double> dpd_block_norms(type_t type, const communicator& comm,
+                                    const dpd_marray_view<char>& A);
+
+/*
+ * Norms of dense sub-blocks, computed on first use. One cache is shared by
+ * all of the tasks of a contraction, so each sub-block is only read once.
+ * Sub-blocks are identified by their start, lengths and strides, since
+ * different sub-blocks (e.g. an empty one and its neighbour, or a block and
+ * its first sub-block) may start at the same address.
+ */
+class block_norm_cache
+{
+    protected:
+        type_t type_;
+        std::mutex lock_;
+        std::map<std::pair<const char*,std::vector<stride_type>>,double> norms_;
+
+    public:
+        block_norm_cache(type_t type) : type_(type) {}
+
+        double operator()(const char* A, const len_vector& len, const stride_vector& stride);
+};
+
+inline
+bool screen_block_pair(const scalar& factor, double norm_A, double norm_B)
+{
+    return block_screening_tol > 0 &&
+           std::abs(factor.as<dcomplex>())*norm_A*norm_B < block_screening_tol;
+}
+
 }
 }
 
@@ -60,8 +60,8 @@ void trace_block(type_t type, const communicator& comm, const cntx_t* cntx,
     index_group<2> group_AB(A, idx_A_AB, B, idx_B_AB);
     index_group<1> group_A(A, idx_A_A);
 
-    group_indices<2> indices_A(type, A, group_AB, 0, group_A, 0);
-    group_indices<1> indices_B(type, B, group_AB, 1);
+    group_indices<2> indices_A(type, comm, A, group_AB, 0, group_A, 0);
+    group_indices<1> indices_B(type, comm, B, group_AB, 1);
     auto nidx_A = indices_A.size();
     auto nidx_B = indices_B.size();
 
@@ -122,8 +122,8 @@ void replicate_block(type_t type, const communicator& comm, const cntx_t* cntx,
     index_group<2> group_AB(A, idx_A_AB, B, idx_B_AB);
     index_group<1> group_B(B, idx_B_B);
 
-    group_indices<1> indices_A(type, A, group_AB, 0);
-    group_indices<2> indices_B(type, B, group_AB, 1, group_B, 0);
+    group_indices<1> indices_A(type, comm, A, group_AB, 0);
+    group_indices<2> indices_B(type, comm, B, group_AB, 1, group_B, 0);
     auto nidx_A = indices_A.size();
     auto nidx_B = indices_B.size();
 
@@ -184,8 +184,8 @@ void transpose_block(type_t type, const communicator& comm, const cntx_t* cntx,
 
     index_group<2> group_AB(A, idx_A_AB, B, idx_B_AB);
 
-    group_indices<1> indices_A(type, A, group_AB, 0);
-    group_indices<1> indices_B(type, B, group_AB, 1);
+    group_indices<1> indices_A(type, comm, A, group_AB, 0);
+    group_indices<1> indices_B(type, comm, B, group_AB, 1);
     auto nidx_A = indices_A.size();
     auto nidx_B = indices_B.size();
 
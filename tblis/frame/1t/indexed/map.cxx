@@ -0,0 +1,171 @@
+#include "map.hpp"
+#include "tblis/frame/1t/dense/map.hpp"
+
+#include "tblis/frame/base/tensor.hpp"
+
+#include "tblis/plugin/bli_plugin_tblis.h"
+
+namespace tblis
+{
+namespace internal
+{
+
+/*
+ * Wraps a map or zip function so that each output fiber is then scaled by
+ * omega while it is still in cache, rather than in a second pass.
+ */
+template <typename Func>
+struct scaled_fiber
+{
+    Func func;
+    void* data;
+    scalar omega;
+    scalv_ker_ft scal;
+    const cntx_t* cntx;
+
+    scaled_fiber(type_t type, const cntx_t* cntx, Func func, void* data)
+    : func(func), data(data), omega(1.0, type),
+      scal(reinterpret_cast<scalv_ker_ft>(bli_cntx_get_ukr_dt((num_t)type, BLIS_SCALV_KER, cntx))),
+      cntx(cntx) {}
+
+    void scale(len_type n, void* B, stride_type inc_B)
+    {
+        if (!omega.is_one())
+            scal(BLIS_NO_CONJUGATE, n, omega.raw(), B, inc_B, cntx);
+    }
+};
+
+static void scaled_map_fiber(len_type n,
+                             const void* alpha, int conj_A, const void* A, stride_type inc_A,
+                             const void*  beta, int conj_B,       void* B, stride_type inc_B,
+                             void* data)
+{
+    auto& s = *static_cast<scaled_fiber<tblis_map_func>*>(data);
+    s.func(n, alpha, conj_A, A, inc_A, beta, conj_B, B, inc_B, s.data);
+    s.scale(n, B, inc_B);
+}
+
+static void scaled_zip_fiber(len_type n,
+                             const void* alpha, int conj_A, const void* A, stride_type inc_A,
+                             const void*  beta, int conj_B, const void* B, stride_type inc_B,
+                             const void* gamma, int conj_C,       void* C, stride_type inc_C,
+                             void* data)
+{
+    auto& s = *static_cast<scaled_fiber<tblis_zip_func>*>(data);
+    s.func(n, alpha, conj_A, A, inc_A, beta, conj_B, B, inc_B, gamma, conj_C, C, inc_C, s.data);
+    s.scale(n, C, inc_C);
+}
+
+/*
+ * The operands have the same indices in the same order, so index i of each
+ * holds the same elements. The factor of the input is applied before f and
+ * that of the output (the stored values are the results divided by it)
+ * after, by scaling each output fiber as it is produced; outputs with a
+ * zero factor are skipped.
+ */
+void map(type_t type, const communicator& comm, const cntx_t* cntx,
+         tblis_map_func func, void* data,
+         const scalar& alpha, bool conj_A, const indexed_marray_view<char>& A,
+         const dim_vector& idx_A_AB,
+         const scalar&  beta, bool conj_B, const indexed_marray_view<char>& B,
+         const dim_vector& idx_B_AB)
+{
+    const len_type ts = type_size[type];
+
+    dim_vector dense_idx_A, dense_idx_B;
+    for (auto i : range(idx_A_AB.size()))
+    {
+        if (idx_A_AB[i] >= A.dense_dimension()) continue;
+        dense_idx_A.push_back(idx_A_AB[i]);
+        dense_idx_B.push_back(idx_B_AB[i]);
+    }
+
+    auto len_AB = stl_ext::select_from(B.dense_lengths(), dense_idx_B);
+    auto stride_A_AB = stl_ext::select_from(A.dense_strides(), dense_idx_A);
+    auto stride_B_AB = stl_ext::select_from(B.dense_strides(), dense_idx_B);
+
+    scalar factor_A(0.0, type);
+    scalar factor_B(0.0, type);
+    scalar one(1.0, type);
+
+    scaled_fiber<tblis_map_func> scaled(type, cntx, func, data);
+
+    for (len_type i = 0;i < B.num_indices();i++)
+    {
+        factor_A.from(A.factors().data() + i*ts);
+        factor_B.from(B.factors().data() + i*ts);
+
+        if (factor_B.is_zero()) continue;
+
+        if (conj_A) factor_A.conj();
+
+        auto beta_fac = beta;
+        if (!factor_B.is_one() && !beta.is_zero())
+            beta_fac *= conj_B ? conj(factor_B) : factor_B;
+
+        scaled.omega = one/factor_B;
+
+        map(type, comm, cntx, scaled_map_fiber, &scaled, len_AB,
+            alpha*factor_A, conj_A, A.data(i), stride_A_AB,
+                  beta_fac, conj_B, B.data(i), stride_B_AB);
+    }
+}
+
+void zip(type_t type, const communicator& comm, const cntx_t* cntx,
+         tblis_zip_func func, void* data,
+         const scalar& alpha, bool conj_A, const indexed_marray_view<char>& A,
+         const dim_vector& idx_A_ABC,
+         const scalar&  beta, bool conj_B, const indexed_marray_view<char>& B,
+         const dim_vector& idx_B_ABC,
+         const scalar& gamma, bool conj_C, const indexed_marray_view<char>& C,
+         const dim_vector& idx_C_ABC)
+{
+    const len_type ts = type_size[type];
+
+    dim_vector dense_idx_A, dense_idx_B, dense_idx_C;
+    for (auto i : range(idx_A_ABC.size()))
+    {
+        if (idx_A_ABC[i] >= A.dense_dimension()) continue;
+        dense_idx_A.push_back(idx_A_ABC[i]);
+        dense_idx_B.push_back(idx_B_ABC[i]);
+        dense_idx_C.push_back(idx_C_ABC[i]);
+    }
+
+    auto len_ABC = stl_ext::select_from(C.dense_lengths(), dense_idx_C);
+    auto stride_A_ABC = stl_ext::select_from(A.dense_strides(), dense_idx_A);
+    auto stride_B_ABC = stl_ext::select_from(B.dense_strides(), dense_idx_B);
+    auto stride_C_ABC = stl_ext::select_from(C.dense_strides(), dense_idx_C);
+
+    scalar factor_A(0.0, type);
+    scalar factor_B(0.0, type);
+    scalar factor_C(0.0, type);
+    scalar one(1.0, type);
+
+    scaled_fiber<tblis_zip_func> scaled(type, cntx, func, data);
+
+    for (len_type i = 0;i < C.num_indices();i++)
+    {
+        factor_A.from(A.factors().data() + i*ts);
+        factor_B.from(B.factors().data() + i*ts);
+        factor_C.from(C.factors().data() + i*ts);
+
+        if (factor_C.is_zero()) continue;
+
+        if (conj_A) factor_A.conj();
+        if (conj_B) factor_B.conj();
+
+        auto gamma_fac = gamma;
+        if (!factor_C.is_one() && !gamma.is_zero())
+            gamma_fac *= conj_C ? conj(factor_C) : factor_C;
+
+        scaled.omega = one/factor_C;
+
+        zip(type, comm, cntx, scaled_zip_fiber, &scaled, len_ABC,
+            alpha*factor_A, conj_A, A.data(i), stride_A_ABC,
+             beta*factor_B, conj_B, B.data(i), stride_B_ABC,
+                 gamma_fac, conj_C, C.data(i), stride_C_ABC);
+    }
+}
+
+}
+}
@@ -0,0 +1,30 @@
+#ifndef _TBLIS_INTERNAL_1T_INDEXED_MAP_HPP_
+#define _TBLIS_INTERNAL_1T_INDEXED_MAP_HPP_
+
+#include "util.hpp"
+
+namespace tblis
+{
+namespace internal
+{
+
+void map(type_t type, const communicator& comm, const cntx_t* cntx,
+         tblis_map_func func, void* data,
+         const scalar& alpha, bool conj_A, const indexed_marray_view<char>& A,
+         const dim_vector& idx_A_AB,
+         const scalar&  beta, bool conj_B, const indexed_marray_view<char>& B,
+         const dim_vector& idx_B_AB);
+
+void zip(type_t type, const communicator& comm, const cntx_t* cntx,
+         tblis_zip_func func, void* data,
+         const scalar& alpha, bool conj_A, const indexed_marray_view<char>& A,
+         const dim_vector& idx_A_ABC,
+         const scalar&  beta, bool conj_B, const indexed_marray_view<char>& B,
+         const dim_vector& idx_B_ABC,
+         const scalar& gamma, bool conj_C, const indexed_marray_view<char>& C,
+         const dim_vector& idx_C_ABC);
+
+}
+}
+
+#endif
@@ -50,5 +50,59 @@ void reduce(type_t type, const communicator& comm, const cntx_t* cntx, reduce_t
     comm.barrier();
 }
 
+void reduce_multi(type_t type, const communicator& comm, const cntx_t* cntx, unsigned ops,
+                  const indexed_marray_view<char>& A, const dim_vector&,
+                  char* result, len_type* idx)
+{
+    constexpr auto nop = TBLIS_NUM_REDUCE_OPS;
+
+    const len_type ts = type_size[type];
+
+    std::vector<char> local_result(nop*ts);
+    len_type local_idx[nop];
+    reduce_init(type, local_result.data(), local_idx);
+
+    for (len_type i = 0;i < A.num_indices();i++)
+    {
+        std::vector<char> block_result(nop*ts);
+        len_type block_idx[nop];
+
+        reduce_multi(type, comm, cntx, ops, A.dense_lengths(), A.data(i),
+                     A.dense_strides(), block_result.data(), block_idx);
+
+        for (auto op : range(nop))
+        {
+            auto value = block_result.data() + op*ts;
+            block_idx[op] += (A.data(i)-A.data(0))/ts;
+
+            switch (type)
+            {
+                case TYPE_FLOAT:    *reinterpret_cast<   float*>(value) *= reinterpret_cast<const indexed_marray_view<   float>&>(A).factor(i); break;
+                case TYPE_DOUBLE:   *reinterpret_cast<  double*>(value) *= reinterpret_cast<const indexed_marray_view<  double>&>(A).factor(i); break;
+                case TYPE_SCOMPLEX: *reinterpret_cast<scomplex*>(value) *= reinterpret_cast<const indexed_marray_view<scomplex>&>(A).factor(i); break;
+                case TYPE_DCOMPLEX: *reinterpret_cast<dcomplex*>(value) *= reinterpret_cast<const indexed_marray_view<dcomplex>&>(A).factor(i); break;
+            }
+        }
+
+        reduce(type, ops, block_result.data(), block_idx, local_result.data(), local_idx);
+    }
+
+    if (comm.master())
+    {
+        for (auto op : range(nop))
+        {
+            if (!((ops >> op) & 1)) continue;
+
+            scalar value(0, type);
+            value.from(local_result.data() + op*ts);
+            if (op == REDUCE_NORM_2) value.sqrt();
+            value.to(result + op*ts);
+            idx[op] = local_idx[op];
+        }
+    }
+
+    comm.barrier();
+}
+
 }
 }
@@ -12,6 +12,10 @@ void reduce(type_t type, const communicator& comm, const cntx_t* cntx, reduce_t
             const indexed_marray_view<char>& A, const dim_vector&,
             char* result, len_type& idx);
 
+void reduce_multi(type_t type, const communicator& comm, const cntx_t* cntx, unsigned ops,
+                  const indexed_marray_view<char>& A, const dim_vector& idx_A,
+                  char* result, len_type* idx);
+
 }
 }
 
@@ -0,0 +1,39 @@
+#include "util.hpp"
+
+#include "tblis/frame/base/env.hpp"
+
+#include <map>
+#include <mutex>
+
+namespace tblis
+{
+namespace internal
+{
+
+len_type group_indices_cache_size = envtol("TBLIS_GROUP_INDICES_CACHE", 0);
+
+len_type gallop_match_ratio = envtol("TBLIS_GALLOP_MATCH_RATIO", 16);
+
+static std::mutex group_indices_lock;
+static std::map<std::vector<stride_type>,
+                std::shared_ptr<const std::vector<stride_type>>> group_indices_cache;
+
+std::shared_ptr<const std::vector<stride_type>>
+find_group_indices_order(const std::vector<stride_type>& key)
+{
+    std::lock_guard<std::mutex> guard(group_indices_lock);
+    auto it = group_indices_cache.find(key);
+    return it == group_indices_cache.end() ? nullptr : it->second;
+}
+
+void save_group_indices_order(std::vector<stride_type> key,
+                              std::shared_ptr<const std::vector<stride_type>> order)
+{
+    std::lock_guard<std::mutex> guard(group_indices_lock);
+    if ((len_type)group_indices_cache.size() >= group_indices_cache_size)
+        group_indices_cache.clear();
+    group_indices_cache[std::move(key)] = std::move(order);
+}
+
+}
+}
@@ -10,6 +10,10 @@
 #include "tblis/frame/1t/dense/add.hpp"
 #include "tblis/frame/3t/dpd/mult.hpp"
 
+#include <algorithm>
+#include <memory>
+#include <vector>
+
 namespace tblis
 {
 
@@ -325,61 +329,247 @@ struct index_set
     scalar factor{0.0};
 };
 
-template <int N>
-struct group_indices : std::vector<index_set<N>>
+/*
+ * Sort v with all threads of comm: each thread sorts a contiguous chunk and
+ * the sorted chunks are then merged pairwise. v must be shared by all threads.
+ */
+template <typename T, typename Compare=std::less<T>>
+void parallel_sort(const communicator& comm, std::vector<T>& v, Compare comp={})
 {
-    template <typename Array, typename... Args>
-    group_indices(type_t type, const Array& A, const Args&... args)
+    const size_t n = v.size();
+    const unsigned nt = comm.num_threads();
+    const unsigned tid = comm.thread_num();
+
+    auto bound = [&](unsigned t) { return v.begin() + n*std::min(t, nt)/nt; };
+
+    std::sort(bound(tid), bound(tid+1), comp);
+    comm.barrier();
+
+    for (unsigned width = 1;width < nt;width *= 2)
     {
-        const len_type ts = type_size[type];
+        if (tid % (2*width) == 0 && tid+width < nt)
+            std::inplace_merge(bound(tid), bound(tid+width), bound(tid+2*width), comp);
+        comm.barrier();
+    }
+}
+
+/*
+ * Maximum number of sort orders remembered by group_indices. Zero (the
+ * default) disables the cache.
+ */
+extern len_type group_indices_cache_size;
+
+std::shared_ptr<const std::vector<stride_type>>
+find_group_indices_order(const std::vector<stride_type>& key);
+
+void save_group_indices_order(std::vector<stride_type> key,
+                              std::shared_ptr<const std::vector<stride_type>> order);
+
+inline void group_indices_key_helper(std::vector<stride_type>&) {}
+
+template <typename Group, typename... Args>
+void group_indices_key_helper(std::vector<stride_type>& key,
+                              const Group& group, int i, const Args&... args)
+{
+    key.push_back(i);
+    key.push_back(group.batch_ndim);
+    key.insert(key.end(), group.batch_len.begin(), group.batch_len.end());
+    key.insert(key.end(), group.batch_stride.begin(), group.batch_stride.end());
+
+    for (auto idx : {&group.batch_idx[i], &group.batch_pos[i], &group.mixed_pos[i]})
+    {
+        key.push_back(idx->size());
+        key.insert(key.end(), idx->begin(), idx->end());
+    }
 
-        len_vector mixed_len;
-        dim_vector mixed_off;
-        get_mixed_lengths(mixed_len, mixed_off, args...);
+    group_indices_key_helper(key, args...);
+}
 
-        this->reserve(A.num_indices()*stl_ext::prod(mixed_len));
+/*
+ * Identifies the index storage of A and the partition of its indices. A
+ * cached order is only a hint: it is checked before use, so a stale entry
+ * for reused or modified storage just causes a re-sort.
+ */
+template <typename Array, typename... Args>
+std::vector<stride_type> group_indices_key(int N, const Array& A, const Args&... args)
+{
+    std::vector<stride_type> key{N, A.dimension(), A.num_indices(),
+                                 reinterpret_cast<stride_type>(A.data(0)),
+                                 reinterpret_cast<stride_type>(&A.factor(0))};
+    group_indices_key_helper(key, args...);
+    return key;
+}
 
-        viterator<0> iter(mixed_len);
-        for (len_type i = 0;i < A.num_indices();i++)
+/*
+ * The index sets of A for the given groups, sorted by key. The sets are
+ * built and sorted by all threads of comm and shared between them. When
+ * group_indices_cache_size > 0, the sort order is remembered for the index
+ * storage and partition of A, so later calls only rebuild the sets in
+ * place and verify that they are still sorted.
+ */
+template <int N>
+class group_indices
+{
+    protected:
+        std::shared_ptr<const std::vector<index_set<N>>> sets_;
+
+    public:
+        template <typename Array, typename... Args>
+        group_indices(type_t type, const communicator& comm, const Array& A, const Args&... args)
         {
-            index_set<N> idx;
-            std::array<stride_vector,N> idx_stride;
+            const len_type ts = type_size[type];
 
-            set_batch_indices(idx.idx, idx_stride, A, i, args...);
+            len_vector mixed_len;
+            dim_vector mixed_off;
+            get_mixed_lengths(mixed_len, mixed_off, args...);
 
-            idx.offset = (A.data(i) - A.data(0))/ts;
+            const stride_type nmixed = stl_ext::prod(mixed_len);
+            const stride_type nset = A.num_indices()*nmixed;
 
-            switch (type)
+            /*
+             * Call body(p, set) for each set generated by index i of A, where
+             * p is the position of the set in unsorted order.
+             */
+            auto visit = [&](len_type i, auto&& body)
             {
-                case TYPE_FLOAT:    idx.factor.reset(reinterpret_cast<const    float*>(&A.factor(0))[i]); break;
-                case TYPE_DOUBLE:   idx.factor.reset(reinterpret_cast<const   double*>(&A.factor(0))[i]); break;
-                case TYPE_SCOMPLEX: idx.factor.reset(reinterpret_cast<const scomplex*>(&A.factor(0))[i]); break;
-                case TYPE_DCOMPLEX: idx.factor.reset(reinterpret_cast<const dcomplex*>(&A.factor(0))[i]); break;
-            }
+                index_set<N> idx;
+                std::array<stride_vector,N> idx_stride;
 
-            while (iter.next())
-            {
-                set_mixed_indices(idx.idx, idx_stride, iter, mixed_off, args...);
+                set_batch_indices(idx.idx, idx_stride, A, i, args...);
 
-                for (auto j : range(N))
+                idx.offset = (A.data(i) - A.data(0))/ts;
+
+                switch (type)
+                {
+                    case TYPE_FLOAT:    idx.factor.reset(reinterpret_cast<const    float*>(&A.factor(0))[i]); break;
+                    case TYPE_DOUBLE:   idx.factor.reset(reinterpret_cast<const   double*>(&A.factor(0))[i]); break;
+                    case TYPE_SCOMPLEX: idx.factor.reset(reinterpret_cast<const scomplex*>(&A.factor(0))[i]); break;
+                    case TYPE_DCOMPLEX: idx.factor.reset(reinterpret_cast<const dcomplex*>(&A.factor(0))[i]); break;
+                }
+
+                viterator<0> iter(mixed_len);
+                for (stride_type p = i*nmixed;iter.next();p++)
                 {
-                    idx.key[j] = 0;
-                    for (auto k : range(idx.idx[j].size()))
+                    set_mixed_indices(idx.idx, idx_stride, iter, mixed_off, args...);
+
+                    for (auto j : range(N))
                     {
-                        idx.key[j] += idx.idx[j][k]*idx_stride[j][k];
+                        idx.key[j] = 0;
+                        for (auto k : range(idx.idx[j].size()))
+                        {
+                            idx.key[j] += idx.idx[j][k]*idx_stride[j][k];
+                        }
                     }
+
+                    body(p, idx);
                 }
+            };
 
-                this->push_back(idx);
+            std::shared_ptr<std::vector<index_set<N>>> sets;
+            std::shared_ptr<const std::vector<stride_type>> order;
+            std::vector<stride_type> cache_key;
+
+            if (comm.master())
+            {
+                sets = std::make_shared<std::vector<index_set<N>>>(nset);
+
+                if (group_indices_cache_size > 0 && nset > 0)
+                {
+                    cache_key = group_indices_key(N, A, args...);
+                    order = find_group_indices_order(cache_key);
+                    if (order && (stride_type)order->size() != nset) order.reset();
+                }
             }
+
+            comm.broadcast(
+            [&](auto master_sets, auto master_order)
+            {
+                sets = master_sets;
+                order = master_order;
+            },
+            sets, order);
+
+            auto fill = [&](const std::vector<stride_type>& dest)
+            {
+                comm.distribute_over_threads(A.num_indices(),
+                [&](len_type i_min, len_type i_max)
+                {
+                    for (auto i : range(i_min, i_max))
+                        visit(i, [&](stride_type p, const index_set<N>& idx) { (*sets)[dest[p]] = idx; });
+                });
+                comm.barrier();
+            };
+
+            if (order)
+            {
+                fill(*order);
+
+                len_type unsorted = 0;
+                comm.distribute_over_threads(std::max<stride_type>(nset-1, 0),
+                [&](len_type p_min, len_type p_max)
+                {
+                    for (auto p : range(p_min, p_max))
+                        if ((*sets)[p+1].key < (*sets)[p].key) unsorted++;
+                });
+
+                tblis::reduce(comm, unsorted);
+                comm.broadcast_value(unsorted);
+
+                if (unsorted) order.reset();
+            }
+
+            if (!order)
+            {
+                using key_pos = std::pair<std::array<stride_type,N>,stride_type>;
+
+                auto keys = comm.master() ? new std::vector<key_pos>(nset) : nullptr;
+                auto dest = comm.master() ? std::make_shared<std::vector<stride_type>>(nset) : nullptr;
+                comm.broadcast(
+                [&](auto master_keys, auto master_dest)
+                {
+                    keys = master_keys;
+                    dest = master_dest;
+                },
+                keys, dest);
+
+                comm.distribute_over_threads(A.num_indices(),
+                [&](len_type i_min, len_type i_max)
+                {
+                    for (auto i : range(i_min, i_max))
+                        visit(i, [&](stride_type p, const index_set<N>& idx) { (*keys)[p] = {idx.key, p}; });
+                });
+                comm.barrier();
+
+                parallel_sort(comm, *keys);
+
+                comm.distribute_over_threads(nset,
+                [&](len_type q_min, len_type q_max)
+                {
+                    for (auto q : range(q_min, q_max))
+                        (*dest)[(*keys)[q].second] = q;
+                });
+                comm.barrier();
+
+                if (comm.master()) delete keys;
+
+                fill(*dest);
+
+                if (comm.master() && !cache_key.empty())
+                    save_group_indices_order(std::move(cache_key), dest);
+            }
+
+            sets_ = sets;
         }
 
-        stl_ext::sort(*this,
-                      [](const index_set<N>& a, const index_set<N>& b)
-                      {
-                          return a.key < b.key;
-                      });
-    }
+        const index_set<N>& operator[](size_t i) const
+        {
+            return (*sets_)[i];
+        }
+
+        size_t size() const
+        {
+            return sets_->size();
+        }
 };
 
 template <int I, int N>
@@ -474,11 +664,11 @@ template <> struct call_match_body<true, true, true>
 
 template <bool AIsRange, bool BIsRange, int NA, int NB,
           typename Body>
-void for_each_match(stride_type& idx_A, stride_type nidx_A,
-                   const group_indices<NA>& indices_A, int iA,
-                   stride_type& idx_B, stride_type nidx_B,
-                   const group_indices<NB>& indices_B, int iB,
-                   Body&& body)
+void merge_match(stride_type& idx_A, stride_type nidx_A,
+                const group_indices<NA>& indices_A, int iA,
+                stride_type& idx_B, stride_type nidx_B,
+                const group_indices<NB>& indices_B, int iB,
+                Body&& body)
 {
     while (idx_A < nidx_A && idx_B < nidx_B)
     {
@@ -517,6 +707,162 @@ void for_each_match(stride_type& idx_A, stride_type nidx_A,
     }
 }
 
+/*
+ * The end of the run of sets starting at idx with the same key[i], found by
+ * an exponential search.
+ */
+template <int N>
+stride_type match_run_end(const group_indices<N>& indices, int i,
+                          stride_type idx, stride_type nidx)
+{
+    auto key = indices[idx].key[i];
+
+    stride_type lo = idx+1;
+    stride_type step = 1;
+    while (lo+step <= nidx && indices[lo+step-1].key[i] == key)
+    {
+        lo += step;
+        step *= 2;
+    }
+
+    stride_type hi = std::min(lo+step-1, nidx);
+    while (lo < hi)
+    {
+        auto mid = lo + (hi-lo)/2;
+        if (indices[mid].key[i] == key) lo = mid+1;
+        else hi = mid;
+    }
+
+    return lo;
+}
+
+/*
+ * The first set at or after idx with key[i] not less than key, found by an
+ * exponential search.
+ */
+template <int N, typename Key>
+stride_type match_lower_bound(const group_indices<N>& indices, int i,
+                              stride_type idx, stride_type nidx, const Key& key)
+{
+    stride_type step = 1;
+    while (idx+step <= nidx && indices[idx+step-1].key[i] < key)
+    {
+        idx += step;
+        step *= 2;
+    }
+
+    stride_type hi = std::min(idx+step-1, nidx);
+    while (idx < hi)
+    {
+        auto mid = idx + (hi-idx)/2;
+        if (indices[mid].key[i] < key) idx = mid+1;
+        else hi = mid;
+    }
+
+    return idx;
+}
+
+/*
+ * Galloping searches are used by for_each_match when one side has at least
+ * this many times more sets than the other. Zero disables them.
+ */
+extern len_type gallop_match_ratio;
+
+inline bool use_gallop_match(stride_type n_A, stride_type n_B)
+{
+    return gallop_match_ratio > 0 && n_A > 0 && n_B > 0 &&
+           std::max(n_A, n_B) >= gallop_match_ratio*std::min(n_A, n_B);
+}
+
+/*
+ * Same as merge_match, but for each run of the smaller side the matching
+ * run of the larger side is found by an exponential search from the end of
+ * the previous match, so that the larger side is only visited at
+ * O(n_small*log(n_large/n_small)) positions. Each pair of matching runs is
+ * handed to merge_match so that the body sees the same calls, in the same
+ * order, as with a plain merge.
+ */
+template <bool AIsRange, bool BIsRange, int NA, int NB,
+          typename Body>
+void gallop_match(stride_type& idx_A, stride_type nidx_A,
+                  const group_indices<NA>& indices_A, int iA,
+                  stride_type& idx_B, stride_type nidx_B,
+                  const group_indices<NB>& indices_B, int iB,
+                  Body&& body)
+{
+    if (nidx_A-idx_A <= nidx_B-idx_B)
+    {
+        auto pos_B = idx_B;
+        for (auto first_A = idx_A;first_A < nidx_A && pos_B < nidx_B;)
+        {
+            auto last_A = match_run_end(indices_A, iA, first_A, nidx_A);
+            auto& key = indices_A[first_A].key[iA];
+
+            pos_B = match_lower_bound(indices_B, iB, pos_B, nidx_B, key);
+
+            if (pos_B < nidx_B && indices_B[pos_B].key[iB] == key)
+            {
+                auto last_B = match_run_end(indices_B, iB, pos_B, nidx_B);
+                idx_A = first_A;
+                idx_B = pos_B;
+                merge_match<AIsRange, BIsRange>(idx_A, last_A, indices_A, iA,
+                                                idx_B, last_B, indices_B, iB, body);
+                pos_B = last_B;
+            }
+
+            first_A = last_A;
+        }
+    }
+    else
+    {
+        auto pos_A = idx_A;
+        for (auto first_B = idx_B;first_B < nidx_B && pos_A < nidx_A;)
+        {
+            auto last_B = match_run_end(indices_B, iB, first_B, nidx_B);
+            auto& key = indices_B[first_B].key[iB];
+
+            pos_A = match_lower_bound(indices_A, iA, pos_A, nidx_A, key);
+
+            if (pos_A < nidx_A && indices_A[pos_A].key[iA] == key)
+            {
+                auto last_A = match_run_end(indices_A, iA, pos_A, nidx_A);
+                idx_A = pos_A;
+                idx_B = first_B;
+                merge_match<AIsRange, BIsRange>(idx_A, last_A, indices_A, iA,
+                                                idx_B, last_B, indices_B, iB, body);
+                pos_A = last_A;
+            }
+
+            first_B = last_B;
+        }
+    }
+
+    idx_A = nidx_A;
+    idx_B = nidx_B;
+}
+
+/*
+ * Call body for each key[iA] of indices_A[idx_A...nidx_A-1] which matches a
+ * key[iB] of indices_B[idx_B...nidx_B-1]. Both ranges must be sorted by
+ * these keys. Galloping searches are used instead of a merge when one side
+ * is much smaller than the other.
+ */
+template <bool AIsRange, bool BIsRange, int NA, int NB,
+          typename Body>
+void for_each_match(stride_type& idx_A, stride_type nidx_A,
+                   const group_indices<NA>& indices_A, int iA,
+                   stride_type& idx_B, stride_type nidx_B,
+                   const group_indices<NB>& indices_B, int iB,
+                   Body&& body)
+{
+    if (use_gallop_match(nidx_A-idx_A, nidx_B-idx_B))
+        gallop_match<AIsRange, BIsRange>(idx_A, nidx_A, indices_A, iA,
+                                         idx_B, nidx_B, indices_B, iB, body);
+    else
+        merge_match<AIsRange, BIsRange>(idx_A, nidx_A, indices_A, iA,
+                                        idx_B, nidx_B, indices_B, iB, body);
+}
+
 template <bool AIsRange, bool BIsRange, bool CIsRange,
           int NA, int NB, int NC, typename Body>
 void for_each_match(stride_type& idx_A, stride_type nidx_A,
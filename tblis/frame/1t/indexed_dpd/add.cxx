@@ -73,8 +73,8 @@ void trace_block(type_t type, const communicator& comm, const cntx_t* cntx,
     if (group_A.dense_ndim == 0 && irrep_A != 0) return;
     if (group_AB.dense_ndim == 0 && irrep_AB != 0) return;
 
-    group_indices<2> indices_A(type, A, group_AB, 0, group_A, 0);
-    group_indices<1> indices_B(type, B, group_AB, 1);
+    group_indices<2> indices_A(type, comm, A, group_AB, 0, group_A, 0);
+    group_indices<1> indices_B(type, comm, B, group_AB, 1);
     auto nidx_A = indices_A.size();
     auto nidx_B = indices_B.size();
 
@@ -193,8 +193,8 @@ void replicate_block(type_t type, const communicator& comm, const cntx_t* cntx,
     if (group_B.dense_ndim == 0 && irrep_B != 0) return;
     if (group_AB.dense_ndim == 0 && irrep_AB != 0) return;
 
-    group_indices<1> indices_A(type, A, group_AB, 0);
-    group_indices<2> indices_B(type, B, group_AB, 1, group_B, 0);
+    group_indices<1> indices_A(type, comm, A, group_AB, 0);
+    group_indices<2> indices_B(type, comm, B, group_AB, 1, group_B, 0);
     auto nidx_A = indices_A.size();
     auto nidx_B = indices_B.size();
 
@@ -303,8 +303,8 @@ void transpose_block(type_t type, const communicator& comm, const cntx_t* cntx,
 
     if (group_AB.dense_ndim == 0 && irrep_AB != 0) return;
 
-    group_indices<1> indices_A(type, A, group_AB, 0);
-    group_indices<1> indices_B(type, B, group_AB, 1);
+    group_indices<1> indices_A(type, comm, A, group_AB, 0);
+    group_indices<1> indices_B(type, comm, B, group_AB, 1);
     auto nidx_A = indices_A.size();
     auto nidx_B = indices_B.size();
 
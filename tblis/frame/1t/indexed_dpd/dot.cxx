@@ -61,8 +61,8 @@ void dot_block(type_t type, const communicator& comm, const cntx_t* cntx,
         return;
     }
 
-    group_indices<1> indices_A(type, A, group_AB, 0);
-    group_indices<1> indices_B(type, B, group_AB, 1);
+    group_indices<1> indices_A(type, comm, A, group_AB, 0);
+    group_indices<1> indices_B(type, comm, B, group_AB, 1);
     auto nidx_A = indices_A.size();
     auto nidx_B = indices_B.size();
 
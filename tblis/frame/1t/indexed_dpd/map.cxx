@@ -0,0 +1,124 @@
+#include "map.hpp"
+#include "tblis/frame/1t/dpd/map.hpp"
+#include "tblis/frame/1t/dpd/scale.hpp"
+
+#include "tblis/frame/base/tensor.hpp"
+
+namespace tblis
+{
+namespace internal
+{
+
+/*
+ * As for indexed tensors, with a DPD map or zip over the dense dimensions
+ * of each index.
+ */
+void map(type_t type, const communicator& comm, const cntx_t* cntx,
+         tblis_map_func func, void* data,
+         const scalar& alpha, bool conj_A, const indexed_dpd_marray_view<char>& A,
+         const dim_vector& idx_A_AB,
+         const scalar&  beta, bool conj_B, const indexed_dpd_marray_view<char>& B,
+         const dim_vector& idx_B_AB)
+{
+    const len_type ts = type_size[type];
+
+    dim_vector dense_idx_A, dense_idx_B;
+    for (auto i : range(idx_A_AB.size()))
+    {
+        if (idx_A_AB[i] >= A.dense_dimension()) continue;
+        dense_idx_A.push_back(idx_A_AB[i]);
+        dense_idx_B.push_back(idx_B_AB[i]);
+    }
+
+    auto local_A = A[0];
+    auto local_B = B[0];
+
+    scalar factor_A(0.0, type);
+    scalar factor_B(0.0, type);
+    scalar one(1.0, type);
+
+    for (len_type i = 0;i < B.num_indices();i++)
+    {
+        factor_A.from(A.factors().data() + i*ts);
+        factor_B.from(B.factors().data() + i*ts);
+
+        if (factor_B.is_zero()) continue;
+
+        if (conj_A) factor_A.conj();
+
+        auto beta_fac = beta;
+        if (!factor_B.is_one() && !beta.is_zero())
+            beta_fac *= conj_B ? conj(factor_B) : factor_B;
+
+        local_A.data(A.data(i));
+        local_B.data(B.data(i));
+
+        map(type, comm, cntx, func, data,
+            alpha*factor_A, conj_A, local_A, dense_idx_A,
+                  beta_fac, conj_B, local_B, dense_idx_B);
+
+        if (!factor_B.is_one())
+            scale(type, comm, cntx, one/factor_B, false, local_B, dense_idx_B);
+    }
+}
+
+void zip(type_t type, const communicator& comm, const cntx_t* cntx,
+         tblis_zip_func func, void* data,
+         const scalar& alpha, bool conj_A, const indexed_dpd_marray_view<char>& A,
+         const dim_vector& idx_A_ABC,
+         const scalar&  beta, bool conj_B, const indexed_dpd_marray_view<char>& B,
+         const dim_vector& idx_B_ABC,
+         const scalar& gamma, bool conj_C, const indexed_dpd_marray_view<char>& C,
+         const dim_vector& idx_C_ABC)
+{
+    const len_type ts = type_size[type];
+
+    dim_vector dense_idx_A, dense_idx_B, dense_idx_C;
+    for (auto i : range(idx_A_ABC.size()))
+    {
+        if (idx_A_ABC[i] >= A.dense_dimension()) continue;
+        dense_idx_A.push_back(idx_A_ABC[i]);
+        dense_idx_B.push_back(idx_B_ABC[i]);
+        dense_idx_C.push_back(idx_C_ABC[i]);
+    }
+
+    auto local_A = A[0];
+    auto local_B = B[0];
+    auto local_C = C[0];
+
+    scalar factor_A(0.0, type);
+    scalar factor_B(0.0, type);
+    scalar factor_C(0.0, type);
+    scalar one(1.0, type);
+
+    for (len_type i = 0;i < C.num_indices();i++)
+    {
+        factor_A.from(A.factors().data() + i*ts);
+        factor_B.from(B.factors().data() + i*ts);
+        factor_C.from(C.factors().data() + i*ts);
+
+        if (factor_C.is_zero()) continue;
+
+        if (conj_A) factor_A.conj();
+        if (conj_B) factor_B.conj();
+
+        auto gamma_fac = gamma;
+        if (!factor_C.is_one() && !gamma.is_zero())
+            gamma_fac *= conj_C ? conj(factor_C) : factor_C;
+
+        local_A.data(A.data(i));
+        local_B.data(B.data(i));
+        local_C.data(C.data(i));
+
+        zip(type, comm, cntx, func, data,
+            alpha*factor_A, conj_A, local_A, dense_idx_A,
+             beta*factor_B, conj_B, local_B, dense_idx_B,
+                 gamma_fac, conj_C, local_C, dense_idx_C);
+
+        if (!factor_C.is_one())
+            scale(type, comm, cntx, one/factor_C, false, local_C, dense_idx_C);
+    }
+}
+
+}
+}
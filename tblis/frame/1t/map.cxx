@@ -0,0 +1,607 @@
+#include "map.h"
+
+#include "tblis/plugin/bli_plugin_tblis.h"
+
+#include "tblis/frame/base/tensor.hpp"
+#include "tblis/frame/base/stats.hpp"
+
+#include "tblis/frame/1t/dense/convert.hpp"
+#include "tblis/frame/1t/dense/map.hpp"
+#include "tblis/frame/1t/dpd/map.hpp"
+#include "tblis/frame/1t/indexed/map.hpp"
+#include "tblis/frame/1t/indexed_dpd/map.hpp"
+
+namespace tblis
+{
+
+/*
+ * The built-in functions are applied by the MAP_KER and ZIP_KER kernels of
+ * the context.
+ */
+struct map_builtin
+{
+    map_ft ukr;
+    map_t op;
+
+    map_builtin(type_t type, const cntx_t* cntx, map_t op)
+    : ukr(reinterpret_cast<map_ft>(bli_cntx_get_ukr_dt((num_t)type, MAP_KER, cntx))), op(op) {}
+
+    static void apply(len_type n,
+                      const void* alpha, int conj_A, const void* A, stride_type inc_A,
+                      const void*  beta, int conj_B,       void* B, stride_type inc_B,
+                      void* data)
+    {
+        auto& f = *static_cast<map_builtin*>(data);
+        f.ukr(f.op, n, alpha, conj_A, A, inc_A, beta, conj_B, B, inc_B);
+    }
+};
+
+struct zip_builtin
+{
+    zip_ft ukr;
+    zip_t op;
+
+    zip_builtin(type_t type, const cntx_t* cntx, zip_t op)
+    : ukr(reinterpret_cast<zip_ft>(bli_cntx_get_ukr_dt((num_t)type, ZIP_KER, cntx))), op(op) {}
+
+    static void apply(len_type n,
+                      const void* alpha, int conj_A, const void* A, stride_type inc_A,
+                      const void*  beta, int conj_B, const void* B, stride_type inc_B,
+                      const void* gamma, int conj_C,       void* C, stride_type inc_C,
+                      void* data)
+    {
+        auto& f = *static_cast<zip_builtin*>(data);
+        f.ukr(f.op, n, alpha, conj_A, A, inc_A, beta, conj_B, B, inc_B, gamma, conj_C, C, inc_C);
+    }
+};
+
+TBLIS_EXPORT
+void tblis_tensor_map_func(const tblis_comm* comm,
+                           const tblis_config* cntx,
+                           tblis_map_func func,
+                           void* data,
+                           const tblis_tensor* A,
+                           const label_type* idx_A_,
+                                 tblis_tensor* B,
+                           const label_type* idx_B_)
+{
+    (void)cntx;
+
+    internal::initialize_once();
+    internal::stats_scope stats(comm);
+
+    TBLIS_ASSERT(!internal::is_half(A->type), "Half precision tensors are not supported by this operation");
+    TBLIS_ASSERT(A->type == B->type);
+
+    auto ndim_A = A->ndim;
+    len_vector len_A;
+    stride_vector stride_A;
+    label_vector idx_A;
+    diagonal(ndim_A, A->len, A->stride, idx_A_, len_A, stride_A, idx_A);
+
+    auto ndim_B = B->ndim;
+    len_vector len_B;
+    stride_vector stride_B;
+    label_vector idx_B;
+    diagonal(ndim_B, B->len, B->stride, idx_B_, len_B, stride_B, idx_B);
+
+    TBLIS_ASSERT(stl_ext::exclusion(idx_A, idx_B).empty());
+    TBLIS_ASSERT(stl_ext::exclusion(idx_B, idx_A).empty());
+
+    auto len_AB = stl_ext::select_from(len_B, idx_B, idx_B);
+    TBLIS_ASSERT(len_AB == stl_ext::select_from(len_A, idx_A, idx_B));
+    auto stride_A_AB = stl_ext::select_from(stride_A, idx_A, idx_B);
+    auto stride_B_AB = stride_B;
+    auto idx_AB = idx_B;
+
+    if (idx_AB.empty())
+    {
+        len_AB.push_back(1);
+        stride_A_AB.push_back(0);
+        stride_B_AB.push_back(0);
+        idx_AB.push_back(0);
+    }
+
+    fold(len_AB, idx_AB, stride_A_AB, stride_B_AB);
+
+    parallelize_if(
+    [&](const communicator& comm)
+    {
+        internal::map(A->type, comm, bli_gks_query_cntx(), func, data, len_AB,
+                      A->scalar, A->conj, reinterpret_cast<char*>(A->data), stride_A_AB,
+                      B->scalar, B->conj, reinterpret_cast<char*>(B->data), stride_B_AB);
+    }, comm);
+
+    B->scalar = 1;
+    B->conj = false;
+}
+
+TBLIS_EXPORT
+void tblis_tensor_map(const tblis_comm* comm,
+                      const tblis_config* cntx,
+                      map_t op,
+                      const tblis_tensor* A,
+                      const label_type* idx_A,
+                            tblis_tensor* B,
+                      const label_type* idx_B)
+{
+    internal::initialize_once();
+
+    TBLIS_ASSERT(!internal::is_half(A->type), "Half precision tensors are not supported by this operation");
+
+    map_builtin f(A->type, bli_gks_query_cntx(), op);
+    tblis_tensor_map_func(comm, cntx, &map_builtin::apply, &f, A, idx_A, B, idx_B);
+}
+
+TBLIS_EXPORT
+void tblis_tensor_zip_func(const tblis_comm* comm,
+                           const tblis_config* cntx,
+                           tblis_zip_func func,
+                           void* data,
+                           const tblis_tensor* A,
+                           const label_type* idx_A_,
+                           const tblis_tensor* B,
+                           const label_type* idx_B_,
+                                 tblis_tensor* C,
+                           const label_type* idx_C_)
+{
+    (void)cntx;
+
+    internal::initialize_once();
+    internal::stats_scope stats(comm);
+
+    TBLIS_ASSERT(!internal::is_half(A->type), "Half precision tensors are not supported by this operation");
+    TBLIS_ASSERT(A->type == B->type);
+    TBLIS_ASSERT(A->type == C->type);
+
+    auto ndim_A = A->ndim;
+    len_vector len_A;
+    stride_vector stride_A;
+    label_vector idx_A;
+    diagonal(ndim_A, A->len, A->stride, idx_A_, len_A, stride_A, idx_A);
+
+    auto ndim_B = B->ndim;
+    len_vector len_B;
+    stride_vector stride_B;
+    label_vector idx_B;
+    diagonal(ndim_B, B->len, B->stride, idx_B_, len_B, stride_B, idx_B);
+
+    auto ndim_C = C->ndim;
+    len_vector len_C;
+    stride_vector stride_C;
+    label_vector idx_C;
+    diagonal(ndim_C, C->len, C->stride, idx_C_, len_C, stride_C, idx_C);
+
+    TBLIS_ASSERT(stl_ext::exclusion(idx_A, idx_C).empty());
+    TBLIS_ASSERT(stl_ext::exclusion(idx_B, idx_C).empty());
+    TBLIS_ASSERT(stl_ext::exclusion(idx_C, idx_A).empty());
+    TBLIS_ASSERT(stl_ext::exclusion(idx_C, idx_B).empty());
+
+    auto len_ABC = len_C;
+    TBLIS_ASSERT(len_ABC == stl_ext::select_from(len_A, idx_A, idx_C));
+    TBLIS_ASSERT(len_ABC == stl_ext::select_from(len_B, idx_B, idx_C));
+    auto stride_A_ABC = stl_ext::select_from(stride_A, idx_A, idx_C);
+    auto stride_B_ABC = stl_ext::select_from(stride_B, idx_B, idx_C);
+    auto stride_C_ABC = stride_C;
+    auto idx_ABC = idx_C;
+
+    if (idx_ABC.empty())
+    {
+        len_ABC.push_back(1);
+        stride_A_ABC.push_back(0);
+        stride_B_ABC.push_back(0);
+        stride_C_ABC.push_back(0);
+        idx_ABC.push_back(0);
+    }
+
+    fold(len_ABC, idx_ABC, stride_A_ABC, stride_B_ABC, stride_C_ABC);
+
+    parallelize_if(
+    [&](const communicator& comm)
+    {
+        internal::zip(A->type, comm, bli_gks_query_cntx(), func, data, len_ABC,
+                      A->scalar, A->conj, reinterpret_cast<char*>(A->data), stride_A_ABC,
+                      B->scalar, B->conj, reinterpret_cast<char*>(B->data), stride_B_ABC,
+                      C->scalar, C->conj, reinterpret_cast<char*>(C->data), stride_C_ABC);
+    }, comm);
+
+    C->scalar = 1;
+    C->conj = false;
+}
+
+TBLIS_EXPORT
+void tblis_tensor_zip(const tblis_comm* comm,
+                      const tblis_config* cntx,
+                      zip_t op,
+                      const tblis_tensor* A,
+                      const label_type* idx_A,
+                      const tblis_tensor* B,
+                      const label_type* idx_B,
+                            tblis_tensor* C,
+                      const label_type* idx_C)
+{
+    internal::initialize_once();
+
+    TBLIS_ASSERT(!internal::is_half(A->type), "Half precision tensors are not supported by this operation");
+
+    zip_builtin f(A->type, bli_gks_query_cntx(), op);
+    tblis_tensor_zip_func(comm, cntx, &zip_builtin::apply, &f, A, idx_A, B, idx_B, C, idx_C);
+}
+
+/*
+ * The positions in A of the dimensions of B, checking that the indices of A
+ * and B are distinct and the same up to order.
+ */
+static dim_vector match_dims(const label_vector& idx_A, const label_vector& idx_B)
+{
+    TBLIS_ASSERT(idx_A.size() == idx_B.size());
+
+    for (auto i : range(1,idx_B.size()))
+    for (auto j : range(i))
+        TBLIS_ASSERT(idx_B[i] != idx_B[j]);
+
+    TBLIS_ASSERT(stl_ext::exclusion(idx_A, idx_B).empty());
+
+    return internal::relative_permutation(idx_A, idx_B);
+}
+
+/*
+ * The elementwise operations on indexed tensors require that the operands
+ * hold the same indices in the same order, with the dense (and indexed)
+ * dimensions of one matching those of the other.
+ */
+template <typename Array, typename Array2>
+static void check_indices(const Array& A, const dim_vector& idx_A,
+                          const Array2& B, const dim_vector& idx_B)
+{
+    (void)A; (void)idx_A; (void)B; (void)idx_B;
+
+    TBLIS_ASSERT(A.num_indices() == B.num_indices());
+
+    for (auto k : range(idx_A.size()))
+    {
+        auto indexed_A = idx_A[k] >= A.dense_dimension();
+        auto indexed_B = idx_B[k] >= B.dense_dimension();
+        TBLIS_ASSERT(indexed_A == indexed_B);
+        if (!indexed_A) continue;
+
+        for (auto i : range(A.num_indices()))
+            TBLIS_ASSERT(A.index(i, idx_A[k] - A.dense_dimension()) ==
+                         B.index(i, idx_B[k] - B.dense_dimension()));
+    }
+}
+
+template <typename T>
+void map(const communicator& comm, tblis_map_func func, void* data,
+         T alpha, dpd_marray_view<const T> A, const label_vector& idx_A,
+         T  beta, dpd_marray_view<      T> B, const label_vector& idx_B)
+{
+    internal::initialize_once();
+    internal::stats_scope stats(comm);
+
+    auto idx_A_AB = match_dims(idx_A, idx_B);
+    dim_vector idx_B_AB = range(B.dimension());
+
+    TBLIS_ASSERT(A.num_irreps() == B.num_irreps());
+    TBLIS_ASSERT(A.irrep() == B.irrep());
+
+    for (auto i : range(B.dimension()))
+    for (auto irrep : range(B.num_irreps()))
+        TBLIS_ASSERT(A.length(idx_A_AB[i], irrep) == B.length(i, irrep));
+
+    internal::map(type_tag<T>::value, comm, bli_gks_query_cntx(), func, data,
+                  alpha, false, reinterpret_cast<dpd_marray_view<char>&>(A), idx_A_AB,
+                   beta, false, reinterpret_cast<dpd_marray_view<char>&>(B), idx_B_AB);
+}
+
+#undef FOREACH_TYPE
+#define FOREACH_TYPE(T) \
+template void map(const communicator& comm, tblis_map_func func, void* data, \
+                  T alpha, dpd_marray_view<const T> A, const label_vector& idx_A, \
+                  T  beta, dpd_marray_view<      T> B, const label_vector& idx_B);
+DO_FOREACH_TYPE
+
+template <typename T>
+void map(const communicator& comm, map_t op,
+         T alpha, dpd_marray_view<const T> A, const label_vector& idx_A,
+         T  beta, dpd_marray_view<      T> B, const label_vector& idx_B)
+{
+    internal::initialize_once();
+
+    map_builtin f(type_tag<T>::value, bli_gks_query_cntx(), op);
+    map(comm, &map_builtin::apply, &f, alpha, A, idx_A, beta, B, idx_B);
+}
+
+#undef FOREACH_TYPE
+#define FOREACH_TYPE(T) \
+template void map(const communicator& comm, map_t op, \
+                  T alpha, dpd_marray_view<const T> A, const label_vector& idx_A, \
+                  T  beta, dpd_marray_view<      T> B, const label_vector& idx_B);
+DO_FOREACH_TYPE
+
+template <typename T>
+void zip(const communicator& comm, tblis_zip_func func, void* data,
+         T alpha, dpd_marray_view<const T> A, const label_vector& idx_A,
+         T  beta, dpd_marray_view<const T> B, const label_vector& idx_B,
+         T gamma, dpd_marray_view<      T> C, const label_vector& idx_C)
+{
+    internal::initialize_once();
+    internal::stats_scope stats(comm);
+
+    auto idx_A_ABC = match_dims(idx_A, idx_C);
+    auto idx_B_ABC = match_dims(idx_B, idx_C);
+    dim_vector idx_C_ABC = range(C.dimension());
+
+    TBLIS_ASSERT(A.num_irreps() == C.num_irreps());
+    TBLIS_ASSERT(B.num_irreps() == C.num_irreps());
+    TBLIS_ASSERT(A.irrep() == C.irrep());
+    TBLIS_ASSERT(B.irrep() == C.irrep());
+
+    for (auto i : range(C.dimension()))
+    for (auto irrep : range(C.num_irreps()))
+    {
+        TBLIS_ASSERT(A.length(idx_A_ABC[i], irrep) == C.length(i, irrep));
+        TBLIS_ASSERT(B.length(idx_B_ABC[i], irrep) == C.length(i, irrep));
+    }
+
+    internal::zip(type_tag<T>::value, comm, bli_gks_query_cntx(), func, data,
+                  alpha, false, reinterpret_cast<dpd_marray_view<char>&>(A), idx_A_ABC,
+                   beta, false, reinterpret_cast<dpd_marray_view<char>&>(B), idx_B_ABC,
+                  gamma, false, reinterpret_cast<dpd_marray_view<char>&>(C), idx_C_ABC);
+}
+
+#undef FOREACH_TYPE
+#define FOREACH_TYPE(T) \
+template void zip(const communicator& comm, tblis_zip_func func, void* data, \
+                  T alpha, dpd_marray_view<const T> A, const label_vector& idx_A, \
+                  T  beta, dpd_marray_view<const T> B, const label_vector& idx_B, \
+                  T gamma, dpd_marray_view<      T> C, const label_vector& idx_C);
+DO_FOREACH_TYPE
+
+template <typename T>
+void zip(const communicator& comm, zip_t op,
+         T alpha, dpd_marray_view<const T> A, const label_vector& idx_A,
+         T  beta, dpd_marray_view<const T> B, const label_vector& idx_B,
+         T gamma, dpd_marray_view<      T> C, const label_vector& idx_C)
+{
+    internal::initialize_once();
+
+    zip_builtin f(type_tag<T>::value, bli_gks_query_cntx(), op);
+    zip(comm, &zip_builtin::apply, &f, alpha, A, idx_A, beta, B, idx_B, gamma, C, idx_C);
+}
+
+#undef FOREACH_TYPE
+#define FOREACH_TYPE(T) \
+template void zip(const communicator& comm, zip_t op, \
+                  T alpha, dpd_marray_view<const T> A, const label_vector& idx_A, \
+                  T  beta, dpd_marray_view<const T> B, const label_vector& idx_B, \
+                  T gamma, dpd_marray_view<      T> C, const label_vector& idx_C);
+DO_FOREACH_TYPE
+
+template <typename T>
+void map(const communicator& comm, tblis_map_func func, void* data,
+         T alpha, indexed_marray_view<const T> A, const label_vector& idx_A,
+         T  beta, indexed_marray_view<      T> B, const label_vector& idx_B)
+{
+    internal::initialize_once();
+    internal::stats_scope stats(comm);
+
+    auto idx_A_AB = match_dims(idx_A, idx_B);
+    dim_vector idx_B_AB = range(B.dimension());
+
+    for (auto i : range(B.dimension()))
+        TBLIS_ASSERT(A.length(idx_A_AB[i]) == B.length(i));
+
+    check_indices(A, idx_A_AB, B, idx_B_AB);
+
+    internal::map(type_tag<T>::value, comm, bli_gks_query_cntx(), func, data,
+                  alpha, false, reinterpret_cast<indexed_marray_view<char>&>(A), idx_A_AB,
+                   beta, false, reinterpret_cast<indexed_marray_view<char>&>(B), idx_B_AB);
+}
+
+#undef FOREACH_TYPE
+#define FOREACH_TYPE(T) \
+template void map(const communicator& comm, tblis_map_func func, void* data, \
+                  T alpha, indexed_marray_view<const T> A, const label_vector& idx_A, \
+                  T  beta, indexed_marray_view<      T> B, const label_vector& idx_B);
+DO_FOREACH_TYPE
+
+template <typename T>
+void map(const communicator& comm, map_t op,
+         T alpha, indexed_marray_view<const T> A, const label_vector& idx_A,
+         T  beta, indexed_marray_view<      T> B, const label_vector& idx_B)
+{
+    internal::initialize_once();
+
+    map_builtin f(type_tag<T>::value, bli_gks_query_cntx(), op);
+    map(comm, &map_builtin::apply, &f, alpha, A, idx_A, beta, B, idx_B);
+}
+
+#undef FOREACH_TYPE
+#define FOREACH_TYPE(T) \
+template void map(const communicator& comm, map_t op, \
+                  T alpha, indexed_marray_view<const T> A, const label_vector& idx_A, \
+                  T  beta, indexed_marray_view<      T> B, const label_vector& idx_B);
+DO_FOREACH_TYPE
+
+template <typename T>
+void zip(const communicator& comm, tblis_zip_func func, void* data,
+         T alpha, indexed_marray_view<const T> A, const label_vector& idx_A,
+         T  beta, indexed_marray_view<const T> B, const label_vector& idx_B,
+         T gamma, indexed_marray_view<      T> C, const label_vector& idx_C)
+{
+    internal::initialize_once();
+    internal::stats_scope stats(comm);
+
+    auto idx_A_ABC = match_dims(idx_A, idx_C);
+    auto idx_B_ABC = match_dims(idx_B, idx_C);
+    dim_vector idx_C_ABC = range(C.dimension());
+
+    for (auto i : range(C.dimension()))
+    {
+        TBLIS_ASSERT(A.length(idx_A_ABC[i]) == C.length(i));
+        TBLIS_ASSERT(B.length(idx_B_ABC[i]) == C.length(i));
+    }
+
+    check_indices(A, idx_A_ABC, C, idx_C_ABC);
+    check_indices(B, idx_B_ABC, C, idx_C_ABC);
+
+    internal::zip(type_tag<T>::value, comm, bli_gks_query_cntx(), func, data,
+                  alpha, false, reinterpret_cast<indexed_marray_view<char>&>(A), idx_A_ABC,
+                   beta, false, reinterpret_cast<indexed_marray_view<char>&>(B), idx_B_ABC,
+                  gamma, false, reinterpret_cast<indexed_marray_view<char>&>(C), idx_C_ABC);
+}
+
+#undef FOREACH_TYPE
+#define FOREACH_TYPE(T) \
+template void zip(const communicator& comm, tblis_zip_func func, void* data, \
+                  T alpha, indexed_marray_view<const T> A, const label_vector& idx_A, \
+                  T  beta, indexed_marray_view<const T> B, const label_vector& idx_B, \
+                  T gamma, indexed_marray_view<      T> C, const label_vector& idx_C);
+DO_FOREACH_TYPE
+
+template <typename T>
+void zip(const communicator& comm, zip_t op,
+         T alpha, indexed_marray_view<const T> A, const label_vector& idx_A,
+         T  beta, indexed_marray_view<const T> B, const label_vector& idx_B,
+         T gamma, indexed_marray_view<      T> C, const label_vector& idx_C)
+{
+    internal::initialize_once();
+
+    zip_builtin f(type_tag<T>::value, bli_gks_query_cntx(), op);
+    zip(comm, &zip_builtin::apply, &f, alpha, A, idx_A, beta, B, idx_B, gamma, C, idx_C);
+}
+
+#undef FOREACH_TYPE
+#define FOREACH_TYPE(T) \
+template void zip(const communicator& comm, zip_t op, \
+                  T alpha, indexed_marray_view<const T> A, const label_vector& idx_A, \
+                  T  beta, indexed_marray_view<const T> B, const label_vector& idx_B, \
+                  T gamma, indexed_marray_view<      T> C, const label_vector& idx_C);
+DO_FOREACH_TYPE
+
+template <typename T>
+void map(const communicator& comm, tblis_map_func func, void* data,
+         T alpha, indexed_dpd_marray_view<const T> A, const label_vector& idx_A,
+         T  beta, indexed_dpd_marray_view<      T> B, const label_vector& idx_B)
+{
+    internal::initialize_once();
+    internal::stats_scope stats(comm);
+
+    auto idx_A_AB = match_dims(idx_A, idx_B);
+    dim_vector idx_B_AB = range(B.dimension());
+
+    TBLIS_ASSERT(A.num_irreps() == B.num_irreps());
+    TBLIS_ASSERT(A.irrep() == B.irrep());
+
+    for (auto i : range(B.dimension()))
+    for (auto irrep : range(B.num_irreps()))
+        TBLIS_ASSERT(A.length(idx_A_AB[i], irrep) == B.length(i, irrep));
+
+    for (auto i : range(B.dense_dimension(), B.dimension()))
+        TBLIS_ASSERT(A.indexed_irrep(idx_A_AB[i] - A.dense_dimension()) ==
+                     B.indexed_irrep(i - B.dense_dimension()));
+
+    check_indices(A, idx_A_AB, B, idx_B_AB);
+
+    internal::map(type_tag<T>::value, comm, bli_gks_query_cntx(), func, data,
+                  alpha, false, reinterpret_cast<indexed_dpd_marray_view<char>&>(A), idx_A_AB,
+                   beta, false, reinterpret_cast<indexed_dpd_marray_view<char>&>(B), idx_B_AB);
+}
+
+#undef FOREACH_TYPE
+#define FOREACH_TYPE(T) \
+template void map(const communicator& comm, tblis_map_func func, void* data, \
+                  T alpha, indexed_dpd_marray_view<const T> A, const label_vector& idx_A, \
+                  T  beta, indexed_dpd_marray_view<      T> B, const label_vector& idx_B);
+DO_FOREACH_TYPE
+
+template <typename T>
+void map(const communicator& comm, map_t op,
+         T alpha, indexed_dpd_marray_view<const T> A, const label_vector& idx_A,
+         T  beta, indexed_dpd_marray_view<      T> B, const label_vector& idx_B)
+{
+    internal::initialize_once();
+
+    map_builtin f(type_tag<T>::value, bli_gks_query_cntx(), op);
+    map(comm, &map_builtin::apply, &f, alpha, A, idx_A, beta, B, idx_B);
+}
+
+#undef FOREACH_TYPE
+#define FOREACH_TYPE(T) \
+template void map(const communicator& comm, map_t op, \
+                  T alpha, indexed_dpd_marray_view<const T> A, const label_vector& idx_A, \
+                  T  beta, indexed_dpd_marray_view<      T> B, const label_vector& idx_B);
+DO_FOREACH_TYPE
+
+template <typename T>
+void zip(const communicator& comm, tblis_zip_func func, void* data,
+         T alpha, indexed_dpd_marray_view<const T> A, const label_vector& idx_A,
+         T  beta, indexed_dpd_marray_view<const T> B, const label_vector& idx_B,
+         T gamma, indexed_dpd_marray_view<      T> C, const label_vector& idx_C)
+{
+    internal::initialize_once();
+    internal::stats_scope stats(comm);
+
+    auto idx_A_ABC = match_dims(idx_A, idx_C);
+    auto idx_B_ABC = match_dims(idx_B, idx_C);
+    dim_vector idx_C_ABC = range(C.dimension());
+
+    TBLIS_ASSERT(A.num_irreps() == C.num_irreps());
+    TBLIS_ASSERT(B.num_irreps() == C.num_irreps());
+    TBLIS_ASSERT(A.irrep() == C.irrep());
+    TBLIS_ASSERT(B.irrep() == C.irrep());
+
+    for (auto i : range(C.dimension()))
+    for (auto irrep : range(C.num_irreps()))
+    {
+        TBLIS_ASSERT(A.length(idx_A_ABC[i], irrep) == C.length(i, irrep));
+        TBLIS_ASSERT(B.length(idx_B_ABC[i], irrep) == C.length(i, irrep));
+    }
+
+    for (auto i : range(C.dense_dimension(), C.dimension()))
+    {
+        TBLIS_ASSERT(A.indexed_irrep(idx_A_ABC[i] - A.dense_dimension()) ==
+                     C.indexed_irrep(i - C.dense_dimension()));
+        TBLIS_ASSERT(B.indexed_irrep(idx_B_ABC[i] - B.dense_dimension()) ==
+                     C.indexed_irrep(i - C.dense_dimension()));
+    }
+
+    check_indices(A, idx_A_ABC, C, idx_C_ABC);
+    check_indices(B, idx_B_ABC, C, idx_C_ABC);
+
+    internal::zip(type_tag<T>::value, comm, bli_gks_query_cntx(), func, data,
+                  alpha, false, reinterpret_cast<indexed_dpd_marray_view<char>&>(A), idx_A_ABC,
+                   beta, false, reinterpret_cast<indexed_dpd_marray_view<char>&>(B), idx_B_ABC,
+                  gamma, false, reinterpret_cast<indexed_dpd_marray_view<char>&>(C), idx_C_ABC);
+}
+
+#undef FOREACH_TYPE
+#define FOREACH_TYPE(T) \
+template void zip(const communicator& comm, tblis_zip_func func, void* data, \
+                  T alpha, indexed_dpd_marray_view<const T> A, const label_vector& idx_A, \
+                  T  beta, indexed_dpd_marray_view<const T> B, const label_vector& idx_B, \
+                  T gamma, indexed_dpd_marray_view<      T> C, const label_vector& idx_C);
+DO_FOREACH_TYPE
+
+template <typename T>
+void zip(const communicator& comm, zip_t op,
+         T alpha, indexed_dpd_marray_view<const T> A, const label_vector& idx_A,
+         T  beta, indexed_dpd_marray_view<const T> B, const label_vector& idx_B,
+         T gamma, indexed_dpd_marray_view<      T> C, const label_vector& idx_C)
+{
+    internal::initialize_once();
+
+    zip_builtin f(type_tag<T>::value, bli_gks_query_cntx(), op);
+    zip(comm, &zip_builtin::apply, &f, alpha, A, idx_A, beta, B, idx_B, gamma, C, idx_C);
+}
+
+#undef FOREACH_TYPE
+#define FOREACH_TYPE(T) \
+template void zip(const communicator& comm, zip_t op, \
+                  T alpha, indexed_dpd_marray_view<const T> A, const label_vector& idx_A, \
+                  T  beta, indexed_dpd_marray_view<const T> B, const label_vector& idx_B, \
+                  T gamma, indexed_dpd_marray_view<      T> C, const label_vector& idx_C);
+DO_FOREACH_TYPE
+
+}
@@ -0,0 +1,665 @@
+#ifndef _TBLIS_IFACE_1T_MAP_H_
+#define _TBLIS_IFACE_1T_MAP_H_
+
+#include "../base/thread.h"
+#include "../base/basic_types.h"
+
+#if TBLIS_ENABLE_CPLUSPLUS
+#include <type_traits>
+#endif
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wnull-dereference"
+
+TBLIS_BEGIN_NAMESPACE
+
+/*
+ * B = f(A.scalar*A) + B.scalar*B elementwise, where f is a built-in function.
+ * The indices of A and B must be the same up to order.
+ */
+TBLIS_EXPORT
+void tblis_tensor_map(const tblis_comm* comm,
+                      const tblis_config* cntx,
+                      map_t op,
+                      const tblis_tensor* A,
+                      const label_type* idx_A,
+                            tblis_tensor* B,
+                      const label_type* idx_B);
+
+/*
+ * As tblis_tensor_map, with f applied one fiber at a time by func, which is
+ * passed data.
+ */
+TBLIS_EXPORT
+void tblis_tensor_map_func(const tblis_comm* comm,
+                           const tblis_config* cntx,
+                           tblis_map_func func,
+                           void* data,
+                           const tblis_tensor* A,
+                           const label_type* idx_A,
+                                 tblis_tensor* B,
+                           const label_type* idx_B);
+
+/*
+ * C = f(A.scalar*A, B.scalar*B) + C.scalar*C elementwise, where f is a
+ * built-in function. The indices of A, B, and C must be the same up to
+ * order.
+ */
+TBLIS_EXPORT
+void tblis_tensor_zip(const tblis_comm* comm,
+                      const tblis_config* cntx,
+                      zip_t op,
+                      const tblis_tensor* A,
+                      const label_type* idx_A,
+                      const tblis_tensor* B,
+                      const label_type* idx_B,
+                            tblis_tensor* C,
+                      const label_type* idx_C);
+
+TBLIS_EXPORT
+void tblis_tensor_zip_func(const tblis_comm* comm,
+                           const tblis_config* cntx,
+                           tblis_zip_func func,
+                           void* data,
+                           const tblis_tensor* A,
+                           const label_type* idx_A,
+                           const tblis_tensor* B,
+                           const label_type* idx_B,
+                                 tblis_tensor* C,
+                           const label_type* idx_C);
+
+#if TBLIS_ENABLE_CPLUSPLUS
+
+/*
+ * The fiber loops below are compiled as part of user code, which may not
+ * enable OpenMP, so the simd hint is only given where it is understood.
+ */
+#ifdef _OPENMP
+#define TBLIS_MAP_SIMD _Pragma("omp simd")
+#else
+#define TBLIS_MAP_SIMD
+#endif
+
+/*
+ * Adapts a functor taking and returning values of type T to a
+ * tblis_map_func. The functor is inlined into the fiber loops, so simple
+ * functions are vectorized as for the built-in ones.
+ */
+template <typename T, typename Func>
+void map_fiber(len_type n,
+               const void* alpha_, int conj_A, const void* A_, stride_type inc_A,
+               const void*  beta_, int conj_B,       void* B_, stride_type inc_B,
+               void* data)
+{
+    if constexpr (std::is_invocable_r_v<T, Func&, T>)
+    {
+        auto& f = *static_cast<Func*>(data);
+
+        T alpha = *static_cast<const T*>(alpha_);
+        T beta  = *static_cast<const T*>(beta_ );
+
+        const T* TBLIS_RESTRICT A = static_cast<const T*>(A_);
+              T* TBLIS_RESTRICT B = static_cast<      T*>(B_);
+
+        if (beta == T(0))
+        {
+            if (inc_A == 1 && inc_B == 1)
+            {
+                TBLIS_MAP_SIMD
+                for (len_type i = 0;i < n;i++)
+                    B[i] = f(alpha*conj(conj_A, A[i]));
+            }
+            else
+            {
+                for (len_type i = 0;i < n;i++)
+                    B[i*inc_B] = f(alpha*conj(conj_A, A[i*inc_A]));
+            }
+        }
+        else
+        {
+            if (inc_A == 1 && inc_B == 1)
+            {
+                TBLIS_MAP_SIMD
+                for (len_type i = 0;i < n;i++)
+                    B[i] = f(alpha*conj(conj_A, A[i])) + beta*conj(conj_B, B[i]);
+            }
+            else
+            {
+                for (len_type i = 0;i < n;i++)
+                    B[i*inc_B] = f(alpha*conj(conj_A, A[i*inc_A])) +
+                                  beta*conj(conj_B, B[i*inc_B]);
+            }
+        }
+    }
+    else
+    {
+        (void)n; (void)alpha_; (void)conj_A; (void)A_; (void)inc_A;
+        (void)beta_; (void)conj_B; (void)B_; (void)inc_B; (void)data;
+        tblis_abort_with_message("map: functor does not accept the tensor type");
+    }
+}
+
+template <typename T, typename Func>
+void zip_fiber(len_type n,
+               const void* alpha_, int conj_A, const void* A_, stride_type inc_A,
+               const void*  beta_, int conj_B, const void* B_, stride_type inc_B,
+               const void* gamma_, int conj_C,       void* C_, stride_type inc_C,
+               void* data)
+{
+    if constexpr (std::is_invocable_r_v<T, Func&, T, T>)
+    {
+        auto& f = *static_cast<Func*>(data);
+
+        T alpha = *static_cast<const T*>(alpha_);
+        T beta  = *static_cast<const T*>(beta_ );
+        T gamma = *static_cast<const T*>(gamma_);
+
+        const T* TBLIS_RESTRICT A = static_cast<const T*>(A_);
+        const T* TBLIS_RESTRICT B = static_cast<const T*>(B_);
+              T* TBLIS_RESTRICT C = static_cast<      T*>(C_);
+
+        if (gamma == T(0))
+        {
+            if (inc_A == 1 && inc_B == 1 && inc_C == 1)
+            {
+                TBLIS_MAP_SIMD
+                for (len_type i = 0;i < n;i++)
+                    C[i] = f(alpha*conj(conj_A, A[i]), beta*conj(conj_B, B[i]));
+            }
+            else
+            {
+                for (len_type i = 0;i < n;i++)
+                    C[i*inc_C] = f(alpha*conj(conj_A, A[i*inc_A]),
+                                    beta*conj(conj_B, B[i*inc_B]));
+            }
+        }
+        else
+        {
+            if (inc_A == 1 && inc_B == 1 && inc_C == 1)
+            {
+                TBLIS_MAP_SIMD
+                for (len_type i = 0;i < n;i++)
+                    C[i] = f(alpha*conj(conj_A, A[i]), beta*conj(conj_B, B[i])) +
+                           gamma*conj(conj_C, C[i]);
+            }
+            else
+            {
+                for (len_type i = 0;i < n;i++)
+                    C[i*inc_C] = f(alpha*conj(conj_A, A[i*inc_A]),
+                                    beta*conj(conj_B, B[i*inc_B])) +
+                                 gamma*conj(conj_C, C[i*inc_C]);
+            }
+        }
+    }
+    else
+    {
+        (void)n; (void)alpha_; (void)conj_A; (void)A_; (void)inc_A;
+        (void)beta_; (void)conj_B; (void)B_; (void)inc_B;
+        (void)gamma_; (void)conj_C; (void)C_; (void)inc_C; (void)data;
+        tblis_abort_with_message("zip: functor does not accept the tensor type");
+    }
+}
+
+template <typename Func>
+tblis_map_func map_fiber_for(type_t type)
+{
+    switch (type)
+    {
+        case TYPE_FLOAT:    return &map_fiber<   float,Func>;
+        case TYPE_DOUBLE:   return &map_fiber<  double,Func>;
+        case TYPE_SCOMPLEX: return &map_fiber<scomplex,Func>;
+        default:            return &map_fiber<dcomplex,Func>;
+    }
+}
+
+template <typename Func>
+tblis_zip_func zip_fiber_for(type_t type)
+{
+    switch (type)
+    {
+        case TYPE_FLOAT:    return &zip_fiber<   float,Func>;
+        case TYPE_DOUBLE:   return &zip_fiber<  double,Func>;
+        case TYPE_SCOMPLEX: return &zip_fiber<scomplex,Func>;
+        default:            return &zip_fiber<dcomplex,Func>;
+    }
+}
+
+template <typename Func>
+using if_functor = std::enable_if_t<!std::is_same_v<std::decay_t<Func>,map_t> &&
+                                    !std::is_same_v<std::decay_t<Func>,zip_t>>;
+
+inline
+void map(const communicator& comm,
+         map_t op,
+         const scalar& alpha,
+         const tensor_wrapper& A_,
+         const label_vector& idx_A,
+         const scalar& beta,
+               tensor_wrapper&& B,
+         const label_vector& idx_B)
+{
+    auto A(A_);
+    A.scalar *= alpha.convert(A.type);
+    B.scalar *= beta.convert(B.type);
+    tblis_tensor_map(comm, nullptr, op, &A, idx_A.data(), &B, idx_B.data());
+}
+
+template <typename Func, typename=if_functor<Func>>
+void map(const communicator& comm,
+         Func&& f,
+         const scalar& alpha,
+         const tensor_wrapper& A_,
+         const label_vector& idx_A,
+         const scalar& beta,
+               tensor_wrapper&& B,
+         const label_vector& idx_B)
+{
+    using F = std::remove_reference_t<Func>;
+    auto A(A_);
+    A.scalar *= alpha.convert(A.type);
+    B.scalar *= beta.convert(B.type);
+    tblis_tensor_map_func(comm, nullptr, map_fiber_for<F>(A.type),
+                          const_cast<void*>(static_cast<const void*>(&f)),
+                          &A, idx_A.data(), &B, idx_B.data());
+}
+
+template <typename Func>
+void map(const communicator& comm,
+         Func&& f,
+         const tensor_wrapper& A,
+         const label_vector& idx_A,
+               tensor_wrapper&& B,
+         const label_vector& idx_B)
+{
+    map(comm, std::forward<Func>(f), {1.0, A.type}, A, idx_A, {0.0, A.type}, std::move(B), idx_B);
+}
+
+template <typename Func>
+void map(const communicator& comm,
+         Func&& f,
+         const tensor_wrapper& A,
+               tensor_wrapper&& B)
+{
+    map(comm, std::forward<Func>(f), A, idx(A), std::move(B), idx(B));
+}
+
+template <typename Func>
+void map(Func&& f,
+         const scalar& alpha,
+         const tensor_wrapper& A,
+         const label_vector& idx_A,
+         const scalar& beta,
+               tensor_wrapper&& B,
+         const label_vector& idx_B)
+{
+    map(*(communicator*)nullptr, std::forward<Func>(f), alpha, A, idx_A, beta, std::move(B), idx_B);
+}
+
+template <typename Func>
+void map(Func&& f,
+         const tensor_wrapper& A,
+         const label_vector& idx_A,
+               tensor_wrapper&& B,
+         const label_vector& idx_B)
+{
+    map(std::forward<Func>(f), {1.0, A.type}, A, idx_A, {0.0, A.type}, std::move(B), idx_B);
+}
+
+template <typename Func>
+void map(Func&& f,
+         const tensor_wrapper& A,
+               tensor_wrapper&& B)
+{
+    map(std::forward<Func>(f), A, idx(A), std::move(B), idx(B));
+}
+
+inline
+void zip(const communicator& comm,
+         zip_t op,
+         const scalar& alpha,
+         const tensor_wrapper& A_,
+         const label_vector& idx_A,
+         const scalar& beta,
+         const tensor_wrapper& B_,
+         const label_vector& idx_B,
+         const scalar& gamma,
+               tensor_wrapper&& C,
+         const label_vector& idx_C)
+{
+    auto A(A_);
+    auto B(B_);
+    A.scalar *= alpha.convert(A.type);
+    B.scalar *= beta.convert(B.type);
+    C.scalar *= gamma.convert(C.type);
+    tblis_tensor_zip(comm, nullptr, op, &A, idx_A.data(), &B, idx_B.data(), &C, idx_C.data());
+}
+
+template <typename Func, typename=if_functor<Func>>
+void zip(const communicator& comm,
+         Func&& f,
+         const scalar& alpha,
+         const tensor_wrapper& A_,
+         const label_vector& idx_A,
+         const scalar& beta,
+         const tensor_wrapper& B_,
+         const label_vector& idx_B,
+         const scalar& gamma,
+               tensor_wrapper&& C,
+         const label_vector& idx_C)
+{
+    using F = std::remove_reference_t<Func>;
+    auto A(A_);
+    auto B(B_);
+    A.scalar *= alpha.convert(A.type);
+    B.scalar *= beta.convert(B.type);
+    C.scalar *= gamma.convert(C.type);
+    tblis_tensor_zip_func(comm, nullptr, zip_fiber_for<F>(A.type),
+                          const_cast<void*>(static_cast<const void*>(&f)),
+                          &A, idx_A.data(), &B, idx_B.data(), &C, idx_C.data());
+}
+
+template <typename Func>
+void zip(const communicator& comm,
+         Func&& f,
+         const tensor_wrapper& A,
+         const label_vector& idx_A,
+         const tensor_wrapper& B,
+         const label_vector& idx_B,
+               tensor_wrapper&& C,
+         const label_vector& idx_C)
+{
+    zip(comm, std::forward<Func>(f), {1.0, A.type}, A, idx_A, {1.0, A.type}, B, idx_B,
+        {0.0, A.type}, std::move(C), idx_C);
+}
+
+template <typename Func>
+void zip(const communicator& comm,
+         Func&& f,
+         const tensor_wrapper& A,
+         const tensor_wrapper& B,
+               tensor_wrapper&& C)
+{
+    zip(comm, std::forward<Func>(f), A, idx(A), B, idx(B), std::move(C), idx(C));
+}
+
+template <typename Func>
+void zip(Func&& f,
+         const scalar& alpha,
+         const tensor_wrapper& A,
+         const label_vector& idx_A,
+         const scalar& beta,
+         const tensor_wrapper& B,
+         const label_vector& idx_B,
+         const scalar& gamma,
+               tensor_wrapper&& C,
+         const label_vector& idx_C)
+{
+    zip(*(communicator*)nullptr, std::forward<Func>(f), alpha, A, idx_A, beta, B, idx_B,
+        gamma, std::move(C), idx_C);
+}
+
+template <typename Func>
+void zip(Func&& f,
+         const tensor_wrapper& A,
+         const label_vector& idx_A,
+         const tensor_wrapper& B,
+         const label_vector& idx_B,
+               tensor_wrapper&& C,
+         const label_vector& idx_C)
+{
+    zip(std::forward<Func>(f), {1.0, A.type}, A, idx_A, {1.0, A.type}, B, idx_B,
+        {0.0, A.type}, std::move(C), idx_C);
+}
+
+template <typename Func>
+void zip(Func&& f,
+         const tensor_wrapper& A,
+         const tensor_wrapper& B,
+               tensor_wrapper&& C)
+{
+    zip(std::forward<Func>(f), A, idx(A), B, idx(B), std::move(C), idx(C));
+}
+
+#ifdef MARRAY_DPD_MARRAY_HPP
+
+template <typename T>
+void map(const communicator& comm, tblis_map_func func, void* data,
+         T alpha, MArray::dpd_marray_view<const T> A, const label_vector& idx_A,
+         T  beta, MArray::dpd_marray_view<      T> B, const label_vector& idx_B);
+
+template <typename T>
+void map(const communicator& comm, map_t op,
+         T alpha, MArray::dpd_marray_view<const T> A, const label_vector& idx_A,
+         T  beta, MArray::dpd_marray_view<      T> B, const label_vector& idx_B);
+
+template <typename T, typename Func, typename=if_functor<Func>>
+void map(const communicator& comm, Func&& f,
+         T alpha, MArray::dpd_marray_view<const T> A, const label_vector& idx_A,
+         T  beta, MArray::dpd_marray_view<      T> B, const label_vector& idx_B)
+{
+    map(comm, &map_fiber<T,std::remove_reference_t<Func>>,
+        const_cast<void*>(static_cast<const void*>(&f)),
+        alpha, A, idx_A, beta, B, idx_B);
+}
+
+template <typename T, typename Func>
+void map(Func&& f,
+         T alpha, MArray::dpd_marray_view<const T> A, const label_vector& idx_A,
+         T  beta, MArray::dpd_marray_view<      T> B, const label_vector& idx_B)
+{
+    parallelize
+    (
+        [&](const communicator& comm)
+        {
+            map(comm, f, alpha, A, idx_A, beta, B, idx_B);
+        },
+        tblis_get_num_threads()
+    );
+}
+
+template <typename T>
+void zip(const communicator& comm, tblis_zip_func func, void* data,
+         T alpha, MArray::dpd_marray_view<const T> A, const label_vector& idx_A,
+         T  beta, MArray::dpd_marray_view<const T> B, const label_vector& idx_B,
+         T gamma, MArray::dpd_marray_view<      T> C, const label_vector& idx_C);
+
+template <typename T>
+void zip(const communicator& comm, zip_t op,
+         T alpha, MArray::dpd_marray_view<const T> A, const label_vector& idx_A,
+         T  beta, MArray::dpd_marray_view<const T> B, const label_vector& idx_B,
+         T gamma, MArray::dpd_marray_view<      T> C, const label_vector& idx_C);
+
+template <typename T, typename Func, typename=if_functor<Func>>
+void zip(const communicator& comm, Func&& f,
+         T alpha, MArray::dpd_marray_view<const T> A, const label_vector& idx_A,
+         T  beta, MArray::dpd_marray_view<const T> B, const label_vector& idx_B,
+         T gamma, MArray::dpd_marray_view<      T> C, const label_vector& idx_C)
+{
+    zip(comm, &zip_fiber<T,std::remove_reference_t<Func>>,
+        const_cast<void*>(static_cast<const void*>(&f)),
+        alpha, A, idx_A, beta, B, idx_B, gamma, C, idx_C);
+}
+
+template <typename T, typename Func>
+void zip(Func&& f,
+         T alpha, MArray::dpd_marray_view<const T> A, const label_vector& idx_A,
+         T  beta, MArray::dpd_marray_view<const T> B, const label_vector& idx_B,
+         T gamma, MArray::dpd_marray_view<      T> C, const label_vector& idx_C)
+{
+    parallelize
+    (
+        [&](const communicator& comm)
+        {
+            zip(comm, f, alpha, A, idx_A, beta, B, idx_B, gamma, C, idx_C);
+        },
+        tblis_get_num_threads()
+    );
+}
+
+#endif
+
+#ifdef MARRAY_INDEXED_MARRAY_HPP
+
+template <typename T>
+void map(const communicator& comm, tblis_map_func func, void* data,
+         T alpha, MArray::indexed_marray_view<const T> A, const label_vector& idx_A,
+         T  beta, MArray::indexed_marray_view<      T> B, const label_vector& idx_B);
+
+template <typename T>
+void map(const communicator& comm, map_t op,
+         T alpha, MArray::indexed_marray_view<const T> A, const label_vector& idx_A,
+         T  beta, MArray::indexed_marray_view<      T> B, const label_vector& idx_B);
+
+template <typename T, typename Func, typename=if_functor<Func>>
+void map(const communicator& comm, Func&& f,
+         T alpha, MArray::indexed_marray_view<const T> A, const label_vector& idx_A,
+         T  beta, MArray::indexed_marray_view<      T> B, const label_vector& idx_B)
+{
+    map(comm, &map_fiber<T,std::remove_reference_t<Func>>,
+        const_cast<void*>(static_cast<const void*>(&f)),
+        alpha, A, idx_A, beta, B, idx_B);
+}
+
+template <typename T, typename Func>
+void map(Func&& f,
+         T alpha, MArray::indexed_marray_view<const T> A, const label_vector& idx_A,
+         T  beta, MArray::indexed_marray_view<      T> B, const label_vector& idx_B)
+{
+    parallelize
+    (
+        [&](const communicator& comm)
+        {
+            map(comm, f, alpha, A, idx_A, beta, B, idx_B);
+        },
+        tblis_get_num_threads()
+    );
+}
+
+template <typename T>
+void zip(const communicator& comm, tblis_zip_func func, void* data,
+         T alpha, MArray::indexed_marray_view<const T> A, const label_vector& idx_A,
+         T  beta, MArray::indexed_marray_view<const T> B, const label_vector& idx_B,
+         T gamma, MArray::indexed_marray_view<      T> C, const label_vector& idx_C);
+
+template <typename T>
+void zip(const communicator& comm, zip_t op,
+         T alpha, MArray::indexed_marray_view<const T> A, const label_vector& idx_A,
+         T  beta, MArray::indexed_marray_view<const T> B, const label_vector& idx_B,
+         T gamma, MArray::indexed_marray_view<      T> C, const label_vector& idx_C);
+
+template <typename T, typename Func, typename=if_functor<Func>>
+void zip(const communicator& comm, Func&& f,
+         T alpha, MArray::indexed_marray_view<const T> A, const label_vector& idx_A,
+         T  beta, MArray::indexed_marray_view<const T> B, const label_vector& idx_B,
+         T gamma, MArray::indexed_marray_view<      T> C, const label_vector& idx_C)
+{
+    zip(comm, &zip_fiber<T,std::remove_reference_t<Func>>,
+        const_cast<void*>(static_cast<const void*>(&f)),
+        alpha, A, idx_A, beta, B, idx_B, gamma, C, idx_C);
+}
+
+template <typename T, typename Func>
+void zip(Func&& f,
+         T alpha, MArray::indexed_marray_view<const T> A, const label_vector& idx_A,
+         T  beta, MArray::indexed_marray_view<const T> B, const label_vector& idx_B,
+         T gamma, MArray::indexed_marray_view<      T> C, const label_vector& idx_C)
+{
+    parallelize
+    (
+        [&](const communicator& comm)
+        {
+            zip(comm, f, alpha, A, idx_A, beta, B, idx_B, gamma, C, idx_C);
+        },
+        tblis_get_num_threads()
+    );
+}
+
+#endif
+
+#ifdef MARRAY_INDEXED_DPD_MARRAY_HPP
+
+template <typename T>
+void map(const communicator& comm, tblis_map_func func, void* data,
+         T alpha, MArray::indexed_dpd_marray_view<const T> A, const label_vector& idx_A,
+         T  beta, MArray::indexed_dpd_marray_view<      T> B, const label_vector& idx_B);
+
+template <typename T>
+void map(const communicator& comm, map_t op,
+         T alpha, MArray::indexed_dpd_marray_view<const T> A, const label_vector& idx_A,
+         T  beta, MArray::indexed_dpd_marray_view<      T> B, const label_vector& idx_B);
+
+template <typename T, typename Func, typename=if_functor<Func>>
+void map(const communicator& comm, Func&& f,
+         T alpha, MArray::indexed_dpd_marray_view<const T> A, const label_vector& idx_A,
+         T  beta, MArray::indexed_dpd_marray_view<      T> B, const label_vector& idx_B)
+{
+    map(comm, &map_fiber<T,std::remove_reference_t<Func>>,
+        const_cast<void*>(static_cast<const void*>(&f)),
+        alpha, A, idx_A, beta, B, idx_B);
+}
+
+template <typename T, typename Func>
+void map(Func&& f,
+         T alpha, MArray::indexed_dpd_marray_view<const T> A, const label_vector& idx_A,
+         T  beta, MArray::indexed_dpd_marray_view<      T> B, const label_vector& idx_B)
+{
+    parallelize
+    (
+        [&](const communicator& comm)
+        {
+            map(comm, f, alpha, A, idx_A, beta, B, idx_B);
+        },
+        tblis_get_num_threads()
+    );
+}
+
+template <typename T>
+void zip(const communicator& comm, tblis_zip_func func, void* data,
+         T alpha, MArray::indexed_dpd_marray_view<const T> A, const label_vector& idx_A,
+         T  beta, MArray::indexed_dpd_marray_view<const T> B, const label_vector& idx_B,
+         T gamma, MArray::indexed_dpd_marray_view<      T> C, const label_vector& idx_C);
+
+template <typename T>
+void zip(const communicator& comm, zip_t op,
+         T alpha, MArray::indexed_dpd_marray_view<const T> A, const label_vector& idx_A,
+         T  beta, MArray::indexed_dpd_marray_view<const T> B, const label_vector& idx_B,
+         T gamma, MArray::indexed_dpd_marray_view<      T> C, const label_vector& idx_C);
+
+template <typename T, typename Func, typename=if_functor<Func>>
+void zip(const communicator& comm, Func&& f,
+         T alpha, MArray::indexed_dpd_marray_view<const T> A, const label_vector& idx_A,
+         T  beta, MArray::indexed_dpd_marray_view<const T> B, const label_vector& idx_B,
+         T gamma, MArray::indexed_dpd_marray_view<      T> C, const label_vector& idx_C)
+{
+    zip(comm, &zip_fiber<T,std::remove_reference_t<Func>>,
+        const_cast<void*>(static_cast<const void*>(&f)),
+        alpha, A, idx_A, beta, B, idx_B, gamma, C, idx_C);
+}
+
+template <typename T, typename Func>
+void zip(Func&& f,
+         T alpha, MArray::indexed_dpd_marray_view<const T> A, const label_vector& idx_A,
+         T  beta, MArray::indexed_dpd_marray_view<const T> B, const label_vector& idx_B,
+         T gamma, MArray::indexed_dpd_marray_view<      T> C, const label_vector& idx_C)
+{
+    parallelize
+    (
+        [&](const communicator& comm)
+        {
+            zip(comm, f, alpha, A, idx_A, beta, B, idx_B, gamma, C, idx_C);
+        },
+        tblis_get_num_threads()
+    );
+}
+
+#endif
+
+#undef TBLIS_MAP_SIMD
+
+#endif
+
+TBLIS_END_NAMESPACE
+
+#pragma GCC diagnostic pop
+
+#endif
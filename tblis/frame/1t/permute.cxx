@@ -0,0 +1,90 @@
+#include "permute.h"
+
+#include "tblis/plugin/bli_plugin_tblis.h"
+
+#include "tblis/frame/base/tensor.hpp"
+#include "tblis/frame/base/stats.hpp"
+
+#include "tblis/frame/1t/dense/permute.hpp"
+#include "tblis/frame/1t/dense/scale.hpp"
+#include "tblis/frame/1t/dense/set.hpp"
+
+namespace tblis
+{
+
+TBLIS_EXPORT
+void tblis_tensor_permute(const tblis_comm* comm,
+                          const tblis_config* cntx,
+                                tblis_tensor* A,
+                          const label_type* idx_A_,
+                          const label_type* idx_B_,
+                                stride_type* stride_B)
+{
+    internal::initialize_once();
+    internal::stats_scope stats(comm);
+
+    int ndim = A->ndim;
+    len_vector len_A(A->len, A->len+ndim);
+    stride_vector stride_A(A->stride, A->stride+ndim);
+    label_vector idx_A(idx_A_, idx_A_+ndim);
+    label_vector idx_B(idx_B_, idx_B_+ndim);
+
+    auto perm = internal::relative_permutation(idx_A, idx_B);
+    TBLIS_ASSERT(perm.size() == ndim);
+
+    /*
+     * The dimensions of A in storage order, and the storage order of the
+     * result, in which position i has the same rank as in A.
+     */
+    auto order = internal::sort_by_stride(stride_A);
+    dim_vector rank(ndim);
+    for (auto k : range(ndim)) rank[order[k]] = k;
+
+    len_vector len_S;
+    dim_vector perm_S;
+    for (auto k : range(ndim))
+    {
+        len_S.push_back(len_A[order[k]]);
+        perm_S.push_back(rank[perm[order[k]]]);
+    }
+
+    stride_type size = 1;
+    for (auto k : range(ndim))
+    {
+        TBLIS_ASSERT(len_S[k] == 1 || stride_A[order[k]] == size);
+        size *= len_S[k];
+    }
+
+    stride_type stride = 1;
+    for (auto k : range(ndim))
+    {
+        stride_B[order[k]] = stride;
+        stride *= len_A[perm[order[k]]];
+    }
+
+    parallelize_if(
+    [&](const communicator& comm)
+    {
+        if (A->scalar.is_zero())
+        {
+            internal::set(A->type, comm, bli_gks_query_cntx(), {size},
+                          A->scalar, reinterpret_cast<char*>(A->data), {1});
+            return;
+        }
+
+        internal::permute(A->type, comm, bli_gks_query_cntx(),
+                          len_S, perm_S, reinterpret_cast<char*>(A->data));
+
+        if (!A->scalar.is_one() || (A->scalar.is_complex() && A->conj))
+        {
+            internal::scale(A->type, comm, bli_gks_query_cntx(), {size},
+                            A->scalar, A->conj,
+                            reinterpret_cast<char*>(A->data), {1});
+        }
+    }, comm);
+
+    A->scalar = 1;
+    A->conj = false;
+}
+
+}
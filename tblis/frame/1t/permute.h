@@ -0,0 +1,60 @@
+#ifndef _TBLIS_IFACE_1T_PERMUTE_H_
+#define _TBLIS_IFACE_1T_PERMUTE_H_
+
+#include "../base/thread.h"
+#include "../base/basic_types.h"
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wnull-dereference"
+
+TBLIS_BEGIN_NAMESPACE
+
+/*
+ * Permute the dimensions of A in place, without a second buffer. A must be
+ * densely packed (in any storage order). On exit, the data of A holds
+ * A.scalar*A with the indices idx_B, where dimension i has the length of
+ * dimension idx_B[i] of A and the stride stride_B[i]. The storage order is
+ * kept by position: if A was column-major (row-major) then so is the result.
+ */
+TBLIS_EXPORT
+void tblis_tensor_permute(const tblis_comm* comm,
+                          const tblis_config* cntx,
+                                tblis_tensor* A,
+                          const label_type* idx_A,
+                          const label_type* idx_B,
+                                stride_type* stride_B);
+
+#if TBLIS_ENABLE_CPLUSPLUS
+
+/*
+ * Returns the strides of the permuted tensor.
+ */
+inline
+stride_vector permute(const communicator& comm,
+                            tensor_wrapper&& A,
+                      const label_vector& idx_A,
+                      const label_vector& idx_B)
+{
+    TBLIS_ASSERT(A.ndim == idx_A.size());
+    TBLIS_ASSERT(A.ndim == idx_B.size());
+
+    stride_vector stride_B(A.ndim);
+    tblis_tensor_permute(comm, nullptr, &A, idx_A.data(), idx_B.data(), stride_B.data());
+    return stride_B;
+}
+
+TBLIS_COMPAT_INLINE
+stride_vector permute(      tensor_wrapper&& A,
+                      const label_vector& idx_A,
+                      const label_vector& idx_B)
+{
+    return permute(*(communicator*)nullptr, std::move(A), idx_A, idx_B);
+}
+
+#endif
+
+TBLIS_END_NAMESPACE
+
+#pragma GCC diagnostic pop
+
+#endif
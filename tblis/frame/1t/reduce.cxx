@@ -2,8 +2,11 @@
 
 #include "tblis/plugin/bli_plugin_tblis.h"
 
+#include "tblis/frame/base/env.hpp"
 #include "tblis/frame/base/tensor.hpp"
+#include "tblis/frame/base/stats.hpp"
 
+#include "tblis/frame/1t/dense/convert.hpp"
 #include "tblis/frame/1t/dense/reduce.hpp"
 #include "tblis/frame/1t/dpd/reduce.hpp"
 #include "tblis/frame/1t/indexed/reduce.hpp"
@@ -22,8 +25,9 @@ void tblis_tensor_reduce(const tblis_comm* comm,
                          len_type* idx)
 {
     internal::initialize_once();
+    internal::stats_scope stats(comm);
 
-    TBLIS_ASSERT(A->type == result->type);
+    TBLIS_ASSERT(internal::value_type(A->type) == result->type);
 
     auto ndim_A = A->ndim;
     len_vector len_A;
@@ -62,12 +66,93 @@ void tblis_tensor_reduce(const tblis_comm* comm,
         *result *= A->scalar;
 }
 
+TBLIS_EXPORT
+void tblis_tensor_reduce_multi(const tblis_comm* comm,
+                               const tblis_config* cntx,
+                               unsigned ops,
+                               const tblis_tensor* A,
+                               const label_type* idx_A_,
+                               tblis_scalar* result,
+                               len_type* idx)
+{
+    internal::initialize_once();
+    internal::stats_scope stats(comm);
+
+    auto ndim_A = A->ndim;
+    len_vector len_A;
+    stride_vector stride_A;
+    label_vector idx_A;
+    diagonal(ndim_A, A->len, A->stride, idx_A_, len_A, stride_A, idx_A);
+
+    if (idx_A.empty())
+    {
+        len_A.push_back(1);
+        stride_A.push_back(0);
+        idx_A.push_back(0);
+    }
+
+    fold(len_A, idx_A, stride_A);
+
+    /*
+     * A negative scalar exchanges the minimum and maximum.
+     */
+    auto swap = A->scalar.is_negative();
+    if (swap && ((ops >> REDUCE_MIN) & 1 || (ops >> REDUCE_MAX) & 1))
+        ops |= (1u << REDUCE_MIN) | (1u << REDUCE_MAX);
+
+    const len_type ts = type_size[internal::value_type(A->type)];
+    std::vector<char> result_(TBLIS_NUM_REDUCE_OPS*ts);
+    len_type idx_[TBLIS_NUM_REDUCE_OPS];
+
+    parallelize_if(
+    [&](const communicator& comm)
+    {
+        internal::reduce_multi(A->type, comm, bli_gks_query_cntx(), ops, len_A,
+                               reinterpret_cast<char*>(A->data), stride_A,
+                               result_.data(), idx_);
+    }, comm);
+
+    for (auto op : range(TBLIS_NUM_REDUCE_OPS))
+    {
+        if (!((ops >> op) & 1)) continue;
+
+        auto from = op;
+        if (swap && op == REDUCE_MIN) from = REDUCE_MAX;
+        if (swap && op == REDUCE_MAX) from = REDUCE_MIN;
+
+        TBLIS_ASSERT(result[op].type == internal::value_type(A->type));
+
+        result[op].from(result_.data() + from*ts);
+        idx[op] = idx_[from];
+
+        if (A->conj) result[op].conj();
+
+        if (op == REDUCE_SUM_ABS || op == REDUCE_MAX_ABS || op == REDUCE_MIN_ABS || op == REDUCE_NORM_2)
+            result[op] *= abs(A->scalar);
+        else
+            result[op] *= A->scalar;
+    }
+}
+
+TBLIS_EXPORT
+void tblis_set_compensated_sum(int enabled)
+{
+    set_compensated_sum(enabled);
+}
+
+TBLIS_EXPORT
+int tblis_get_compensated_sum()
+{
+    return get_compensated_sum();
+}
+
 template <typename T>
 void reduce(const communicator& comm, reduce_t op,
             dpd_marray_view<const T> A, const label_vector& idx_A,
             T& result, len_type& idx)
 {
     internal::initialize_once();
+    internal::stats_scope stats(comm);
 
     (void)idx_A;
 
@@ -97,6 +182,7 @@ void reduce(const communicator& comm, reduce_t op,
             T& result, len_type& idx)
 {
     internal::initialize_once();
+    internal::stats_scope stats(comm);
 
     (void)idx_A;
 
@@ -126,6 +212,7 @@ void reduce(const communicator& comm, reduce_t op,
             T& result, len_type& idx)
 {
     internal::initialize_once();
+    internal::stats_scope stats(comm);
 
     (void)idx_A;
 
@@ -149,4 +236,94 @@ template void reduce(const communicator& comm, reduce_t op, \
                      T& result, len_type& idx);
 DO_FOREACH_TYPE
 
+template <typename T>
+void reduce_multi(const communicator& comm, unsigned ops,
+                  dpd_marray_view<const T> A, const label_vector& idx_A,
+                  T* result, len_type* idx)
+{
+    internal::initialize_once();
+    internal::stats_scope stats(comm);
+
+    (void)idx_A;
+
+    auto ndim_A = A.dimension();
+
+    for (auto i : range(1,ndim_A))
+    for (auto j : range(i))
+        TBLIS_ASSERT(idx_A[i] != idx_A[j]);
+
+    dim_vector idx_A_A = range(ndim_A);
+
+    internal::reduce_multi(type_tag<T>::value, comm, bli_gks_query_cntx(), ops,
+                           reinterpret_cast<dpd_marray_view<char>&>(A), idx_A_A,
+                           reinterpret_cast<char*>(result), idx);
+}
+
+#undef FOREACH_TYPE
+#define FOREACH_TYPE(T) \
+template void reduce_multi(const communicator& comm, unsigned ops, \
+                           dpd_marray_view<const T> A, const label_vector& idx_A, \
+                           T* result, len_type* idx);
+DO_FOREACH_TYPE
+
+template <typename T>
+void reduce_multi(const communicator& comm, unsigned ops,
+                  indexed_marray_view<const T> A, const label_vector& idx_A,
+                  T* result, len_type* idx)
+{
+    internal::initialize_once();
+    internal::stats_scope stats(comm);
+
+    (void)idx_A;
+
+    auto ndim_A = A.dimension();
+
+    for (auto i : range(1,ndim_A))
+    for (auto j : range(i))
+        TBLIS_ASSERT(idx_A[i] != idx_A[j]);
+
+    dim_vector idx_A_A = range(ndim_A);
+
+    internal::reduce_multi(type_tag<T>::value, comm, bli_gks_query_cntx(), ops,
+                           reinterpret_cast<indexed_marray_view<char>&>(A), idx_A_A,
+                           reinterpret_cast<char*>(result), idx);
+}
+
+#undef FOREACH_TYPE
+#define FOREACH_TYPE(T) \
+template void reduce_multi(const communicator& comm, unsigned ops, \
+                           indexed_marray_view<const T> A, const label_vector& idx_A, \
+                           T* result, len_type* idx);
+DO_FOREACH_TYPE
+
+template <typename T>
+void reduce_multi(const communicator& comm, unsigned ops,
+                  indexed_dpd_marray_view<const T> A, const label_vector& idx_A,
+                  T* result, len_type* idx)
+{
+    internal::initialize_once();
+    internal::stats_scope stats(comm);
+
+    (void)idx_A;
+
+    auto ndim_A = A.dimension();
+
+    for (auto i : range(1,ndim_A))
+    for (auto j : range(i))
+        TBLIS_ASSERT(idx_A[i] != idx_A[j]);
+
+    dim_vector idx_A_A = range(ndim_A);
+
+    internal::reduce_multi(type_tag<T>::value, comm, bli_gks_query_cntx(), ops,
+                           reinterpret_cast<indexed_dpd_marray_view<char>&>(A), idx_A_A,
+                           reinterpret_cast<char*>(result), idx);
+}
+
+#undef FOREACH_TYPE
+#define FOREACH_TYPE(T) \
+template void reduce_multi(const communicator& comm, unsigned ops, \
+                           indexed_dpd_marray_view<const T> A, const label_vector& idx_A, \
+                           T* result, len_type* idx);
+DO_FOREACH_TYPE
+
 }
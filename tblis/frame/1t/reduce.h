@@ -4,6 +4,10 @@
 #include "../base/thread.h"
 #include "../base/basic_types.h"
 
+#if TBLIS_ENABLE_CPLUSPLUS
+#include <array>
+#endif
+
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wnull-dereference"
 
@@ -19,6 +23,39 @@ void tblis_tensor_reduce(const tblis_comm* comm,
                          tblis_scalar* result,
                          len_type* idx);
 
+/*
+ * Compute several reductions of A in a single pass over the data. Bit op
+ * of ops requests the reduction op (see reduce_t), whose result is
+ * returned in result[op] and idx[op] as by tblis_tensor_reduce. result and
+ * idx must have TBLIS_NUM_REDUCE_OPS entries, and the entries of result
+ * must have the type of A.
+ */
+TBLIS_EXPORT
+void tblis_tensor_reduce_multi(const tblis_comm* comm,
+                               const tblis_config* cntx,
+                               unsigned ops,
+                               const tblis_tensor* A,
+                               const label_type* idx_A,
+                               tblis_scalar* result,
+                               len_type* idx);
+
+/*
+ * Enable (nonzero) or disable compensated (Kahan) summation in dot products
+ * and REDUCE_SUM reductions (but not tblis_tensor_reduce_multi) of dense
+ * tensors. This keeps the result accurate to nearly the working precision
+ * regardless of the number of terms, for a small extra cost in these
+ * bandwidth-bound operations. It is off by default, unless the
+ * TBLIS_COMPENSATED_SUM environment variable is nonzero.
+ *
+ * The setting is process-wide and is not synchronized: changing it while
+ * another thread is calling into TBLIS is a data race.
+ */
+TBLIS_EXPORT
+void tblis_set_compensated_sum(int enabled);
+
+TBLIS_EXPORT
+int tblis_get_compensated_sum();
+
 #if TBLIS_ENABLE_CPLUSPLUS
 
 template <typename T=scalar>
@@ -172,6 +209,95 @@ reduce_result<T> reduce(reduce_t op, const tensor_wrapper& A)
     return result;
 }
 
+/*
+ * The results of reduce_multi, indexed by reduce_t. Only the requested
+ * reductions are set.
+ */
+template <typename T=scalar>
+struct reduce_multi_result
+{
+    std::array<T,TBLIS_NUM_REDUCE_OPS> value;
+    std::array<len_type,TBLIS_NUM_REDUCE_OPS> idx;
+
+    reduce_multi_result(type_t)
+    : value(), idx() {}
+
+    const T& operator[](reduce_t op) const { return value[op]; }
+};
+
+template <>
+struct reduce_multi_result<scalar>
+{
+    std::array<scalar,TBLIS_NUM_REDUCE_OPS> value;
+    std::array<len_type,TBLIS_NUM_REDUCE_OPS> idx;
+
+    reduce_multi_result(type_t type)
+    : idx()
+    {
+        for (auto& v : value) v.reset(0.0, type);
+    }
+
+    const scalar& operator[](reduce_t op) const { return value[op]; }
+};
+
+constexpr unsigned reduce_ops() { return 0; }
+
+/*
+ * The bitmask requesting each of the given reductions.
+ */
+template <typename... Ops>
+constexpr unsigned reduce_ops(reduce_t op, Ops... ops)
+{
+    return (1u << op) | reduce_ops(ops...);
+}
+
+template <typename T=scalar>
+reduce_multi_result<T> reduce_multi(const communicator& comm,
+                                    unsigned ops,
+                                    const tensor_wrapper& A,
+                                    const label_vector& idx_A)
+{
+    reduce_multi_result<scalar> result_(A.type);
+    tblis_tensor_reduce_multi(comm, nullptr, ops, &A, idx_A.data(),
+                              result_.value.data(), result_.idx.data());
+
+    if constexpr (std::is_same_v<T,scalar>)
+    {
+        return result_;
+    }
+    else
+    {
+        reduce_multi_result<T> result(A.type);
+        for (auto op : range(TBLIS_NUM_REDUCE_OPS))
+            result.value[op] = result_.value[op].template get<T>();
+        result.idx = result_.idx;
+        return result;
+    }
+}
+
+template <typename T=scalar>
+reduce_multi_result<T> reduce_multi(const communicator& comm,
+                                    unsigned ops,
+                                    const tensor_wrapper& A)
+{
+    return reduce_multi<T>(comm, ops, A, tblis::idx(A));
+}
+
+template <typename T=scalar>
+reduce_multi_result<T> reduce_multi(unsigned ops,
+                                    const tensor_wrapper& A,
+                                    const label_vector& idx_A)
+{
+    return reduce_multi<T>(*(communicator*)nullptr, ops, A, idx_A);
+}
+
+template <typename T=scalar>
+reduce_multi_result<T> reduce_multi(unsigned ops,
+                                    const tensor_wrapper& A)
+{
+    return reduce_multi<T>(ops, A, tblis::idx(A));
+}
+
 #ifdef MARRAY_DPD_MARRAY_HPP
 
 template <typename T>
@@ -209,6 +335,37 @@ reduce_result<T> reduce(const communicator& comm, reduce_t op,
     return result;
 }
 
+template <typename T>
+void reduce_multi(const communicator& comm, unsigned ops, MArray::dpd_marray_view<const T> A,
+                  const label_vector& idx_A, T* result, len_type* idx);
+
+template <typename T>
+reduce_multi_result<T> reduce_multi(const communicator& comm, unsigned ops,
+                                    MArray::dpd_marray_view<const T> A, const label_vector& idx_A)
+{
+    reduce_multi_result<T> result(type_tag<T>::value);
+    reduce_multi(comm, ops, A, idx_A, result.value.data(), result.idx.data());
+    return result;
+}
+
+template <typename T>
+reduce_multi_result<T> reduce_multi(unsigned ops, MArray::dpd_marray_view<const T> A,
+                                    const label_vector& idx_A)
+{
+    reduce_multi_result<T> result(type_tag<T>::value);
+
+    parallelize
+    (
+        [&](const communicator& comm)
+        {
+            reduce_multi(comm, ops, A, idx_A, result.value.data(), result.idx.data());
+        },
+        tblis_get_num_threads()
+    );
+
+    return result;
+}
+
 #endif
 
 #ifdef MARRAY_INDEXED_MARRAY_HPP
@@ -248,6 +405,37 @@ reduce_result<T> reduce(const communicator& comm, reduce_t op,
     return result;
 }
 
+template <typename T>
+void reduce_multi(const communicator& comm, unsigned ops, MArray::indexed_marray_view<const T> A,
+                  const label_vector& idx_A, T* result, len_type* idx);
+
+template <typename T>
+reduce_multi_result<T> reduce_multi(const communicator& comm, unsigned ops,
+                                    MArray::indexed_marray_view<const T> A, const label_vector& idx_A)
+{
+    reduce_multi_result<T> result(type_tag<T>::value);
+    reduce_multi(comm, ops, A, idx_A, result.value.data(), result.idx.data());
+    return result;
+}
+
+template <typename T>
+reduce_multi_result<T> reduce_multi(unsigned ops, MArray::indexed_marray_view<const T> A,
+                                    const label_vector& idx_A)
+{
+    reduce_multi_result<T> result(type_tag<T>::value);
+
+    parallelize
+    (
+        [&](const communicator& comm)
+        {
+            reduce_multi(comm, ops, A, idx_A, result.value.data(), result.idx.data());
+        },
+        tblis_get_num_threads()
+    );
+
+    return result;
+}
+
 #endif
 
 #ifdef MARRAY_INDEXED_DPD_MARRAY_HPP
@@ -287,6 +475,37 @@ reduce_result<T> reduce(const communicator& comm, reduce_t op,
     return result;
 }
 
+template <typename T>
+void reduce_multi(const communicator& comm, unsigned ops, MArray::indexed_dpd_marray_view<const T> A,
+                  const label_vector& idx_A, T* result, len_type* idx);
+
+template <typename T>
+reduce_multi_result<T> reduce_multi(const communicator& comm, unsigned ops,
+                                    MArray::indexed_dpd_marray_view<const T> A, const label_vector& idx_A)
+{
+    reduce_multi_result<T> result(type_tag<T>::value);
+    reduce_multi(comm, ops, A, idx_A, result.value.data(), result.idx.data());
+    return result;
+}
+
+template <typename T>
+reduce_multi_result<T> reduce_multi(unsigned ops, MArray::indexed_dpd_marray_view<const T> A,
+                                    const label_vector& idx_A)
+{
+    reduce_multi_result<T> result(type_tag<T>::value);
+
+    parallelize
+    (
+        [&](const communicator& comm)
+        {
+            reduce_multi(comm, ops, A, idx_A, result.value.data(), result.idx.data());
+        },
+        tblis_get_num_threads()
+    );
+
+    return result;
+}
+
 #endif
 
 namespace internal
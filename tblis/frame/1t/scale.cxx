@@ -3,7 +3,9 @@
 #include "tblis/plugin/bli_plugin_tblis.h"
 
 #include "tblis/frame/base/tensor.hpp"
+#include "tblis/frame/base/stats.hpp"
 
+#include "tblis/frame/1t/dense/convert.hpp"
 #include "tblis/frame/1t/dense/scale.hpp"
 #include "tblis/frame/1t/dense/set.hpp"
 #include "tblis/frame/1t/dpd/scale.hpp"
@@ -23,6 +25,7 @@ void tblis_tensor_scale(const tblis_comm* comm,
                         const label_type* idx_A_)
 {
     internal::initialize_once();
+    internal::stats_scope stats(comm);
 
     auto ndim_A = A->ndim;
     len_vector len_A;
@@ -42,7 +45,13 @@ void tblis_tensor_scale(const tblis_comm* comm,
     parallelize_if(
     [&](const communicator& comm)
     {
-        if (A->scalar.is_zero())
+        if (internal::is_half(A->type))
+        {
+            if (!A->scalar.is_one())
+                internal::scale_half(A->type, comm, len_A, A->scalar.as<float>(),
+                                     reinterpret_cast<char*>(A->data), stride_A);
+        }
+        else if (A->scalar.is_zero())
         {
             internal::set(A->type, comm, bli_gks_query_cntx(), len_A,
                           A->scalar, reinterpret_cast<char*>(A->data), stride_A);
@@ -64,6 +73,7 @@ void scale(const communicator& comm,
            T alpha, dpd_marray_view<T> A, const label_vector& idx_A)
 {
     internal::initialize_once();
+    internal::stats_scope stats(comm);
 
     (void)idx_A;
 
@@ -98,6 +108,7 @@ void scale(const communicator& comm,
            T alpha, indexed_marray_view<T> A, const label_vector& idx_A)
 {
     internal::initialize_once();
+    internal::stats_scope stats(comm);
 
     (void)idx_A;
 
@@ -132,6 +143,7 @@ void scale(const communicator& comm,
            T alpha, indexed_dpd_marray_view<T> A, const label_vector& idx_A)
 {
     internal::initialize_once();
+    internal::stats_scope stats(comm);
 
     (void)idx_A;
 
@@ -3,7 +3,9 @@
 #include "tblis/plugin/bli_plugin_tblis.h"
 
 #include "tblis/frame/base/tensor.hpp"
+#include "tblis/frame/base/stats.hpp"
 
+#include "tblis/frame/1t/dense/convert.hpp"
 #include "tblis/frame/1t/dense/set.hpp"
 #include "tblis/frame/1t/dpd/set.hpp"
 #include "tblis/frame/1t/indexed/set.hpp"
@@ -20,7 +22,9 @@ void tblis_tensor_set(const tblis_comm* comm,
                       const label_type* idx_A_)
 {
     internal::initialize_once();
+    internal::stats_scope stats(comm);
 
+    TBLIS_ASSERT(!internal::is_half(A->type), "Half precision tensors are not supported by this operation");
     TBLIS_ASSERT(alpha->type == A->type);
 
     auto ndim_A = A->ndim;
@@ -54,6 +58,7 @@ void set(const communicator& comm,
          T alpha, dpd_marray_view<T> A, const label_vector& idx_A)
 {
     internal::initialize_once();
+    internal::stats_scope stats(comm);
 
     (void)idx_A;
 
@@ -80,6 +85,7 @@ void set(const communicator& comm,
          T alpha, indexed_marray_view<T> A, const label_vector& idx_A)
 {
     internal::initialize_once();
+    internal::stats_scope stats(comm);
 
     (void)idx_A;
 
@@ -106,6 +112,7 @@ void set(const communicator& comm,
          T alpha, indexed_dpd_marray_view<T> A, const label_vector& idx_A)
 {
     internal::initialize_once();
+    internal::stats_scope stats(comm);
 
     (void)idx_A;
 
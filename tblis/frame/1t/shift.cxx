@@ -3,7 +3,9 @@
 #include "tblis/plugin/bli_plugin_tblis.h"
 
 #include "tblis/frame/base/tensor.hpp"
+#include "tblis/frame/base/stats.hpp"
 
+#include "tblis/frame/1t/dense/convert.hpp"
 #include "tblis/frame/1t/dense/scale.hpp"
 #include "tblis/frame/1t/dense/set.hpp"
 #include "tblis/frame/1t/dense/shift.hpp"
@@ -28,7 +30,9 @@ void tblis_tensor_shift(const tblis_comm* comm,
                         const label_type* idx_A_)
 {
     internal::initialize_once();
+    internal::stats_scope stats(comm);
 
+    TBLIS_ASSERT(!internal::is_half(A->type), "Half precision tensors are not supported by this operation");
     TBLIS_ASSERT(alpha->type == A->type);
 
     auto ndim_A = A->ndim;
@@ -80,6 +84,7 @@ void shift(const communicator& comm,
            T alpha, T beta, dpd_marray_view<T> A, const label_vector& idx_A)
 {
     internal::initialize_once();
+    internal::stats_scope stats(comm);
 
     (void)idx_A;
 
@@ -122,6 +127,7 @@ void shift(const communicator& comm,
            T alpha, T beta, indexed_marray_view<T> A, const label_vector& idx_A)
 {
     internal::initialize_once();
+    internal::stats_scope stats(comm);
 
     (void)idx_A;
 
@@ -164,6 +170,7 @@ void shift(const communicator& comm,
            T alpha, T beta, indexed_dpd_marray_view<T> A, const label_vector& idx_A)
 {
     internal::initialize_once();
+    internal::stats_scope stats(comm);
 
     (void)idx_A;
 
@@ -4,10 +4,64 @@
 
 #include "tblis/frame/base/alignment.hpp"
 #include "tblis/frame/base/block_scatter.hpp"
+#include "tblis/frame/base/stats.hpp"
 
 namespace tblis
 {
 
+/*
+ * C = ct + beta*C for a microtile computed in another precision of the same
+ * domain. beta (and the arithmetic) is of type V, which differs from the
+ * type of C only when C is stored in half precision.
+ */
+template <typename T, typename U, typename V = U>
+static void xpbys_tile(dim_t m, dim_t n, const void* ct_, dim_t ld_ct,
+                       const void* beta_, void* c_,
+                       const stride_type* rscat_c, const stride_type* cscat_c)
+{
+    auto ct = static_cast<const T*>(ct_);
+    auto c = static_cast<U*>(c_);
+    auto beta = *static_cast<const V*>(beta_);
+
+    if (beta == V(0))
+    {
+        for (dim_t j = 0;j < n;j++)
+            for (dim_t i = 0;i < m;i++)
+                c[rscat_c[i] + cscat_c[j]] = U(V(ct[i + j*ld_ct]));
+    }
+    else
+    {
+        for (dim_t j = 0;j < n;j++)
+            for (dim_t i = 0;i < m;i++)
+                c[rscat_c[i] + cscat_c[j]] = U(V(ct[i + j*ld_ct]) +
+                                               beta*V(c[rscat_c[i] + cscat_c[j]]));
+    }
+}
+
+static void xpbys_tile(type_t type_ct, type_t type_c, dim_t m, dim_t n,
+                       const void* ct, dim_t ld_ct, const void* beta, void* c,
+                       const stride_type* rscat_c, const stride_type* cscat_c)
+{
+    if (type_ct == TYPE_DOUBLE && type_c == TYPE_FLOAT)
+        xpbys_tile<double,float>(m, n, ct, ld_ct, beta, c, rscat_c, cscat_c);
+    else if (type_ct == TYPE_FLOAT && type_c == TYPE_DOUBLE)
+        xpbys_tile<float,double>(m, n, ct, ld_ct, beta, c, rscat_c, cscat_c);
+    else if (type_ct == TYPE_DCOMPLEX && type_c == TYPE_SCOMPLEX)
+        xpbys_tile<dcomplex,scomplex>(m, n, ct, ld_ct, beta, c, rscat_c, cscat_c);
+    else if (type_ct == TYPE_SCOMPLEX && type_c == TYPE_DCOMPLEX)
+        xpbys_tile<scomplex,dcomplex>(m, n, ct, ld_ct, beta, c, rscat_c, cscat_c);
+    else if (type_ct == TYPE_FLOAT && type_c == TYPE_BFLOAT16)
+        xpbys_tile<float,bfloat16,float>(m, n, ct, ld_ct, beta, c, rscat_c, cscat_c);
+    else if (type_ct == TYPE_FLOAT && type_c == TYPE_FLOAT16)
+        xpbys_tile<float,float16,float>(m, n, ct, ld_ct, beta, c, rscat_c, cscat_c);
+    else if (type_ct == TYPE_DOUBLE && type_c == TYPE_BFLOAT16)
+        xpbys_tile<double,bfloat16,float>(m, n, ct, ld_ct, beta, c, rscat_c, cscat_c);
+    else if (type_ct == TYPE_DOUBLE && type_c == TYPE_FLOAT16)
+        xpbys_tile<double,float16,float>(m, n, ct, ld_ct, beta, c, rscat_c, cscat_c);
+    else
+        TBLIS_ASSERT(0);
+}
+
 void gemm_ker_bsmtc
      (
        const obj_t*     a,
@@ -21,6 +75,7 @@ void gemm_ker_bsmtc
     auto dt_a     = bli_obj_dt( a );
     auto dt_b     = bli_obj_dt( b );
     auto dt_c     = bli_obj_dt( c );
+    auto dt_exec  = bli_obj_exec_dt( c );
 
     auto schema_a = bli_obj_pack_schema( a );
     auto schema_b = bli_obj_pack_schema( b );
@@ -69,11 +124,21 @@ void gemm_ker_bsmtc
     auto MR = pd_a;
     auto NR = pd_b;
 
-    auto gemm_ukr = reinterpret_cast<gemm_bsmtc_ft>(bli_cntx_get_ukr_dt(dt_c, GEMM_BSMTC_UKR, cntx));
+    auto gemm_ukr = reinterpret_cast<gemm_bsmtc_ft>(bli_cntx_get_ukr_dt(dt_exec, GEMM_BSMTC_UKR, cntx));
     auto params   = static_cast<const bsmtc_params*>(bli_gemm_var_cntl_real_ukr(cntl) ?
                                                      bli_gemm_var_cntl_real_params(cntl) :
                                                      bli_gemm_var_cntl_params(cntl));
 
+    // Half precision C is described to BLIS as float; the actual element
+    // size is needed for the scatter vectors, and every microtile is
+    // converted when it is accumulated.
+    auto type_c   = static_cast<type_t>(dt_c);
+    if (params->storage_type == TYPE_BFLOAT16 || params->storage_type == TYPE_FLOAT16)
+    {
+        type_c = params->storage_type;
+        dt_c_size = 2;
+    }
+
     //
     // Assumptions/assertions:
     //   rs_a == 1
@@ -182,36 +247,48 @@ void gemm_ker_bsmtc
     dim_t n_start, n_end, n_inc;
     bli_thread_range_sl(irjr_tid, irjr_nt, n_iter, 1, FALSE, &n_start, &n_end, &n_inc);
 
-    if (m_start < m_iter)
-    fill_block_scatter(dt_c_size,
-                       params->nblock[0],
-                       params->block_off[0],
-                       params->ndim[0],
-                       params->len[0],
-                       params->stride[0],
-                       MR,
-                       off_m + m_start*MR,
-                       std::min(m_end*MR, m) - m_start*MR,
-                       rscat_c + m_start*MR,
-                       rbs_c + m_start,
-                       params->pack_3d[0]);
-
-    if (n_start < n_iter)
-    fill_block_scatter(dt_c_size,
-                       params->nblock[1],
-                       params->block_off[1],
-                       params->ndim[1],
-                       params->len[1],
-                       params->stride[1],
-                       NR,
-                       off_n + n_start*NR,
-                       std::min(n_end*NR, n) - n_start*NR,
-                       cscat_c + n_start*NR,
-                       cbs_c + n_start,
-                       params->pack_3d[1]);
+    {
+        internal::stats_timer timer(internal::STATS_SCATTER);
+
+        if (m_start < m_iter)
+        fill_block_scatter(dt_c_size,
+                           params->nblock[0],
+                           params->block_off[0],
+                           params->ndim[0],
+                           params->len[0],
+                           params->stride[0],
+                           MR,
+                           off_m + m_start*MR,
+                           std::min(m_end*MR, m) - m_start*MR,
+                           rscat_c + m_start*MR,
+                           rbs_c + m_start,
+                           params->pack_3d[0]);
+
+        if (n_start < n_iter)
+        fill_block_scatter(dt_c_size,
+                           params->nblock[1],
+                           params->block_off[1],
+                           params->ndim[1],
+                           params->len[1],
+                           params->stride[1],
+                           NR,
+                           off_n + n_start*NR,
+                           std::min(n_end*NR, n) - n_start*NR,
+                           cscat_c + n_start*NR,
+                           cbs_c + n_start,
+                           params->pack_3d[1]);
+    }
 
     bli_thrinfo_barrier(thread_par);
 
+    internal::stats_timer timer(internal::STATS_KERNEL);
+
+    // Scratch space for microtiles computed in a precision other than
+    // that of C.
+    char ct[BLIS_STACK_BUF_MAX_SIZE] __attribute__((aligned(BLIS_STACK_BUF_ALIGN_SIZE)));
+    auto zero_exec = bli_obj_buffer_for_const( dt_exec, &BLIS_ZERO );
+    stride_type zero_off = 0;
+
     // Loop over the n dimension (NR columns at a time).
     for ( dim_t j = jr_start; j < jr_end && n_ut_for_me; j += jr_inc )
     {
@@ -246,20 +323,45 @@ void gemm_ker_bsmtc
 
             // Edge case handling now occurs within the microkernel itself.
             // Invoke the gemm micro-kernel.
-            gemm_ukr
-            (
-              m_cur,
-              n_cur,
-              k,
-              alpha_cast,
-              a1,
-              b1,
-              beta_cast,
-              c_cast, rbs_c[i], rscat_c + i*MR,
-                      cbs_c[j], cscat_c + j*NR,
-              &aux,
-              cntx
-            );
+            if (static_cast<type_t>(dt_exec) == type_c)
+            {
+                gemm_ukr
+                (
+                  m_cur,
+                  n_cur,
+                  k,
+                  alpha_cast,
+                  a1,
+                  b1,
+                  beta_cast,
+                  c_cast, rbs_c[i], rscat_c + i*MR,
+                          cbs_c[j], cscat_c + j*NR,
+                  &aux,
+                  cntx
+                );
+            }
+            else
+            {
+                // The microtile is computed in the execution precision and
+                // then converted while it is accumulated into C.
+                gemm_ukr
+                (
+                  m_cur,
+                  n_cur,
+                  k,
+                  alpha_cast,
+                  a1,
+                  b1,
+                  zero_exec,
+                  ct, 1, &zero_off,
+                      MR, &zero_off,
+                  &aux,
+                  cntx
+                );
+
+                xpbys_tile(static_cast<type_t>(dt_exec), type_c, m_cur, n_cur, ct, MR, beta_cast,
+                           c_cast, rscat_c + i*MR, cscat_c + j*NR);
+            }
 
             // Decrement the number of microtiles assigned to the thread; once
             // it reaches zero, return immediately.
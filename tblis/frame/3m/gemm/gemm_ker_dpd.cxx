@@ -4,6 +4,7 @@
 
 #include "tblis/frame/base/alignment.hpp"
 #include "tblis/frame/base/dpd_block_scatter.hpp"
+#include "tblis/frame/base/stats.hpp"
 
 namespace tblis
 {
@@ -173,13 +174,19 @@ void gemm_ker_dpd
 
             bli_thrinfo_barrier(thread_par);
 
-            auto c0 = fill_block_scatter(dt_c_size, bli_thrinfo_am_chief(thread), params, MR, NR,
-                                         m_patch, m_patch_off, m_patch_size,
-                                         n_patch, n_patch_off, n_patch_size,
-                                         rscat_c, cscat_c, rbs_c, cbs_c);
+            char* c0;
+            {
+                internal::stats_timer timer(internal::STATS_SCATTER);
+                c0 = fill_block_scatter(dt_c_size, bli_thrinfo_am_chief(thread), params, MR, NR,
+                                        m_patch, m_patch_off, m_patch_size,
+                                        n_patch, n_patch_off, n_patch_size,
+                                        rscat_c, cscat_c, rbs_c, cbs_c);
+            }
 
             bli_thrinfo_barrier(thread_par);
 
+            internal::stats_timer timer(internal::STATS_KERNEL);
+
             // Loop over the n dimension (NR columns at a time).
             for ( dim_t j = jr_start; j < jr_end && n_ut_for_me; j += jr_inc )
             {
@@ -0,0 +1,798 @@
+#include "antisym.h"
+
+#include "tblis/plugin/bli_plugin_tblis.h"
+
+#include "tblis/frame/1t/scale.h"
+#include "tblis/frame/3t/dense/mult.hpp"
+
+#include "tblis/frame/base/tensor.hpp"
+#include "tblis/frame/base/stats.hpp"
+
+#include <algorithm>
+#include <array>
+#include <map>
+
+namespace tblis
+{
+namespace internal
+{
+
+static stride_type binomial(len_type n, int k)
+{
+    if (k < 0 || k > n) return 0;
+
+    stride_type b = 1;
+    for (auto i : range(k))
+        b = b*(n-i)/(i+1);
+    return b;
+}
+
+static int parity(const label_vector& idx)
+{
+    auto inversions = 0;
+    for (auto i : range(idx.size()))
+    for (auto j : range(i+1,idx.size()))
+        if (idx[i] > idx[j]) inversions++;
+    return inversions%2 ? -1 : 1;
+}
+
+/*
+ * The sign of the permutation which sorts the values of a group, and the
+ * colexicographic position of the sorted values among the unique elements.
+ * The sign is 0 if any value is repeated.
+ */
+static std::pair<int,stride_type> colex(len_vector s)
+{
+    auto sign = 1;
+    for (auto i : range(1,int(s.size())))
+    for (auto j = i;j > 0 && s[j-1] >= s[j];j--)
+    {
+        if (s[j-1] == s[j]) return {0, 0};
+        std::swap(s[j-1], s[j]);
+        sign = -sign;
+    }
+
+    stride_type pos = 0;
+    for (auto m : range(s.size()))
+        pos += binomial(s[m], m+1);
+
+    return {sign, pos};
+}
+
+struct antisym_group
+{
+    int ndim;
+    len_type len;
+    label_vector idx;
+    label_type label;
+    bool intact;
+};
+
+static std::vector<antisym_group> make_groups(const tblis_antisym_tensor& A,
+                                              const label_type* idx_A)
+{
+    std::vector<antisym_group> groups;
+
+    for (auto g : range(A.packed.ndim))
+    {
+        antisym_group group;
+        group.ndim = A.group_ndim[g];
+        group.len = A.group_len[g];
+        group.idx.assign(idx_A, idx_A+group.ndim);
+        group.label = group.ndim == 1 ? group.idx[0] : 0;
+        group.intact = group.ndim == 1;
+        idx_A += group.ndim;
+
+        TBLIS_ASSERT(group.ndim > 0);
+        TBLIS_ASSERT(A.packed.len[g] == binomial(group.len, group.ndim));
+
+        groups.push_back(group);
+    }
+
+    return groups;
+}
+
+/*
+ * One dimension of an elementwise copy between packed and dense storage:
+ * the offsets of each position in A and B, and the sign of A's element (0
+ * if it vanishes).
+ */
+struct scatter_dim
+{
+    stride_vector off_A;
+    stride_vector off_B;
+    std::vector<int> sign;
+};
+
+/*
+ * The scatter dimensions for one group, which is stored packed at the given
+ * stride in one tensor and unpacked with one stride per index in the other.
+ * Only the positions of the packed tensor are enumerated, or when expanding
+ * every element of the unpacked group.
+ */
+static scatter_dim scatter_group(const antisym_group& group, stride_type stride_P,
+                                 const stride_vector& stride_U, bool expand)
+{
+    scatter_dim dim;
+
+    auto k = group.ndim;
+    auto n = group.len;
+
+    if (!expand)
+    {
+        /*
+         * The strictly increasing tuples, which are visited in colexicographic
+         * order and so at consecutive positions.
+         */
+        auto npos = binomial(n, k);
+        dim.off_A.resize(npos);
+        dim.off_B.resize(npos);
+        dim.sign.assign(npos, 1);
+
+        len_vector s(k);
+        for (auto m : range(k))
+            s[m] = m;
+
+        for (auto pos : range(npos))
+        {
+            stride_type off_U = 0;
+            for (auto m : range(k))
+                off_U += s[m]*stride_U[m];
+
+            dim.off_A[pos] = off_U;
+            dim.off_B[pos] = pos*stride_P;
+
+            auto m = 0;
+            for (;m+1 < k && s[m]+1 == s[m+1];m++)
+                s[m] = m;
+            s[m]++;
+        }
+
+        return dim;
+    }
+
+    if (n == 0) return dim;
+
+    len_vector s(k);
+    while (true)
+    {
+        stride_type off_U = 0;
+        for (auto m : range(k))
+            off_U += s[m]*stride_U[m];
+
+        auto [sign, pos] = colex(s);
+
+        dim.off_A.push_back(pos*stride_P);
+        dim.off_B.push_back(off_U);
+        dim.sign.push_back(sign);
+
+        auto m = 0;
+        for (;m < k;m++)
+        {
+            if (++s[m] < n) break;
+            s[m] = 0;
+        }
+        if (m == k) break;
+    }
+
+    return dim;
+}
+
+/*
+ * B = alpha*A + beta*B elementwise over the product of the scatter
+ * dimensions.
+ */
+template <typename T>
+static void scatter_add(const communicator& comm, const std::vector<scatter_dim>& dims,
+                        T alpha, bool conj_A, const T* A,
+                        T  beta, bool conj_B,       T* B)
+{
+    stride_type n = 1;
+    for (auto& dim : dims)
+        n *= dim.off_A.size();
+
+    comm.distribute_over_threads(n,
+    [&](len_type n_min, len_type n_max)
+    {
+        len_vector pos(dims.size());
+        auto rem = n_min;
+        for (auto i : range(dims.size()))
+        {
+            pos[i] = rem % dims[i].off_A.size();
+            rem /= dims[i].off_A.size();
+        }
+
+        for (auto i = n_min;i < n_max;i++)
+        {
+            stride_type off_A = 0;
+            stride_type off_B = 0;
+            auto sign = 1;
+            for (auto j : range(dims.size()))
+            {
+                off_A += dims[j].off_A[pos[j]];
+                off_B += dims[j].off_B[pos[j]];
+                sign *= dims[j].sign[pos[j]];
+            }
+
+            auto a = sign ? T(sign)*alpha*conj(conj_A, A[off_A]) : T();
+            B[off_B] = beta == T(0) ? a : a + beta*conj(conj_B, B[off_B]);
+
+            for (auto j : range(dims.size()))
+            {
+                if (++pos[j] < len_type(dims[j].off_A.size())) break;
+                pos[j] = 0;
+            }
+        }
+    });
+
+    comm.barrier();
+}
+
+static void scatter_add(type_t type, const tblis_comm* comm, const std::vector<scatter_dim>& dims,
+                        const tblis_scalar& alpha, bool conj_A, const void* A,
+                        const tblis_scalar&  beta, bool conj_B,       void* B)
+{
+    parallelize_if(
+    [&](const communicator& comm)
+    {
+        switch (type)
+        {
+            case TYPE_FLOAT:
+                scatter_add(comm, dims, alpha.data.s, conj_A, static_cast<const float*>(A),
+                                         beta.data.s, conj_B, static_cast<float*>(B));
+                break;
+            case TYPE_DOUBLE:
+                scatter_add(comm, dims, alpha.data.d, conj_A, static_cast<const double*>(A),
+                                         beta.data.d, conj_B, static_cast<double*>(B));
+                break;
+            case TYPE_SCOMPLEX:
+                scatter_add(comm, dims, alpha.data.c, conj_A, static_cast<const scomplex*>(A),
+                                         beta.data.c, conj_B, static_cast<scomplex*>(B));
+                break;
+            case TYPE_DCOMPLEX:
+                scatter_add(comm, dims, alpha.data.z, conj_A, static_cast<const dcomplex*>(A),
+                                         beta.data.z, conj_B, static_cast<dcomplex*>(B));
+                break;
+        }
+    }, comm);
+}
+
+/*
+ * The scatter dimensions between a packed antisymmetric tensor and a dense
+ * tensor with the same labels, with A the packed tensor if expand is true.
+ */
+static std::vector<scatter_dim> scatter_dims(const tblis_antisym_tensor& P, const label_type* idx_P,
+                                             const tblis_tensor& U, const label_type* idx_U,
+                                             bool expand)
+{
+    auto groups = make_groups(P, idx_P);
+
+    auto ndim = 0;
+    for (auto& group : groups)
+        ndim += group.ndim;
+    TBLIS_ASSERT(ndim == U.ndim);
+
+    std::vector<scatter_dim> dims;
+    for (auto g : range(groups.size()))
+    {
+        stride_vector stride_U;
+        for (auto l : groups[g].idx)
+        {
+            auto it = std::find(idx_U, idx_U+U.ndim, l);
+            TBLIS_ASSERT(it != idx_U+U.ndim);
+            TBLIS_ASSERT(U.len[it-idx_U] == groups[g].len);
+            stride_U.push_back(U.stride[it-idx_U]);
+        }
+
+        dims.push_back(scatter_group(groups[g], P.packed.stride[g], stride_U, expand));
+    }
+
+    return dims;
+}
+
+struct antisym_label
+{
+    label_type label;
+    len_type len;
+    int ops = 0;
+    bool scattered = false;
+    bool fixed = false;
+};
+
+/*
+ * The dimension of the GEMM (0 = m, 1 = n, 2 = k) to which a label shared
+ * by the given operands (as a bit mask of A, B, and C) belongs, or -1 for
+ * labels shared by all three.
+ */
+static int label_dim(int ops)
+{
+    switch (ops)
+    {
+        case 5: return 0;
+        case 6: return 1;
+        case 3: return 2;
+        case 7: return -1;
+    }
+
+    TBLIS_ASSERT(0, "every label must appear in at least two operands");
+    return -1;
+}
+
+/*
+ * One operand of an antisymmetric contraction: its regular dimensions
+ * (including each intact group under its common label), and its broken
+ * groups, which are addressed one unique element at a time. Labels are
+ * referred to by their position in the list of all labels.
+ */
+struct antisym_operand
+{
+    char* data = nullptr;
+    std::vector<int> reg;
+    stride_vector reg_stride;
+    std::vector<std::vector<int>> groups;
+    stride_vector group_stride;
+    std::vector<int> group_dim;
+    bool output = false;
+
+    stride_type stride(int id) const
+    {
+        auto it = std::find(reg.begin(), reg.end(), id);
+        return it == reg.end() ? 0 : reg_stride[it-reg.begin()];
+    }
+
+    /*
+     * The sign and offset of the element of broken group g with the label
+     * values val. The sign is 0 for elements which vanish or, in the output,
+     * are not stored.
+     */
+    std::pair<int,stride_type> group(int g, const len_vector& val) const
+    {
+        len_vector s;
+        for (auto id : groups[g])
+            s.push_back(val[id]);
+
+        auto [sign, pos] = colex(s);
+        if (output && sign < 0) sign = 0;
+
+        return {sign, pos*group_stride[g]};
+    }
+};
+
+/*
+ * Calls func() for every combination of values of the given labels, which
+ * are stored in val.
+ */
+template <typename Func>
+static void for_each_value(const std::vector<int>& ids, const std::vector<antisym_label>& labels,
+                           len_vector& val, Func&& func)
+{
+    for (auto id : ids)
+    {
+        if (labels[id].len == 0) return;
+        val[id] = 0;
+    }
+
+    while (true)
+    {
+        func();
+
+        auto i = 0;
+        for (;i < int(ids.size());i++)
+        {
+            if (++val[ids[i]] < labels[ids[i]].len) break;
+            val[ids[i]] = 0;
+        }
+        if (i == int(ids.size())) return;
+    }
+}
+
+/*
+ * The block offsets of the two operands sharing one GEMM dimension, for
+ * each combination of values of its scattered labels, split by sign.
+ */
+struct antisym_blocks
+{
+    std::array<stride_vector,2> off;
+};
+
+}
+}
+
+TBLIS_BEGIN_NAMESPACE
+
+void tblis_tensor_mult_antisym(const tblis_comm* comm, const tblis_config* cntx,
+                               const tblis_antisym_tensor* A, const label_type* idx_A,
+                               const tblis_antisym_tensor* B, const label_type* idx_B,
+                                     tblis_antisym_tensor* C, const label_type* idx_C)
+{
+    using namespace internal;
+
+    initialize_once();
+    stats_scope stats(comm);
+
+    auto type = C->packed.type;
+    TBLIS_ASSERT(A->packed.type == type);
+    TBLIS_ASSERT(B->packed.type == type);
+
+    std::array<const tblis_antisym_tensor*,3> ops = {A, B, C};
+    std::array<std::vector<antisym_group>,3> groups =
+        {make_groups(*A, idx_A), make_groups(*B, idx_B), make_groups(*C, idx_C)};
+
+    label_vector used;
+    for (auto& op : groups)
+    for (auto& group : op)
+        used.insert(used.end(), group.idx.begin(), group.idx.end());
+
+    label_type next_label = 1;
+    auto fresh_label = [&]
+    {
+        while (std::find(used.begin(), used.end(), next_label) != used.end()) next_label++;
+        used.push_back(next_label);
+        return next_label;
+    };
+
+    /*
+     * A group of two or more indices is intact if every other operand which
+     * shares any of its labels has a group with exactly the same labels.
+     * Intact groups are contracted in packed form under a common label;
+     * the unique elements of the others are gathered while packing.
+     */
+    auto sorted = [](label_vector idx)
+    {
+        std::sort(idx.begin(), idx.end());
+        return idx;
+    };
+
+    std::map<label_vector,label_type> intact_label;
+    tblis_scalar factor(1.0, type);
+
+    for (auto i : range(3))
+    for (auto& group : groups[i])
+    {
+        if (group.ndim == 1) continue;
+
+        auto set = sorted(group.idx);
+        auto shared = false;
+        auto intact = true;
+        auto contracted = i != 2;
+
+        for (auto j : range(3))
+        {
+            if (j == i) continue;
+
+            auto has_any = false;
+            auto has_match = false;
+            for (auto& other : groups[j])
+            {
+                for (auto l : other.idx)
+                    if (std::binary_search(set.begin(), set.end(), l)) has_any = true;
+
+                if (sorted(other.idx) == set && other.len == group.len)
+                    has_match = true;
+            }
+
+            if (has_any)
+            {
+                shared = true;
+                if (!has_match) intact = false;
+                if (j == 2) contracted = false;
+            }
+        }
+
+        group.intact = shared && intact;
+
+        if (!group.intact)
+        {
+            group.label = fresh_label();
+            continue;
+        }
+
+        auto it = intact_label.find(set);
+        if (it == intact_label.end())
+        {
+            it = intact_label.emplace(set, fresh_label()).first;
+
+            // Each unique element appears k! times in the full sum.
+            if (contracted)
+                for (auto m : range(2,group.ndim+1))
+                    factor *= tblis_scalar(double(m), type);
+        }
+
+        group.label = it->second;
+
+        if (parity(group.idx) < 0)
+            factor *= tblis_scalar(-1.0, type);
+    }
+
+    std::vector<antisym_label> labels;
+    auto label_id = [&](label_type label, len_type len, int op)
+    {
+        auto it = std::find_if(labels.begin(), labels.end(),
+                               [&](const antisym_label& l) { return l.label == label; });
+
+        if (it == labels.end())
+        {
+            labels.push_back({label, len});
+            it = labels.end()-1;
+        }
+
+        TBLIS_ASSERT(it->len == len);
+        TBLIS_ASSERT(!(it->ops & (1 << op)));
+        it->ops |= 1 << op;
+
+        return int(it - labels.begin());
+    };
+
+    std::array<antisym_operand,3> operands;
+    for (auto i : range(3))
+    {
+        auto& op = operands[i];
+        op.data = static_cast<char*>(ops[i]->packed.data);
+        op.output = i == 2;
+
+        for (auto g : range(groups[i].size()))
+        {
+            auto& group = groups[i][g];
+            auto stride = ops[i]->packed.stride[g];
+
+            if (group.intact)
+            {
+                op.reg.push_back(label_id(group.label, ops[i]->packed.len[g], i));
+                op.reg_stride.push_back(stride);
+                continue;
+            }
+
+            std::vector<int> ids;
+            for (auto l : group.idx)
+            {
+                ids.push_back(label_id(l, group.len, i));
+                labels[ids.back()].scattered = true;
+            }
+
+            op.groups.push_back(ids);
+            op.group_stride.push_back(stride);
+        }
+    }
+
+    /*
+     * The unique elements of a broken group are enumerated along only one
+     * dimension of the GEMM, as block offsets when the operands are packed.
+     * Its labels belonging to the other dimensions are fixed and looped over
+     * instead, as are the labels shared by all three operands. The dimension
+     * of the largest extent is kept, preferring k.
+     */
+    for (auto& label : labels)
+        label.fixed = label_dim(label.ops) == -1;
+
+    for (auto changed = true;changed;)
+    {
+        changed = false;
+
+        for (auto& op : operands)
+        for (auto& group : op.groups)
+        {
+            std::array<bool,3> present = {false, false, false};
+            std::array<stride_type,3> extent = {1, 1, 1};
+            for (auto id : group)
+            {
+                if (labels[id].fixed) continue;
+                auto d = label_dim(labels[id].ops);
+                present[d] = true;
+                extent[d] *= labels[id].len;
+            }
+
+            auto keep = -1;
+            for (auto d : {2, 0, 1})
+                if (present[d] && (keep == -1 || extent[d] > extent[keep])) keep = d;
+
+            for (auto id : group)
+            {
+                if (labels[id].fixed || label_dim(labels[id].ops) == keep) continue;
+                labels[id].fixed = true;
+                changed = true;
+            }
+        }
+    }
+
+    for (auto& op : operands)
+    for (auto& group : op.groups)
+    {
+        auto dim = -1;
+        for (auto id : group)
+            if (!labels[id].fixed) dim = label_dim(labels[id].ops);
+        op.group_dim.push_back(dim);
+    }
+
+    // The operands sharing the m, n, and k dimensions.
+    constexpr int pair[3][2] = {{0, 2}, {1, 2}, {0, 1}};
+
+    std::vector<int> fixed;
+    std::array<std::vector<int>,3> scattered;
+    std::array<len_vector,3> len;
+    std::array<std::array<stride_vector,2>,3> stride;
+    auto empty = false;
+
+    for (auto id : range(int(labels.size())))
+    {
+        auto& label = labels[id];
+        if (label.len == 0) empty = true;
+
+        if (label.fixed)
+        {
+            fixed.push_back(id);
+            continue;
+        }
+
+        auto d = label_dim(label.ops);
+
+        if (label.scattered)
+        {
+            scattered[d].push_back(id);
+            continue;
+        }
+
+        len[d].push_back(label.len);
+        for (auto j : range(2))
+            stride[d][j].push_back(operands[pair[d][j]].stride(id));
+    }
+
+    if (!C->packed.scalar.is_one() || C->packed.conj)
+    {
+        label_vector idx_C_;
+        for (auto& group : groups[2])
+            idx_C_.push_back(group.label);
+
+        tblis_tensor_scale(comm, cntx, &C->packed, idx_C_.data());
+    }
+
+    C->packed.scalar = 1;
+    C->packed.conj = false;
+
+    if (empty) return;
+
+    auto ts = type_size[type];
+    tblis_scalar one(1.0, type);
+
+    auto alpha = A->packed.scalar;
+    alpha *= B->packed.scalar;
+    alpha *= factor;
+
+    auto neg_alpha = alpha;
+    neg_alpha *= tblis_scalar(-1.0, type);
+
+    parallelize_if(
+    [&](const communicator& comm)
+    {
+        len_vector val(labels.size());
+
+        for_each_value(fixed, labels, val,
+        [&]
+        {
+            std::array<stride_type,3> off = {0, 0, 0};
+            auto sign = 1;
+
+            for (auto i : range(3))
+            {
+                auto& op = operands[i];
+
+                for (auto id : fixed)
+                    off[i] += op.stride(id)*val[id];
+
+                for (auto g : range(op.groups.size()))
+                {
+                    if (op.group_dim[g] != -1) continue;
+
+                    auto [sign_g, off_g] = op.group(g, val);
+                    sign *= sign_g;
+                    off[i] += off_g;
+                }
+            }
+
+            if (!sign) return;
+
+            std::array<std::array<antisym_blocks,2>,3> blocks;
+            for (auto d : range(3))
+            {
+                for_each_value(scattered[d], labels, val,
+                [&]
+                {
+                    std::array<stride_type,2> off_d = {0, 0};
+                    auto sign_d = 1;
+
+                    for (auto j : range(2))
+                    {
+                        auto& op = operands[pair[d][j]];
+
+                        for (auto id : scattered[d])
+                            off_d[j] += op.stride(id)*val[id];
+
+                        for (auto g : range(op.groups.size()))
+                        {
+                            if (op.group_dim[g] != d) continue;
+
+                            auto [sign_g, off_g] = op.group(g, val);
+                            sign_d *= sign_g;
+                            off_d[j] += off_g;
+                        }
+                    }
+
+                    if (!sign_d) return;
+
+                    auto& b = blocks[d][sign_d < 0];
+                    b.off[0].push_back(off_d[0]);
+                    b.off[1].push_back(off_d[1]);
+                });
+            }
+
+            for (auto sign_m : range(2))
+            for (auto sign_n : range(2))
+            for (auto sign_k : range(2))
+            {
+                auto& M = blocks[0][sign_m];
+                auto& N = blocks[1][sign_n];
+                auto& K = blocks[2][sign_k];
+
+                if (M.off[0].empty() || N.off[0].empty() || K.off[0].empty()) continue;
+
+                auto neg = (sign < 0) ^ sign_m ^ sign_n ^ sign_k;
+
+                gemm_bsmtc_blis(type, comm, bli_gks_query_cntx(),
+                                make_span(len[0]), false,
+                                make_span(len[1]), false,
+                                make_span(len[2]), false,
+                                neg ? neg_alpha : alpha,
+                                A->packed.conj, operands[0].data + off[0]*ts,
+                                make_span(M.off[0]), make_span(K.off[0]),
+                                make_span(stride[0][0]), make_span(stride[2][0]),
+                                B->packed.conj, operands[1].data + off[1]*ts,
+                                make_span(N.off[0]), make_span(K.off[1]),
+                                make_span(stride[1][0]), make_span(stride[2][1]),
+                                one, false, operands[2].data + off[2]*ts,
+                                make_span(M.off[1]), make_span(N.off[1]),
+                                make_span(stride[0][1]), make_span(stride[1][1]));
+            }
+        });
+    }, comm);
+}
+
+void tblis_antisym_pack(const tblis_comm* comm, const tblis_config* cntx,
+                        const tblis_tensor* A, const label_type* idx_A,
+                              tblis_antisym_tensor* B, const label_type* idx_B)
+{
+    using namespace internal;
+
+    initialize_once();
+    stats_scope stats(comm);
+
+    auto type = B->packed.type;
+    TBLIS_ASSERT(A->type == type);
+
+    scatter_add(type, comm, scatter_dims(*B, idx_B, *A, idx_A, false),
+                A->scalar, A->conj, A->data,
+                B->packed.scalar, B->packed.conj, B->packed.data);
+
+    B->packed.scalar = 1;
+    B->packed.conj = false;
+}
+
+void tblis_antisym_unpack(const tblis_comm* comm, const tblis_config* cntx,
+                          const tblis_antisym_tensor* A, const label_type* idx_A,
+                                tblis_tensor* B, const label_type* idx_B)
+{
+    using namespace internal;
+
+    initialize_once();
+    stats_scope stats(comm);
+
+    auto type = B->type;
+    TBLIS_ASSERT(A->packed.type == type);
+
+    scatter_add(type, comm, scatter_dims(*A, idx_A, *B, idx_B, true),
+                A->packed.scalar, A->packed.conj, A->packed.data,
+                B->scalar, B->conj, B->data);
+
+    B->scalar = 1;
+    B->conj = false;
+}
+
+TBLIS_END_NAMESPACE
@@ -0,0 +1,209 @@
+#ifndef _TBLIS_IFACE_3T_ANTISYM_H_
+#define _TBLIS_IFACE_3T_ANTISYM_H_
+
+#include "../base/thread.h"
+#include "../base/basic_types.h"
+
+#if TBLIS_ENABLE_CPLUSPLUS
+#include <vector>
+#endif
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wnull-dereference"
+
+TBLIS_BEGIN_NAMESPACE
+
+/*
+ * A tensor with one or more groups of antisymmetric indices, of which only
+ * the elements with strictly increasing index values within each group are
+ * stored. Group g consists of group_ndim[g] consecutive indices of length
+ * group_len[g], and corresponds to dimension g of packed, which has length
+ * binomial(group_len[g], group_ndim[g]). The values i_1 < ... < i_k of a
+ * group are stored at position sum_m binomial(i_m, m) (colexicographic
+ * order).
+ *
+ * Labels always refer to the unpacked indices, in group order.
+ */
+typedef struct tblis_antisym_tensor
+{
+    tblis_tensor packed;
+    const int* group_ndim;
+    const len_type* group_len;
+} tblis_antisym_tensor;
+
+/*
+ * C = A.scalar*B.scalar*A*B + C.scalar*C
+ *
+ * Only the unique elements of each operand are read. Antisymmetric groups
+ * which are shared whole between operands are contracted in packed form,
+ * with the permutational factors and signs folded into the scalar; groups
+ * which are split by the contraction are addressed element by element when
+ * the operands are packed for the GEMM, with any remaining indices looped
+ * over. Only the unique elements of C are computed; no implicit
+ * antisymmetrization is performed.
+ */
+TBLIS_EXPORT
+void tblis_tensor_mult_antisym(const tblis_comm* comm, const tblis_config* cntx,
+                               const tblis_antisym_tensor* A, const label_type* idx_A,
+                               const tblis_antisym_tensor* B, const label_type* idx_B,
+                                     tblis_antisym_tensor* C, const label_type* idx_C);
+
+/*
+ * B = A.scalar*A + B.scalar*B, reading only the elements of the dense
+ * tensor A with increasing index values within each group of B.
+ */
+TBLIS_EXPORT
+void tblis_antisym_pack(const tblis_comm* comm, const tblis_config* cntx,
+                        const tblis_tensor* A, const label_type* idx_A,
+                              tblis_antisym_tensor* B, const label_type* idx_B);
+
+/*
+ * B = A.scalar*A + B.scalar*B, where A is expanded to a dense tensor with
+ * full antisymmetry within each group.
+ */
+TBLIS_EXPORT
+void tblis_antisym_unpack(const tblis_comm* comm, const tblis_config* cntx,
+                          const tblis_antisym_tensor* A, const label_type* idx_A,
+                                tblis_tensor* B, const label_type* idx_B);
+
+#if TBLIS_ENABLE_CPLUSPLUS
+
+struct antisym_tensor : tblis_antisym_tensor
+{
+    tensor_wrapper packed_buf;
+    std::vector<int> group_ndim_buf;
+    len_vector group_len_buf;
+
+    antisym_tensor(tensor_wrapper packed_,
+                   std::vector<int> group_ndim_,
+                   len_vector group_len_)
+    : packed_buf(std::move(packed_)),
+      group_ndim_buf(std::move(group_ndim_)),
+      group_len_buf(std::move(group_len_))
+    {
+        TBLIS_ASSERT(group_ndim_buf.size() == packed_buf.ndim);
+        TBLIS_ASSERT(group_len_buf.size() == packed_buf.ndim);
+
+        if (!packed_buf.len_buf.empty())
+        {
+            packed_buf.len = packed_buf.len_buf.data();
+            packed_buf.stride = packed_buf.stride_buf.data();
+        }
+
+        packed = packed_buf;
+        group_ndim = group_ndim_buf.data();
+        group_len = group_len_buf.data();
+    }
+
+    antisym_tensor(const antisym_tensor&) = delete;
+
+    antisym_tensor& operator=(const antisym_tensor&) = delete;
+};
+
+inline
+void mult_antisym(const communicator& comm,
+                  const scalar& alpha,
+                  const tblis_antisym_tensor& A,
+                  const label_vector& idx_A,
+                  const tblis_antisym_tensor& B,
+                  const label_vector& idx_B,
+                  const scalar& beta,
+                  const tblis_antisym_tensor& C,
+                  const label_vector& idx_C)
+{
+    auto A_(A);
+    A_.packed.scalar *= alpha.convert(A_.packed.type);
+
+    auto C_(C);
+    C_.packed.scalar *= beta.convert(C_.packed.type);
+
+    tblis_tensor_mult_antisym(comm, nullptr, &A_, idx_A.data(), &B, idx_B.data(), &C_, idx_C.data());
+}
+
+inline
+void mult_antisym(const communicator& comm,
+                  const tblis_antisym_tensor& A,
+                  const label_vector& idx_A,
+                  const tblis_antisym_tensor& B,
+                  const label_vector& idx_B,
+                  const tblis_antisym_tensor& C,
+                  const label_vector& idx_C)
+{
+    mult_antisym(comm, {1.0, A.packed.type}, A, idx_A, B, idx_B, {0.0, A.packed.type}, C, idx_C);
+}
+
+TBLIS_COMPAT_INLINE
+void mult_antisym(const scalar& alpha,
+                  const tblis_antisym_tensor& A,
+                  const label_vector& idx_A,
+                  const tblis_antisym_tensor& B,
+                  const label_vector& idx_B,
+                  const scalar& beta,
+                  const tblis_antisym_tensor& C,
+                  const label_vector& idx_C)
+{
+    mult_antisym(*(communicator*)nullptr, alpha, A, idx_A, B, idx_B, beta, C, idx_C);
+}
+
+inline
+void mult_antisym(const tblis_antisym_tensor& A,
+                  const label_vector& idx_A,
+                  const tblis_antisym_tensor& B,
+                  const label_vector& idx_B,
+                  const tblis_antisym_tensor& C,
+                  const label_vector& idx_C)
+{
+    mult_antisym({1.0, A.packed.type}, A, idx_A, B, idx_B, {0.0, A.packed.type}, C, idx_C);
+}
+
+inline
+void pack_antisym(const communicator& comm,
+                  const tensor_wrapper& A,
+                  const label_vector& idx_A,
+                  const tblis_antisym_tensor& B,
+                  const label_vector& idx_B)
+{
+    auto B_(B);
+    B_.packed.scalar.reset(0.0, B_.packed.type);
+
+    tblis_antisym_pack(comm, nullptr, &A, idx_A.data(), &B_, idx_B.data());
+}
+
+TBLIS_COMPAT_INLINE
+void pack_antisym(const tensor_wrapper& A,
+                  const label_vector& idx_A,
+                  const tblis_antisym_tensor& B,
+                  const label_vector& idx_B)
+{
+    pack_antisym(*(communicator*)nullptr, A, idx_A, B, idx_B);
+}
+
+inline
+void unpack_antisym(const communicator& comm,
+                    const tblis_antisym_tensor& A,
+                    const label_vector& idx_A,
+                    const tensor_wrapper& B,
+                    const label_vector& idx_B)
+{
+    auto B_(B);
+    B_.scalar.reset(0.0, B_.type);
+
+    tblis_antisym_unpack(comm, nullptr, &A, idx_A.data(), &B_, idx_B.data());
+}
+
+TBLIS_COMPAT_INLINE
+void unpack_antisym(const tblis_antisym_tensor& A,
+                    const label_vector& idx_A,
+                    const tensor_wrapper& B,
+                    const label_vector& idx_B)
+{
+    unpack_antisym(*(communicator*)nullptr, A, idx_A, B, idx_B);
+}
+
+#endif
+
+TBLIS_END_NAMESPACE
+
+#pragma GCC diagnostic pop
+
+#endif
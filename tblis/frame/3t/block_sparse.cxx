@@ -0,0 +1,394 @@
+#include "block_sparse.h"
+
+#include "tblis/plugin/bli_plugin_tblis.h"
+#include "tblis/frame/1t/dense/scale.hpp"
+#include "tblis/frame/1t/dense/set.hpp"
+#include "tblis/frame/3t/dense/mult.hpp"
+
+#include "tblis/frame/base/tensor.hpp"
+#include "tblis/frame/base/stats.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <tuple>
+#include <unordered_map>
+
+namespace tblis
+{
+namespace internal
+{
+
+using block_key = std::vector<len_type>;
+
+struct block_key_hash
+{
+    size_t operator()(const block_key& key) const
+    {
+        size_t h = key.size();
+        for (auto k : key)
+            h ^= std::hash<len_type>{}(k) + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+        return h;
+    }
+};
+
+static dim_vector positions(const label_vector& idx, const label_vector& labels)
+{
+    dim_vector dims;
+    for (auto label : labels)
+        dims.push_back(std::find(idx.begin(), idx.end(), label) - idx.begin());
+    return dims;
+}
+
+/*
+ * Dimensions of one operand, split by which other operands share them.
+ */
+struct block_sparse_operand
+{
+    const tblis_block_sparse_tensor& T;
+    dim_vector dims[2];
+    dim_vector dims_ABC;
+
+    block_sparse_operand(const tblis_block_sparse_tensor& T,
+                         const label_vector& idx,
+                         const label_vector& idx_0,
+                         const label_vector& idx_1,
+                         const label_vector& idx_ABC)
+    : T(T), dims{positions(idx, idx_0), positions(idx, idx_1)},
+      dims_ABC(positions(idx, idx_ABC)) {}
+
+    const len_type* coords(len_type b) const
+    {
+        return T.block_idx + b*T.ndim;
+    }
+
+    /*
+     * The block coordinates along dims[i] and the batch dimensions.
+     */
+    block_key key(len_type b, int i) const
+    {
+        auto coord = coords(b);
+        block_key key;
+        for (auto d : dims[i]) key.push_back(coord[d]);
+        for (auto d : dims_ABC) key.push_back(coord[d]);
+        return key;
+    }
+
+    len_type length(len_type b, int d) const
+    {
+        return T.block_len[d][coords(b)[d]];
+    }
+
+    len_vector lengths(len_type b, const dim_vector& dims) const
+    {
+        len_vector len;
+        for (auto d : dims) len.push_back(length(b, d));
+        return len;
+    }
+
+    stride_vector strides(len_type b, const dim_vector& dims) const
+    {
+        stride_vector stride;
+        for (auto d : dims) stride.push_back(T.block_stride[b*T.ndim+d]);
+        return stride;
+    }
+
+    char* data(len_type b) const
+    {
+        return static_cast<char*>(T.block_data[b]);
+    }
+};
+
+static void check_partition(const block_sparse_operand& A, const dim_vector& dims_A,
+                            const block_sparse_operand& B, const dim_vector& dims_B)
+{
+    for (auto i : range(dims_A.size()))
+    {
+        auto nblock = A.T.nblock[dims_A[i]];
+        TBLIS_ASSERT(nblock == B.T.nblock[dims_B[i]]);
+        for (auto j : range(nblock))
+            TBLIS_ASSERT(A.T.block_len[dims_A[i]][j] == B.T.block_len[dims_B[i]][j]);
+    }
+}
+
+/*
+ * Products A(a)*B(b) contributing to a single block of C which have the same
+ * shape and layout, so that they may be computed by one call to
+ * gemm_bsmtc_blis with multiple blocks along the contracted dimension.
+ */
+struct block_product_group
+{
+    len_vector len_AB;
+    stride_vector stride_A_AC, stride_A_AB, stride_A_ABC;
+    stride_vector stride_B_BC, stride_B_AB, stride_B_ABC;
+    const char* data_A;
+    const char* data_B;
+    std::vector<stride_type> block_off_A;
+    std::vector<stride_type> block_off_B;
+};
+
+struct block_product
+{
+    len_type c, a, b;
+    stride_type cost;
+
+    bool operator<(const block_product& other) const
+    {
+        return std::tie(c, a, b) < std::tie(other.c, other.a, other.b);
+    }
+};
+
+static void mult_block_sparse(type_t type, const communicator& comm, const cntx_t* cntx,
+                              const scalar& alpha, bool conj_A, const block_sparse_operand& A,
+                                                   bool conj_B, const block_sparse_operand& B,
+                              const scalar&  beta, bool conj_C, const block_sparse_operand& C)
+{
+    auto ts = type_size[type];
+
+    /*
+     * Match blocks of A and B with equal AB and ABC coordinates by hashing,
+     * and look up the block of C which each product contributes to.
+     */
+    std::unordered_map<block_key,std::vector<len_type>,block_key_hash> blocks_B;
+    for (auto b : range(B.T.nnz_block))
+        blocks_B[B.key(b, 0)].push_back(b);
+
+    std::unordered_map<block_key,len_type,block_key_hash> blocks_C;
+    for (auto c : range(C.T.nnz_block))
+    {
+        auto key = C.key(c, 0);
+        auto key_BC = C.key(c, 1);
+        key.insert(key.end(), key_BC.begin(), key_BC.end());
+        auto inserted = blocks_C.emplace(key, c).second;
+        TBLIS_ASSERT(inserted);
+        (void)inserted;
+    }
+
+    std::vector<block_product> products;
+    for (auto a : range(A.T.nnz_block))
+    {
+        auto it = blocks_B.find(A.key(a, 1));
+        if (it == blocks_B.end()) continue;
+
+        auto key_AC = A.key(a, 0);
+        auto coord_A = A.coords(a);
+
+        stride_type size_A = 1;
+        for (auto d : range(A.T.ndim))
+            size_A *= A.length(a, d);
+
+        for (auto b : it->second)
+        {
+            auto key = key_AC;
+            auto coord_B = B.coords(b);
+            for (auto d : B.dims[1]) key.push_back(coord_B[d]);
+            for (auto d : A.dims_ABC) key.push_back(coord_A[d]);
+
+            auto c = blocks_C.find(key);
+            if (c == blocks_C.end()) continue;
+
+            stride_type cost = size_A;
+            for (auto d : B.dims[1])
+                cost *= B.length(b, d);
+
+            products.push_back({c->second, a, b, cost});
+        }
+    }
+
+    std::sort(products.begin(), products.end());
+
+    /*
+     * Each block of C is a task, and all tasks are scheduled in order of
+     * decreasing cost.
+     */
+    std::vector<stride_type> first(C.T.nnz_block+1, products.size());
+    std::vector<stride_type> cost(C.T.nnz_block);
+    for (auto i : range(products.size()))
+    {
+        cost[products[i].c] += products[i].cost;
+        first[products[i].c] = std::min(first[products[i].c], stride_type(i));
+    }
+    for (auto c = C.T.nnz_block-1;c >= 0;c--)
+        first[c] = std::min(first[c], first[c+1]);
+
+    std::vector<len_type> order(C.T.nnz_block);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&](len_type i, len_type j) { return cost[i] > cost[j]; });
+
+    auto total_cost = std::accumulate(cost.begin(), cost.end(), stride_type());
+
+    scalar one(1.0, type);
+
+    comm.do_tasks_deferred(order.size(), total_cost/std::max<len_type>(1, order.size())*inout_ratio,
+    [&](communicator::deferred_task_set& tasks)
+    {
+        for (auto task : range(order.size()))
+        {
+            tasks.visit(task,
+            [&,c=order[task]](const communicator& subcomm)
+            {
+                auto len_AC = C.lengths(c, C.dims[0]);
+                auto len_BC = C.lengths(c, C.dims[1]);
+                auto len_ABC = C.lengths(c, C.dims_ABC);
+                auto stride_C_AC = C.strides(c, C.dims[0]);
+                auto stride_C_BC = C.strides(c, C.dims[1]);
+                auto stride_C_ABC = C.strides(c, C.dims_ABC);
+                auto data_C = C.data(c);
+
+                if (first[c] == first[c+1])
+                {
+                    auto len_C = len_AC + len_BC + len_ABC;
+                    auto stride_C = stride_C_AC + stride_C_BC + stride_C_ABC;
+
+                    if (beta.is_zero())
+                        set(type, subcomm, cntx, len_C, beta, data_C, stride_C);
+                    else if (!beta.is_one() || (beta.is_complex() && conj_C))
+                        scale(type, subcomm, cntx, len_C, beta, conj_C, data_C, stride_C);
+
+                    return;
+                }
+
+                std::vector<block_product_group> groups;
+
+                for (auto i : range(first[c], first[c+1]))
+                {
+                    auto a = products[i].a;
+                    auto b = products[i].b;
+
+                    auto len_AB = A.lengths(a, A.dims[1]);
+                    auto stride_A_AC = A.strides(a, A.dims[0]);
+                    auto stride_A_AB = A.strides(a, A.dims[1]);
+                    auto stride_A_ABC = A.strides(a, A.dims_ABC);
+                    auto stride_B_BC = B.strides(b, B.dims[1]);
+                    auto stride_B_AB = B.strides(b, B.dims[0]);
+                    auto stride_B_ABC = B.strides(b, B.dims_ABC);
+
+                    auto group = std::find_if(groups.begin(), groups.end(),
+                    [&](const block_product_group& g)
+                    {
+                        return g.len_AB == len_AB &&
+                               g.stride_A_AC == stride_A_AC &&
+                               g.stride_A_AB == stride_A_AB &&
+                               g.stride_A_ABC == stride_A_ABC &&
+                               g.stride_B_BC == stride_B_BC &&
+                               g.stride_B_AB == stride_B_AB &&
+                               g.stride_B_ABC == stride_B_ABC;
+                    });
+
+                    if (group == groups.end())
+                    {
+                        groups.push_back({len_AB,
+                                          stride_A_AC, stride_A_AB, stride_A_ABC,
+                                          stride_B_BC, stride_B_AB, stride_B_ABC,
+                                          A.data(a), B.data(b), {}, {}});
+                        group = groups.end()-1;
+                    }
+
+                    auto off_A = A.data(a) - group->data_A;
+                    auto off_B = B.data(b) - group->data_B;
+                    TBLIS_ASSERT(off_A % ts == 0 && off_B % ts == 0);
+
+                    group->block_off_A.push_back(off_A/ts);
+                    group->block_off_B.push_back(off_B/ts);
+                }
+
+                auto empty = make_span<stride_type>();
+                auto beta_ = beta;
+                auto conj_C_ = conj_C;
+
+                for (auto& group : groups)
+                {
+                    viterator<3> it(len_ABC, group.stride_A_ABC, group.stride_B_ABC, stride_C_ABC);
+                    stride_type off_A = 0, off_B = 0, off_C = 0;
+
+                    while (it.next(off_A, off_B, off_C))
+                    {
+                        gemm_bsmtc_blis(type, subcomm, cntx,
+                                        make_span(len_AC), false,
+                                        make_span(len_BC), false,
+                                        make_span(group.len_AB), false,
+                                        alpha, conj_A, group.data_A + off_A*ts, empty, make_span(group.block_off_A), make_span(group.stride_A_AC), make_span(group.stride_A_AB),
+                                               conj_B, group.data_B + off_B*ts, empty, make_span(group.block_off_B), make_span(group.stride_B_BC), make_span(group.stride_B_AB),
+                                        beta_, conj_C_,      data_C + off_C*ts, empty,                      empty, make_span(stride_C_AC), make_span(stride_C_BC));
+                    }
+
+                    beta_ = one;
+                    conj_C_ = false;
+                }
+            });
+        }
+    });
+}
+
+}
+
+TBLIS_EXPORT
+void tblis_tensor_mult_block_sparse(const tblis_comm* comm, const tblis_config* cntx,
+                                    const tblis_block_sparse_tensor* A, const label_type* idx_A_,
+                                    const tblis_block_sparse_tensor* B, const label_type* idx_B_,
+                                          tblis_block_sparse_tensor* C, const label_type* idx_C_)
+{
+    using namespace internal;
+
+    initialize_once();
+    stats_scope stats(comm);
+
+    auto type = C->type;
+    TBLIS_ASSERT(A->type == type);
+    TBLIS_ASSERT(B->type == type);
+
+    label_vector idx_A(idx_A_, idx_A_+A->ndim);
+    label_vector idx_B(idx_B_, idx_B_+B->ndim);
+    label_vector idx_C(idx_C_, idx_C_+C->ndim);
+
+    for (auto i : range(1,A->ndim))
+    for (auto j : range(i))
+        TBLIS_ASSERT(idx_A[i] != idx_A[j]);
+
+    for (auto i : range(1,B->ndim))
+    for (auto j : range(i))
+        TBLIS_ASSERT(idx_B[i] != idx_B[j]);
+
+    for (auto i : range(1,C->ndim))
+    for (auto j : range(i))
+        TBLIS_ASSERT(idx_C[i] != idx_C[j]);
+
+    auto idx_ABC = stl_ext::intersection(idx_A, idx_B, idx_C);
+    auto idx_AB = stl_ext::exclusion(stl_ext::intersection(idx_A, idx_B), idx_ABC);
+    auto idx_AC = stl_ext::exclusion(stl_ext::intersection(idx_A, idx_C), idx_ABC);
+    auto idx_BC = stl_ext::exclusion(stl_ext::intersection(idx_B, idx_C), idx_ABC);
+
+    TBLIS_ASSERT(stl_ext::exclusion(idx_A, idx_AB, idx_AC, idx_ABC).empty());
+    TBLIS_ASSERT(stl_ext::exclusion(idx_B, idx_AB, idx_BC, idx_ABC).empty());
+    TBLIS_ASSERT(stl_ext::exclusion(idx_C, idx_AC, idx_BC, idx_ABC).empty());
+
+    block_sparse_operand A_(*A, idx_A, idx_AC, idx_AB, idx_ABC);
+    block_sparse_operand B_(*B, idx_B, idx_AB, idx_BC, idx_ABC);
+    block_sparse_operand C_(*C, idx_C, idx_AC, idx_BC, idx_ABC);
+
+    check_partition(A_, A_.dims[0], C_, C_.dims[0]);
+    check_partition(A_, A_.dims[1], B_, B_.dims[0]);
+    check_partition(B_, B_.dims[1], C_, C_.dims[1]);
+    check_partition(A_, A_.dims_ABC, B_, B_.dims_ABC);
+    check_partition(A_, A_.dims_ABC, C_, C_.dims_ABC);
+
+    auto alpha = A->scalar*B->scalar;
+
+    parallelize_if(
+    [&](const communicator& comm)
+    {
+        record_algorithm(comm, ALGORITHM_BLOCK_SPARSE);
+
+        mult_block_sparse(type, comm, bli_gks_query_cntx(),
+                          alpha, A->conj, A_,
+                                 B->conj, B_,
+                          C->scalar, C->conj, C_);
+
+        comm.barrier();
+    }, comm);
+
+    C->scalar = 1;
+    C->conj = false;
+}
+
+}
@@ -0,0 +1,204 @@
+#ifndef _TBLIS_IFACE_3T_BLOCK_SPARSE_H_
+#define _TBLIS_IFACE_3T_BLOCK_SPARSE_H_
+
+#include "../base/thread.h"
+#include "../base/basic_types.h"
+
+#if TBLIS_ENABLE_CPLUSPLUS
+#include <vector>
+#endif
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wnull-dereference"
+
+TBLIS_BEGIN_NAMESPACE
+
+/*
+ * A tensor where each mode d is partitioned into nblock[d] blocks of lengths
+ * block_len[d][0...nblock[d]-1], and only the blocks listed in block_idx are
+ * stored (all others are zero). Block b has coordinates
+ * block_idx[b*ndim...(b+1)*ndim-1] and its elements are located at
+ * block_data[b] with strides block_stride[b*ndim...(b+1)*ndim-1].
+ *
+ * Each block may appear at most once.
+ */
+typedef struct tblis_block_sparse_tensor
+{
+    type_t type;
+    int conj;
+    tblis_scalar scalar;
+    int ndim;
+    const len_type* nblock;
+    const len_type* const* block_len;
+    len_type nnz_block;
+    const len_type* block_idx;
+    void* const* block_data;
+    const stride_type* block_stride;
+} tblis_block_sparse_tensor;
+
+/*
+ * C = A.scalar*B.scalar*A*B + C.scalar*C
+ *
+ * The block partitions of shared modes must agree. Only the stored blocks of
+ * C are computed, and products which would contribute to other blocks are
+ * skipped.
+ */
+TBLIS_EXPORT
+void tblis_tensor_mult_block_sparse(const tblis_comm* comm, const tblis_config* cntx,
+                                    const tblis_block_sparse_tensor* A, const label_type* idx_A,
+                                    const tblis_block_sparse_tensor* B, const label_type* idx_B,
+                                          tblis_block_sparse_tensor* C, const label_type* idx_C);
+
+#if TBLIS_ENABLE_CPLUSPLUS
+
+/*
+ * A block-sparse tensor owning its storage, where each stored block is laid
+ * out contiguously in column-major order.
+ */
+struct block_sparse_tensor : tblis_block_sparse_tensor
+{
+    std::vector<len_type> nblock_buf;
+    std::vector<len_vector> block_len_buf;
+    std::vector<const len_type*> block_len_ptr;
+    std::vector<len_type> block_idx_buf;
+    std::vector<void*> block_data_buf;
+    std::vector<stride_type> block_stride_buf;
+    std::vector<len_type> block_shape_buf;
+    std::vector<char> data_buf;
+
+    block_sparse_tensor(type_t type_,
+                        const std::vector<len_vector>& block_len_,
+                        const std::vector<len_vector>& blocks)
+    : nblock_buf(block_len_.size()),
+      block_len_buf(block_len_)
+    {
+        type = type_;
+        conj = false;
+        scalar.reset(1.0, type);
+        ndim = block_len_buf.size();
+        nnz_block = blocks.size();
+
+        for (auto i : range(ndim))
+        {
+            nblock_buf[i] = block_len_buf[i].size();
+            block_len_ptr.push_back(block_len_buf[i].data());
+        }
+
+        std::vector<stride_type> offset;
+        stride_type size = 0;
+        for (auto& block : blocks)
+        {
+            TBLIS_ASSERT(block.size() == ndim);
+
+            offset.push_back(size);
+
+            stride_type stride = 1;
+            for (auto i : range(ndim))
+            {
+                TBLIS_ASSERT(block[i] >= 0 && block[i] < nblock_buf[i]);
+                block_idx_buf.push_back(block[i]);
+                block_stride_buf.push_back(stride);
+                block_shape_buf.push_back(block_len_buf[i][block[i]]);
+                stride *= block_len_buf[i][block[i]];
+            }
+
+            size += stride;
+        }
+
+        data_buf.resize(size*type_size[type]);
+        for (auto off : offset)
+            block_data_buf.push_back(data_buf.data() + off*type_size[type]);
+
+        nblock = nblock_buf.data();
+        block_len = block_len_ptr.data();
+        block_idx = block_idx_buf.data();
+        block_data = block_data_buf.data();
+        block_stride = block_stride_buf.data();
+    }
+
+    block_sparse_tensor(const block_sparse_tensor&) = delete;
+
+    block_sparse_tensor& operator=(const block_sparse_tensor&) = delete;
+
+    /*
+     * A dense view of stored block b.
+     */
+    tblis_tensor block(len_type b) const
+    {
+        TBLIS_ASSERT(b >= 0 && b < nnz_block);
+
+        tblis_tensor view;
+        view.type = type;
+        view.scalar.reset(1.0, type);
+        view.data = block_data[b];
+        view.ndim = ndim;
+        view.len = const_cast<len_type*>(block_shape_buf.data() + b*ndim);
+        view.stride = const_cast<stride_type*>(block_stride + b*ndim);
+
+        return view;
+    }
+};
+
+inline
+void mult_block_sparse(const communicator& comm,
+                       const scalar& alpha,
+                       const tblis_block_sparse_tensor& A,
+                       const label_vector& idx_A,
+                       const tblis_block_sparse_tensor& B,
+                       const label_vector& idx_B,
+                       const scalar& beta,
+                       const tblis_block_sparse_tensor& C,
+                       const label_vector& idx_C)
+{
+    auto A_(A);
+    A_.scalar *= alpha.convert(A_.type);
+
+    auto C_(C);
+    C_.scalar *= beta.convert(C_.type);
+
+    tblis_tensor_mult_block_sparse(comm, nullptr, &A_, idx_A.data(), &B, idx_B.data(), &C_, idx_C.data());
+}
+
+inline
+void mult_block_sparse(const communicator& comm,
+                       const tblis_block_sparse_tensor& A,
+                       const label_vector& idx_A,
+                       const tblis_block_sparse_tensor& B,
+                       const label_vector& idx_B,
+                       const tblis_block_sparse_tensor& C,
+                       const label_vector& idx_C)
+{
+    mult_block_sparse(comm, {1.0, A.type}, A, idx_A, B, idx_B, {0.0, A.type}, C, idx_C);
+}
+
+TBLIS_COMPAT_INLINE
+void mult_block_sparse(const scalar& alpha,
+                       const tblis_block_sparse_tensor& A,
+                       const label_vector& idx_A,
+                       const tblis_block_sparse_tensor& B,
+                       const label_vector& idx_B,
+                       const scalar& beta,
+                       const tblis_block_sparse_tensor& C,
+                       const label_vector& idx_C)
+{
+    mult_block_sparse(*(communicator*)nullptr, alpha, A, idx_A, B, idx_B, beta, C, idx_C);
+}
+
+inline
+void mult_block_sparse(const tblis_block_sparse_tensor& A,
+                       const label_vector& idx_A,
+                       const tblis_block_sparse_tensor& B,
+                       const label_vector& idx_B,
+                       const tblis_block_sparse_tensor& C,
+                       const label_vector& idx_C)
+{
+    mult_block_sparse({1.0, A.type}, A, idx_A, B, idx_B, {0.0, A.type}, C, idx_C);
+}
+
+#endif
+
+TBLIS_END_NAMESPACE
+
+#pragma GCC diagnostic pop
+
+#endif
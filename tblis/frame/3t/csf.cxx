@@ -0,0 +1,382 @@
+#include "csf.h"
+
+#include "tblis/plugin/bli_plugin_tblis.h"
+#include "tblis/frame/1t/dense/scale.hpp"
+#include "tblis/frame/1t/dense/set.hpp"
+
+#include "tblis/frame/base/tensor.hpp"
+#include "tblis/frame/base/stats.hpp"
+
+#include <algorithm>
+
+namespace tblis
+{
+namespace internal
+{
+
+/*
+ * The dense dimensions shared by B and C (the free indices of the sparse
+ * product), with the dimension of smallest stride in C split off so that
+ * the innermost loop runs over it.
+ */
+struct csf_free_dims
+{
+    len_type len0 = 1;
+    stride_type stride_B0 = 0;
+    stride_type stride_C0 = 0;
+    len_vector len;
+    stride_vector stride_B, stride_C, stride_T;
+    stride_type size = 1;
+
+    csf_free_dims(len_vector len_BC, stride_vector stride_B_BC, stride_vector stride_C_BC)
+    {
+        if (!len_BC.empty())
+        {
+            auto inner = std::min_element(stride_C_BC.begin(), stride_C_BC.end(),
+                [](stride_type a, stride_type b) { return std::abs(a) < std::abs(b); }) - stride_C_BC.begin();
+
+            len0 = len_BC[inner];
+            stride_B0 = stride_B_BC[inner];
+            stride_C0 = stride_C_BC[inner];
+
+            len_BC.erase(len_BC.begin()+inner);
+            stride_B_BC.erase(stride_B_BC.begin()+inner);
+            stride_C_BC.erase(stride_C_BC.begin()+inner);
+        }
+
+        len = len_BC;
+        stride_B = stride_B_BC;
+        stride_C = stride_C_BC;
+
+        /*
+         * Accumulators are laid out densely, with the inner dimension
+         * contiguous.
+         */
+        size = len0;
+        for (auto l : len)
+        {
+            stride_T.push_back(size);
+            size *= l;
+        }
+    }
+};
+
+/*
+ * Y[free] (+)= alpha*X[free] over the inner range [i0,i1), where X and Y have
+ * the given inner and outer strides.
+ */
+template <typename T>
+void csf_axpy(const csf_free_dims& dims, len_type i0, len_type i1, T alpha,
+              bool conj_X, const T* X, stride_type stride_X0, const stride_vector& stride_X,
+                                 T* Y, stride_type stride_Y0, const stride_vector& stride_Y)
+{
+    viterator<2> iter(dims.len, stride_X, stride_Y);
+
+    while (iter.next(X, Y))
+    {
+        if (stride_X0 == 1 && stride_Y0 == 1 && !conj_X)
+        {
+            for (auto i = i0;i < i1;i++)
+                Y[i] += alpha*X[i];
+        }
+        else
+        {
+            for (auto i = i0;i < i1;i++)
+                Y[i*stride_Y0] += alpha*conj(conj_X, X[i*stride_X0]);
+        }
+    }
+}
+
+template <typename T>
+struct csf_mult
+{
+    const tblis_csf_tensor& A;
+    const csf_free_dims& dims;
+    const stride_vector& stride_B;
+    const stride_vector& stride_C;
+    int acc_level;
+    T alpha;
+    bool conj_A, conj_B;
+    const T* data_A;
+    const T* data_B;
+    T* data_C;
+    len_type i0, i1;
+    std::vector<T> tmp;
+
+    csf_mult(const tblis_csf_tensor& A, const csf_free_dims& dims,
+             const stride_vector& stride_B, const stride_vector& stride_C,
+             int acc_level, T alpha, bool conj_A, bool conj_B,
+             const T* data_B, T* data_C, len_type i0, len_type i1)
+    : A(A), dims(dims), stride_B(stride_B), stride_C(stride_C),
+      acc_level(acc_level), alpha(alpha), conj_A(conj_A), conj_B(conj_B),
+      data_A(static_cast<const T*>(A.data)), data_B(data_B), data_C(data_C),
+      i0(i0), i1(i1), tmp(acc_level < A.ndim ? dims.size : 0) {}
+
+    /*
+     * Accumulate the subtree of node f at level l into the dense free
+     * dimensions at acc, which are zeroed first by the caller.
+     */
+    void accumulate(int l, len_type f, stride_type off_B, T* acc)
+    {
+        off_B += A.fidx[l][f]*stride_B[l];
+
+        if (l == A.ndim-1)
+        {
+            csf_axpy(dims, i0, i1, conj(conj_A, data_A[f]),
+                     conj_B, data_B + off_B, dims.stride_B0, dims.stride_B,
+                                        acc,              1, dims.stride_T);
+            return;
+        }
+
+        /*
+         * Levels below acc_level contract the fiber into a single vector
+         * which only needs to be added to C once.
+         */
+        for (auto g = A.fptr[l][f];g < A.fptr[l][f+1];g++)
+            accumulate(l+1, g, off_B, acc);
+    }
+
+    void visit(int l, len_type f, stride_type off_B, stride_type off_C)
+    {
+        off_B += A.fidx[l][f]*stride_B[l];
+        off_C += A.fidx[l][f]*stride_C[l];
+
+        if (l == A.ndim-1)
+        {
+            csf_axpy(dims, i0, i1, alpha*conj(conj_A, data_A[f]),
+                     conj_B, data_B + off_B, dims.stride_B0, dims.stride_B,
+                             data_C + off_C, dims.stride_C0, dims.stride_C);
+            return;
+        }
+
+        if (l+1 == acc_level)
+        {
+            auto acc = tmp.data();
+            zero(acc);
+
+            for (auto g = A.fptr[l][f];g < A.fptr[l][f+1];g++)
+                accumulate(l+1, g, off_B, acc);
+
+            flush(acc, off_C);
+            return;
+        }
+
+        for (auto g = A.fptr[l][f];g < A.fptr[l][f+1];g++)
+            visit(l+1, g, off_B, off_C);
+    }
+
+    /*
+     * Process the top-level fibers f0...f1-1.
+     */
+    void operator()(len_type f0, len_type f1)
+    {
+        if (acc_level == 0)
+        {
+            auto acc = tmp.data();
+            zero(acc);
+
+            for (auto f = f0;f < f1;f++)
+                accumulate(0, f, 0, acc);
+
+            flush(acc, 0);
+            return;
+        }
+
+        for (auto f = f0;f < f1;f++)
+            visit(0, f, 0, 0);
+    }
+
+    void zero(T* acc)
+    {
+        viterator<1> iter(dims.len, dims.stride_T);
+
+        while (iter.next(acc))
+            std::fill(acc+i0, acc+i1, T());
+    }
+
+    void flush(const T* acc, stride_type off_C)
+    {
+        csf_axpy(dims, i0, i1, alpha, false, acc, 1, dims.stride_T,
+                 data_C + off_C, dims.stride_C0, dims.stride_C);
+    }
+};
+
+template <typename T>
+void mult_csf(const communicator& comm, const tblis_csf_tensor& A,
+              const stride_vector& stride_A_B, const stride_vector& stride_A_C,
+              const std::vector<bool>& is_AB, const csf_free_dims& dims,
+              T alpha, bool conj_A, bool conj_B, const T* B, T* C)
+{
+    const auto ndim = A.ndim;
+    const auto nnz = A.nfib[ndim-1];
+
+    /*
+     * Levels from acc_level down are contracted only, so their contributions
+     * are summed into a dense vector before being added to C.
+     */
+    auto acc_level = ndim;
+    while (acc_level > 0 && is_AB[acc_level-1]) acc_level--;
+
+    if (acc_level > 0 && !is_AB[0] && A.nfib[0] > 1)
+    {
+        /*
+         * Top-level fibers of an index of C write disjoint parts of C, so
+         * they are divided among the threads in ranges with roughly equal
+         * numbers of non-zeros.
+         */
+        std::vector<len_type> first_nz(A.nfib[0]+1);
+        for (auto f : range(A.nfib[0]+1))
+        {
+            auto g = f;
+            for (auto l : range(ndim-1)) g = A.fptr[l][g];
+            first_nz[f] = g;
+        }
+
+        comm.distribute_over_threads(nnz,
+        [&](len_type nz0, len_type nz1)
+        {
+            auto f0 = std::lower_bound(first_nz.begin(), first_nz.end()-1, nz0) - first_nz.begin();
+            auto f1 = std::lower_bound(first_nz.begin(), first_nz.end()-1, nz1) - first_nz.begin();
+            if (nz1 == nnz) f1 = A.nfib[0];
+
+            csf_mult<T>(A, dims, stride_A_B, stride_A_C, acc_level, alpha,
+                        conj_A, conj_B, B, C, 0, dims.len0)(f0, f1);
+        });
+    }
+    else
+    {
+        /*
+         * Otherwise all non-zeros may write the same part of C, and the
+         * threads divide the innermost free dimension instead.
+         */
+        comm.distribute_over_threads(dims.len0,
+        [&](len_type i0, len_type i1)
+        {
+            csf_mult<T>(A, dims, stride_A_B, stride_A_C, acc_level, alpha,
+                        conj_A, conj_B, B, C, i0, i1)(0, A.nfib[0]);
+        });
+    }
+
+    comm.barrier();
+}
+
+}
+
+TBLIS_EXPORT
+void tblis_tensor_mult_csf(const tblis_comm* comm, const tblis_config* cntx,
+                           const tblis_csf_tensor* A, const label_type* idx_A_,
+                           const tblis_tensor* B, const label_type* idx_B_,
+                                 tblis_tensor* C, const label_type* idx_C_)
+{
+    using namespace internal;
+
+    initialize_once();
+    stats_scope stats(comm);
+
+    auto type = C->type;
+    TBLIS_ASSERT(A->type == type);
+    TBLIS_ASSERT(B->type == type);
+
+    label_vector idx_A(idx_A_, idx_A_+A->ndim);
+    label_vector idx_B(idx_B_, idx_B_+B->ndim);
+    label_vector idx_C(idx_C_, idx_C_+C->ndim);
+
+    auto idx_BC = stl_ext::exclusion(stl_ext::intersection(idx_B, idx_C), idx_A);
+
+    TBLIS_ASSERT(stl_ext::exclusion(idx_A, idx_B, idx_C).empty());
+    TBLIS_ASSERT(stl_ext::exclusion(idx_B, idx_A, idx_C).empty());
+    TBLIS_ASSERT(stl_ext::exclusion(idx_C, idx_A, idx_B).empty());
+
+    auto position = [](const label_vector& idx, label_type label) -> int
+    {
+        auto it = std::find(idx.begin(), idx.end(), label);
+        return it == idx.end() ? -1 : it - idx.begin();
+    };
+
+    /*
+     * Strides of B and C along each level of A, zero where the index does
+     * not appear.
+     */
+    stride_vector stride_A_B, stride_A_C;
+    std::vector<bool> is_AB;
+    for (auto l : range(A->ndim))
+    {
+        auto i_B = position(idx_B, idx_A[l]);
+        auto i_C = position(idx_C, idx_A[l]);
+
+        TBLIS_ASSERT(i_B == -1 || B->len[i_B] == A->len[l]);
+        TBLIS_ASSERT(i_C == -1 || C->len[i_C] == A->len[l]);
+
+        stride_A_B.push_back(i_B == -1 ? 0 : B->stride[i_B]);
+        stride_A_C.push_back(i_C == -1 ? 0 : C->stride[i_C]);
+        is_AB.push_back(i_C == -1);
+    }
+
+    len_vector len_BC;
+    stride_vector stride_B_BC, stride_C_BC;
+    for (auto label : idx_BC)
+    {
+        auto i_B = position(idx_B, label);
+        auto i_C = position(idx_C, label);
+
+        TBLIS_ASSERT(B->len[i_B] == C->len[i_C]);
+
+        len_BC.push_back(C->len[i_C]);
+        stride_B_BC.push_back(B->stride[i_B]);
+        stride_C_BC.push_back(C->stride[i_C]);
+    }
+
+    csf_free_dims dims(len_BC, stride_B_BC, stride_C_BC);
+
+    auto alpha = A->scalar*B->scalar;
+    auto beta = C->scalar;
+    len_vector len_C(C->len, C->len+C->ndim);
+    stride_vector stride_C(C->stride, C->stride+C->ndim);
+
+    parallelize_if(
+    [&](const communicator& comm)
+    {
+        auto cntx = bli_gks_query_cntx();
+
+        record_algorithm(comm, ALGORITHM_CSF);
+        record_flops(comm, 2*A->nfib[A->ndim-1]*dims.size);
+
+        if (beta.is_zero())
+            set(type, comm, cntx, len_C, beta, static_cast<char*>(C->data), stride_C);
+        else if (!beta.is_one() || (beta.is_complex() && C->conj))
+            scale(type, comm, cntx, len_C, beta, C->conj, static_cast<char*>(C->data), stride_C);
+
+        comm.barrier();
+
+        if (alpha.is_zero() || A->nfib[A->ndim-1] == 0) return;
+
+        switch (type)
+        {
+            case TYPE_FLOAT:
+                mult_csf(comm, *A, stride_A_B, stride_A_C, is_AB, dims,
+                         alpha.data.s, A->conj, B->conj,
+                         static_cast<const float*>(B->data), static_cast<float*>(C->data));
+                break;
+            case TYPE_DOUBLE:
+                mult_csf(comm, *A, stride_A_B, stride_A_C, is_AB, dims,
+                         alpha.data.d, A->conj, B->conj,
+                         static_cast<const double*>(B->data), static_cast<double*>(C->data));
+                break;
+            case TYPE_SCOMPLEX:
+                mult_csf(comm, *A, stride_A_B, stride_A_C, is_AB, dims,
+                         alpha.data.c, A->conj, B->conj,
+                         static_cast<const scomplex*>(B->data), static_cast<scomplex*>(C->data));
+                break;
+            case TYPE_DCOMPLEX:
+                mult_csf(comm, *A, stride_A_B, stride_A_C, is_AB, dims,
+                         alpha.data.z, A->conj, B->conj,
+                         static_cast<const dcomplex*>(B->data), static_cast<dcomplex*>(C->data));
+                break;
+        }
+    }, comm);
+
+    C->scalar = 1;
+    C->conj = false;
+}
+
+}
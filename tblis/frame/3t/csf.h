@@ -0,0 +1,211 @@
+#ifndef _TBLIS_IFACE_3T_CSF_H_
+#define _TBLIS_IFACE_3T_CSF_H_
+
+#include "../base/thread.h"
+#include "../base/basic_types.h"
+
+#if TBLIS_ENABLE_CPLUSPLUS
+#include <algorithm>
+#include <numeric>
+#include <vector>
+#endif
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wnull-dereference"
+
+TBLIS_BEGIN_NAMESPACE
+
+/*
+ * An element-sparse tensor in compressed sparse fiber (CSF) format. The
+ * non-zeros form a tree with one level per dimension, in dimension order.
+ * Level l has nfib[l] nodes, and node f of level l has index fidx[l][f]
+ * along dimension l. For l < ndim-1 its children are the nodes
+ * fptr[l][f]...fptr[l][f+1]-1 of level l+1. The nodes of the last level are
+ * the non-zeros, and the value of node f is element f of data.
+ */
+typedef struct tblis_csf_tensor
+{
+    type_t type;
+    int conj;
+    tblis_scalar scalar;
+    int ndim;
+    const len_type* len;
+    const len_type* nfib;
+    const len_type* const* fptr;
+    const len_type* const* fidx;
+    void* data;
+} tblis_csf_tensor;
+
+/*
+ * C = A.scalar*B.scalar*A*B + C.scalar*C, where A is sparse and B and C are
+ * dense. Each index of A must also appear in B, C, or both, and each index
+ * of B or C must appear in at least one other tensor.
+ */
+TBLIS_EXPORT
+void tblis_tensor_mult_csf(const tblis_comm* comm, const tblis_config* cntx,
+                           const tblis_csf_tensor* A, const label_type* idx_A,
+                           const tblis_tensor* B, const label_type* idx_B,
+                                 tblis_tensor* C, const label_type* idx_C);
+
+#if TBLIS_ENABLE_CPLUSPLUS
+
+/*
+ * A CSF tensor owning its storage, built from a list of non-zeros in
+ * coordinate (COO) form.
+ */
+struct csf_tensor : tblis_csf_tensor
+{
+    len_vector len_buf;
+    std::vector<len_type> nfib_buf;
+    std::vector<std::vector<len_type>> fptr_buf;
+    std::vector<std::vector<len_type>> fidx_buf;
+    std::vector<const len_type*> fptr_ptr;
+    std::vector<const len_type*> fidx_ptr;
+    std::vector<char> data_buf;
+
+    template <typename T>
+    csf_tensor(const len_vector& len_,
+               const std::vector<len_vector>& coords,
+               const std::vector<T>& values)
+    : len_buf(len_),
+      nfib_buf(len_.size()),
+      fptr_buf(std::max<size_t>(len_.size(), 1)-1),
+      fidx_buf(len_.size())
+    {
+        TBLIS_ASSERT(!len_buf.empty());
+        TBLIS_ASSERT(coords.size() == values.size());
+
+        type = type_tag<T>::value;
+        conj = false;
+        scalar.reset(1.0, type);
+        ndim = len_buf.size();
+
+        std::vector<size_t> order(coords.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(),
+        [&](size_t i, size_t j)
+        {
+            return std::lexicographical_compare(coords[i].begin(), coords[i].end(),
+                                                coords[j].begin(), coords[j].end());
+        });
+
+        data_buf.resize(coords.size()*sizeof(T));
+        auto data_T = reinterpret_cast<T*>(data_buf.data());
+
+        for (auto k : range(order.size()))
+        {
+            auto& coord = coords[order[k]];
+            TBLIS_ASSERT(coord.size() == ndim);
+
+            /*
+             * The first level at which this non-zero leaves the path of the
+             * previous one; new nodes are started from there down. Repeated
+             * coordinates are not allowed.
+             */
+            auto l = 0;
+            if (k > 0)
+                while (l < ndim-1 && coord[l] == coords[order[k-1]][l]) l++;
+
+            for (;l < ndim;l++)
+            {
+                TBLIS_ASSERT(coord[l] >= 0 && coord[l] < len_buf[l]);
+                if (l < ndim-1) fptr_buf[l].push_back(fidx_buf[l+1].size());
+                fidx_buf[l].push_back(coord[l]);
+            }
+
+            data_T[k] = values[order[k]];
+        }
+
+        for (auto l : range(ndim))
+        {
+            nfib_buf[l] = fidx_buf[l].size();
+            if (l < ndim-1) fptr_buf[l].push_back(fidx_buf[l+1].size());
+        }
+
+        for (auto& f : fptr_buf) fptr_ptr.push_back(f.data());
+        for (auto& f : fidx_buf) fidx_ptr.push_back(f.data());
+
+        len = len_buf.data();
+        nfib = nfib_buf.data();
+        fptr = fptr_ptr.data();
+        fidx = fidx_ptr.data();
+        data = data_buf.data();
+    }
+
+    csf_tensor(const csf_tensor&) = delete;
+
+    csf_tensor& operator=(const csf_tensor&) = delete;
+
+    len_type num_nonzeros() const
+    {
+        return nfib[ndim-1];
+    }
+};
+
+inline
+void mult(const communicator& comm,
+          const scalar& alpha,
+          const tblis_csf_tensor& A,
+          const label_vector& idx_A,
+          const tensor_wrapper& B,
+          const label_vector& idx_B,
+          const scalar& beta,
+          const tensor_wrapper& C,
+          const label_vector& idx_C)
+{
+    auto A_(A);
+    A_.scalar *= alpha.convert(A_.type);
+
+    auto C_(C);
+    C_.scalar *= beta.convert(C_.type);
+
+    TBLIS_ASSERT(A.ndim == idx_A.size());
+    TBLIS_ASSERT(B.ndim == idx_B.size());
+    TBLIS_ASSERT(C.ndim == idx_C.size());
+
+    tblis_tensor_mult_csf(comm, nullptr, &A_, idx_A.data(), &B, idx_B.data(), &C_, idx_C.data());
+}
+
+inline
+void mult(const communicator& comm,
+          const tblis_csf_tensor& A,
+          const label_vector& idx_A,
+          const tensor_wrapper& B,
+          const label_vector& idx_B,
+          const tensor_wrapper& C,
+          const label_vector& idx_C)
+{
+    mult(comm, {1.0, A.type}, A, idx_A, B, idx_B, {0.0, A.type}, C, idx_C);
+}
+
+TBLIS_COMPAT_INLINE
+void mult(const scalar& alpha,
+          const tblis_csf_tensor& A,
+          const label_vector& idx_A,
+          const tensor_wrapper& B,
+          const label_vector& idx_B,
+          const scalar& beta,
+          const tensor_wrapper& C,
+          const label_vector& idx_C)
+{
+    mult(*(communicator*)nullptr, alpha, A, idx_A, B, idx_B, beta, C, idx_C);
+}
+
+inline
+void mult(const tblis_csf_tensor& A,
+          const label_vector& idx_A,
+          const tensor_wrapper& B,
+          const label_vector& idx_B,
+          const tensor_wrapper& C,
+          const label_vector& idx_C)
+{
+    mult({1.0, A.type}, A, idx_A, B, idx_B, {0.0, A.type}, C, idx_C);
+}
+
+#endif
+
+TBLIS_END_NAMESPACE
+
+#pragma GCC diagnostic pop
+
+#endif
@@ -2,10 +2,15 @@
 
 #include "tblis/frame/base/tensor.hpp"
 #include "tblis/frame/base/block_scatter.hpp"
+#include "tblis/frame/base/alignment.hpp"
+#include "tblis/frame/base/env.hpp"
+#include "tblis/frame/base/stats.hpp"
+#include "tblis/frame/base/fixed_rank.hpp"
 
 #include "tblis/frame/0/add.hpp"
 #include "tblis/frame/0/mult.hpp"
 #include "tblis/frame/1t/dense/add.hpp"
+#include "tblis/frame/1t/dense/convert.hpp"
 #include "tblis/frame/1t/dense/dot.hpp"
 #include "tblis/frame/1t/dense/scale.hpp"
 #include "tblis/frame/1t/dense/set.hpp"
@@ -16,6 +21,7 @@
 #include "tblis/plugin/bli_plugin_tblis.h"
 
 #include <numeric>
+#include <vector>
 
 using gemm_vfp = void (*)(      trans_t transa, \
                                 trans_t transb, \
@@ -37,6 +43,17 @@ namespace internal
 
 impl_t impl = BLIS_BASED;
 
+/*
+ * GEMMs with m*n*k at most this are computed by gemm_bsmtc_small on a single
+ * thread. It packs and calls the microkernel just as the full path does, so
+ * the trade is the fixed cost of the control tree, pool buffers and thread
+ * barriers against the loss of parallelism. 16^3 multiply-adds take well
+ * under a microsecond on one core, below that fixed cost, so the value errs
+ * towards keeping parallelism. It has not been tuned; override it with
+ * TBLIS_SMALL_GEMM_THRESHOLD (0 disables the small path).
+ */
+len_type small_gemm_threshold = envtol("TBLIS_SMALL_GEMM_THRESHOLD", 4096);
+
 static
 void ger_blis(type_t type, const communicator& comm, const cntx_t* cntx,
               len_type m, len_type n,
@@ -215,6 +232,164 @@ void gemm_blis(type_t type, const communicator& comm, const cntx_t* cntx,
     thread_blis(comm, &ao, &bo, &co, cntx, (cntl_t*)&cntl);
 }
 
+/*
+ * Compute a small block-scatter GEMM by calling the native microkernel
+ * directly, without creating a control tree, a thread communicator, or
+ * packing buffers from the BLIS pool. Edge tiles are handled inside the
+ * microkernel. Only the calling thread does any work.
+ */
+static
+void gemm_bsmtc_small(type_t type, const cntx_t* cntx,
+                      len_type m, len_type n, len_type k,
+                      const bsmtc_params& params_A,
+                      const bsmtc_params& params_B,
+                      const bsmtc_params& params_C,
+                      const scalar& alpha, bool conj_A, const char* A,
+                                           bool conj_B, const char* B,
+                      const scalar&  beta,                    char* C)
+{
+    const len_type ts = type_size[type];
+    const auto dt = (num_t)type;
+
+    auto MR  = bli_cntx_get_blksz_def_dt(dt, BLIS_MR, cntx);
+    auto NR  = bli_cntx_get_blksz_def_dt(dt, BLIS_NR, cntx);
+    auto BBM = bli_cntx_get_blksz_def_dt(dt, BLIS_BBM, cntx);
+    auto BBN = bli_cntx_get_blksz_def_dt(dt, BLIS_BBN, cntx);
+    auto KE  = bli_cntx_get_blksz_def_dt(dt, (bszid_t)KE_BSZ, cntx);
+
+    auto gemm_ukr  = reinterpret_cast<gemm_ukr_ft>(bli_cntx_get_ukr_dt(dt, BLIS_GEMM_UKR, cntx));
+    auto packm_ukr = reinterpret_cast<packm_bsmtc_ft>(bli_cntx_get_ukr2_dt(dt, dt, PACKM_BSMTC_UKR, cntx));
+    auto row_pref  = bli_cntx_ukr_prefers_rows_dt(dt, BLIS_GEMM_UKR, cntx);
+
+    auto m_iter = ceil_div(m, MR);
+    auto n_iter = ceil_div(n, NR);
+    auto k_iter = ceil_div(k, KE);
+
+    auto ldp_A = MR*BBM;
+    auto ldp_B = NR*BBN;
+    auto ps_A = ldp_A*k;
+    auto ps_B = ldp_B*k;
+
+    auto nscat = 2*(m_iter*(MR+1) + n_iter*(NR+1) + k_iter*(KE+1));
+    auto size = (m_iter*ps_A + n_iter*ps_B)*ts +
+                nscat*sizeof(stride_type) + 2*BLIS_PAGE_SIZE;
+
+    thread_local std::vector<char> buffer;
+    if (buffer.size() < (size_t)size) buffer.resize(size);
+
+    auto p_A = reinterpret_cast<char*>(round_up(reinterpret_cast<uintptr_t>(buffer.data()), BLIS_PAGE_SIZE));
+    auto p_B = p_A + m_iter*ps_A*ts;
+    auto rscat_A = convert_and_align<stride_type>(p_B + n_iter*ps_B*ts);
+    auto rbs_A   = rscat_A + m_iter*MR;
+    auto cscat_A = rbs_A + m_iter;
+    auto cbs_A   = cscat_A + k_iter*KE;
+    auto rscat_B = cbs_A + k_iter;
+    auto rbs_B   = rscat_B + n_iter*NR;
+    auto cscat_B = rbs_B + n_iter;
+    auto cbs_B   = cscat_B + k_iter*KE;
+    auto rscat_C = cbs_B + k_iter;
+    auto rbs_C   = rscat_C + m_iter*MR;
+    auto cscat_C = rbs_C + m_iter;
+    auto cbs_C   = cscat_C + n_iter*NR;
+
+    auto fill = [&](const bsmtc_params& params, int dim, len_type BS, len_type size,
+                    stride_type* scat, stride_type* bs)
+    {
+        fill_block_scatter(ts,
+                           params.nblock[dim],
+                           params.block_off[dim],
+                           params.ndim[dim],
+                           params.len[dim],
+                           params.stride[dim],
+                           BS, 0, size, scat, bs,
+                           params.pack_3d[dim]);
+    };
+
+    {
+        stats_timer timer(STATS_SCATTER);
+
+        fill(params_A, 0, MR, m, rscat_A, rbs_A);
+        fill(params_A, 1, KE, k, cscat_A, cbs_A);
+        fill(params_B, 0, NR, n, rscat_B, rbs_B);
+        fill(params_B, 1, KE, k, cscat_B, cbs_B);
+        fill(params_C, 0, MR, m, rscat_C, rbs_C);
+        fill(params_C, 1, NR, n, cscat_C, cbs_C);
+    }
+
+    scalar one(1.0, type);
+    scalar zero(0.0, type);
+
+    {
+        stats_timer timer(STATS_PACK);
+
+        for (auto i : range(m_iter))
+            packm_ukr(conj_A ? BLIS_CONJUGATE : BLIS_NO_CONJUGATE,
+                      BLIS_PACKED_PANELS,
+                      std::min(MR, m-i*MR), k, MR, k, BBM,
+                      one.raw(),
+                      A, rscat_A + i*MR, rbs_A[i], cscat_A, cbs_A,
+                      p_A + i*ps_A*ts, ldp_A);
+
+        for (auto j : range(n_iter))
+            packm_ukr(conj_B ? BLIS_CONJUGATE : BLIS_NO_CONJUGATE,
+                      BLIS_PACKED_PANELS,
+                      std::min(NR, n-j*NR), k, NR, k, BBN,
+                      one.raw(),
+                      B, rscat_B + j*NR, rbs_B[j], cscat_B, cbs_B,
+                      p_B + j*ps_B*ts, ldp_B);
+
+        record_bytes_packed((m_iter*ps_A + n_iter*ps_B)*ts);
+    }
+
+    auxinfo_t aux;
+    bli_auxinfo_set_schema_a(BLIS_PACKED_PANELS, &aux);
+    bli_auxinfo_set_schema_b(BLIS_PACKED_PANELS, &aux);
+    bli_auxinfo_set_is_a(1, &aux);
+    bli_auxinfo_set_is_b(1, &aux);
+    bli_auxinfo_set_params(nullptr, &aux);
+
+    char ct[BLIS_STACK_BUF_MAX_SIZE] __attribute__((aligned(BLIS_STACK_BUF_ALIGN_SIZE)));
+    auto rs_ct = row_pref ? NR : 1;
+    auto cs_ct = row_pref ? 1 : MR;
+
+    stats_timer timer(STATS_KERNEL);
+
+    for (auto j : range(n_iter))
+    for (auto i : range(m_iter))
+    {
+        auto m_cur = std::min(MR, m-i*MR);
+        auto n_cur = std::min(NR, n-j*NR);
+        auto a1 = p_A + i*ps_A*ts;
+        auto b1 = p_B + j*ps_B*ts;
+
+        bli_auxinfo_set_next_a(i+1 < m_iter ? a1 + ps_A*ts : p_A, &aux);
+        bli_auxinfo_set_next_b(i+1 < m_iter ? b1 : b1 + ps_B*ts, &aux);
+
+        auto rscat = rscat_C + i*MR;
+        auto cscat = cscat_C + j*NR;
+
+        if (rbs_C[i] && cbs_C[j])
+        {
+            gemm_ukr(m_cur, n_cur, k,
+                     alpha.raw(), a1, b1,
+                     beta.raw(), C + (rscat[0] + cscat[0])*ts, rbs_C[i], cbs_C[j],
+                     &aux, cntx);
+        }
+        else
+        {
+            gemm_ukr(MR, NR, k,
+                     alpha.raw(), a1, b1,
+                     zero.raw(), ct, rs_ct, cs_ct,
+                     &aux, cntx);
+
+            for (auto jr : range(n_cur))
+            for (auto ir : range(m_cur))
+                add(type, one, false, ct + (ir*rs_ct + jr*cs_ct)*ts,
+                          beta, false, C + (rscat[ir] + cscat[jr])*ts);
+        }
+    }
+}
+
 void gemm_bsmtc_blis(type_t type, const communicator& comm, const cntx_t* cntx,
                      std::span<const len_type> len_AC, bool pack_3d_AC,
                      std::span<const len_type> len_BC, bool pack_3d_BC,
@@ -222,6 +397,38 @@ void gemm_bsmtc_blis(type_t type, const communicator& comm, const cntx_t* cntx,
                      const scalar& alpha, bool conj_A, const char* A, std::span<const stride_type> block_off_A_AC, std::span<const stride_type> block_off_A_AB, std::span<const stride_type> stride_A_AC, std::span<const stride_type> stride_A_AB,
                                           bool conj_B, const char* B, std::span<const stride_type> block_off_B_BC, std::span<const stride_type> block_off_B_AB, std::span<const stride_type> stride_B_BC, std::span<const stride_type> stride_B_AB,
                      const scalar& beta_, bool conj_C,       char* C, std::span<const stride_type> block_off_C_AC, std::span<const stride_type> block_off_C_BC, std::span<const stride_type> stride_C_AC, std::span<const stride_type> stride_C_BC)
+{
+    /*
+     * The dense mult counts its flops up front; the block-sparse callers
+     * (indexed DPD and block-sparse tensors) come through here instead.
+     */
+    auto extent = [](std::span<const len_type> len, std::span<const stride_type> block_off)
+    {
+        return std::reduce(len.begin(), len.end(), len_type{1}, std::multiplies<len_type>{}) *
+               std::max<len_type>(block_off.size(), 1);
+    };
+
+    record_flops(comm, 2*extent(len_AC, block_off_A_AC)*
+                        extent(len_BC, block_off_B_BC)*
+                        extent(len_AB, block_off_A_AB));
+
+    gemm_bsmtc_blis(type, type, type, comm, cntx,
+                    len_AC, pack_3d_AC,
+                    len_BC, pack_3d_BC,
+                    len_AB, pack_3d_AB,
+                    alpha, conj_A, A, block_off_A_AC, block_off_A_AB, stride_A_AC, stride_A_AB,
+                           conj_B, B, block_off_B_BC, block_off_B_AB, stride_B_BC, stride_B_AB,
+                    beta_, conj_C, C, block_off_C_AC, block_off_C_BC, stride_C_AC, stride_C_BC);
+}
+
+void gemm_bsmtc_blis(type_t type_AB, type_t type_C, type_t type_comp,
+                     const communicator& comm, const cntx_t* cntx,
+                     std::span<const len_type> len_AC, bool pack_3d_AC,
+                     std::span<const len_type> len_BC, bool pack_3d_BC,
+                     std::span<const len_type> len_AB, bool pack_3d_AB,
+                     const scalar& alpha, bool conj_A, const char* A, std::span<const stride_type> block_off_A_AC, std::span<const stride_type> block_off_A_AB, std::span<const stride_type> stride_A_AC, std::span<const stride_type> stride_A_AB,
+                                          bool conj_B, const char* B, std::span<const stride_type> block_off_B_BC, std::span<const stride_type> block_off_B_AB, std::span<const stride_type> stride_B_BC, std::span<const stride_type> stride_B_AB,
+                     const scalar& beta_, bool conj_C,       char* C, std::span<const stride_type> block_off_C_AC, std::span<const stride_type> block_off_C_BC, std::span<const stride_type> stride_C_AC, std::span<const stride_type> stride_C_BC)
 {
     stride_type zero = 0;
     if (!block_off_A_AC.data()) block_off_A_AC = std::span(&zero, 1);
@@ -259,19 +466,45 @@ void gemm_bsmtc_blis(type_t type, const communicator& comm, const cntx_t* cntx,
     auto bt = (ndim_BC ? stride_B_BC[0] : 1) < (ndim_AB ? stride_B_AB[0] : 1);
     auto ct = (ndim_BC ? stride_C_BC[0] : 1) < (ndim_AC ? stride_C_AC[0] : 1);
 
-    bli_obj_create_with_attached_buffer((num_t)type, m, k, (void*)A, at ? k : 1, at ? 1 : m, &ao);
-    bli_obj_create_with_attached_buffer((num_t)type, k, n, (void*)B, bt ? n : 1, bt ? 1 : k, &bo);
-    bli_obj_create_with_attached_buffer((num_t)type, m, n, (void*)C, ct ? n : 1, ct ? 1 : m, &co);
-
-    bli_obj_create_1x1_with_attached_buffer((num_t)type, (void*)alpha.raw(), &alpo);
-    bli_obj_create_1x1_with_attached_buffer((num_t)type, (void*)beta.raw(), &beto);
+    /*
+     * BLIS has no half precision datatypes, so half precision A and B are
+     * described to it as float, and are converted by their own packing
+     * kernels (see packm_blk_bsmtc). Likewise a half precision C is
+     * converted microtile by microtile by gemm_ker_bsmtc.
+     */
+    auto type_ABo = value_type(type_AB);
+    auto type_Co = value_type(type_C);
+
+    TBLIS_ASSERT(bli_dt_domain((num_t)type_ABo) == bli_dt_domain((num_t)type_comp));
+    TBLIS_ASSERT(bli_dt_domain((num_t)type_Co) == bli_dt_domain((num_t)type_comp));
+
+    bli_obj_create_with_attached_buffer((num_t)type_ABo, m, k, (void*)A, at ? k : 1, at ? 1 : m, &ao);
+    bli_obj_create_with_attached_buffer((num_t)type_ABo, k, n, (void*)B, bt ? n : 1, bt ? 1 : k, &bo);
+    bli_obj_create_with_attached_buffer((num_t)type_Co, m, n, (void*)C, ct ? n : 1, ct ? 1 : m, &co);
+
+    bli_obj_create_1x1_with_attached_buffer((num_t)type_comp, (void*)alpha.raw(), &alpo);
+    bli_obj_create_1x1_with_attached_buffer((num_t)type_Co, (void*)beta.raw(), &beto);
+
+    /*
+     * A and B are converted to the computation type while packing (the
+     * packing kernels are instantiated for each pair of precisions), and
+     * gemm_ker_bsmtc converts the result when it is accumulated into C.
+     */
+    bli_obj_set_target_dt((num_t)type_comp, &ao);
+    bli_obj_set_target_dt((num_t)type_comp, &bo);
+    bli_obj_set_exec_dt((num_t)type_comp, &ao);
+    bli_obj_set_exec_dt((num_t)type_comp, &bo);
+    bli_obj_set_exec_dt((num_t)type_comp, &co);
+    bli_obj_set_comp_dt((num_t)type_comp, &ao);
+    bli_obj_set_comp_dt((num_t)type_comp, &bo);
+    bli_obj_set_comp_dt((num_t)type_comp, &co);
 
     if (conj_A) bli_obj_toggle_conj(&ao);
     if (conj_B) bli_obj_toggle_conj(&bo);
 
-    if (conj_C && !beta.is_zero() && bli_dt_dom_is_complex((num_t)type))
+    if (conj_C && !beta.is_zero() && bli_dt_dom_is_complex((num_t)type_C))
     {
-        auto ts = type_size[type];
+        auto ts = type_size[type_C];
 
         len_vector len_C(len_AC.begin(), len_AC.end());
         len_C.insert(len_C.end(), len_BC.begin(), len_BC.end());
@@ -281,26 +514,12 @@ void gemm_bsmtc_blis(type_t type, const communicator& comm, const cntx_t* cntx,
 
         for (auto i : range(nblock_AC))
         for (auto j : range(nblock_BC))
-            scale(type, comm, cntx, len_C, beta, conj_C, C + block_off_C_AC[i]*ts + block_off_C_BC[j]*ts, stride_C);
+            scale(type_C, comm, cntx, len_C, beta, conj_C, C + block_off_C_AC[i]*ts + block_off_C_BC[j]*ts, stride_C);
 
         beta = 1.0;
         conj_C = false;
     }
 
-    gemm_cntl_t cntl;
-    auto trans = bli_gemm_cntl_init
-    (
-      bli_dt_dom_is_complex((num_t)type) ? bli_ind_oper_find_avail(BLIS_GEMM, (num_t)type) : BLIS_NAT,
-      BLIS_GEMM,
-      &alpo,
-      &ao,
-      &bo,
-      &beto,
-      &co,
-      cntx,
-      &cntl
-    );
-
     bsmtc_params params_A, params_B, params_C;
 
     params_A.nblock = {nblock_AC, nblock_AB};
@@ -309,6 +528,7 @@ void gemm_bsmtc_blis(type_t type, const communicator& comm, const cntx_t* cntx,
     params_A.len = {len_AC.data(), len_AB.data()};
     params_A.stride = {stride_A_AC.data(), stride_A_AB.data()};
     params_A.pack_3d = {pack_3d_AC, pack_3d_AB};
+    params_A.storage_type = type_AB;
 
     params_B.nblock = {nblock_BC, nblock_AB};
     params_B.block_off = {block_off_B_BC.data(), block_off_B_AB.data()};
@@ -316,6 +536,7 @@ void gemm_bsmtc_blis(type_t type, const communicator& comm, const cntx_t* cntx,
     params_B.len = {len_BC.data(), len_AB.data()};
     params_B.stride = {stride_B_BC.data(), stride_B_AB.data()};
     params_B.pack_3d = {pack_3d_BC, pack_3d_AB};
+    params_B.storage_type = type_AB;
 
     params_C.nblock = {nblock_AC, nblock_BC};
     params_C.block_off = {block_off_C_AC.data(), block_off_C_BC.data()};
@@ -323,6 +544,41 @@ void gemm_bsmtc_blis(type_t type, const communicator& comm, const cntx_t* cntx,
     params_C.len = {len_AC.data(), len_BC.data()};
     params_C.stride = {stride_C_AC.data(), stride_C_BC.data()};
     params_C.pack_3d = {pack_3d_AC, pack_3d_BC};
+    if (is_half(type_C)) params_C.storage_type = type_C;
+
+    if (m*n*k <= small_gemm_threshold &&
+        type_AB == type_comp && type_C == type_comp &&
+        (!bli_dt_dom_is_complex((num_t)type_comp) ||
+         bli_ind_oper_find_avail(BLIS_GEMM, (num_t)type_comp) == BLIS_NAT))
+    {
+        record_algorithm(comm, ALGORITHM_SMALL_GEMM);
+
+        if (comm.master())
+            gemm_bsmtc_small(type_comp, cntx, m, n, k,
+                             params_A, params_B, params_C,
+                             alpha, conj_A, A,
+                                    conj_B, B,
+                              beta,         C);
+
+        comm.barrier();
+        return;
+    }
+
+    record_algorithm(comm, ALGORITHM_GEMM);
+
+    gemm_cntl_t cntl;
+    auto trans = bli_gemm_cntl_init
+    (
+      bli_dt_dom_is_complex((num_t)type_comp) ? bli_ind_oper_find_avail(BLIS_GEMM, (num_t)type_comp) : BLIS_NAT,
+      BLIS_GEMM,
+      &alpo,
+      &ao,
+      &bo,
+      &beto,
+      &co,
+      cntx,
+      &cntl
+    );
 
     bli_gemm_cntl_set_packa_var(packm_blk_bsmtc, &cntl);
     bli_gemm_cntl_set_packb_var(packm_blk_bsmtc, &cntl);
@@ -403,7 +659,19 @@ void mult_blis(type_t type, const communicator& comm, const cntx_t* cntx,
     len_type m2 = stl_ext::prod(len_AC)/m;
     len_type n2 = stl_ext::prod(len_AB)/n;
 
-    if (comm.master()) flops += 2*m*m2*n*n2*l;
+    auto len_AB_r = stl_ext::permuted(len_AB, reorder_AB);
+    auto stride_A_AB_r = stl_ext::permuted(stride_A_AB, reorder_AB);
+    auto stride_B_AB_r = stl_ext::permuted(stride_B_AB, reorder_AB);
+    auto len_ABC_r = stl_ext::appended(stl_ext::permuted(len_ABC, reorder_ABC),
+                                       stl_ext::permuted(len_AC, reorder_AC));
+    auto stride_A_ABC_r = stl_ext::appended(stl_ext::permuted(stride_A_ABC, reorder_ABC),
+                                            stl_ext::permuted(stride_A_AC, reorder_AC));
+    auto stride_B_ABC_r = stl_ext::appended(stl_ext::permuted(stride_B_ABC, reorder_ABC),
+                                            stride_vector(reorder_AC.size()));
+    auto stride_C_ABC_r = stl_ext::appended(stl_ext::permuted(stride_C_ABC, reorder_ABC),
+                                            stl_ext::permuted(stride_C_AC, reorder_AC));
+
+    record_algorithm(comm, ALGORITHM_GEMV);
 
     unsigned nt_l, nt_m;
     std::tie(nt_l, nt_m) = partition_2x2(comm.num_threads(), l*m2, l*m2, m, m);
@@ -413,46 +681,44 @@ void mult_blis(type_t type, const communicator& comm, const cntx_t* cntx,
     subcomm.distribute_over_gangs(l*m2,
     [&](len_type l_min, len_type l_max)
     {
-        viterator<2> iter_AB(stl_ext::permuted(len_AB, reorder_AB),
-                             stl_ext::permuted(stride_A_AB, reorder_AB),
-                             stl_ext::permuted(stride_B_AB, reorder_AB));
-
-        viterator<3> iter_ABC(stl_ext::appended(stl_ext::permuted(len_ABC, reorder_ABC),
-                                                stl_ext::permuted(len_AC, reorder_AC)),
-                              stl_ext::appended(stl_ext::permuted(stride_A_ABC, reorder_ABC),
-                                                stl_ext::permuted(stride_A_AC, reorder_AC)),
-                              stl_ext::appended(stl_ext::permuted(stride_B_ABC, reorder_ABC),
-                                                stride_vector(reorder_AC.size())),
-                              stl_ext::appended(stl_ext::permuted(stride_C_ABC, reorder_ABC),
-                                                stl_ext::permuted(stride_C_AC, reorder_AC)));
+        dispatch_rank(len_AB_r.size(),
+        [&](auto rank_AB)
+        {
+        dispatch_rank(len_ABC_r.size(),
+        [&](auto rank_ABC)
+        {
+            rank_viterator<decltype(rank_AB)::value,2> iter_AB(len_AB_r, stride_A_AB_r, stride_B_AB_r);
+            rank_viterator<decltype(rank_ABC)::value,3> iter_ABC(len_ABC_r, stride_A_ABC_r, stride_B_ABC_r, stride_C_ABC_r);
 
-        auto A1 = A;
-        auto B1 = B;
-        auto C1 = C;
+            auto A1 = A;
+            auto B1 = B;
+            auto C1 = C;
 
-        iter_ABC.position(l_min, A1, B1, C1);
+            iter_ABC.position(l_min, A1, B1, C1);
 
-        for (len_type l = l_min;l < l_max;l++)
-        {
-            iter_ABC.next(A1, B1, C1);
+            for (len_type l = l_min;l < l_max;l++)
+            {
+                iter_ABC.next(A1, B1, C1);
 
-            auto beta1 = beta;
-            auto conj_C1 = conj_C;
+                auto beta1 = beta;
+                auto conj_C1 = conj_C;
 
-            while (iter_AB.next(A1, B1))
-            {
-                gemv_blis(type, subcomm, cntx,
-                          m, n,
-                          alpha, conj_A,  A1, rs_A, cs_A,
-                                 conj_B,  B1, inc_B,
-                          beta1, conj_C1, C1, inc_C);
+                while (iter_AB.next(A1, B1))
+                {
+                    gemv_blis(type, subcomm, cntx,
+                              m, n,
+                              alpha, conj_A,  A1, rs_A, cs_A,
+                                     conj_B,  B1, inc_B,
+                              beta1, conj_C1, C1, inc_C);
 
-                subcomm.barrier();
+                    subcomm.barrier();
 
-                beta1 = 1.0;
-                conj_C1 = false;
+                    beta1 = 1.0;
+                    conj_C1 = false;
+                }
             }
-        }
+        });
+        });
     });
 }
 
@@ -510,7 +776,20 @@ void mult_blis(type_t type, const communicator& comm, const cntx_t* cntx,
     len_type m2 = stl_ext::prod(len_AC)/m;
     len_type n2 = stl_ext::prod(len_BC)/n;
 
-    if (comm.master()) flops += 2*m*m2*n*n2*l;
+    auto len_ABC_r = stl_ext::appended(stl_ext::permuted(len_ABC, reorder_ABC),
+                                       stl_ext::permuted(len_AC, reorder_AC),
+                                       stl_ext::permuted(len_BC, reorder_BC));
+    auto stride_A_ABC_r = stl_ext::appended(stl_ext::permuted(stride_A_ABC, reorder_ABC),
+                                            stl_ext::permuted(stride_A_AC, reorder_AC),
+                                            stride_vector(reorder_BC.size()));
+    auto stride_B_ABC_r = stl_ext::appended(stl_ext::permuted(stride_B_ABC, reorder_ABC),
+                                            stride_vector(reorder_AC.size()),
+                                            stl_ext::permuted(stride_B_BC, reorder_BC));
+    auto stride_C_ABC_r = stl_ext::appended(stl_ext::permuted(stride_C_ABC, reorder_ABC),
+                                            stl_ext::permuted(stride_C_AC, reorder_AC),
+                                            stl_ext::permuted(stride_C_BC, reorder_BC));
+
+    record_algorithm(comm, ALGORITHM_GER);
 
     unsigned nt_l, nt_m;
     std::tie(nt_l, nt_m) = partition_2x2(comm.num_threads(), l*m2*n2, l*m2*n2, m*n, m*n);
@@ -520,40 +799,34 @@ void mult_blis(type_t type, const communicator& comm, const cntx_t* cntx,
     subcomm.distribute_over_gangs(l*m2*n2,
     [&](len_type l_min, len_type l_max)
     {
-        viterator<3> iter_ABC(stl_ext::appended(stl_ext::permuted(len_ABC, reorder_ABC),
-                                                stl_ext::permuted(len_AC, reorder_AC),
-                                                stl_ext::permuted(len_BC, reorder_BC)),
-                              stl_ext::appended(stl_ext::permuted(stride_A_ABC, reorder_ABC),
-                                                stl_ext::permuted(stride_A_AC, reorder_AC),
-                                                stride_vector(reorder_BC.size())),
-                              stl_ext::appended(stl_ext::permuted(stride_B_ABC, reorder_ABC),
-                                                stride_vector(reorder_AC.size()),
-                                                stl_ext::permuted(stride_B_BC, reorder_BC)),
-                              stl_ext::appended(stl_ext::permuted(stride_C_ABC, reorder_ABC),
-                                                stl_ext::permuted(stride_C_AC, reorder_AC),
-                                                stl_ext::permuted(stride_C_BC, reorder_BC)));
+        dispatch_rank(len_ABC_r.size(),
+        [&](auto rank)
+        {
+            rank_viterator<decltype(rank)::value,3> iter_ABC(len_ABC_r, stride_A_ABC_r, stride_B_ABC_r, stride_C_ABC_r);
 
-        auto A1 = A;
-        auto B1 = B;
-        auto C1 = C;
+            auto A1 = A;
+            auto B1 = B;
+            auto C1 = C;
 
-        iter_ABC.position(l_min, A1, B1, C1);
+            iter_ABC.position(l_min, A1, B1, C1);
 
-        for (len_type l = l_min;l < l_max;l++)
-        {
-            iter_ABC.next(A1, B1, C1);
+            for (len_type l = l_min;l < l_max;l++)
+            {
+                iter_ABC.next(A1, B1, C1);
 
-            ger_blis(type, subcomm, cntx,
-                     m, n,
-                     alpha, conj_A, A1, inc_A,
-                            conj_B, B1, inc_B,
-                      beta, conj_C, C1, rs_C, cs_C);
-        }
+                ger_blis(type, subcomm, cntx,
+                         m, n,
+                         alpha, conj_A, A1, inc_A,
+                                conj_B, B1, inc_B,
+                          beta, conj_C, C1, rs_C, cs_C);
+            }
+        });
     });
 }
 
 static
-void mult_blis(type_t type, const communicator& comm, const cntx_t* cntx,
+void mult_blis(type_t type_AB, type_t type_C, type_t type_comp,
+               const communicator& comm, const cntx_t* cntx,
                const len_vector& len_AB,
                const len_vector& len_AC,
                const len_vector& len_BC,
@@ -573,7 +846,8 @@ void mult_blis(type_t type, const communicator& comm, const cntx_t* cntx,
                const stride_vector& stride_C_BC,
                const stride_vector& stride_C_ABC)
 {
-    const len_type ts = type_size[type];
+    const len_type ts_AB = storage_size(type_AB);
+    const len_type ts_C = storage_size(type_C);
 
     auto reorder_AC = internal::sort_by_stride(stride_C_AC, stride_A_AC);
     auto reorder_BC = internal::sort_by_stride(stride_C_BC, stride_B_BC);
@@ -611,14 +885,11 @@ void mult_blis(type_t type, const communicator& comm, const cntx_t* cntx,
     if (pack_K_3d)
         std::rotate(reorder_AB.begin()+1, reorder_AB.begin()+std::max(unit_A_AB, unit_B_AB), reorder_AB.end());
 
-    scalar one(1.0, type);
-
     len_type m = stl_ext::prod(len_AC);
     len_type n = stl_ext::prod(len_BC);
     len_type k = stl_ext::prod(len_AB);
     len_type l = stl_ext::prod(len_ABC);
 
-    if (comm.master()) flops += 2*m*n*k*l;
 
     unsigned nt_l, nt_mn;
     std::tie(nt_l, nt_mn) =
@@ -656,13 +927,13 @@ void mult_blis(type_t type, const communicator& comm, const cntx_t* cntx,
             iter_ABC.next(A1, B1, C1);
 
             auto empty = make_span<stride_type>();
-            gemm_bsmtc_blis(type, subcomm, cntx,
+            gemm_bsmtc_blis(type_AB, type_C, type_comp, subcomm, cntx,
                             make_span(len_AC_r), pack_M_3d,
                             make_span(len_BC_r), pack_N_3d,
                             make_span(len_AB_r), pack_K_3d,
-                            alpha, conj_A, A + A1*ts, empty, empty, make_span(stride_A_AC_r), make_span(stride_A_AB_r),
-                                   conj_B, B + B1*ts, empty, empty, make_span(stride_B_BC_r), make_span(stride_B_AB_r),
-                             beta, conj_C, C + C1*ts, empty, empty, make_span(stride_C_AC_r), make_span(stride_C_BC_r));
+                            alpha, conj_A, A + A1*ts_AB, empty, empty, make_span(stride_A_AC_r), make_span(stride_A_AB_r),
+                                   conj_B, B + B1*ts_AB, empty, empty, make_span(stride_B_BC_r), make_span(stride_B_AB_r),
+                             beta, conj_C, C + C1*ts_C, empty, empty, make_span(stride_C_AC_r), make_span(stride_C_BC_r));
         }
     });
 }
@@ -872,25 +1143,29 @@ void mult_vec(type_t type, const communicator& comm, const cntx_t* cntx,
     comm.distribute_over_threads(n0, n1,
     [&](len_type n0_min, len_type n0_max, len_type n1_min, len_type n1_max)
     {
-        auto A1 = A;
-        auto B1 = B;
-        auto C1 = C;
+        dispatch_rank(len1.size(),
+        [&](auto rank)
+        {
+            auto A1 = A;
+            auto B1 = B;
+            auto C1 = C;
 
-        viterator<3> iter_ABC(len1, stride_A1, stride_B1, stride_C1);
-        iter_ABC.position(n1_min, A1, B1, C1);
-        A1 += n0_min*stride_A0*ts;
-        B1 += n0_min*stride_B0*ts;
-        C1 += n0_min*stride_C0*ts;
+            rank_viterator<decltype(rank)::value,3> iter_ABC(len1, stride_A1, stride_B1, stride_C1);
+            iter_ABC.position(n1_min, A1, B1, C1);
+            A1 += n0_min*stride_A0*ts;
+            B1 += n0_min*stride_B0*ts;
+            C1 += n0_min*stride_C0*ts;
 
-        for (len_type i = n1_min;i < n1_max;i++)
-        {
-            iter_ABC.next(A1, B1, C1);
+            for (len_type i = n1_min;i < n1_max;i++)
+            {
+                iter_ABC.next(A1, B1, C1);
 
-            mult_ukr(n0_max-n0_min,
-                     alpha.raw(), conj_A, A1, stride_A0,
-                             conj_B, B1, stride_B0,
-                      beta.raw(), conj_C, C1, stride_C0);
-        }
+                mult_ukr(n0_max-n0_min,
+                         alpha.raw(), conj_A, A1, stride_A0,
+                                 conj_B, B1, stride_B0,
+                          beta.raw(), conj_C, C1, stride_C0);
+            }
+        });
     });
 }
 
@@ -938,8 +1213,11 @@ void mult(type_t type, const communicator& comm, const cntx_t* cntx,
         return;
     }
 
+    record_flops(comm, 2*n_AB*n_AC*n_BC*n_ABC);
+
     if (impl == REFERENCE)
     {
+        record_algorithm(comm, ALGORITHM_REFERENCE);
         mult_ref(type, comm, cntx,
                  len_AB, len_AC, len_BC, len_ABC,
                  alpha, conj_A, A, stride_A_AB, stride_A_AC, stride_A_ABC,
@@ -950,6 +1228,7 @@ void mult(type_t type, const communicator& comm, const cntx_t* cntx,
     }
     else if (impl == BLAS_BASED)
     {
+        record_algorithm(comm, ALGORITHM_BLAS);
         mult_blas(type, comm, cntx,
                   len_AB, len_AC, len_BC, len_ABC,
                   alpha, conj_A, A,
@@ -987,12 +1266,16 @@ void mult(type_t type, const communicator& comm, const cntx_t* cntx,
     {
         case HAS_NONE:
         {
+            record_algorithm(comm, ALGORITHM_VECTOR);
+
             if (comm.master())
                 mult(type, alpha, conj_A, A, conj_B, B, beta, conj_C, C);
         }
         break;
         case HAS_ABC:
         {
+            record_algorithm(comm, ALGORITHM_VECTOR);
+
             mult_vec(type, comm, cntx, len_ABC,
                      alpha, conj_A, A, stride_A_ABC,
                             conj_B, B, stride_B_ABC,
@@ -1002,6 +1285,8 @@ void mult(type_t type, const communicator& comm, const cntx_t* cntx,
         case HAS_AB:
         case HAS_AB+HAS_ABC:
         {
+            record_algorithm(comm, ALGORITHM_VECTOR);
+
             while (iter_ABC.next(A, B, C))
             {
                 dot(type, comm, cntx, len_AB, conj_A, A, stride_A_AB,
@@ -1015,6 +1300,8 @@ void mult(type_t type, const communicator& comm, const cntx_t* cntx,
         case HAS_AC:
         case HAS_AC+HAS_ABC:
         {
+            record_algorithm(comm, ALGORITHM_VECTOR);
+
             while (iter_ABC.next(A, B, C))
             {
                 add(type, alpha, conj_B, B, zero, false, sum.raw());
@@ -1028,6 +1315,8 @@ void mult(type_t type, const communicator& comm, const cntx_t* cntx,
         case HAS_BC:
         case HAS_BC+HAS_ABC:
         {
+            record_algorithm(comm, ALGORITHM_VECTOR);
+
             while (iter_ABC.next(A, B, C))
             {
                 add(type, alpha, conj_A, A, zero, false, sum.raw());
@@ -1070,7 +1359,7 @@ void mult(type_t type, const communicator& comm, const cntx_t* cntx,
         case HAS_AB+HAS_AC+HAS_BC:
         case HAS_AB+HAS_AC+HAS_BC+HAS_ABC:
         {
-            mult_blis(type, comm, cntx,
+            mult_blis(type, type, type, comm, cntx,
                       len_AB, len_AC, len_BC, len_ABC,
                       alpha, conj_A, A, stride_A_AB, stride_A_AC, stride_A_ABC,
                              conj_B, B, stride_B_AB, stride_B_BC, stride_B_ABC,
@@ -1082,5 +1371,163 @@ void mult(type_t type, const communicator& comm, const cntx_t* cntx,
     comm.barrier();
 }
 
+void mult(type_t type_AB, type_t type_C, type_t type_comp,
+          const communicator& comm, const cntx_t* cntx,
+          const len_vector& len_AB,
+          const len_vector& len_AC,
+          const len_vector& len_BC,
+          const len_vector& len_ABC,
+          const scalar& alpha, bool conj_A, const char* A,
+          const stride_vector& stride_A_AB,
+          const stride_vector& stride_A_AC,
+          const stride_vector& stride_A_ABC,
+                               bool conj_B, const char* B,
+          const stride_vector& stride_B_AB,
+          const stride_vector& stride_B_BC,
+          const stride_vector& stride_B_ABC,
+          const scalar&  beta, bool conj_C,       char* C,
+          const stride_vector& stride_C_AC,
+          const stride_vector& stride_C_BC,
+          const stride_vector& stride_C_ABC)
+{
+    if (type_AB == type_comp && type_C == type_comp)
+    {
+        mult(type_comp, comm, cntx,
+             len_AB, len_AC, len_BC, len_ABC,
+             alpha, conj_A, A, stride_A_AB, stride_A_AC, stride_A_ABC,
+                    conj_B, B, stride_B_AB, stride_B_BC, stride_B_ABC,
+              beta, conj_C, C, stride_C_AC, stride_C_BC, stride_C_ABC);
+        return;
+    }
+
+    bli_init();
+
+    auto n_AB = stl_ext::prod(len_AB);
+    auto n_AC = stl_ext::prod(len_AC);
+    auto n_BC = stl_ext::prod(len_BC);
+    auto n_ABC = stl_ext::prod(len_ABC);
+
+    if (n_AC == 0 || n_BC == 0 || n_ABC == 0) return;
+
+    auto len_C = len_AC+len_BC+len_ABC;
+    auto stride_C = stride_C_AC+stride_C_BC+stride_C_ABC;
+
+    if (n_AB == 0)
+    {
+        if (is_half(type_C))
+        {
+            if (!beta.is_one())
+                scale_half(type_C, comm, len_C, beta.as<float>(), C, stride_C);
+        }
+        else if (beta.is_zero())
+        {
+            set(type_C, comm, cntx, len_C, beta, C, stride_C);
+        }
+        else if (!beta.is_one() || (bli_dt_dom_is_complex((num_t)type_C) && conj_C))
+        {
+            scale(type_C, comm, cntx, len_C, beta, conj_C, C, stride_C);
+        }
+
+        return;
+    }
+
+    /*
+     * Every shape, including matrix-vector and outer products, goes
+     * through the block-scatter GEMM, which converts A and B while packing
+     * and C one microtile at a time, so that no operand is copied.
+     */
+    if (impl == BLIS_BASED)
+    {
+        record_flops(comm, 2*n_AB*n_AC*n_BC*n_ABC);
+
+        mult_blis(type_AB, type_C, type_comp, comm, cntx,
+                  len_AB, len_AC, len_BC, len_ABC,
+                  alpha, conj_A, A, stride_A_AB, stride_A_AC, stride_A_ABC,
+                         conj_B, B, stride_B_AB, stride_B_BC, stride_B_ABC,
+                   beta, conj_C, C, stride_C_AC, stride_C_BC, stride_C_ABC);
+
+        comm.barrier();
+        return;
+    }
+
+    /*
+     * The reference and BLAS implementations (used for testing) work in a
+     * single type, on converted copies of the operands which are not
+     * already in type_comp.
+     */
+    auto len_A = len_AB+len_AC+len_ABC;
+    auto len_B = len_AB+len_BC+len_ABC;
+    auto copy_AB = type_AB != type_comp;
+    auto copy_C = type_C != type_comp;
+
+    stride_vector stride_A = stride_A_AB+stride_A_AC+stride_A_ABC;
+    stride_vector stride_B = stride_B_AB+stride_B_BC+stride_B_ABC;
+    stride_vector stride_c = stride_C;
+    if (copy_AB) stride_A = MArray::detail::strides(len_A, MArray::COLUMN_MAJOR);
+    if (copy_AB) stride_B = MArray::detail::strides(len_B, MArray::COLUMN_MAJOR);
+    if (copy_C) stride_c = MArray::detail::strides(len_C, MArray::COLUMN_MAJOR);
+
+    auto split = [](const stride_vector& stride, len_type n1, len_type n2,
+                    stride_vector& stride1, stride_vector& stride2, stride_vector& stride3)
+    {
+        stride1.assign(stride.begin(), stride.begin()+n1);
+        stride2.assign(stride.begin()+n1, stride.begin()+n1+n2);
+        stride3.assign(stride.begin()+n1+n2, stride.end());
+    };
+
+    stride_vector stride_a_AB, stride_a_AC, stride_a_ABC;
+    stride_vector stride_b_AB, stride_b_BC, stride_b_ABC;
+    stride_vector stride_c_AC, stride_c_BC, stride_c_ABC;
+    split(stride_A, len_AB.size(), len_AC.size(), stride_a_AB, stride_a_AC, stride_a_ABC);
+    split(stride_B, len_AB.size(), len_BC.size(), stride_b_AB, stride_b_BC, stride_b_ABC);
+    split(stride_c, len_AC.size(), len_BC.size(), stride_c_AC, stride_c_BC, stride_c_ABC);
+
+    auto ts = type_size[type_comp];
+
+    const char *a = A;
+    const char *b = B;
+    char *c = C;
+    if (comm.master())
+    {
+        if (copy_AB) a = new char[stl_ext::prod(len_A) * ts];
+        if (copy_AB) b = new char[stl_ext::prod(len_B) * ts];
+        if (copy_C) c = new char[stl_ext::prod(len_C) * ts];
+    }
+
+    comm.broadcast(
+    [&](auto a, auto b, auto c)
+    {
+        if (copy_AB)
+        {
+            convert(type_AB, type_comp, comm, len_A,
+                    A, stride_A_AB+stride_A_AC+stride_A_ABC, const_cast<char*>(a), stride_A);
+            convert(type_AB, type_comp, comm, len_B,
+                    B, stride_B_AB+stride_B_BC+stride_B_ABC, const_cast<char*>(b), stride_B);
+        }
+
+        if (copy_C && !beta.is_zero())
+            convert(type_C, type_comp, comm, len_C, C, stride_C, c, stride_c);
+
+        mult(type_comp, comm, cntx,
+             len_AB, len_AC, len_BC, len_ABC,
+             alpha, conj_A, a, stride_a_AB, stride_a_AC, stride_a_ABC,
+                    conj_B, b, stride_b_AB, stride_b_BC, stride_b_ABC,
+             beta.convert(type_comp), conj_C, c, stride_c_AC, stride_c_BC, stride_c_ABC);
+
+        comm.barrier();
+
+        if (copy_C)
+            convert(type_comp, type_C, comm, len_C, c, stride_c, C, stride_C);
+    },
+    a, b, c);
+
+    if (comm.master())
+    {
+        if (copy_AB) delete[] a;
+        if (copy_AB) delete[] b;
+        if (copy_C) delete[] c;
+    }
+}
+
 }
 }
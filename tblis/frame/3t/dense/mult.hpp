@@ -14,6 +14,8 @@ namespace internal
 enum impl_t {BLIS_BASED, BLAS_BASED, REFERENCE};
 extern impl_t impl;
 
+extern len_type small_gemm_threshold;
+
 void gemm_bsmtc_blis(type_t type, const communicator& comm, const cntx_t* cntx,
                      std::span<const len_type> len_AC, bool pack_3d_AC,
                      std::span<const len_type> len_BC, bool pack_3d_BC,
@@ -22,6 +24,20 @@ void gemm_bsmtc_blis(type_t type, const communicator& comm, const cntx_t* cntx,
                                           bool conj_B, const char* B, std::span<const stride_type> block_off_B_BC, std::span<const stride_type> block_off_B_AB, std::span<const stride_type> stride_B_BC, std::span<const stride_type> stride_B_AB,
                      const scalar& beta_, bool conj_C,       char* C, std::span<const stride_type> block_off_C_AC, std::span<const stride_type> block_off_C_BC, std::span<const stride_type> stride_C_AC, std::span<const stride_type> stride_C_BC);
 
+/*
+ * As above, but with A and B stored as type_AB and C as type_C, all in the
+ * same domain. The operands are packed as type_comp and the products are
+ * accumulated in type_comp; alpha is of type_comp and beta of type_C.
+ */
+void gemm_bsmtc_blis(type_t type_AB, type_t type_C, type_t type_comp,
+                     const communicator& comm, const cntx_t* cntx,
+                     std::span<const len_type> len_AC, bool pack_3d_AC,
+                     std::span<const len_type> len_BC, bool pack_3d_BC,
+                     std::span<const len_type> len_AB, bool pack_3d_AB,
+                     const scalar& alpha, bool conj_A, const char* A, std::span<const stride_type> block_off_A_AC, std::span<const stride_type> block_off_A_AB, std::span<const stride_type> stride_A_AC, std::span<const stride_type> stride_A_AB,
+                                          bool conj_B, const char* B, std::span<const stride_type> block_off_B_BC, std::span<const stride_type> block_off_B_AB, std::span<const stride_type> stride_B_BC, std::span<const stride_type> stride_B_AB,
+                     const scalar& beta_, bool conj_C,       char* C, std::span<const stride_type> block_off_C_AC, std::span<const stride_type> block_off_C_BC, std::span<const stride_type> stride_C_AC, std::span<const stride_type> stride_C_BC);
+
 auto make_span(auto&& container)
 {
     return std::span(container.data(), container.size());
@@ -51,6 +67,28 @@ void mult(type_t type, const communicator& comm, const cntx_t* cntx,
           const stride_vector& stride_C_BC,
           const stride_vector& stride_C_ABC);
 
+/*
+ * As above, with the types split as for gemm_bsmtc_blis.
+ */
+void mult(type_t type_AB, type_t type_C, type_t type_comp,
+          const communicator& comm, const cntx_t* cntx,
+          const len_vector& len_AB,
+          const len_vector& len_AC,
+          const len_vector& len_BC,
+          const len_vector& len_ABC,
+          const scalar& alpha, bool conj_A, const char* A,
+          const stride_vector& stride_A_AB,
+          const stride_vector& stride_A_AC,
+          const stride_vector& stride_A_ABC,
+                               bool conj_B, const char* B,
+          const stride_vector& stride_B_AB,
+          const stride_vector& stride_B_BC,
+          const stride_vector& stride_B_ABC,
+          const scalar&  beta, bool conj_C,       char* C,
+          const stride_vector& stride_C_AC,
+          const stride_vector& stride_C_BC,
+          const stride_vector& stride_C_ABC);
+
 }
 }
 
@@ -13,6 +13,8 @@
 
 #include "tblis/frame/base/tensor.hpp"
 #include "tblis/frame/base/dpd_block_scatter.hpp"
+#include "tblis/frame/base/stats.hpp"
+#include "tblis/frame/base/env.hpp"
 
 #include "tblis/frame/1m/packm/packm_blk_dpd.hpp"
 #include "tblis/frame/3m/gemm/gemm_ker_dpd.hpp"
@@ -25,6 +27,7 @@ namespace internal
 {
 
 dpd_impl_t dpd_impl = BLIS;
+len_type dpd_full_memory_limit = envtol("TBLIS_DPD_FULL_MEMORY", 1l << 30);
 
 void gemm_dpd_blis(type_t type, const communicator& comm, const cntx_t* cntx,
                    int nirrep, int irrep_AC, int irrep_BC, int irrep_AB,
@@ -74,6 +77,8 @@ void gemm_dpd_blis(type_t type, const communicator& comm, const cntx_t* cntx,
 
     if (m == 0 || n == 0 || k == 0) return;
 
+    record_flops(comm, 2*m*n*k);
+
     gemm_cntl_t cntl;
     auto trans = bli_gemm_cntl_init
     (
@@ -118,30 +123,100 @@ void mult_full(type_t type, const communicator& comm, const cntx_t* cntx,
 {
     scalar one(1.0, type);
 
-    auto [A2, len_A2, stride_A2] = block_to_full(type, comm, cntx, A);
-    auto [B2, len_B2, stride_B2] = block_to_full(type, comm, cntx, B);
-    auto [C2, len_C2, stride_C2] = block_to_full(type, comm, cntx, C);
-
-    auto len_AB = stl_ext::select_from(len_A2, idx_A_AB);
-    auto len_AC = stl_ext::select_from(len_C2, idx_C_AC);
-    auto len_BC = stl_ext::select_from(len_C2, idx_C_BC);
-    auto len_ABC = stl_ext::select_from(len_C2, idx_C_ABC);
-    auto stride_A_AB = stl_ext::select_from(stride_A2, idx_A_AB);
-    auto stride_A_AC = stl_ext::select_from(stride_A2, idx_A_AC);
-    auto stride_B_AB = stl_ext::select_from(stride_B2, idx_B_AB);
-    auto stride_B_BC = stl_ext::select_from(stride_B2, idx_B_BC);
-    auto stride_C_AC = stl_ext::select_from(stride_C2, idx_C_AC);
-    auto stride_C_BC = stl_ext::select_from(stride_C2, idx_C_BC);
-    auto stride_A_ABC = stl_ext::select_from(stride_A2, idx_A_ABC);
-    auto stride_B_ABC = stl_ext::select_from(stride_B2, idx_B_ABC);
-    auto stride_C_ABC = stl_ext::select_from(stride_C2, idx_C_ABC);
-
-    mult(type, comm, cntx, len_AB, len_AC, len_BC, len_ABC,
-         alpha, conj_A, A2, stride_A_AB, stride_A_AC, stride_A_ABC,
-                conj_B, B2, stride_B_AB, stride_B_BC, stride_B_ABC,
-            one, false, C2, stride_C_AC, stride_C_BC, stride_C_ABC);
-
-    full_to_block(type, comm, cntx, C2, len_C2, stride_C2, C);
+    auto ts = type_size[type];
+    auto nirrep = A.num_irreps();
+
+    /*
+     * Number the distinct indices of the problem (AB, AC, BC, then ABC), and
+     * record the per-irrep length of each and the index of each dimension
+     * of A, B, and C.
+     */
+    std::vector<len_vector> len;
+    dim_vector idx_A(A.dimension()), idx_B(B.dimension()), idx_C(C.dimension());
+
+    auto add_index = [&](const dpd_marray_view<char>& T, int dim)
+    {
+        len_vector len_i(nirrep);
+        for (auto irrep : range(nirrep))
+            len_i[irrep] = T.length(dim, irrep);
+        len.push_back(len_i);
+        return len.size()-1;
+    };
+
+    for (auto i : range(idx_A_AB.size()))
+        idx_A[idx_A_AB[i]] = idx_B[idx_B_AB[i]] = add_index(A, idx_A_AB[i]);
+    auto nidx_AB = len.size();
+    for (auto i : range(idx_A_AC.size()))
+        idx_A[idx_A_AC[i]] = idx_C[idx_C_AC[i]] = add_index(A, idx_A_AC[i]);
+    for (auto i : range(idx_B_BC.size()))
+        idx_B[idx_B_BC[i]] = idx_C[idx_C_BC[i]] = add_index(B, idx_B_BC[i]);
+    for (auto i : range(idx_A_ABC.size()))
+        idx_A[idx_A_ABC[i]] = idx_B[idx_B_ABC[i]] = idx_C[idx_C_ABC[i]] = add_index(A, idx_A_ABC[i]);
+
+    auto ranges = dpd_tile(type, len, {idx_A, idx_B, idx_C});
+
+    char *A2, *B2, *C2;
+    if (comm.master())
+    {
+        A2 = new char[dpd_tile_size(ranges, idx_A)*ts];
+        B2 = new char[dpd_tile_size(ranges, idx_B)*ts];
+        C2 = new char[dpd_tile_size(ranges, idx_C)*ts];
+    }
+    comm.broadcast_value(A2);
+    comm.broadcast_value(B2);
+    comm.broadcast_value(C2);
+
+    /*
+     * Each tile of C is materialized once, and then all contributions from
+     * the tiles of A and B along the AB indices are accumulated into it.
+     * Tiles which do not overlap any block are skipped.
+     */
+    len_vector pos(len.size());
+
+    for_each_dpd_tile(ranges, range(nidx_AB, len.size()), pos,
+    [&]
+    {
+        len_vector off_C2, len_C2;
+        stride_vector stride_C2;
+        std::tie(off_C2, len_C2, stride_C2) = dpd_tile_extent(ranges, idx_C, pos);
+
+        if (!block_to_tile(type, comm, cntx, C, off_C2, len_C2, C2, stride_C2))
+            return;
+
+        for_each_dpd_tile(ranges, range(nidx_AB), pos,
+        [&]
+        {
+            auto [off_A2, len_A2, stride_A2] = dpd_tile_extent(ranges, idx_A, pos);
+            auto [off_B2, len_B2, stride_B2] = dpd_tile_extent(ranges, idx_B, pos);
+
+            if (!block_to_tile(type, comm, cntx, A, off_A2, len_A2, A2, stride_A2) ||
+                !block_to_tile(type, comm, cntx, B, off_B2, len_B2, B2, stride_B2))
+                return;
+
+            auto len_AB = stl_ext::select_from(len_A2, idx_A_AB);
+            auto len_AC = stl_ext::select_from(len_C2, idx_C_AC);
+            auto len_BC = stl_ext::select_from(len_C2, idx_C_BC);
+            auto len_ABC = stl_ext::select_from(len_C2, idx_C_ABC);
+            auto stride_A_AB = stl_ext::select_from(stride_A2, idx_A_AB);
+            auto stride_A_AC = stl_ext::select_from(stride_A2, idx_A_AC);
+            auto stride_B_AB = stl_ext::select_from(stride_B2, idx_B_AB);
+            auto stride_B_BC = stl_ext::select_from(stride_B2, idx_B_BC);
+            auto stride_C_AC = stl_ext::select_from(stride_C2, idx_C_AC);
+            auto stride_C_BC = stl_ext::select_from(stride_C2, idx_C_BC);
+            auto stride_A_ABC = stl_ext::select_from(stride_A2, idx_A_ABC);
+            auto stride_B_ABC = stl_ext::select_from(stride_B2, idx_B_ABC);
+            auto stride_C_ABC = stl_ext::select_from(stride_C2, idx_C_ABC);
+
+            mult(type, comm, cntx, len_AB, len_AC, len_BC, len_ABC,
+                 alpha, conj_A, A2, stride_A_AB, stride_A_AC, stride_A_ABC,
+                        conj_B, B2, stride_B_AB, stride_B_BC, stride_B_ABC,
+                    one, false, C2, stride_C_AC, stride_C_BC, stride_C_ABC);
+        });
+
+        tile_to_block(type, comm, cntx, C2, off_C2, len_C2, stride_C2, C);
+    });
+
+    comm.barrier();
 
     if (comm.master())
     {
@@ -470,15 +545,19 @@ void mult_block(type_t type, const communicator& comm, const cntx_t* cntx,
     stl_ext::permute(idx_C_AC, perm_AC);
     stl_ext::permute(idx_C_BC, perm_BC);
 
-    stride_type nblock_AB = ipow(nirrep, ndim_AB-1);
-    stride_type nblock_AC = ipow(nirrep, ndim_AC-1);
-    stride_type nblock_BC = ipow(nirrep, ndim_BC-1);
-    stride_type nblock_ABC = ipow(nirrep, ndim_ABC-1);
-
     irrep_vector irreps_A(ndim_A);
     irrep_vector irreps_B(ndim_B);
     irrep_vector irreps_C(ndim_C);
 
+    std::vector<double> norms_A, norms_B;
+    long pairs = 0, skipped = 0;
+
+    if (block_screening_tol > 0)
+    {
+        norms_A = dpd_block_norms(type, comm, A);
+        norms_B = dpd_block_norms(type, comm, B);
+    }
+
     for (auto irrep_ABC : range(nirrep))
     {
         if (ndim_ABC == 0 && irrep_ABC != 0) continue;
@@ -491,23 +570,25 @@ void mult_block(type_t type, const communicator& comm, const cntx_t* cntx,
             if (ndim_AC == 0 && irrep_AC != 0) continue;
             if (ndim_BC == 0 && irrep_BC != 0) continue;
 
-            for (stride_type block_ABC = 0;block_ABC < nblock_ABC;block_ABC++)
+            auto blocks_AB = dpd_nonempty_blocks(A, idx_A_AB, irrep_AB);
+            auto blocks_AC = dpd_nonempty_blocks(C, idx_C_AC, irrep_AC);
+            auto blocks_BC = dpd_nonempty_blocks(C, idx_C_BC, irrep_BC);
+
+            for (auto block_ABC : *dpd_nonempty_blocks(C, idx_C_ABC, irrep_ABC))
             {
                 assign_irreps(ndim_ABC, irrep_ABC, nirrep, block_ABC,
                               irreps_A, idx_A_ABC, irreps_B, idx_B_ABC, irreps_C, idx_C_ABC);
 
-                for (stride_type block_AC = 0;block_AC < nblock_AC;block_AC++)
+                for (auto block_AC : *blocks_AC)
                 {
                     assign_irreps(ndim_AC, irrep_AC, nirrep, block_AC,
                                   irreps_A, idx_A_AC, irreps_C, idx_C_AC);
 
-                    for (stride_type block_BC = 0;block_BC < nblock_BC;block_BC++)
+                    for (auto block_BC : *blocks_BC)
                     {
                         assign_irreps(ndim_BC, irrep_BC, nirrep, block_BC,
                                       irreps_B, idx_B_BC, irreps_C, idx_C_BC);
 
-                        if (is_block_empty(C, irreps_C)) continue;
-
                         marray_view<char> local_C = C(irreps_C);
 
                         auto len_ABC = stl_ext::select_from(local_C.lengths(), idx_C_ABC);
@@ -520,12 +601,21 @@ void mult_block(type_t type, const communicator& comm, const cntx_t* cntx,
                         if ((ndim_AB != 0 || irrep_AB == 0) &&
                             irrep_ABC == (A.irrep()^B.irrep()^C.irrep()))
                         {
-                            for (stride_type block_AB = 0;block_AB < nblock_AB;block_AB++)
+                            for (auto block_AB : *blocks_AB)
                             {
                                 assign_irreps(ndim_AB, irrep_AB, nirrep, block_AB,
                                               irreps_A, idx_A_AB, irreps_B, idx_B_AB);
 
-                                if (is_block_empty(A, irreps_A)) continue;
+                                if (block_screening_tol > 0)
+                                {
+                                    pairs++;
+                                    if (screen_block_pair(alpha, norms_A[dpd_block_number(nirrep, irreps_A)],
+                                                                 norms_B[dpd_block_number(nirrep, irreps_B)]))
+                                    {
+                                        skipped++;
+                                        continue;
+                                    }
+                                }
 
                                 marray_view<char> local_A = A(irreps_A);
                                 marray_view<char> local_B = B(irreps_B);
@@ -549,6 +639,8 @@ void mult_block(type_t type, const communicator& comm, const cntx_t* cntx,
             }
         }
     }
+
+    record_screening(comm, pairs, skipped);
 }
 
 static
@@ -768,6 +860,8 @@ void mult(type_t type, const communicator& comm, const cntx_t* cntx,
 
     if (dpd_impl == FULL)
     {
+        record_algorithm(comm, ALGORITHM_DPD_FULL);
+
         mult_full(type, comm, cntx,
                   alpha, conj_A, A, idx_A_AB, idx_A_AC, idx_A_ABC,
                          conj_B, B, idx_B_AB, idx_B_BC, idx_B_ABC,
@@ -778,6 +872,8 @@ void mult(type_t type, const communicator& comm, const cntx_t* cntx,
     }
     else if (dpd_impl == BLOCKED)
     {
+        record_algorithm(comm, ALGORITHM_DPD_BLOCKED);
+
         mult_block(type, comm, cntx,
                    alpha, conj_A, A, idx_A_AB, idx_A_AC, idx_A_ABC,
                           conj_B, B, idx_B_AB, idx_B_BC, idx_B_ABC,
@@ -787,6 +883,8 @@ void mult(type_t type, const communicator& comm, const cntx_t* cntx,
         return;
     }
 
+    record_algorithm(comm, ALGORITHM_DPD_BLIS);
+
     enum
     {
         HAS_NONE = 0x0,
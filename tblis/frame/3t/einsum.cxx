@@ -0,0 +1,591 @@
+#include "einsum.h"
+#include "einsum.hpp"
+
+#include "tblis/frame/1t/add.h"
+#include "tblis/frame/3t/mult.h"
+
+#include "tblis/frame/base/tensor.hpp"
+#include "tblis/frame/base/stats.hpp"
+#include "tblis/frame/base/alignment.hpp"
+#include "tblis/frame/base/aligned_allocator.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <mutex>
+
+namespace tblis
+{
+namespace internal
+{
+
+einsum_search_t einsum_search = EINSUM_AUTO;
+
+len_type einsum_memory_limit = 0;
+
+using len_map = std::map<label_type,len_type>;
+
+struct einsum_cost
+{
+    double flops = 0;
+    double memory = 0;
+
+    bool operator<(const einsum_cost& other) const
+    {
+        return flops < other.flops ||
+               (flops == other.flops && memory < other.memory);
+    }
+};
+
+static label_vector label_set(label_vector idx)
+{
+    std::sort(idx.begin(), idx.end());
+    idx.erase(std::unique(idx.begin(), idx.end()), idx.end());
+    return idx;
+}
+
+static label_vector set_union(const label_vector& a, const label_vector& b)
+{
+    label_vector r;
+    std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(r));
+    return r;
+}
+
+static label_vector set_intersection(const label_vector& a, const label_vector& b)
+{
+    label_vector r;
+    std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(r));
+    return r;
+}
+
+static double set_size(const label_vector& idx, const len_map& len)
+{
+    double size = 1;
+    for (auto i : idx) size *= len.at(i);
+    return size;
+}
+
+/*
+ * Labels of the result of contracting ops[i] and ops[j]: those which are
+ * still needed either by the output or by one of the other operands.
+ */
+static label_vector contracted_set(const std::vector<label_vector>& ops,
+                                   int i, int j, const label_vector& idx_C)
+{
+    auto keep = idx_C;
+    for (auto k : range(ops.size()))
+        if (k != i && k != j) keep = set_union(keep, ops[k]);
+
+    return set_intersection(set_union(ops[i], ops[j]), keep);
+}
+
+static bool any_shared(const std::vector<label_vector>& ops)
+{
+    for (auto i : range(ops.size()))
+    for (auto j : range(i+1, ops.size()))
+        if (!set_intersection(ops[i], ops[j]).empty()) return true;
+
+    return false;
+}
+
+static void contract_pair(std::vector<label_vector>& ops, int i, int j, label_vector idx)
+{
+    ops.erase(ops.begin()+j);
+    ops.erase(ops.begin()+i);
+    ops.push_back(std::move(idx));
+}
+
+static einsum_path greedy_path(std::vector<label_vector> ops,
+                               const label_vector& idx_C,
+                               const len_map& len,
+                               einsum_cost& cost)
+{
+    einsum_path path;
+
+    while (ops.size() > 1)
+    {
+        auto shared = any_shared(ops);
+        auto limit = einsum_memory_limit > 0 ? double(einsum_memory_limit) :
+                                               std::numeric_limits<double>::max();
+
+        int best_i = -1, best_j = -1;
+        double best_key = 0, best_flops = 0, best_size = 0;
+        bool best_fits = false;
+        label_vector best_idx;
+
+        for (auto i : range(ops.size()))
+        for (auto j : range(i+1, ops.size()))
+        {
+            if (shared && set_intersection(ops[i], ops[j]).empty()) continue;
+
+            auto idx = contracted_set(ops, i, j, idx_C);
+            auto size = set_size(idx, len);
+            auto flops = set_size(set_union(ops[i], ops[j]), len);
+            auto key = size - set_size(ops[i], len) - set_size(ops[j], len);
+            auto fits = ops.size() == 2 || size <= limit;
+
+            if (best_i == -1 || (fits && !best_fits) ||
+                (fits == best_fits && (key < best_key ||
+                                       (key == best_key && flops < best_flops))))
+            {
+                best_i = i;
+                best_j = j;
+                best_key = key;
+                best_flops = flops;
+                best_size = size;
+                best_fits = fits;
+                best_idx = std::move(idx);
+            }
+        }
+
+        cost.flops += best_flops;
+        if (ops.size() > 2) cost.memory = std::max(cost.memory, best_size);
+
+        path.emplace_back(best_i, best_j);
+        contract_pair(ops, best_i, best_j, std::move(best_idx));
+    }
+
+    return path;
+}
+
+static void optimal_path(const std::vector<label_vector>& ops,
+                         const label_vector& idx_C,
+                         const len_map& len,
+                         einsum_path& path,
+                         const einsum_cost& cost,
+                         einsum_path& best_path,
+                         einsum_cost& best_cost)
+{
+    if (ops.size() == 1)
+    {
+        if (cost < best_cost)
+        {
+            best_cost = cost;
+            best_path = path;
+        }
+        return;
+    }
+
+    auto shared = any_shared(ops);
+
+    for (auto i : range(ops.size()))
+    for (auto j : range(i+1, ops.size()))
+    {
+        if (shared && set_intersection(ops[i], ops[j]).empty()) continue;
+
+        auto idx = contracted_set(ops, i, j, idx_C);
+        auto size = set_size(idx, len);
+
+        if (ops.size() > 2 && einsum_memory_limit > 0 &&
+            size > double(einsum_memory_limit)) continue;
+
+        auto new_cost = cost;
+        new_cost.flops += set_size(set_union(ops[i], ops[j]), len);
+        if (ops.size() > 2) new_cost.memory = std::max(new_cost.memory, size);
+
+        if (!(new_cost < best_cost)) continue;
+
+        auto next = ops;
+        contract_pair(next, i, j, std::move(idx));
+
+        path.emplace_back(i, j);
+        optimal_path(next, idx_C, len, path, new_cost, best_path, best_cost);
+        path.pop_back();
+    }
+}
+
+einsum_path einsum_find_path(const std::vector<label_vector>& idx_ops,
+                             const label_vector& idx_C,
+                             const len_map& len,
+                             einsum_search_t search)
+{
+    std::vector<label_vector> ops;
+    for (auto& idx : idx_ops) ops.push_back(label_set(idx));
+    auto set_C = label_set(idx_C);
+
+    einsum_cost cost;
+    auto path = greedy_path(ops, set_C, len, cost);
+
+    if (search == EINSUM_OPTIMAL || (search == EINSUM_AUTO && ops.size() <= 6))
+    {
+        einsum_path cur_path;
+        optimal_path(ops, set_C, len, cur_path, {}, path, cost);
+    }
+
+    return path;
+}
+
+static std::mutex path_cache_mutex;
+static std::map<std::vector<long>,einsum_path> path_cache;
+
+void einsum_clear_cache()
+{
+    std::lock_guard<std::mutex> guard(path_cache_mutex);
+    path_cache.clear();
+}
+
+static einsum_path cached_path(const std::vector<label_vector>& idx_ops,
+                               const label_vector& idx_C,
+                               const len_map& len)
+{
+    std::vector<long> key{einsum_search, einsum_memory_limit, (long)idx_ops.size()};
+
+    auto append = [&](const label_vector& idx)
+    {
+        key.push_back(idx.size());
+        for (auto i : idx) key.push_back(i);
+        for (auto i : idx) key.push_back(len.at(i));
+    };
+
+    for (auto& idx : idx_ops) append(idx);
+    append(idx_C);
+
+    std::lock_guard<std::mutex> guard(path_cache_mutex);
+
+    auto it = path_cache.find(key);
+    if (it != path_cache.end()) return it->second;
+
+    auto path = einsum_find_path(idx_ops, idx_C, len, einsum_search);
+    path_cache.emplace(std::move(key), path);
+    return path;
+}
+
+/*
+ * An uninitialized, aligned workspace; every byte of it is written before
+ * it is read.
+ */
+class workspace_buffer
+{
+    protected:
+        char* data_ = nullptr;
+        size_t size_ = 0;
+
+    public:
+        workspace_buffer() {}
+
+        explicit workspace_buffer(size_t size)
+        : data_(aligned_allocator<char,64>().allocate(size)), size_(size) {}
+
+        workspace_buffer(workspace_buffer&& other)
+        : data_(other.data_), size_(other.size_)
+        {
+            other.data_ = nullptr;
+            other.size_ = 0;
+        }
+
+        workspace_buffer& operator=(workspace_buffer&& other)
+        {
+            std::swap(data_, other.data_);
+            std::swap(size_, other.size_);
+            return *this;
+        }
+
+        ~workspace_buffer()
+        {
+            aligned_allocator<char,64>().deallocate(data_, size_);
+        }
+
+        char* data() const { return data_; }
+
+        size_t size() const { return size_; }
+};
+
+/*
+ * The most workspaces kept for reuse. When there are more, the smallest
+ * ones are freed, since they are the least likely to fit later calls.
+ */
+constexpr size_t workspace_pool_max = 4;
+
+static std::mutex workspace_mutex;
+static std::vector<workspace_buffer> workspace_pool;
+
+static workspace_buffer acquire_workspace(size_t size)
+{
+    std::lock_guard<std::mutex> guard(workspace_mutex);
+
+    auto best = workspace_pool.end();
+    for (auto it = workspace_pool.begin();it != workspace_pool.end();++it)
+    {
+        if (it->size() >= size && (best == workspace_pool.end() || it->size() < best->size()))
+            best = it;
+    }
+
+    if (best == workspace_pool.end())
+        return workspace_buffer(size);
+
+    auto buf = std::move(*best);
+    workspace_pool.erase(best);
+    return buf;
+}
+
+static void release_workspace(workspace_buffer&& buf)
+{
+    std::lock_guard<std::mutex> guard(workspace_mutex);
+    workspace_pool.push_back(std::move(buf));
+
+    if (workspace_pool.size() > workspace_pool_max)
+    {
+        auto smallest = std::min_element(workspace_pool.begin(), workspace_pool.end(),
+            [](const workspace_buffer& a, const workspace_buffer& b) { return a.size() < b.size(); });
+        workspace_pool.erase(smallest);
+    }
+}
+
+/*
+ * First-fit placement of intermediates within a single workspace buffer.
+ */
+class workspace_plan
+{
+    protected:
+        std::map<stride_type,stride_type> live_;
+        stride_type size_ = 0;
+
+    public:
+        stride_type allocate(stride_type size)
+        {
+            size = round_up(std::max<stride_type>(size, 1), 64);
+
+            stride_type off = 0;
+            for (auto& block : live_)
+            {
+                if (block.first-off >= size) break;
+                off = block.first+block.second;
+            }
+
+            live_.emplace(off, size);
+            size_ = std::max(size_, off+size);
+            return off;
+        }
+
+        void free(stride_type off)
+        {
+            live_.erase(off);
+        }
+
+        stride_type size() const { return size_; }
+};
+
+struct einsum_operand
+{
+    const tblis_tensor* tensor = nullptr;
+    label_vector idx;
+    len_vector len;
+    stride_vector stride;
+    stride_type offset = -1;
+
+    /*
+     * Intermediates are overwritten when they are the output of a step, and
+     * have already absorbed the scaling of the original operands when used
+     * as an input.
+     */
+    tblis_tensor as_tensor(type_t type, char* workspace, bool output) const
+    {
+        if (tensor) return *tensor;
+
+        tblis_tensor t;
+        t.type = type;
+        t.conj = false;
+        t.scalar.reset(output ? 0.0 : 1.0, type);
+        t.data = workspace + offset;
+        t.ndim = idx.size();
+        t.len = const_cast<len_type*>(len.data());
+        t.stride = const_cast<stride_type*>(stride.data());
+        return t;
+    }
+};
+
+static einsum_operand make_intermediate(const label_vector& idx, const len_map& len,
+                                        type_t type, workspace_plan& plan)
+{
+    einsum_operand op;
+    op.idx = idx;
+
+    stride_type size = 1;
+    for (auto i : idx)
+    {
+        op.len.push_back(len.at(i));
+        op.stride.push_back(size);
+        size *= len.at(i);
+    }
+
+    op.offset = plan.allocate(size*type_size[type]);
+    return op;
+}
+
+}
+
+TBLIS_EXPORT
+void tblis_tensor_einsum(const tblis_comm* comm,
+                         const tblis_config* cntx,
+                         int nop,
+                         const tblis_tensor* const* ops,
+                         const label_type* const* idx_ops_,
+                               tblis_tensor* C,
+                         const label_type* idx_C_)
+{
+    using namespace internal;
+
+    initialize_once();
+    stats_scope stats(comm);
+
+    TBLIS_ASSERT(nop > 0);
+
+    auto type = C->type;
+    for (auto i : range(nop))
+        TBLIS_ASSERT(ops[i]->type == type);
+
+    if (nop == 1)
+    {
+        tblis_tensor_add(comm, cntx, ops[0], idx_ops_[0], C, idx_C_);
+        return;
+    }
+
+    len_map len;
+    std::vector<label_vector> idx_ops(nop);
+
+    auto record = [&](const tblis_tensor* t, const label_type* idx_)
+    {
+        label_vector idx(idx_, idx_+t->ndim);
+        for (auto i : range(t->ndim))
+        {
+            auto it = len.find(idx[i]);
+            if (it == len.end())
+                len.emplace(idx[i], t->len[i]);
+            else
+                TBLIS_ASSERT(it->second == t->len[i]);
+        }
+        return idx;
+    };
+
+    for (auto i : range(nop))
+        idx_ops[i] = record(ops[i], idx_ops_[i]);
+
+    label_vector idx_C(idx_C_, idx_C_+C->ndim);
+    for (auto i : range(C->ndim))
+    {
+        TBLIS_ASSERT(len.count(idx_C[i]), "Output label does not appear in any operand");
+        TBLIS_ASSERT(len.at(idx_C[i]) == C->len[i]);
+    }
+
+    /*
+     * Labels which appear in only one operand and not in the output are
+     * summed over before the pairwise contractions.
+     */
+    auto set_C = label_set(idx_C);
+    std::vector<label_vector> needed(nop);
+    for (auto i : range(nop))
+    {
+        auto keep = set_C;
+        for (auto j : range(nop))
+            if (j != i) keep = set_union(keep, label_set(idx_ops[j]));
+        needed[i] = set_intersection(label_set(idx_ops[i]), keep);
+    }
+
+    auto path = cached_path(needed, idx_C, len);
+    TBLIS_ASSERT(path.size() == (size_t)nop-1);
+
+    workspace_plan plan;
+    std::vector<einsum_operand> operands(nop);
+    std::vector<std::pair<int,int>> reductions;
+
+    for (auto i : range(nop))
+    {
+        if (needed[i] == label_set(idx_ops[i]))
+        {
+            operands[i].tensor = ops[i];
+            operands[i].idx = idx_ops[i];
+        }
+        else
+        {
+            operands[i] = make_intermediate(needed[i], len, type, plan);
+            reductions.emplace_back(i, i);
+        }
+    }
+
+    std::vector<einsum_operand> list(operands);
+    std::vector<std::array<einsum_operand,3>> steps;
+
+    for (auto& step : path)
+    {
+        auto i = step.first;
+        auto j = step.second;
+
+        auto& A = list[i];
+        auto& B = list[j];
+
+        einsum_operand AB;
+        if (list.size() > 2)
+        {
+            std::vector<label_vector> sets;
+            for (auto& op : list) sets.push_back(label_set(op.idx));
+            AB = make_intermediate(contracted_set(sets, i, j, set_C), len, type, plan);
+        }
+
+        if (A.offset >= 0) plan.free(A.offset);
+        if (B.offset >= 0) plan.free(B.offset);
+
+        steps.push_back({A, B, AB});
+
+        list.erase(list.begin()+j);
+        list.erase(list.begin()+i);
+        list.push_back(AB);
+    }
+
+    parallelize_if(
+    [&](const communicator& comm)
+    {
+        record_algorithm(comm, ALGORITHM_EINSUM);
+
+        workspace_buffer workspace;
+        char* ptr = nullptr;
+
+        if (comm.master() && plan.size() > 0)
+        {
+            workspace = acquire_workspace(plan.size());
+            ptr = workspace.data();
+        }
+
+        comm.broadcast(
+        [&](char* workspace)
+        {
+            for (auto& r : reductions)
+            {
+                auto i = r.first;
+                auto R = operands[i].as_tensor(type, workspace, true);
+                tblis_tensor_add(comm, cntx, ops[i], idx_ops_[i], &R, operands[i].idx.data());
+            }
+
+            for (auto& step : steps)
+            {
+                auto A = step[0].as_tensor(type, workspace, false);
+                auto B = step[1].as_tensor(type, workspace, false);
+
+                if (&step == &steps.back())
+                {
+                    auto C_ = *C;
+                    tblis_tensor_mult(comm, cntx, &A, step[0].idx.data(),
+                                                  &B, step[1].idx.data(),
+                                                  &C_, idx_C_);
+                }
+                else
+                {
+                    auto AB = step[2].as_tensor(type, workspace, true);
+                    tblis_tensor_mult(comm, cntx, &A, step[0].idx.data(),
+                                                  &B, step[1].idx.data(),
+                                                  &AB, step[2].idx.data());
+                }
+            }
+        },
+        ptr);
+
+        comm.barrier();
+
+        if (comm.master() && plan.size() > 0)
+            release_workspace(std::move(workspace));
+    }, comm);
+
+    C->scalar = 1;
+    C->conj = false;
+}
+
+}
@@ -0,0 +1,148 @@
+#ifndef _TBLIS_IFACE_3T_EINSUM_H_
+#define _TBLIS_IFACE_3T_EINSUM_H_
+
+#include "../base/thread.h"
+#include "../base/basic_types.h"
+
+#if TBLIS_ENABLE_CPLUSPLUS
+#include <initializer_list>
+#include <vector>
+#endif
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wnull-dereference"
+
+TBLIS_BEGIN_NAMESPACE
+
+/*
+ * C = prod(ops[i]->scalar) * contract(ops[0], ..., ops[nop-1]) + C->scalar * C
+ *
+ * Labels which do not appear in C are summed over. The operands are
+ * contracted pairwise in an order chosen to minimize the number of flops
+ * (and, secondarily, the size of the largest intermediate). The order is
+ * cached for each distinct set of shapes and labels.
+ */
+TBLIS_EXPORT
+void tblis_tensor_einsum(const tblis_comm* comm,
+                         const tblis_config* cntx,
+                         int nop,
+                         const tblis_tensor* const* ops,
+                         const label_type* const* idx_ops,
+                               tblis_tensor* C,
+                         const label_type* idx_C);
+
+#if TBLIS_ENABLE_CPLUSPLUS
+
+inline
+void einsum(const communicator& comm,
+            const scalar& alpha,
+            std::initializer_list<tensor_wrapper> ops,
+            std::initializer_list<label_vector> idx_ops,
+            const scalar& beta,
+            const tensor_wrapper& C,
+            const label_vector& idx_C)
+{
+    TBLIS_ASSERT(ops.size() > 0);
+    TBLIS_ASSERT(ops.size() == idx_ops.size());
+
+    std::vector<tblis_tensor> ops_(ops.begin(), ops.end());
+    ops_[0].scalar *= alpha.convert(ops_[0].type);
+
+    std::vector<const tblis_tensor*> ptr_ops;
+    std::vector<const label_type*> ptr_idx_ops;
+    auto idx = idx_ops.begin();
+    for (auto& op : ops_)
+    {
+        TBLIS_ASSERT(op.ndim == idx->size());
+        ptr_ops.push_back(&op);
+        ptr_idx_ops.push_back((idx++)->data());
+    }
+
+    auto C_(C);
+    C_.scalar *= beta.convert(C_.type);
+
+    TBLIS_ASSERT(C.ndim == idx_C.size());
+
+    tblis_tensor_einsum(comm, nullptr, ops_.size(), ptr_ops.data(), ptr_idx_ops.data(),
+                        &C_, idx_C.data());
+}
+
+inline
+void einsum(const communicator& comm,
+            std::initializer_list<tensor_wrapper> ops,
+            std::initializer_list<label_vector> idx_ops,
+            const scalar& beta,
+            const tensor_wrapper& C,
+            const label_vector& idx_C)
+{
+    einsum(comm, {1.0, C.type}, ops, idx_ops, beta, C, idx_C);
+}
+
+inline
+void einsum(const communicator& comm,
+            const scalar& alpha,
+            std::initializer_list<tensor_wrapper> ops,
+            std::initializer_list<label_vector> idx_ops,
+            const tensor_wrapper& C,
+            const label_vector& idx_C)
+{
+    einsum(comm, alpha, ops, idx_ops, {0.0, C.type}, C, idx_C);
+}
+
+inline
+void einsum(const communicator& comm,
+            std::initializer_list<tensor_wrapper> ops,
+            std::initializer_list<label_vector> idx_ops,
+            const tensor_wrapper& C,
+            const label_vector& idx_C)
+{
+    einsum(comm, {1.0, C.type}, ops, idx_ops, {0.0, C.type}, C, idx_C);
+}
+
+TBLIS_COMPAT_INLINE
+void einsum(const scalar& alpha,
+            std::initializer_list<tensor_wrapper> ops,
+            std::initializer_list<label_vector> idx_ops,
+            const scalar& beta,
+            const tensor_wrapper& C,
+            const label_vector& idx_C)
+{
+    einsum(*(communicator*)nullptr, alpha, ops, idx_ops, beta, C, idx_C);
+}
+
+inline
+void einsum(std::initializer_list<tensor_wrapper> ops,
+            std::initializer_list<label_vector> idx_ops,
+            const scalar& beta,
+            const tensor_wrapper& C,
+            const label_vector& idx_C)
+{
+    einsum({1.0, C.type}, ops, idx_ops, beta, C, idx_C);
+}
+
+inline
+void einsum(const scalar& alpha,
+            std::initializer_list<tensor_wrapper> ops,
+            std::initializer_list<label_vector> idx_ops,
+            const tensor_wrapper& C,
+            const label_vector& idx_C)
+{
+    einsum(alpha, ops, idx_ops, {0.0, C.type}, C, idx_C);
+}
+
+inline
+void einsum(std::initializer_list<tensor_wrapper> ops,
+            std::initializer_list<label_vector> idx_ops,
+            const tensor_wrapper& C,
+            const label_vector& idx_C)
+{
+    einsum({1.0, C.type}, ops, idx_ops, {0.0, C.type}, C, idx_C);
+}
+
+#endif
+
+TBLIS_END_NAMESPACE
+
+#pragma GCC diagnostic pop
+
+#endif
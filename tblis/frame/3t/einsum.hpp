@@ -0,0 +1,42 @@
+#ifndef _TBLIS_INTERNAL_3T_EINSUM_HPP_
+#define _TBLIS_INTERNAL_3T_EINSUM_HPP_
+
+#include "tblis/frame/base/thread.h"
+#include "tblis/frame/base/basic_types.h"
+
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace tblis
+{
+namespace internal
+{
+
+enum einsum_search_t {EINSUM_AUTO, EINSUM_GREEDY, EINSUM_OPTIMAL};
+extern einsum_search_t einsum_search;
+
+/*
+ * Intermediates larger than this (in elements) are avoided during the
+ * path search when possible. Zero means no limit.
+ */
+extern len_type einsum_memory_limit;
+
+/*
+ * Each step contracts the operands at positions first and second
+ * (first < second) of the current operand list, removes them, and appends
+ * the result to the end of the list.
+ */
+using einsum_path = std::vector<std::pair<int,int>>;
+
+einsum_path einsum_find_path(const std::vector<label_vector>& idx_ops,
+                             const label_vector& idx_C,
+                             const std::map<label_type,len_type>& len,
+                             einsum_search_t search);
+
+void einsum_clear_cache();
+
+}
+}
+
+#endif
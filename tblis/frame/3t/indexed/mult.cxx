@@ -5,6 +5,7 @@
 #include "tblis/frame/3t/dense/mult.hpp"
 
 #include "tblis/frame/base/tensor.hpp"
+#include "tblis/frame/base/stats.hpp"
 
 namespace tblis
 {
@@ -80,9 +81,9 @@ void contract_block(type_t type, const communicator& comm, const cntx_t* cntx,
     index_group<2> group_AC(A, idx_A_AC, C, idx_C_AC);
     index_group<2> group_BC(B, idx_B_BC, C, idx_C_BC);
 
-    group_indices<2> indices_A(type, A, group_AC, 0, group_AB, 0);
-    group_indices<2> indices_B(type, B, group_BC, 0, group_AB, 1);
-    group_indices<2> indices_C(type, C, group_AC, 1, group_BC, 1);
+    group_indices<2> indices_A(type, comm, A, group_AC, 0, group_AB, 0);
+    group_indices<2> indices_B(type, comm, B, group_BC, 0, group_AB, 1);
+    group_indices<2> indices_C(type, comm, C, group_AC, 1, group_BC, 1);
     auto nidx_A = indices_A.size();
     auto nidx_B = indices_B.size();
     auto nidx_C = indices_C.size();
@@ -183,9 +184,9 @@ void mult_block(type_t type, const communicator& comm, const cntx_t* cntx,
     index_group<2> group_AC(A, idx_A_AC, C, idx_C_AC);
     index_group<2> group_BC(B, idx_B_BC, C, idx_C_BC);
 
-    group_indices<3> indices_A(type, A, group_ABC, 0, group_AC, 0, group_AB, 0);
-    group_indices<3> indices_B(type, B, group_ABC, 1, group_BC, 0, group_AB, 1);
-    group_indices<3> indices_C(type, C, group_ABC, 2, group_AC, 1, group_BC, 1);
+    group_indices<3> indices_A(type, comm, A, group_ABC, 0, group_AC, 0, group_AB, 0);
+    group_indices<3> indices_B(type, comm, B, group_ABC, 1, group_BC, 0, group_AB, 1);
+    group_indices<3> indices_C(type, comm, C, group_ABC, 2, group_AC, 1, group_BC, 1);
     auto nidx_A = indices_A.size();
     auto nidx_B = indices_B.size();
     auto nidx_C = indices_C.size();
@@ -302,6 +303,8 @@ void mult(type_t type, const communicator& comm, const cntx_t* cntx,
         scale(type, comm, cntx, beta, conj_C, C, range(C.dimension()));
     }
 
+    record_algorithm(comm, dpd_impl == FULL ? ALGORITHM_INDEXED_FULL : ALGORITHM_INDEXED_BLOCKED);
+
     if (dpd_impl == FULL)
     {
         mult_full(type, comm, cntx, alpha,
@@ -7,6 +7,7 @@
 #include "tblis/frame/3t/dense/mult.hpp"
 
 #include "tblis/frame/base/tensor.hpp"
+#include "tblis/frame/base/stats.hpp"
 
 #include <memory>
 
@@ -72,6 +73,58 @@ double relative_perf(double m, double n, double k)
     return 1/(1 + flops_per_element*(0.5/m + 0.5/n + 0.5/k));
 }
 
+/*
+ * Norm-based screening of block pairs (see block_screening_tol). The norm
+ * cache is shared by all tasks of one contraction.
+ */
+class block_screening
+{
+    protected:
+        const communicator& comm_;
+        block_norm_cache* norms_ = nullptr;
+
+    public:
+        struct counter
+        {
+            const communicator& comm;
+            long pairs = 0;
+            long skipped = 0;
+
+            counter(const communicator& comm) : comm(comm) {}
+
+            ~counter() { if (pairs) record_screening(comm, pairs, skipped); }
+        };
+
+        block_screening(type_t type, const communicator& comm)
+        : comm_(comm)
+        {
+            if (block_screening_tol > 0 && comm.master())
+                norms_ = new block_norm_cache(type);
+            comm.broadcast_value(norms_);
+        }
+
+        ~block_screening()
+        {
+            comm_.barrier();
+            if (comm_.master()) delete norms_;
+        }
+
+        bool skip(counter& count, const scalar& factor,
+                  const char* A, const len_vector& len_A, const stride_vector& stride_A,
+                  const char* B, const len_vector& len_B, const stride_vector& stride_B) const
+        {
+            if (!norms_) return false;
+
+            count.pairs++;
+
+            if (!screen_block_pair(factor, (*norms_)(A, len_A, stride_A),
+                                           (*norms_)(B, len_B, stride_B))) return false;
+
+            count.skipped++;
+            return true;
+        }
+};
+
 static
 void mult_full(type_t type, const communicator& comm, const cntx_t* cntx,
                const scalar& alpha, bool conj_A, const indexed_dpd_marray_view<char>& A,
@@ -150,9 +203,9 @@ void mult_block_fuse_AB(type_t type, const communicator& comm, const cntx_t* cnt
     assign_irreps(group_AC, irreps_A, irreps_C);
     assign_irreps(group_BC, irreps_B, irreps_C);
 
-    group_indices<2> indices_A(type, A, group_AC, 0, group_AB, 0);
-    group_indices<2> indices_B(type, B, group_BC, 0, group_AB, 1);
-    group_indices<2> indices_C(type, C, group_AC, 1, group_BC, 1);
+    group_indices<2> indices_A(type, comm, A, group_AC, 0, group_AB, 0);
+    group_indices<2> indices_B(type, comm, B, group_BC, 0, group_AB, 1);
+    group_indices<2> indices_C(type, comm, C, group_AC, 1, group_BC, 1);
     auto nidx_A = indices_A.size();
     auto nidx_B = indices_B.size();
     auto nidx_C = indices_C.size();
@@ -163,6 +216,8 @@ void mult_block_fuse_AB(type_t type, const communicator& comm, const cntx_t* cnt
     auto dpd_B = B[0];
     auto dpd_C = C[0];
 
+    block_screening screening(type, comm);
+
     comm.do_tasks_deferred(nirrep*nidx_C*group_AC.dense_nblock*group_BC.dense_nblock,
                            group_AB.dense_size*group_AC.dense_size*group_BC.dense_size*group_AB.dense_nblock/inout_ratio,
     [&](communicator::deferred_task_set& tasks)
@@ -205,6 +260,8 @@ void mult_block_fuse_AB(type_t type, const communicator& comm, const cntx_t* cnt
                          irrep_AB,irrep_AC,irrep_BC,block_AC,block_BC]
                         (const communicator& subcomm)
                         {
+                            block_screening::counter count(subcomm);
+
                             auto& scat_A_AB = *(new (&scat_A_AB_) stride_vector_fuse);
                             auto& scat_B_AB = *(new (&scat_B_AB_) stride_vector_fuse);
                             auto& scat_AB = *(new (&scat_AB_) tuple_vector_fuse);
@@ -281,6 +338,14 @@ void mult_block_fuse_AB(type_t type, const communicator& comm, const cntx_t* cnt
                                                      local_A, off_A_AB, 0,
                                                      local_B, off_B_AB, 1);
 
+                                    if (screening.skip(count, factor,
+                                                       A.data(0) + (local_A.data() - A.data(0) + off_A_AC +
+                                                           indices_A[local_idx_A].offset + off_A_AB)*ts,
+                                                       len_AC + len_AB, stride_A_AC + stride_A_AB,
+                                                       B.data(0) + (local_B.data() - B.data(0) + off_B_BC +
+                                                           indices_B[local_idx_B].offset + off_B_AB)*ts,
+                                                       len_BC + len_AB, stride_B_BC + stride_B_AB)) return;
+
                                     switch (type)
                                     {
                                         case TYPE_FLOAT:
@@ -383,9 +448,9 @@ void mult_block_fuse_BC(type_t type, const communicator& comm, const cntx_t* cnt
     assign_irreps(group_AC, irreps_A, irreps_C);
     assign_irreps(group_BC, irreps_B, irreps_C);
 
-    group_indices<2> indices_A(type, A, group_AC, 0, group_AB, 0);
-    group_indices<2> indices_B(type, B, group_AB, 1, group_BC, 0);
-    group_indices<2> indices_C(type, C, group_AC, 1, group_BC, 1);
+    group_indices<2> indices_A(type, comm, A, group_AC, 0, group_AB, 0);
+    group_indices<2> indices_B(type, comm, B, group_AB, 1, group_BC, 0);
+    group_indices<2> indices_C(type, comm, C, group_AC, 1, group_BC, 1);
     auto nidx_A = indices_A.size();
     auto nidx_B = indices_B.size();
     auto nidx_C = indices_C.size();
@@ -396,6 +461,8 @@ void mult_block_fuse_BC(type_t type, const communicator& comm, const cntx_t* cnt
     auto dpd_B = B[0];
     auto dpd_C = C[0];
 
+    block_screening screening(type, comm);
+
     comm.do_tasks_deferred(nirrep*nidx_C*group_AC.dense_nblock*group_BC.dense_nblock,
                            group_AB.dense_size*group_AC.dense_size*group_BC.dense_size*group_AB.dense_nblock/inout_ratio,
     [&](communicator::deferred_task_set& tasks)
@@ -430,6 +497,8 @@ void mult_block_fuse_BC(type_t type, const communicator& comm, const cntx_t* cnt
                      irrep_AB,irrep_AC,irrep_BC,block_AC,block_BC]
                     (const communicator& subcomm)
                     {
+                        block_screening::counter count(subcomm);
+
                         auto& scat_B_BC = *(new (&scat_B_BC_) stride_vector_fuse);
                         auto& scat_C_BC = *(new (&scat_C_BC_) stride_vector_fuse);
                         auto& scat_BC = *(new (&scat_BC_) tuple_vector_fuse);
@@ -515,6 +584,14 @@ void mult_block_fuse_BC(type_t type, const communicator& comm, const cntx_t* cnt
                                                      local_B, off_B_BC, 0,
                                                      local_C, off_C_BC, 1);
 
+                                    if (screening.skip(count, factor,
+                                                       A.data(0) + (local_A.data() - A.data(0) +
+                                                           indices_A[local_idx_A].offset + off_A_AB + off_A_AC)*ts,
+                                                       len_AC + len_AB, stride_A_AC + stride_A_AB,
+                                                       B.data(0) + (local_B.data() - B.data(0) + off_B_AB +
+                                                           indices_B[local_idx_B].offset + off_B_BC)*ts,
+                                                       len_BC + len_AB, stride_B_BC + stride_B_AB)) return;
+
                                     switch (type)
                                     {
                                         case TYPE_FLOAT:
@@ -621,9 +698,9 @@ void mult_block_fuse_AB_BC(type_t type, const communicator& comm, const cntx_t*
     assign_irreps(group_AC, irreps_A, irreps_C);
     assign_irreps(group_BC, irreps_B, irreps_C);
 
-    group_indices<2> indices_A(type, A, group_AC, 0, group_AB, 0);
+    group_indices<2> indices_A(type, comm, A, group_AC, 0, group_AB, 0);
     TBLIS_ASSERT(B.indexed_dimension() == 0);
-    group_indices<2> indices_C(type, C, group_AC, 1, group_BC, 1);
+    group_indices<2> indices_C(type, comm, C, group_AC, 1, group_BC, 1);
     auto nidx_A = indices_A.size();
     auto nidx_C = indices_C.size();
 
@@ -635,6 +712,8 @@ void mult_block_fuse_AB_BC(type_t type, const communicator& comm, const cntx_t*
     auto dpd_B = B[0];
     auto dpd_C = C[0];
 
+    block_screening screening(type, comm);
+
     comm.do_tasks_deferred(nirrep*nidx_C*group_AC.dense_nblock*group_BC.dense_nblock,
                            group_AC.dense_size*group_BC.dense_size*group_AB.dense_size*group_AB.dense_nblock/inout_ratio,
     [&](communicator::deferred_task_set& tasks)
@@ -669,6 +748,8 @@ void mult_block_fuse_AB_BC(type_t type, const communicator& comm, const cntx_t*
                      irrep_AB,irrep_AC,irrep_BC,block_AC,block_BC]
                     (const communicator& subcomm)
                     {
+                        block_screening::counter count(subcomm);
+
                         auto& scat_A_AB = *(new (&scat_A_AB_) stride_vector_fuse);
                         auto& scat_B_AB = *(new (&scat_B_AB_) stride_vector_fuse);
                         auto& scat_B_BC = *(new (&scat_B_BC_) stride_vector_fuse);
@@ -727,6 +808,20 @@ void mult_block_fuse_AB_BC(type_t type, const communicator& comm, const cntx_t*
                             scat_AB.clear();
                             scat_BC.clear();
 
+                            /*
+                             * B has no indexed dimensions, so each block of A is
+                             * screened against the whole dense block of B and the
+                             * largest factor of C.
+                             */
+                            scalar factor_C(0.0, type);
+                            if (block_screening_tol > 0)
+                            {
+                                for (auto local_idx_C = idx_C;local_idx_C < next_C;local_idx_C++)
+                                    if (std::abs(indices_C[local_idx_C].factor.as<dcomplex>()) >
+                                        std::abs(factor_C.as<dcomplex>()))
+                                        factor_C = indices_C[local_idx_C].factor;
+                            }
+
                             for (auto local_idx_A = idx_A;local_idx_A < next_A;local_idx_A++)
                             {
                                 auto factor = alpha*indices_A[local_idx_A].factor*factor_B;
@@ -737,6 +832,13 @@ void mult_block_fuse_AB_BC(type_t type, const communicator& comm, const cntx_t*
                                                  local_A, off_A_AB, 0,
                                                  local_B, off_B_AB, 1);
 
+                                if (screening.skip(count, factor*factor_C,
+                                                   A.data(0) + (local_A.data() - A.data(0) + off_A_AC +
+                                                       off_A_AB + indices_A[local_idx_A].offset)*ts,
+                                                   len_AC + len_AB, stride_A_AC + stride_A_AB,
+                                                   B.data(0) + (local_B.data() - B.data(0))*ts,
+                                                   local_B.lengths(), local_B.strides())) continue;
+
                                 switch (type)
                                 {
                                     case TYPE_FLOAT:
@@ -984,9 +1086,9 @@ void mult_block(type_t type, const communicator& comm, const cntx_t* cntx,
     const auto ts = type_size[type];
     const auto nirrep = A.num_irreps();
 
-    group_indices<2> indices_A(type, A, group_AC, 1, group_AB, 0);
-    group_indices<2> indices_B(type, B, group_BC, 1, group_AB, 1);
-    group_indices<2> indices_C(type, C, group_AC, 0, group_BC, 0);
+    group_indices<2> indices_A(type, comm, A, group_AC, 1, group_AB, 0);
+    group_indices<2> indices_B(type, comm, B, group_BC, 1, group_AB, 1);
+    group_indices<2> indices_C(type, comm, C, group_AC, 0, group_BC, 0);
 
     auto nidx_A = indices_A.size();
     auto nidx_B = indices_B.size();
@@ -1140,9 +1242,9 @@ void mult_block(type_t type, const communicator& comm, const cntx_t* cntx,
     assign_irreps(group_AC, irreps_A, irreps_C);
     assign_irreps(group_BC, irreps_B, irreps_C);
 
-    group_indices<3> indices_A(type, A, group_ABC, 0, group_AC, 0, group_AB, 0);
-    group_indices<3> indices_B(type, B, group_ABC, 1, group_BC, 0, group_AB, 1);
-    group_indices<3> indices_C(type, C, group_ABC, 2, group_AC, 1, group_BC, 1);
+    group_indices<3> indices_A(type, comm, A, group_ABC, 0, group_AC, 0, group_AB, 0);
+    group_indices<3> indices_B(type, comm, B, group_ABC, 1, group_BC, 0, group_AB, 1);
+    group_indices<3> indices_C(type, comm, C, group_ABC, 2, group_AC, 1, group_BC, 1);
     auto nidx_A = indices_A.size();
     auto nidx_B = indices_B.size();
     auto nidx_C = indices_C.size();
@@ -1395,6 +1497,8 @@ void mult(type_t type, const communicator& comm, const cntx_t* cntx,
         }
     }
 
+    record_algorithm(comm, dpd_impl == FULL ? ALGORITHM_INDEXED_DPD_FULL : ALGORITHM_INDEXED_DPD_BLOCKED);
+
     if (dpd_impl == FULL)
     {
         mult_full(type, comm, cntx, alpha,
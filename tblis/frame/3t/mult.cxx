@@ -3,6 +3,12 @@
 #include "tblis/plugin/bli_plugin_tblis.h"
 
 #include "tblis/frame/base/tensor.hpp"
+#include "tblis/frame/base/alignment.hpp"
+#include "tblis/frame/base/stats.hpp"
+#include "tblis/frame/base/async.hpp"
+#include "tblis/frame/1t/dot.h"
+#include "tblis/frame/1t/scale.h"
+#include "tblis/frame/1t/dense/convert.hpp"
 #include "tblis/frame/1t/dense/scale.hpp"
 #include "tblis/frame/1t/dense/set.hpp"
 #include "tblis/frame/3t/dense/mult.hpp"
@@ -19,21 +25,196 @@
 namespace tblis
 {
 
+/*
+ * The real view of a complex tensor: a real tensor with a leading dimension
+ * of length 2 for the real and imaginary parts, labelled idx_ri.
+ */
+struct real_view : tblis_tensor
+{
+    len_vector len_buf;
+    stride_vector stride_buf;
+    label_vector idx;
+
+    real_view(const tblis_tensor& Z, const label_type* idx_Z, label_type idx_ri)
+    : tblis_tensor(Z),
+      len_buf{2}, stride_buf{1}, idx{idx_ri}
+    {
+        for (auto i : range(Z.ndim))
+        {
+            len_buf.push_back(Z.len[i]);
+            stride_buf.push_back(2*Z.stride[i]);
+            idx.push_back(idx_Z[i]);
+        }
+
+        type = Z.type & ~TYPE_SCOMPLEX;
+        conj = false;
+        scalar.reset(1.0, type);
+        ndim = Z.ndim+1;
+        len = len_buf.data();
+        stride = stride_buf.data();
+    }
+};
+
+/*
+ * A real tensor times a complex tensor. Since the real operand does not mix
+ * the real and imaginary parts of the complex one, this is a real
+ * contraction in which the complex operand and C are viewed as real
+ * tensors with an extra index for the real and imaginary parts. The real
+ * operand is packed as is and the kernels run at real speed, half of the
+ * cost of the complex contraction after promoting it.
+ *
+ * With P = R*Z computed this way,
+ *
+ *   C = alpha*conj?(P) + beta*C
+ *     = alpha*conj?(P + conj?(beta/alpha*C)),
+ *
+ * so a complex alpha or a conjugated Z costs a scaling of C before and
+ * after the real contraction.
+ */
+static void mult_mixed(const tblis_comm* comm,
+                       const tblis_config* cntx,
+                       const tblis_tensor* A,
+                       const label_type* idx_A,
+                       const tblis_tensor* B,
+                       const label_type* idx_B,
+                             tblis_tensor* C,
+                       const label_type* idx_C)
+{
+    /*
+     * In the BLIS encoding of the types, the complex types are the real
+     * ones with the TYPE_SCOMPLEX bit set.
+     */
+    auto A_is_real = !(A->type & TYPE_SCOMPLEX);
+    auto R = A_is_real ? A : B;
+    auto Z = A_is_real ? B : A;
+    auto idx_R = A_is_real ? idx_A : idx_B;
+    auto idx_Z = A_is_real ? idx_B : idx_A;
+
+    TBLIS_ASSERT(!(R->type & TYPE_SCOMPLEX));
+    TBLIS_ASSERT(Z->type == (R->type | TYPE_SCOMPLEX));
+    TBLIS_ASSERT(C->type == Z->type);
+
+    auto idx_ri = internal::free_idx(label_vector(idx_A, idx_A+A->ndim),
+                                     label_vector(idx_B, idx_B+B->ndim),
+                                     label_vector(idx_C, idx_C+C->ndim));
+
+    real_view Z_r(*Z, idx_Z, idx_ri);
+    real_view C_r(*C, idx_C, idx_ri);
+
+    tblis_tensor R_r(*R);
+    R_r.scalar.reset(1.0, R->type);
+    R_r.conj = false;
+
+    auto alpha = Z->scalar*R->scalar.convert(Z->type);
+    auto beta = C->scalar;
+    bool conj_Z = Z->conj;
+
+    if (alpha.is_zero())
+    {
+        tblis_tensor_scale(comm, cntx, C, idx_C);
+        return;
+    }
+
+    auto is_real = [](const scalar& x) { return std::imag(x.as<dcomplex>()) == 0; };
+
+    if (!conj_Z && is_real(alpha))
+    {
+        /*
+         * A real alpha goes into the real contraction, and so does beta
+         * unless it is complex or C is conjugated.
+         */
+        auto beta_r = beta.convert(R->type);
+
+        if (C->conj || !is_real(beta))
+        {
+            tblis_tensor_scale(comm, cntx, C, idx_C);
+            beta_r.reset(1.0, R->type);
+        }
+
+        R_r.scalar = alpha;
+        C_r.scalar = beta_r;
+
+        tblis_tensor_mult(comm, cntx, &R_r, idx_R, &Z_r, Z_r.idx.data(), &C_r, C_r.idx.data());
+    }
+    else
+    {
+        auto pre = beta/alpha;
+        if (conj_Z) pre.conj();
+
+        C->scalar = pre;
+        C->conj = bool(C->conj) != conj_Z;
+        tblis_tensor_scale(comm, cntx, C, idx_C);
+
+        C_r.scalar.reset(1.0, R->type);
+
+        tblis_tensor_mult(comm, cntx, &R_r, idx_R, &Z_r, Z_r.idx.data(), &C_r, C_r.idx.data());
+
+        C->scalar = alpha;
+        C->conj = conj_Z;
+        tblis_tensor_scale(comm, cntx, C, idx_C);
+    }
+
+    C->scalar = 1;
+    C->conj = false;
+}
+
 TBLIS_EXPORT
 void tblis_tensor_mult(const tblis_comm* comm,
                        const tblis_config* cntx,
                        const tblis_tensor* A,
-                       const label_type* idx_A_,
+                       const label_type* idx_A,
                        const tblis_tensor* B,
-                       const label_type* idx_B_,
+                       const label_type* idx_B,
                              tblis_tensor* C,
-                       const label_type* idx_C_)
+                       const label_type* idx_C)
 {
     internal::initialize_once();
 
-    TBLIS_ASSERT(A->type == B->type);
+    if (A->type != B->type)
+    {
+        mult_mixed(comm, cntx, A, idx_A, B, idx_B, C, idx_C);
+        return;
+    }
+
+    /*
+     * Half precision tensors are only storage; the computation is in float.
+     */
+    if (internal::is_half(A->type) || internal::is_half(C->type))
+    {
+        tblis_tensor_mult_prec(comm, cntx, A, idx_A, B, idx_B, C, idx_C, TYPE_FLOAT);
+        return;
+    }
+
     TBLIS_ASSERT(A->type == C->type);
 
+    tblis_tensor_mult_prec(comm, cntx, A, idx_A, B, idx_B, C, idx_C, C->type);
+}
+
+TBLIS_EXPORT
+void tblis_tensor_mult_prec(const tblis_comm* comm,
+                            const tblis_config* cntx,
+                            const tblis_tensor* A,
+                            const label_type* idx_A_,
+                            const tblis_tensor* B,
+                            const label_type* idx_B_,
+                                  tblis_tensor* C,
+                            const label_type* idx_C_,
+                            type_t compute_type)
+{
+    TBLIS_ASSERT(!internal::is_half(compute_type));
+    TBLIS_ASSERT(!internal::is_half(A->type) || compute_type == TYPE_FLOAT);
+
+    internal::initialize_once();
+    internal::stats_scope stats(comm);
+
+    /*
+     * In the BLIS encoding of the types, the domain is the TYPE_SCOMPLEX
+     * bit.
+     */
+    TBLIS_ASSERT(A->type == B->type);
+    TBLIS_ASSERT(!((A->type ^ C->type) & TYPE_SCOMPLEX));
+    TBLIS_ASSERT(!((A->type ^ compute_type) & TYPE_SCOMPLEX));
+
     auto ndim_A = A->ndim;
     len_vector len_A;
     stride_vector stride_A;
@@ -125,7 +306,7 @@ void tblis_tensor_mult(const tblis_comm* comm,
     len_vector nolen;
     stride_vector nostride;
 
-    auto alpha = A->scalar*B->scalar;
+    auto alpha = A->scalar.convert(compute_type)*B->scalar.convert(compute_type);
     auto beta = C->scalar;
 
     auto data_A = reinterpret_cast<char*>(A->data);
@@ -137,15 +318,22 @@ void tblis_tensor_mult(const tblis_comm* comm,
     {
         if (alpha.is_zero())
         {
-            if (beta.is_zero())
+            if (internal::is_half(C->type))
+            {
+                if (!beta.is_one())
+                    internal::scale_half(C->type, comm, len_AC+len_BC+len_ABC,
+                                         beta.as<float>(), data_C,
+                                         stride_C_AC+stride_C_BC+stride_C_ABC);
+            }
+            else if (beta.is_zero())
             {
-                internal::set(A->type, comm, bli_gks_query_cntx(),
+                internal::set(C->type, comm, bli_gks_query_cntx(),
                               len_AC+len_BC+len_ABC, beta, data_C,
                               stride_C_AC+stride_C_BC+stride_C_ABC);
             }
             else if (!beta.is_one() || (beta.is_complex() && C->conj))
             {
-                internal::scale(A->type, comm, bli_gks_query_cntx(),
+                internal::scale(C->type, comm, bli_gks_query_cntx(),
                                 len_AC+len_BC+len_ABC,
                                 beta, C->conj, data_C,
                                 stride_C_AC+stride_C_BC+stride_C_ABC);
@@ -153,7 +341,8 @@ void tblis_tensor_mult(const tblis_comm* comm,
         }
         else
         {
-            internal::mult(A->type, comm, bli_gks_query_cntx(),
+            internal::mult(A->type, C->type, compute_type,
+                           comm, bli_gks_query_cntx(),
                            len_AB, len_AC, len_BC, len_ABC,
                            alpha, A->conj, data_A,
                            stride_A_AB, stride_A_AC, stride_A_ABC,
@@ -168,6 +357,209 @@ void tblis_tensor_mult(const tblis_comm* comm,
     C->conj = false;
 }
 
+TBLIS_EXPORT
+tblis_async* tblis_tensor_mult_async(const tblis_config* cntx,
+                                     const tblis_tensor* A,
+                                     const label_type* idx_A,
+                                     const tblis_tensor* B,
+                                     const label_type* idx_B,
+                                           tblis_tensor* C,
+                                     const label_type* idx_C)
+{
+    internal::initialize_once();
+
+    internal::async_tensor A_(A, idx_A);
+    internal::async_tensor B_(B, idx_B);
+    internal::async_tensor C_(C, idx_C);
+
+    auto req = internal::async_submit({&A_, &B_}, {&C_},
+    [=](const tblis_comm* comm) mutable
+    {
+        tblis_tensor_mult(comm, cntx, A_.get(), A_.idx.data(),
+                                      B_.get(), B_.idx.data(),
+                                      C_.get(), C_.idx.data());
+    });
+
+    C->scalar = 1;
+    C->conj = false;
+
+    return req;
+}
+
+/*
+ * The part of A in which the indices idx_C[j] run over
+ * [off_C[j], off_C[j]+len_C[j]).
+ */
+struct tile_view : tblis_tensor
+{
+    len_vector len_buf;
+
+    tile_view(const tblis_tensor& A, const label_type* idx_A,
+              const label_vector& idx_C, const len_vector& off_C, const len_vector& len_C)
+    : tblis_tensor(A), len_buf(A.len, A.len+A.ndim)
+    {
+        auto data_A = static_cast<char*>(A.data);
+
+        for (auto i : range(A.ndim))
+        for (auto j : range(idx_C.size()))
+        {
+            if (idx_A[i] != idx_C[j]) continue;
+
+            len_buf[i] = len_C[j];
+            data_A += off_C[j]*A.stride[i]*storage_size(A.type);
+        }
+
+        data = data_A;
+        len = len_buf.data();
+    }
+};
+
+TBLIS_EXPORT
+void tblis_tensor_mult_tiled(const tblis_comm* comm,
+                             const tblis_config* cntx,
+                             const tblis_tensor* A,
+                             const label_type* idx_A,
+                             const tblis_tensor* B,
+                             const label_type* idx_B,
+                             int ndim_C,
+                             const label_type* idx_C_,
+                             const len_type* tile_len_C,
+                             tblis_tile_func func,
+                             void* data)
+{
+    internal::initialize_once();
+
+    label_vector idx_C(idx_C_, idx_C_+ndim_C);
+    len_vector len_C(ndim_C), tile_len(ndim_C), ntile(ndim_C);
+
+    for (auto i : range(ndim_C))
+    {
+        for (auto j : range(i))
+            TBLIS_ASSERT(idx_C[i] != idx_C[j]);
+
+        len_C[i] = -1;
+
+        for (auto j : range(A->ndim))
+            if (idx_A[j] == idx_C[i]) len_C[i] = A->len[j];
+
+        for (auto j : range(B->ndim))
+            if (idx_B[j] == idx_C[i]) len_C[i] = B->len[j];
+
+        TBLIS_ASSERT(len_C[i] != -1);
+
+        tile_len[i] = tile_len_C[i] > 0 ? std::min(tile_len_C[i], len_C[i]) : len_C[i];
+        ntile[i] = tile_len[i] > 0 ? ceil_div(len_C[i], tile_len[i]) : 0;
+    }
+
+    /*
+     * In the BLIS encoding of the types, a real times a complex tensor of
+     * the same precision is of the complex type. Half precision tensors
+     * are computed in float.
+     */
+    auto type_C = internal::is_half(A->type) ? TYPE_FLOAT : A->type | B->type;
+    auto size = stl_ext::prod(tile_len)*storage_size(type_C);
+
+    /*
+     * All of the threads in comm share one tile.
+     */
+    char* buf = nullptr;
+    if (comm)
+    {
+        auto& comm_ = *reinterpret_cast<const communicator*>(comm);
+        if (comm_.master()) buf = new char[size];
+        comm_.broadcast_value(buf);
+    }
+    else
+    {
+        buf = new char[size];
+    }
+
+    len_vector off_C(ndim_C), len_tile(ndim_C);
+
+    for (auto tile : range(stl_ext::prod(ntile)))
+    {
+        auto pos = tile;
+        for (auto i : range(ndim_C))
+        {
+            off_C[i] = (pos % ntile[i])*tile_len[i];
+            len_tile[i] = std::min(tile_len[i], len_C[i]-off_C[i]);
+            pos /= ntile[i];
+        }
+
+        stride_vector stride_tile = MArray::detail::strides(len_tile, MArray::COLUMN_MAJOR);
+
+        tile_view A_(*A, idx_A, idx_C, off_C, len_tile);
+        tile_view B_(*B, idx_B, idx_C, off_C, len_tile);
+
+        tblis_tensor C_;
+        C_.type = type_C;
+        C_.scalar.reset(0.0, type_C);
+        C_.data = buf;
+        C_.ndim = ndim_C;
+        C_.len = len_tile.data();
+        C_.stride = stride_tile.data();
+
+        tblis_tensor_mult(comm, cntx, &A_, idx_A, &B_, idx_B, &C_, idx_C_);
+
+        /*
+         * The next tile overwrites this one, so every thread must be done
+         * with it first.
+         */
+        if (comm) reinterpret_cast<const communicator*>(comm)->barrier();
+        func(comm, &C_, idx_C_, off_C.data(), data);
+        if (comm) reinterpret_cast<const communicator*>(comm)->barrier();
+    }
+
+    if (!comm || reinterpret_cast<const communicator*>(comm)->master())
+        delete[] buf;
+}
+
+TBLIS_EXPORT
+void tblis_tensor_mult_dot(const tblis_comm* comm,
+                           const tblis_config* cntx,
+                           const tblis_tensor* A,
+                           const label_type* idx_A,
+                           const tblis_tensor* B,
+                           const label_type* idx_B,
+                           const tblis_tensor* D,
+                           const label_type* idx_D,
+                           const len_type* tile_len_D,
+                           tblis_scalar* result)
+{
+    TBLIS_ASSERT(D->type == result->type);
+
+    struct dot_data
+    {
+        const tblis_config* cntx;
+        const tblis_tensor* D;
+        scalar sum;
+    };
+
+    dot_data data{cntx, D, {0.0, D->type}};
+
+    /*
+     * With comm, the tile results (and so the sum) are only complete on the
+     * master thread.
+     */
+    tblis_tensor_mult_tiled(comm, cntx, A, idx_A, B, idx_B, D->ndim, idx_D, tile_len_D,
+    [](const tblis_comm* comm, const tblis_tensor* C, const label_type* idx_C,
+       const len_type* off_C, void* data_)
+    {
+        auto& data = *static_cast<dot_data*>(data_);
+
+        tile_view D_(*data.D, idx_C, label_vector(idx_C, idx_C+C->ndim),
+                     len_vector(off_C, off_C+C->ndim), len_vector(C->len, C->len+C->ndim));
+
+        scalar tile_result(0.0, data.D->type);
+        tblis_tensor_dot(comm, data.cntx, C, idx_C, &D_, idx_C, &tile_result);
+        data.sum += tile_result;
+    }, &data);
+
+    if (comm) reinterpret_cast<const communicator*>(comm)->broadcast_value(data.sum);
+
+    *result = data.sum;
+}
+
 template <typename T>
 void mult(const communicator& comm,
           T alpha, const dpd_marray_view<const T>& A, const label_vector& idx_A,
@@ -175,6 +567,7 @@ void mult(const communicator& comm,
           T  beta, const dpd_marray_view<      T>& C, const label_vector& idx_C)
 {
     internal::initialize_once();
+    internal::stats_scope stats(comm);
 
     auto nirrep = A.num_irreps();
     TBLIS_ASSERT(B.num_irreps() == nirrep);
@@ -296,6 +689,7 @@ void mult(const communicator& comm,
           T  beta, const indexed_marray_view<      T>& C, const label_vector& idx_C)
 {
     internal::initialize_once();
+    internal::stats_scope stats(comm);
 
     auto ndim_A = A.dimension();
     auto ndim_B = B.dimension();
@@ -409,6 +803,7 @@ void mult(const communicator& comm,
           T  beta, const indexed_dpd_marray_view<      T>& C, const label_vector& idx_C)
 {
     internal::initialize_once();
+    internal::stats_scope stats(comm);
 
     auto nirrep = A.num_irreps();
     TBLIS_ASSERT(B.num_irreps() == nirrep);
@@ -3,18 +3,90 @@
 
 #include "../base/thread.h"
 #include "../base/basic_types.h"
+#include "../base/async.h"
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wnull-dereference"
 
 TBLIS_BEGIN_NAMESPACE
 
+/*
+ * C = alpha*A*B + beta*C, where alpha = A.scalar*B.scalar and beta = C.scalar.
+ * A and B may also be one real and one complex tensor of the same precision
+ * as the complex C; the real one is then used as is, without promotion.
+ */
 TBLIS_EXPORT
 void tblis_tensor_mult(const tblis_comm* comm, const tblis_config* cntx,
                        const tblis_tensor* A, const label_type* idx_A,
                        const tblis_tensor* B, const label_type* idx_B,
                              tblis_tensor* C, const label_type* idx_C);
 
+/*
+ * As tblis_tensor_mult, with A and B of one type and C of the same or the
+ * other precision of that domain. The products are formed and accumulated
+ * in compute_type, A and B being converted as they are packed: for example
+ * float A and B may be contracted into a double C entirely in double, or
+ * double tensors may be contracted in float for a fast approximation. The
+ * scalars of A and B may be of either their own type or compute_type.
+ * Half precision (TYPE_BFLOAT16 or TYPE_FLOAT16) tensors require a
+ * compute_type of TYPE_FLOAT.
+ */
+TBLIS_EXPORT
+void tblis_tensor_mult_prec(const tblis_comm* comm, const tblis_config* cntx,
+                            const tblis_tensor* A, const label_type* idx_A,
+                            const tblis_tensor* B, const label_type* idx_B,
+                                  tblis_tensor* C, const label_type* idx_C,
+                            type_t compute_type);
+
+/*
+ * As tblis_tensor_mult, but executed asynchronously; see async.h.
+ */
+TBLIS_EXPORT
+tblis_async* tblis_tensor_mult_async(const tblis_config* cntx,
+                                     const tblis_tensor* A, const label_type* idx_A,
+                                     const tblis_tensor* B, const label_type* idx_B,
+                                           tblis_tensor* C, const label_type* idx_C);
+
+/*
+ * Receives each tile of C from tblis_tensor_mult_tiled, whose position in
+ * C is given by off_C. It is called by every thread of comm, or once with a
+ * null comm.
+ */
+typedef void (*tblis_tile_func)(const tblis_comm* comm,
+                                const tblis_tensor* C_tile,
+                                const label_type* idx_C,
+                                const len_type* off_C,
+                                void* data);
+
+/*
+ * C = A*B one tile at a time, without ever storing all of C: only one tile
+ * is in memory, and it is overwritten by the next one once func returns.
+ * The lengths of C are those of its indices in A and B, and the tiles are
+ * at most tile_len_C[i] long along dimension i, or the whole dimension if
+ * tile_len_C[i] is 0. The tiles are of the type of the product, or float
+ * for half precision A and B.
+ */
+TBLIS_EXPORT
+void tblis_tensor_mult_tiled(const tblis_comm* comm, const tblis_config* cntx,
+                             const tblis_tensor* A, const label_type* idx_A,
+                             const tblis_tensor* B, const label_type* idx_B,
+                             int ndim_C, const label_type* idx_C,
+                             const len_type* tile_len_C,
+                             tblis_tile_func func, void* data);
+
+/*
+ * result = sum of C*D over all of the indices of D, for C = A*B with the
+ * indices of D, computed with tblis_tensor_mult_tiled and tiles of
+ * tile_len_D.
+ */
+TBLIS_EXPORT
+void tblis_tensor_mult_dot(const tblis_comm* comm, const tblis_config* cntx,
+                           const tblis_tensor* A, const label_type* idx_A,
+                           const tblis_tensor* B, const label_type* idx_B,
+                           const tblis_tensor* D, const label_type* idx_D,
+                           const len_type* tile_len_D,
+                           tblis_scalar* result);
+
 #if TBLIS_ENABLE_CPLUSPLUS
 
 inline
@@ -27,18 +99,50 @@ void mult(const communicator& comm,
           const scalar& beta,
           const tensor_wrapper& C,
           const label_vector& idx_C)
+{
+    /*
+     * For a real times a complex tensor, alpha goes to the complex one.
+     */
+    auto A_(A);
+    auto B_(B);
+    if (A.type == C.type)
+        A_.scalar *= alpha.convert(A.type);
+    else
+        B_.scalar *= alpha.convert(B.type);
+
+    auto C_(C);
+    C_.scalar *= beta.convert(C.type);
+
+    TBLIS_ASSERT(A.ndim == idx_A.size());
+    TBLIS_ASSERT(B.ndim == idx_B.size());
+    TBLIS_ASSERT(C.ndim == idx_C.size());
+
+    tblis_tensor_mult(comm, nullptr, &A_, idx_A.data(), &B_, idx_B.data(), &C_, idx_C.data());
+}
+
+inline
+void mult(const communicator& comm,
+          const scalar& alpha,
+          const tensor_wrapper& A,
+          const label_vector& idx_A,
+          const tensor_wrapper& B,
+          const label_vector& idx_B,
+          const scalar& beta,
+          const tensor_wrapper& C,
+          const label_vector& idx_C,
+          type_t compute_type)
 {
     auto A_(A);
-    A_.scalar *= alpha;
+    A_.scalar.reset(A.scalar.convert(compute_type)*alpha.convert(compute_type));
 
     auto C_(C);
-    C_.scalar *= beta;
+    C_.scalar *= beta.convert(C.type);
 
     TBLIS_ASSERT(A.ndim == idx_A.size());
     TBLIS_ASSERT(B.ndim == idx_B.size());
     TBLIS_ASSERT(C.ndim == idx_C.size());
 
-    tblis_tensor_mult(comm, nullptr, &A_, idx_A.data(), &B, idx_B.data(), &C_, idx_C.data());
+    tblis_tensor_mult_prec(comm, nullptr, &A_, idx_A.data(), &B, idx_B.data(), &C_, idx_C.data(), compute_type);
 }
 
 inline
@@ -147,6 +251,20 @@ void mult(const scalar& alpha,
     mult(*(communicator*)nullptr, alpha, A, idx_A, B, idx_B, beta, C, idx_C);
 }
 
+TBLIS_COMPAT_INLINE
+void mult(const scalar& alpha,
+          const tensor_wrapper& A,
+          const label_vector& idx_A,
+          const tensor_wrapper& B,
+          const label_vector& idx_B,
+          const scalar& beta,
+          const tensor_wrapper& C,
+          const label_vector& idx_C,
+          type_t compute_type)
+{
+    mult(*(communicator*)nullptr, alpha, A, idx_A, B, idx_B, beta, C, idx_C, compute_type);
+}
+
 inline
 void mult(const tensor_wrapper& A,
           const label_vector& idx_A,
@@ -218,6 +336,144 @@ void mult(const tensor_wrapper& A,
     mult({1.0, A.type}, A, B, {0.0, A.type}, C);
 }
 
+inline
+future mult_async(const scalar& alpha,
+                  const tensor_wrapper& A,
+                  const label_vector& idx_A,
+                  const tensor_wrapper& B,
+                  const label_vector& idx_B,
+                  const scalar& beta,
+                  const tensor_wrapper& C,
+                  const label_vector& idx_C)
+{
+    auto A_(A);
+    auto B_(B);
+    if (A.type == C.type)
+        A_.scalar *= alpha.convert(A.type);
+    else
+        B_.scalar *= alpha.convert(B.type);
+
+    auto C_(C);
+    C_.scalar *= beta.convert(C.type);
+
+    TBLIS_ASSERT(A.ndim == idx_A.size());
+    TBLIS_ASSERT(B.ndim == idx_B.size());
+    TBLIS_ASSERT(C.ndim == idx_C.size());
+
+    return future(tblis_tensor_mult_async(nullptr, &A_, idx_A.data(), &B_, idx_B.data(), &C_, idx_C.data()));
+}
+
+inline
+future mult_async(const tensor_wrapper& A,
+                  const label_vector& idx_A,
+                  const tensor_wrapper& B,
+                  const label_vector& idx_B,
+                  const tensor_wrapper& C,
+                  const label_vector& idx_C)
+{
+    return mult_async({1.0, A.type}, A, idx_A, B, idx_B, {0.0, A.type}, C, idx_C);
+}
+
+/*
+ * func(comm, C_tile, off_C) is called for each tile, as in
+ * tblis_tensor_mult_tiled.
+ */
+template <typename Func>
+void mult_tiled(const communicator& comm,
+                const tensor_wrapper& A,
+                const label_vector& idx_A,
+                const tensor_wrapper& B,
+                const label_vector& idx_B,
+                const label_vector& idx_C,
+                const len_vector& tile_len_C,
+                Func&& func)
+{
+    TBLIS_ASSERT(A.ndim == idx_A.size());
+    TBLIS_ASSERT(B.ndim == idx_B.size());
+    TBLIS_ASSERT(tile_len_C.size() == idx_C.size());
+
+    tblis_tensor_mult_tiled(comm, nullptr, &A, idx_A.data(), &B, idx_B.data(),
+                            idx_C.size(), idx_C.data(), tile_len_C.data(),
+    [](const tblis_comm* comm, const tblis_tensor* C, const label_type*,
+       const len_type* off_C, void* data)
+    {
+        (*static_cast<std::remove_reference_t<Func>*>(data))
+            (*reinterpret_cast<const communicator*>(comm), *C,
+             len_vector(off_C, off_C+C->ndim));
+    }, &func);
+}
+
+template <typename Func>
+void mult_tiled(const tensor_wrapper& A,
+                const label_vector& idx_A,
+                const tensor_wrapper& B,
+                const label_vector& idx_B,
+                const label_vector& idx_C,
+                const len_vector& tile_len_C,
+                Func&& func)
+{
+    mult_tiled(*(communicator*)nullptr, A, idx_A, B, idx_B, idx_C, tile_len_C,
+               std::forward<Func>(func));
+}
+
+inline
+tblis_scalar mult_dot(const communicator& comm,
+                      const tensor_wrapper& A,
+                      const label_vector& idx_A,
+                      const tensor_wrapper& B,
+                      const label_vector& idx_B,
+                      const tensor_wrapper& D,
+                      const label_vector& idx_D,
+                      const len_vector& tile_len_D)
+{
+    TBLIS_ASSERT(A.ndim == idx_A.size());
+    TBLIS_ASSERT(B.ndim == idx_B.size());
+    TBLIS_ASSERT(D.ndim == idx_D.size());
+    TBLIS_ASSERT(D.ndim == tile_len_D.size());
+
+    tblis_scalar result(0.0, D.type);
+    tblis_tensor_mult_dot(comm, nullptr, &A, idx_A.data(), &B, idx_B.data(),
+                          &D, idx_D.data(), tile_len_D.data(), &result);
+    return result;
+}
+
+template <typename T>
+T mult_dot(const communicator& comm,
+           const tensor_wrapper& A,
+           const label_vector& idx_A,
+           const tensor_wrapper& B,
+           const label_vector& idx_B,
+           const tensor_wrapper& D,
+           const label_vector& idx_D,
+           const len_vector& tile_len_D)
+{
+    return mult_dot(comm, A, idx_A, B, idx_B, D, idx_D, tile_len_D).get<T>();
+}
+
+inline
+tblis_scalar mult_dot(const tensor_wrapper& A,
+                      const label_vector& idx_A,
+                      const tensor_wrapper& B,
+                      const label_vector& idx_B,
+                      const tensor_wrapper& D,
+                      const label_vector& idx_D,
+                      const len_vector& tile_len_D)
+{
+    return mult_dot(*(communicator*)nullptr, A, idx_A, B, idx_B, D, idx_D, tile_len_D);
+}
+
+template <typename T>
+T mult_dot(const tensor_wrapper& A,
+           const label_vector& idx_A,
+           const tensor_wrapper& B,
+           const label_vector& idx_B,
+           const tensor_wrapper& D,
+           const label_vector& idx_D,
+           const len_vector& tile_len_D)
+{
+    return mult_dot(A, idx_A, B, idx_B, D, idx_D, tile_len_D).get<T>();
+}
+
 #ifdef MARRAY_DPD_MARRAY_HPP
 
 template <typename T>
@@ -0,0 +1,240 @@
+#include "async.hpp"
+#include "env.hpp"
+#include "tensor.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tblis
+{
+
+namespace internal
+{
+
+int async_lanes = std::max<long>(1, envtol("TBLIS_ASYNC_LANES", 2));
+
+using extent_t = std::pair<const char*,const char*>;
+
+struct async_task
+{
+    std::function<void(const tblis_comm*)> run;
+    std::vector<extent_t> reads, writes;
+    std::vector<std::shared_ptr<async_task>> dependents;
+    int ndeps = 0;
+    bool done = false;
+};
+
+}
+
+struct tblis_async_s
+{
+    std::shared_ptr<internal::async_task> task;
+};
+
+namespace internal
+{
+
+static bool overlaps(const std::vector<extent_t>& a, const std::vector<extent_t>& b)
+{
+    for (auto& x : a)
+    for (auto& y : b)
+        if (x.first < y.second && y.first < x.second) return true;
+
+    return false;
+}
+
+static bool conflicts(const async_task& a, const async_task& b)
+{
+    return overlaps(a.writes, b.writes) ||
+           overlaps(a.writes, b.reads) ||
+           overlaps(a.reads, b.writes);
+}
+
+class async_scheduler
+{
+    protected:
+        std::mutex mutex_;
+        std::condition_variable ready_cv_;
+        std::condition_variable done_cv_;
+        std::list<std::shared_ptr<async_task>> pending_;
+        std::deque<std::shared_ptr<async_task>> ready_;
+        std::vector<std::thread> workers_;
+        bool stop_ = false;
+
+        void work()
+        {
+            while (true)
+            {
+                std::shared_ptr<async_task> task;
+
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    ready_cv_.wait(lock, [&]{ return stop_ || !ready_.empty(); });
+                    if (ready_.empty()) return;
+                    task = std::move(ready_.front());
+                    ready_.pop_front();
+                }
+
+                auto nt = std::max<unsigned>(1, tblis_get_num_threads()/async_lanes);
+
+                parallelize
+                (
+                    [&](const communicator& comm)
+                    {
+                        task->run(reinterpret_cast<const tblis_comm*>(&comm));
+                    },
+                    nt
+                );
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+
+                    task->done = true;
+                    task->run = nullptr;
+                    pending_.remove(task);
+
+                    for (auto& dep : task->dependents)
+                        if (--dep->ndeps == 0) ready_.push_back(std::move(dep));
+                    task->dependents.clear();
+                }
+
+                ready_cv_.notify_all();
+                done_cv_.notify_all();
+            }
+        }
+
+    public:
+        ~async_scheduler()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stop_ = true;
+            }
+
+            ready_cv_.notify_all();
+
+            for (auto& worker : workers_) worker.join();
+        }
+
+        void submit(const std::shared_ptr<async_task>& task)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+
+                if (workers_.empty())
+                {
+                    for (int i = 0;i < async_lanes;i++)
+                        workers_.emplace_back([this]{ work(); });
+                }
+
+                for (auto& other : pending_)
+                {
+                    if (conflicts(*task, *other))
+                    {
+                        other->dependents.push_back(task);
+                        task->ndeps++;
+                    }
+                }
+
+                pending_.push_back(task);
+                if (task->ndeps == 0) ready_.push_back(task);
+            }
+
+            ready_cv_.notify_one();
+        }
+
+        bool test(const async_task& task)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return task.done;
+        }
+
+        void wait(const async_task& task)
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            done_cv_.wait(lock, [&]{ return task.done; });
+        }
+
+        void wait_all()
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            done_cv_.wait(lock, [&]{ return pending_.empty(); });
+        }
+};
+
+static async_scheduler& scheduler()
+{
+    static async_scheduler sched;
+    return sched;
+}
+
+async_tensor::async_tensor(const tblis_tensor* t, const label_type* idx_)
+: tensor(*t), len(t->len, t->len+t->ndim), stride(t->stride, t->stride+t->ndim),
+  idx(idx_, idx_+t->ndim) {}
+
+std::pair<const char*,const char*> async_tensor::extent() const
+{
+    auto data = static_cast<const char*>(tensor.data);
+    auto ts = storage_size(tensor.type);
+
+    stride_type lo = 0, hi = 0;
+    for (auto i : range(tensor.ndim))
+    {
+        if (len[i] == 0) return {data, data};
+
+        auto off = (len[i]-1)*stride[i];
+        if (off < 0) lo += off;
+        else hi += off;
+    }
+
+    return {data + lo*ts, data + (hi+1)*ts};
+}
+
+tblis_async* async_submit(std::initializer_list<const async_tensor*> reads,
+                          std::initializer_list<const async_tensor*> writes,
+                          std::function<void(const tblis_comm*)> run)
+{
+    auto task = std::make_shared<async_task>();
+    task->run = std::move(run);
+    for (auto t : reads) task->reads.push_back(t->extent());
+    for (auto t : writes) task->writes.push_back(t->extent());
+
+    auto req = new tblis_async{task};
+    scheduler().submit(task);
+    return req;
+}
+
+}
+
+TBLIS_EXPORT
+int tblis_async_test(const tblis_async* req)
+{
+    return internal::scheduler().test(*req->task);
+}
+
+TBLIS_EXPORT
+void tblis_async_wait(tblis_async* req)
+{
+    internal::scheduler().wait(*req->task);
+    delete req;
+}
+
+TBLIS_EXPORT
+void tblis_async_free(tblis_async* req)
+{
+    delete req;
+}
+
+TBLIS_EXPORT
+void tblis_async_wait_all()
+{
+    internal::scheduler().wait_all();
+}
+
+}
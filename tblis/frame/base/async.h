@@ -0,0 +1,108 @@
+#ifndef _TBLIS_IFACE_BASE_ASYNC_H_
+#define _TBLIS_IFACE_BASE_ASYNC_H_
+
+#include "thread.h"
+#include "basic_types.h"
+
+#if TBLIS_ENABLE_CPLUSPLUS
+#include <utility>
+#endif
+
+TBLIS_BEGIN_NAMESPACE
+
+/*
+ * Handle to an operation submitted with one of the tblis_tensor_*_async
+ * functions. Operations run on a dedicated pool of worker threads, split
+ * into TBLIS_ASYNC_LANES lanes (default 2) which each execute one operation
+ * at a time. An operation does not start until all previously submitted
+ * operations which touch overlapping memory (other than two reads) have
+ * completed.
+ *
+ * The tensor descriptors and labels are copied at submission, but the tensor
+ * data must remain valid until the operation completes.
+ */
+typedef struct tblis_async_s tblis_async;
+
+/*
+ * Returns nonzero if the operation has completed. The handle remains valid,
+ * and must still be released with tblis_async_wait or tblis_async_free.
+ */
+TBLIS_EXPORT
+int tblis_async_test(const tblis_async* req);
+
+/*
+ * Blocks until the operation has completed and releases the handle.
+ */
+TBLIS_EXPORT
+void tblis_async_wait(tblis_async* req);
+
+/*
+ * Releases the handle without waiting. The operation, if it has not yet
+ * completed, still runs to completion (as observed by tblis_async_wait_all).
+ */
+TBLIS_EXPORT
+void tblis_async_free(tblis_async* req);
+
+/*
+ * Blocks until all submitted operations have completed. Outstanding handles
+ * must still be released with tblis_async_wait or tblis_async_free.
+ */
+TBLIS_EXPORT
+void tblis_async_wait_all();
+
+#if TBLIS_ENABLE_CPLUSPLUS
+
+class future
+{
+    protected:
+        tblis_async* req_ = nullptr;
+
+    public:
+        future() {}
+
+        explicit future(tblis_async* req) : req_(req) {}
+
+        future(const future&) = delete;
+
+        future(future&& other) : req_(other.req_)
+        {
+            other.req_ = nullptr;
+        }
+
+        future& operator=(const future&) = delete;
+
+        future& operator=(future&& other)
+        {
+            wait();
+            std::swap(req_, other.req_);
+            return *this;
+        }
+
+        ~future()
+        {
+            wait();
+        }
+
+        bool ready() const
+        {
+            return !req_ || tblis_async_test(req_);
+        }
+
+        void wait()
+        {
+            if (req_) tblis_async_wait(req_);
+            req_ = nullptr;
+        }
+
+        void detach()
+        {
+            if (req_) tblis_async_free(req_);
+            req_ = nullptr;
+        }
+};
+
+#endif
+
+TBLIS_END_NAMESPACE
+
+#endif
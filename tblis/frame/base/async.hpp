@@ -0,0 +1,55 @@
+#ifndef _TBLIS_INTERNAL_BASE_ASYNC_HPP_
+#define _TBLIS_INTERNAL_BASE_ASYNC_HPP_
+
+#include "async.h"
+
+#include <functional>
+#include <initializer_list>
+#include <utility>
+
+namespace tblis
+{
+namespace internal
+{
+
+extern int async_lanes;
+
+/*
+ * Owning copy of a tensor descriptor and its labels, used to capture the
+ * arguments of an asynchronous operation.
+ */
+struct async_tensor
+{
+    tblis_tensor tensor;
+    len_vector len;
+    stride_vector stride;
+    label_vector idx;
+
+    async_tensor(const tblis_tensor* t, const label_type* idx_);
+
+    tblis_tensor* get()
+    {
+        tensor.len = len.data();
+        tensor.stride = stride.data();
+        return &tensor;
+    }
+
+    /*
+     * The range of bytes [first, second) spanned by the tensor data. Empty
+     * tensors span an empty range.
+     */
+    std::pair<const char*,const char*> extent() const;
+};
+
+/*
+ * Queue task for execution once all pending operations which conflict with
+ * the given reads and writes have completed.
+ */
+tblis_async* async_submit(std::initializer_list<const async_tensor*> reads,
+                          std::initializer_list<const async_tensor*> writes,
+                          std::function<void(const tblis_comm*)> task);
+
+}
+}
+
+#endif
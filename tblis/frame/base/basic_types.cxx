@@ -86,6 +86,34 @@ void tblis_init_tensor_scaled_z(tblis_tensor* t, dcomplex scalar,
     t->stride = stride;
 }
 
+void tblis_init_tensor_scaled_bf16(tblis_tensor* t, float scalar,
+                                   int ndim, len_type* len, uint16_t* data,
+                                   stride_type* stride)
+{
+    t->type = TYPE_BFLOAT16;
+    t->scalar.type = TYPE_SINGLE;
+    t->conj = 0;
+    t->scalar.data.s = scalar;
+    t->data = data;
+    t->ndim = ndim;
+    t->len = len;
+    t->stride = stride;
+}
+
+void tblis_init_tensor_scaled_f16(tblis_tensor* t, float scalar,
+                                  int ndim, len_type* len, uint16_t* data,
+                                  stride_type* stride)
+{
+    t->type = TYPE_FLOAT16;
+    t->scalar.type = TYPE_SINGLE;
+    t->conj = 0;
+    t->scalar.data.s = scalar;
+    t->data = data;
+    t->ndim = ndim;
+    t->len = len;
+    t->stride = stride;
+}
+
 void tblis_init_tensor_s(tblis_tensor* t,
                          int ndim, len_type* len, float* data,
                          stride_type* stride)
@@ -114,6 +142,20 @@ void tblis_init_tensor_z(tblis_tensor* t,
     tblis_init_tensor_scaled_z(t, {1.0, 0.0}, ndim, len, data, stride);
 }
 
+void tblis_init_tensor_bf16(tblis_tensor* t,
+                            int ndim, len_type* len, uint16_t* data,
+                            stride_type* stride)
+{
+    tblis_init_tensor_scaled_bf16(t, 1.0f, ndim, len, data, stride);
+}
+
+void tblis_init_tensor_f16(tblis_tensor* t,
+                           int ndim, len_type* len, uint16_t* data,
+                           stride_type* stride)
+{
+    tblis_init_tensor_scaled_f16(t, 1.0f, ndim, len, data, stride);
+}
+
 }
 
 label_vector idx(const std::string& from, label_vector&& to)
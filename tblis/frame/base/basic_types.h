@@ -138,6 +138,35 @@ TBLIS_BEGIN_NAMESPACE
         REDUCE_NORM_INF = REDUCE_MAX_ABS
     } reduce_t;
 
+    /*
+     * The number of distinct reductions; a set of reductions is given as a
+     * bitmask with bit op set for each reduce_t op.
+     */
+    #define TBLIS_NUM_REDUCE_OPS 7
+
+    /*
+     * Built-in elementwise functions for tblis_tensor_map (f(a)) and
+     * tblis_tensor_zip (f(a,b)). For complex values, max and min compare
+     * real parts.
+     */
+    typedef enum
+    {
+        MAP_RECIPROCAL = 0,
+        MAP_SQRT       = 1,
+        MAP_EXP        = 2,
+        MAP_LOG        = 3,
+        MAP_ABS        = 4,
+        MAP_SQUARE     = 5
+    } map_t;
+
+    typedef enum
+    {
+        ZIP_MUL = 0,
+        ZIP_DIV = 1,
+        ZIP_MAX = 2,
+        ZIP_MIN = 3
+    } zip_t;
+
     /*
      * Note: these are hard-coded from blis.h to avoid bringing
      * in the whole header as a dependency.
@@ -149,11 +178,40 @@ TBLIS_BEGIN_NAMESPACE
     static const type_t TYPE_SCOMPLEX = 1;
     static const type_t TYPE_DCOMPLEX = 3;
 
+    /*
+     * Storage-only half precision types (real, so the TYPE_SCOMPLEX bit is
+     * clear). Tensors of these types have float scalars and are computed on
+     * in single precision; only the operations which say so accept them.
+     */
+    static const type_t TYPE_BFLOAT16 = 8;
+    static const type_t TYPE_FLOAT16  = 10;
+
     typedef TBLIS_LEN_TYPE len_type;
     typedef TBLIS_STRIDE_TYPE stride_type;
     typedef TBLIS_LABEL_TYPE label_type;
     #define TBLIS_MAX_UNROLL 8
 
+    /*
+     * User-defined elementwise functions, applied to one fiber of n elements
+     * at a time (the scalars point to values of the tensor type):
+     *
+     *   map: B[i] = f(alpha*A[i]) + beta*B[i]
+     *   zip: C[i] = f(alpha*A[i], beta*B[i]) + gamma*C[i]
+     *
+     * where each operand is conjugated first if its conj flag is set, and
+     * the output is overwritten (not read) if its scalar is zero.
+     */
+    typedef void (*tblis_map_func)(len_type n,
+                                   const void* alpha, int conj_A, const void* A, stride_type inc_A,
+                                   const void*  beta, int conj_B,       void* B, stride_type inc_B,
+                                   void* data);
+
+    typedef void (*tblis_zip_func)(len_type n,
+                                   const void* alpha, int conj_A, const void* A, stride_type inc_A,
+                                   const void*  beta, int conj_B, const void* B, stride_type inc_B,
+                                   const void* gamma, int conj_C,       void* C, stride_type inc_C,
+                                   void* data);
+
     #if TBLIS_ENABLE_CPLUSPLUS
 
         using scomplex = std::complex<float>;
@@ -212,6 +270,103 @@ TBLIS_BEGIN_NAMESPACE
             return x*x;
         }
 
+        /*
+         * The half precision storage types. Values convert to and from float
+         * (rounding to nearest even), and arithmetic happens in float.
+         */
+        struct bfloat16
+        {
+            uint16_t bits;
+
+            bfloat16() = default;
+
+            bfloat16(float x)
+            {
+                uint32_t u;
+                memcpy(&u, &x, sizeof(u));
+
+                if ((u & 0x7fffffffu) > 0x7f800000u)
+                    bits = (u >> 16) | 0x40u;
+                else
+                    bits = (u + 0x7fffu + ((u >> 16) & 1u)) >> 16;
+            }
+
+            operator float() const
+            {
+                uint32_t u = uint32_t(bits) << 16;
+                float x;
+                memcpy(&x, &u, sizeof(x));
+                return x;
+            }
+        };
+
+        struct float16
+        {
+            uint16_t bits;
+
+            float16() = default;
+
+            float16(float x)
+            {
+                uint32_t u;
+                memcpy(&u, &x, sizeof(u));
+
+                auto sign = (u >> 16) & 0x8000u;
+                u &= 0x7fffffffu;
+
+                if (u >= 0x47800000u)
+                {
+                    // Inf, NaN, or too large
+                    bits = sign | (u > 0x7f800000u ? 0x7e00u : 0x7c00u);
+                }
+                else if (u < 0x38800000u)
+                {
+                    // Subnormal: let the FPU round by adding 0.5
+                    float f;
+                    memcpy(&f, &u, sizeof(f));
+                    f += 0.5f;
+                    memcpy(&u, &f, sizeof(u));
+                    bits = sign | (u - 0x3f000000u);
+                }
+                else
+                {
+                    u += 0xc8000fffu + ((u >> 13) & 1u);
+                    bits = sign | (u >> 13);
+                }
+            }
+
+            operator float() const
+            {
+                uint32_t u = uint32_t(bits & 0x7fffu) << 13;
+                auto exp = u & 0x0f800000u;
+                u += 0x38000000u;
+
+                if (exp == 0x0f800000u)
+                {
+                    // Inf or NaN
+                    u += 0x38000000u;
+                }
+                else if (exp == 0)
+                {
+                    // Zero or subnormal
+                    u += 0x00800000u;
+                    float f;
+                    memcpy(&f, &u, sizeof(f));
+                    f -= 6.103515625e-05f;
+                    memcpy(&u, &f, sizeof(u));
+                }
+
+                u |= uint32_t(bits & 0x8000u) << 16;
+                float x;
+                memcpy(&x, &u, sizeof(x));
+                return x;
+            }
+        };
+
+        inline bfloat16 conj(bfloat16 x) { return x; }
+
+        inline float16 conj(float16 x) { return x; }
+
     #endif //TBLIS_ENABLE_CPLUSPLUS
 
 TBLIS_END_NAMESPACE
@@ -446,6 +601,8 @@ TBLIS_END_NAMESPACE
         template <> struct type_tag<  double> { static constexpr type_t value =   TYPE_DOUBLE; };
         template <> struct type_tag<scomplex> { static constexpr type_t value = TYPE_SCOMPLEX; };
         template <> struct type_tag<dcomplex> { static constexpr type_t value = TYPE_DCOMPLEX; };
+        template <> struct type_tag<bfloat16> { static constexpr type_t value = TYPE_BFLOAT16; };
+        template <> struct type_tag< float16> { static constexpr type_t value =  TYPE_FLOAT16; };
 
         constexpr static std::array<size_t,4> type_size =
         {
@@ -455,6 +612,15 @@ TBLIS_END_NAMESPACE
             sizeof(dcomplex),
         };
 
+        /*
+         * The size of the elements of a tensor of the given type, including
+         * the storage-only types.
+         */
+        constexpr size_t storage_size(type_t type)
+        {
+            return type == TYPE_BFLOAT16 || type == TYPE_FLOAT16 ? 2 : type_size[type];
+        }
+
         constexpr static std::array<size_t,4> type_alignment =
         {
             alignof(   float),
@@ -521,13 +687,23 @@ TBLIS_BEGIN_NAMESPACE
                 *this = value;
             }
 
+            /*
+             * The scalars of half precision tensors are floats, so that
+             * for example scalar(1.0, A.type) may be used with any tensor.
+             */
             template <typename T>
             tblis_scalar(T value, type_t type)
-            : type(type)
+            : type(type == TYPE_BFLOAT16 || type == TYPE_FLOAT16 ? TYPE_FLOAT : type)
             {
                 *this = value;
             }
 
+            tblis_scalar(bfloat16 value)
+            : tblis_scalar(float(value)) {}
+
+            tblis_scalar(float16 value)
+            : tblis_scalar(float(value)) {}
+
             template <typename T>
             T& get();
 
@@ -575,7 +751,7 @@ TBLIS_BEGIN_NAMESPACE
             template <typename T>
             void reset(T value, type_t type = type_tag<T>::value)
             {
-                this->type = type;
+                this->type = type == TYPE_BFLOAT16 || type == TYPE_FLOAT16 ? TYPE_FLOAT : type;
                 *this = value;
             }
 
@@ -978,6 +1154,17 @@ TBLIS_BEGIN_NAMESPACE
                                                  int ndim, len_type* len, dcomplex* data,
                                                  stride_type* stride);
 
+    /*
+     * Half precision tensors, with the data given as the raw 16-bit values.
+     */
+    TBLIS_EXPORT void tblis_init_tensor_scaled_bf16(tblis_tensor* t, float scalar,
+                                                    int ndim, len_type* len, uint16_t* data,
+                                                    stride_type* stride);
+
+    TBLIS_EXPORT void tblis_init_tensor_scaled_f16(tblis_tensor* t, float scalar,
+                                                   int ndim, len_type* len, uint16_t* data,
+                                                   stride_type* stride);
+
     TBLIS_EXPORT void tblis_init_tensor_s(tblis_tensor* t,
                                           int ndim, len_type* len, float* data,
                                           stride_type* stride);
@@ -994,6 +1181,14 @@ TBLIS_BEGIN_NAMESPACE
                                           int ndim, len_type* len, dcomplex* data,
                                           stride_type* stride);
 
+    TBLIS_EXPORT void tblis_init_tensor_bf16(tblis_tensor* t,
+                                             int ndim, len_type* len, uint16_t* data,
+                                             stride_type* stride);
+
+    TBLIS_EXPORT void tblis_init_tensor_f16(tblis_tensor* t,
+                                            int ndim, len_type* len, uint16_t* data,
+                                            stride_type* stride);
+
 TBLIS_END_NAMESPACE
 
 #if TBLIS_ENABLE_CPLUSPLUS
@@ -1,5 +1,7 @@
 #include "block_scatter.hpp"
 #include "alignment.hpp"
+#include "fixed_rank.hpp"
+#include "streaming.hpp"
 
 #include "tblis/plugin/bli_plugin_tblis.h"
 
@@ -20,7 +22,7 @@ static void fill_scatter_3d(      len_type     type_size,
                                   len_type     scat0,
                                   stride_type*       scat)
 {
-    const auto CL = 64/type_size;
+    const auto CL = internal::cache_line_size/type_size;
 
     TBLIS_ASSERT(ndim1 > 0);
 
@@ -190,24 +192,29 @@ static void fill_scatter(      len_type     type_size,
         }
         else
         {
-            viterator<> it(len_vector{len, len+ndim-1}, stride_vector{stride, stride+ndim-1});
+            dispatch_rank(ndim-1,
+            [&](auto rank)
+            {
+                rank_viterator<decltype(rank)::value> it(len_vector{len, len+ndim-1},
+                                                         stride_vector{stride, stride+ndim-1});
 
-            len_type off0, p0;
-            MArray::detail::divide<len_type>(off_b, m0, off0, p0);
-            auto pos = scat0;
-            it.position(off0, pos);
+                len_type off0, p0;
+                MArray::detail::divide<len_type>(off_b, m0, off0, p0);
+                auto pos = scat0;
+                it.position(off0, pos);
 
-            for (len_type idx = 0;idx < size_b && it.next(pos);)
-            {
-                auto pos2 = pos + p0*s0;
-                auto imax = std::min(m0-p0, size_b-idx);
-                for (len_type i = 0;i < imax;i++)
+                for (len_type idx = 0;idx < size_b && it.next(pos);)
                 {
-                    scat[idx++] = pos2;
-                    pos2 += s0;
+                    auto pos2 = pos + p0*s0;
+                    auto imax = std::min(m0-p0, size_b-idx);
+                    for (len_type i = 0;i < imax;i++)
+                    {
+                        scat[idx++] = pos2;
+                        pos2 += s0;
+                    }
+                    p0 = 0;
                 }
-                p0 = 0;
-            }
+            });
         }
 
         scat += size_b;
@@ -14,6 +14,11 @@ struct bsmtc_params
     std::array<const len_type*,2> len;
     std::array<const stride_type*,2> stride;
     std::array<bool,2> pack_3d;
+    /*
+     * The type of the tensor data if it is stored in half precision, which
+     * BLIS objects cannot describe, otherwise -1.
+     */
+    type_t storage_type = -1;
 };
 
 void fill_block_scatter(      len_type     type_size,
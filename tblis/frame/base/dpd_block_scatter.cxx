@@ -1,5 +1,11 @@
 #include "block_scatter.hpp"
 #include "dpd_block_scatter.hpp"
+#include "env.hpp"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
 
 #if defined(TBLIS_HAVE_GCC_BITSET_BUILTINS)
 
@@ -48,6 +54,119 @@ int popcount(T x_)
 namespace tblis
 {
 
+len_type dpd_scatter_cache_size = envtol("TBLIS_DPD_SCATTER_CACHE", 1024);
+
+/*
+ * The scatter and block-stride vectors of a given irrep block and range only
+ * depend on its shape, so they are computed once and copied thereafter.
+ */
+template <typename Len, typename Stride>
+static void cached_fill_block_scatter(      len_type     ts,
+                                      const Len&         len,
+                                      const Stride&      stride,
+                                            len_type     BS,
+                                            len_type     off,
+                                            len_type     size,
+                                            stride_type* scat,
+                                            stride_type* bs,
+                                            bool         pack_3d)
+{
+    if (size <= 0) return;
+
+    len_type zero = 0;
+    auto nblock = ceil_div(size, BS);
+
+    if (dpd_scatter_cache_size <= 0)
+    {
+        fill_block_scatter(ts, 1, &zero, len.size(), len.data(), stride.data(), BS,
+                           off, size, scat, bs, pack_3d);
+        return;
+    }
+
+    using entry = std::shared_ptr<const std::vector<stride_type>>;
+    static std::mutex lock;
+    static std::map<std::vector<stride_type>,entry> cache;
+
+    std::vector<stride_type> key{ts, BS, off, size, pack_3d};
+    key.insert(key.end(), len.begin(), len.end());
+    key.insert(key.end(), stride.begin(), stride.end());
+
+    entry value;
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        auto it = cache.find(key);
+        if (it != cache.end()) value = it->second;
+    }
+
+    if (!value)
+    {
+        auto data = std::make_shared<std::vector<stride_type>>(size + nblock);
+        fill_block_scatter(ts, 1, &zero, len.size(), len.data(), stride.data(), BS,
+                           off, size, data->data(), data->data() + size, pack_3d);
+        value = data;
+
+        std::lock_guard<std::mutex> guard(lock);
+        if ((len_type)cache.size() >= dpd_scatter_cache_size) cache.clear();
+        cache.emplace(std::move(key), value);
+    }
+
+    std::copy_n(value->data(), size, scat);
+    std::copy_n(value->data() + size, nblock, bs);
+}
+
+/*
+ * The sizes and block numbers of the non-empty blocks of the dimensions
+ * dims of A with total irrep irrep, cached by shape.
+ */
+static std::shared_ptr<const std::pair<len_vector,len_vector>>
+dpd_patches(const dpd_marray_view<char>& A, const dim_vector& dims, int irrep)
+{
+    const auto nirrep = A.num_irreps();
+
+    std::vector<len_type> key{nirrep, irrep};
+    for (auto i : dims)
+    for (auto j : range(nirrep))
+        key.push_back(A.length(i, j));
+
+    using entry = std::shared_ptr<const std::pair<len_vector,len_vector>>;
+    static std::mutex lock;
+    static std::map<std::vector<len_type>,entry> cache;
+
+    if (internal::dpd_layout_cache_size > 0)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        auto it = cache.find(key);
+        if (it != cache.end()) return it->second;
+    }
+
+    auto patches = std::make_shared<std::pair<len_vector,len_vector>>();
+
+    MArray::irrep_iterator it(irrep, nirrep, dims.size());
+    patches->first.reserve(it.nblock());
+    patches->second.reserve(it.nblock());
+    for (int idx = 0;it.next();idx++)
+    {
+        stride_type size = 1;
+        for (auto i : range(dims.size()))
+            size *= A.length(dims[i], it.irrep(i));
+
+        if (size == 0) continue;
+
+        patches->first.push_back(size);
+        patches->second.push_back(idx);
+    }
+
+    if (internal::dpd_layout_cache_size > 0)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if ((len_type)cache.size() >= internal::dpd_layout_cache_size) cache.clear();
+        cache.emplace(std::move(key), patches);
+    }
+
+    return patches;
+}
+
 dpd_params::dpd_params(const dpd_marray_view<char>& other,
                        const dim_vector& row_inds,
                        const dim_vector& col_inds,
@@ -99,20 +218,9 @@ dpd_params::dpd_params(const dpd_marray_view<char>& other,
         }
         else
         {
-            MArray::irrep_iterator it(irrep[dim], nirrep, dims[dim].size());
-            patch_size[dim].reserve(it.nblock());
-            patch_idx[dim].reserve(it.nblock());
-            for (int idx = 0;it.next();idx++)
-            {
-                stride_type size = 1;
-                for (auto i : range(dims[dim].size()))
-                    size *= other.length(dims[dim][i], it.irrep(i));
-
-                if (size == 0) continue;
-
-                patch_size[dim].push_back(size);
-                patch_idx[dim].push_back(idx);
-            }
+            auto patches = dpd_patches(other, dims[dim], irrep[dim]);
+            patch_size[dim] = patches->first;
+            patch_idx[dim] = patches->second;
         }
     }
 }
@@ -189,19 +297,10 @@ char* fill_block_scatter(len_type ts, bool fill, const dpd_params& params,
 
     if (fill)
     {
-        len_type zero = 0;
-
-        fill_block_scatter(ts, 1, &zero,
-                           len_m.size(), len_m.data(), stride_m.data(), MR,
-                           m_off_patch, m_patch_size,
-                           rscat, rbs,
-                           params.pack_3d[0]);
-
-        fill_block_scatter(ts, 1, &zero,
-                           len_n.size(), len_n.data(), stride_n.data(), NR,
-                           n_off_patch, n_patch_size,
-                           cscat, cbs,
-                           params.pack_3d[1]);
+        cached_fill_block_scatter(ts, len_m, stride_m, MR, m_off_patch, m_patch_size,
+                                  rscat, rbs, params.pack_3d[0]);
+        cached_fill_block_scatter(ts, len_n, stride_n, NR, n_off_patch, n_patch_size,
+                                  cscat, cbs, params.pack_3d[1]);
     }
 
     return p_a;
@@ -67,6 +67,12 @@ inline auto get_patches(len_type len, len_type off, len_type MR, const len_vecto
     return std::make_tuple(niter, idx, off);
 }
 
+/*
+ * Maximum number of distinct scatter vectors remembered by
+ * fill_block_scatter. Zero disables the cache.
+ */
+extern len_type dpd_scatter_cache_size;
+
 char* fill_block_scatter(len_type type_size, bool fill, const dpd_params& params,
                          len_type MR, len_type NR,
                          len_type m_patch, len_type m_off_patch, len_type m_patch_size,
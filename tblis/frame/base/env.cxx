@@ -55,5 +55,21 @@ void set_verbose(int level)
     verbosity::level() = level;
 }
 
+static bool& compensated_sum()
+{
+    static bool enabled = envtol("TBLIS_COMPENSATED_SUM");
+    return enabled;
+}
+
+bool get_compensated_sum()
+{
+    return compensated_sum();
+}
+
+void set_compensated_sum(bool enabled)
+{
+    compensated_sum() = enabled;
+}
+
 }
 
@@ -14,10 +14,25 @@ inline long envtol(const std::string& env, long fallback=0)
     return fallback;
 }
 
+inline double envtod(const std::string& env, double fallback=0)
+{
+    char* str = getenv(env.c_str());
+    if (str) return strtod(str, nullptr);
+    return fallback;
+}
+
 int get_verbose();
 
 void set_verbose(int);
 
+/*
+ * Whether dot products and sums of dense tensors use compensated
+ * summation. The default is given by TBLIS_COMPENSATED_SUM (off if unset).
+ */
+bool get_compensated_sum();
+
+void set_compensated_sum(bool);
+
 }
 
 #endif
@@ -0,0 +1,146 @@
+#ifndef _TBLIS_FRAME_BASE_FIXED_RANK_HPP_
+#define _TBLIS_FRAME_BASE_FIXED_RANK_HPP_
+
+#include "basic_types.h"
+
+#include <algorithm>
+#include <array>
+#include <utility>
+#include <type_traits>
+
+namespace tblis
+{
+
+/*
+ * Drop-in replacement for viterator<N> when the number of dimensions is
+ * known at compile time. The lengths and strides are held in fixed-size
+ * arrays and the carry chain in next() is unrolled.
+ */
+template <int NDim, int N=1>
+class fixed_viterator
+{
+    static_assert(NDim >= 0);
+
+    protected:
+        std::array<len_type,NDim> len_ = {};
+        std::array<len_type,NDim> pos_ = {};
+        std::array<std::array<stride_type,NDim>,N> stride_ = {};
+        bool first_ = true;
+        bool empty_ = false;
+
+        template <int I, typename... Offsets>
+        bool next_(Offsets&... off)
+        {
+            if constexpr (I == NDim)
+            {
+                return false;
+            }
+            else
+            {
+                if (pos_[I] == len_[I]-1)
+                {
+                    int k = 0;
+                    ((off -= pos_[I]*stride_[k++][I]), ...);
+                    pos_[I] = 0;
+                    return next_<I+1>(off...);
+                }
+                else
+                {
+                    int k = 0;
+                    ((off += stride_[k++][I]), ...);
+                    pos_[I]++;
+                    return true;
+                }
+            }
+        }
+
+    public:
+        template <typename Len, typename... Strides>
+        fixed_viterator(const Len& len, const Strides&... strides)
+        {
+            static_assert(sizeof...(Strides) == N);
+
+            TBLIS_ASSERT((int)len.size() == NDim);
+
+            for (auto i : range(NDim))
+            {
+                len_[i] = len[i];
+                if (len_[i] == 0) empty_ = true;
+            }
+
+            int k = 0;
+            auto set_stride = [&](const auto& stride)
+            {
+                TBLIS_ASSERT((int)stride.size() == NDim);
+                std::copy_n(stride.begin(), NDim, stride_[k++].begin());
+            };
+
+            (set_stride(strides), ...);
+        }
+
+        template <typename... Offsets>
+        bool next(Offsets&... off)
+        {
+            static_assert(sizeof...(Offsets) == N);
+
+            if (first_)
+            {
+                first_ = false;
+                return !empty_;
+            }
+
+            if (next_<0>(off...)) return true;
+
+            first_ = true;
+            return false;
+        }
+
+        template <typename... Offsets>
+        void position(len_type idx, Offsets&... off)
+        {
+            static_assert(sizeof...(Offsets) == N);
+
+            if (empty_) return;
+
+            for (auto i : range(NDim))
+            {
+                auto p = idx % len_[i];
+                idx /= len_[i];
+
+                int k = 0;
+                ((off += (p-pos_[i])*stride_[k++][i]), ...);
+                pos_[i] = p;
+            }
+
+            first_ = true;
+        }
+
+        int dimension() const
+        {
+            return NDim;
+        }
+};
+
+template <int NDim, int N=1>
+using rank_viterator = std::conditional_t<NDim == MArray::DYNAMIC,
+                                          viterator<N>,
+                                          fixed_viterator<NDim,N>>;
+
+/*
+ * Call func with std::integral_constant<int,ndim> when ndim <= MaxRank, and
+ * with std::integral_constant<int,MArray::DYNAMIC> otherwise, so that
+ * rank_viterator<decltype(rank)::value> selects the appropriate iterator.
+ */
+template <int MaxRank=TBLIS_MAX_FIXED_RANK, typename Func>
+void dispatch_rank(int ndim, Func&& func)
+{
+    [&]<int... I>(std::integer_sequence<int,I...>)
+    {
+        if (!((ndim == I ? (func(std::integral_constant<int,I>{}), true) : false) || ...))
+            func(std::integral_constant<int,MArray::DYNAMIC>{});
+    }(std::make_integer_sequence<int,MaxRank+1>{});
+}
+
+}
+
+#endif
@@ -0,0 +1,109 @@
+#include "stats.hpp"
+
+#include <mutex>
+
+namespace tblis
+{
+
+namespace internal
+{
+
+thread_local call_stats* active_stats = nullptr;
+
+call_stats* get_active_stats()
+{
+    return active_stats;
+}
+
+void set_active_stats(call_stats* stats)
+{
+    active_stats = stats;
+}
+
+static thread_local tblis_stats last_stats = {};
+
+static std::mutex cumulative_mutex;
+static tblis_stats cumulative_stats = {};
+
+stats_scope::stats_scope(const tblis_comm* comm)
+{
+    if (active_stats) return;
+
+    active_ = true;
+    master_ = !comm || reinterpret_cast<const communicator*>(comm)->master();
+    active_stats = &stats_;
+    start_ = std::chrono::steady_clock::now();
+}
+
+stats_scope::~stats_scope()
+{
+    if (!active_) return;
+
+    active_stats = nullptr;
+
+    auto wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+
+    tblis_stats stats;
+    stats.calls = 1;
+    stats.flops = stats_.flops;
+    stats.bytes_packed = stats_.bytes_packed;
+    stats.wall_time = wall;
+    stats.pack_time = 1e-9*stats_.pack_ns;
+    stats.kernel_time = 1e-9*stats_.kernel_ns;
+    stats.scatter_time = 1e-9*stats_.scatter_ns;
+    stats.algorithm = stats_.algorithm;
+    stats.num_threads = stats_.num_threads;
+    stats.block_pairs = stats_.block_pairs;
+    stats.block_pairs_skipped = stats_.block_pairs_skipped;
+
+    last_stats = stats;
+
+    std::lock_guard<std::mutex> guard(cumulative_mutex);
+
+    if (master_)
+    {
+        cumulative_stats.calls++;
+        cumulative_stats.wall_time += stats.wall_time;
+    }
+
+    cumulative_stats.flops += stats.flops;
+    tblis::flops += stats.flops;
+    cumulative_stats.bytes_packed += stats.bytes_packed;
+    cumulative_stats.pack_time += stats.pack_time;
+    cumulative_stats.kernel_time += stats.kernel_time;
+    cumulative_stats.scatter_time += stats.scatter_time;
+    cumulative_stats.block_pairs += stats.block_pairs;
+    cumulative_stats.block_pairs_skipped += stats.block_pairs_skipped;
+
+    if (stats.algorithm != ALGORITHM_NONE)
+    {
+        cumulative_stats.algorithm = stats.algorithm;
+        cumulative_stats.num_threads = stats.num_threads;
+    }
+}
+
+}
+
+TBLIS_EXPORT
+void tblis_get_last_stats(tblis_stats* stats)
+{
+    *stats = internal::last_stats;
+}
+
+TBLIS_EXPORT
+void tblis_get_cumulative_stats(tblis_stats* stats)
+{
+    std::lock_guard<std::mutex> guard(internal::cumulative_mutex);
+    *stats = internal::cumulative_stats;
+}
+
+TBLIS_EXPORT
+void tblis_reset_stats()
+{
+    std::lock_guard<std::mutex> guard(internal::cumulative_mutex);
+    internal::cumulative_stats = {};
+    internal::last_stats = {};
+    flops = 0;
+}
+
+}
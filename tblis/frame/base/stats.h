@@ -0,0 +1,76 @@
+#ifndef _TBLIS_IFACE_BASE_STATS_H_
+#define _TBLIS_IFACE_BASE_STATS_H_
+
+#include "basic_types.h"
+
+TBLIS_BEGIN_NAMESPACE
+
+/*
+ * The algorithm selected for an operation. For operations which decompose
+ * into several sub-operations (e.g. blocked DPD or einsum), this is the
+ * top-level choice.
+ */
+typedef enum
+{
+    ALGORITHM_NONE                =  0,
+    ALGORITHM_REFERENCE           =  1,
+    ALGORITHM_BLAS                =  2,
+    ALGORITHM_VECTOR              =  3,
+    ALGORITHM_GER                 =  4,
+    ALGORITHM_GEMV                =  5,
+    ALGORITHM_GEMM                =  6,
+    ALGORITHM_SMALL_GEMM          =  7,
+    ALGORITHM_DPD_BLIS            =  8,
+    ALGORITHM_DPD_BLOCKED         =  9,
+    ALGORITHM_DPD_FULL            = 10,
+    ALGORITHM_EINSUM              = 11,
+    ALGORITHM_BLOCK_SPARSE        = 12,
+    ALGORITHM_CSF                 = 13,
+    ALGORITHM_INDEXED_BLOCKED     = 14,
+    ALGORITHM_INDEXED_FULL        = 15,
+    ALGORITHM_INDEXED_DPD_BLOCKED = 16,
+    ALGORITHM_INDEXED_DPD_FULL    = 17
+} algorithm_t;
+
+/*
+ * Performance counters. Times are in seconds; the pack, kernel, and
+ * scatter times are summed over all threads. Scatter time covers building
+ * block-scatter vectors and writing back temporary tiles. The block pair
+ * counts are only collected when block screening is enabled.
+ */
+typedef struct tblis_stats
+{
+    long calls;
+    long flops;
+    long bytes_packed;
+    double wall_time;
+    double pack_time;
+    double kernel_time;
+    double scatter_time;
+    int algorithm;
+    int num_threads;
+    long block_pairs;
+    long block_pairs_skipped;
+} tblis_stats;
+
+/*
+ * Statistics for the most recent operation issued from the calling thread.
+ * When a tblis_comm is passed explicitly, each participating thread records
+ * the portion of the work it performed.
+ */
+TBLIS_EXPORT
+void tblis_get_last_stats(tblis_stats* stats);
+
+/*
+ * Statistics summed over all operations since the last reset. The algorithm
+ * and num_threads fields are those of the most recently completed operation.
+ */
+TBLIS_EXPORT
+void tblis_get_cumulative_stats(tblis_stats* stats);
+
+TBLIS_EXPORT
+void tblis_reset_stats();
+
+TBLIS_END_NAMESPACE
+
+#endif
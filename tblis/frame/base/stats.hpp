@@ -0,0 +1,126 @@
+#ifndef _TBLIS_INTERNAL_BASE_STATS_HPP_
+#define _TBLIS_INTERNAL_BASE_STATS_HPP_
+
+#include "stats.h"
+#include "thread.h"
+
+#include <atomic>
+#include <chrono>
+
+namespace tblis
+{
+namespace internal
+{
+
+/*
+ * Counters for one operation. Threads spawned by parallelize_if inherit the
+ * active_stats pointer of the calling thread, so all of the work for an
+ * operation is accumulated in one place.
+ */
+struct call_stats
+{
+    std::atomic<long> flops{0};
+    std::atomic<long> bytes_packed{0};
+    std::atomic<long> pack_ns{0};
+    std::atomic<long> kernel_ns{0};
+    std::atomic<long> scatter_ns{0};
+    std::atomic<int> algorithm{ALGORITHM_NONE};
+    std::atomic<int> num_threads{0};
+    std::atomic<long> block_pairs{0};
+    std::atomic<long> block_pairs_skipped{0};
+};
+
+extern thread_local call_stats* active_stats;
+
+inline void record_flops(const communicator& comm, long flops)
+{
+    if (active_stats && comm.master()) active_stats->flops += flops;
+}
+
+inline void record_screening(const communicator& comm, long pairs, long skipped)
+{
+    if (active_stats && comm.master())
+    {
+        active_stats->block_pairs += pairs;
+        active_stats->block_pairs_skipped += skipped;
+    }
+}
+
+inline void record_bytes_packed(long bytes)
+{
+    if (active_stats) active_stats->bytes_packed += bytes;
+}
+
+/*
+ * The first algorithm recorded for an operation is kept, so that nested
+ * sub-operations do not override the top-level choice.
+ */
+inline void record_algorithm(const communicator& comm, algorithm_t algorithm)
+{
+    if (!active_stats || !comm.master()) return;
+
+    int none = ALGORITHM_NONE;
+    if (active_stats->algorithm.compare_exchange_strong(none, algorithm))
+        active_stats->num_threads = comm.num_threads();
+}
+
+enum stats_timer_t {STATS_PACK, STATS_KERNEL, STATS_SCATTER};
+
+class stats_timer
+{
+    protected:
+        std::atomic<long>* counter_ = nullptr;
+        std::chrono::steady_clock::time_point start_;
+
+    public:
+        stats_timer(stats_timer_t which)
+        {
+            if (!active_stats) return;
+
+            switch (which)
+            {
+                case STATS_PACK:    counter_ = &active_stats->pack_ns; break;
+                case STATS_KERNEL:  counter_ = &active_stats->kernel_ns; break;
+                case STATS_SCATTER: counter_ = &active_stats->scatter_ns; break;
+            }
+
+            start_ = std::chrono::steady_clock::now();
+        }
+
+        stats_timer(const stats_timer&) = delete;
+
+        ~stats_timer()
+        {
+            if (counter_)
+                *counter_ += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start_).count();
+        }
+};
+
+/*
+ * Placed at the top of each public entry point. Nested entry points (e.g.
+ * mult called from einsum) accumulate into the outermost scope.
+ */
+class stats_scope
+{
+    protected:
+        call_stats stats_;
+        bool active_ = false;
+        bool master_ = true;
+        std::chrono::steady_clock::time_point start_;
+
+    public:
+        stats_scope(const tblis_comm* comm);
+
+        stats_scope(const communicator& comm)
+        : stats_scope(reinterpret_cast<const tblis_comm*>(&comm)) {}
+
+        stats_scope(const stats_scope&) = delete;
+
+        ~stats_scope();
+};
+
+}
+}
+
+#endif
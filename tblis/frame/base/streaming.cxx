@@ -0,0 +1,108 @@
+#include "streaming.hpp"
+#include "env.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace tblis
+{
+namespace internal
+{
+
+len_type streaming_threshold = envtol("TBLIS_STREAMING_THRESHOLD");
+
+#if defined(__SSE2__)
+
+/*
+ * The number of leading elements which must be written normally before B
+ * is 16-byte aligned, or -1 if B is not aligned to ts.
+ */
+static len_type stream_head(len_type ts, len_type n, const char* B)
+{
+    auto off = reinterpret_cast<uintptr_t>(B) % 16;
+    if (off % ts) return -1;
+    return std::min<len_type>(n, ((16-off)%16)/ts);
+}
+
+void stream_copy(len_type ts, len_type n, const char* A, char* B)
+{
+    auto head = stream_head(ts, n, B);
+    if (head < 0 || (n-head)*ts < cache_line_size)
+    {
+        memcpy(B, A, n*ts);
+        return;
+    }
+
+    memcpy(B, A, head*ts);
+    A += head*ts;
+    B += head*ts;
+
+    auto body = ((n-head)*ts)/16;
+    for (len_type i = 0;i < body;i++)
+        _mm_stream_si128(reinterpret_cast<__m128i*>(B+i*16),
+                         _mm_loadu_si128(reinterpret_cast<const __m128i*>(A+i*16)));
+
+    memcpy(B+body*16, A+body*16, (n-head)*ts-body*16);
+}
+
+void stream_set(len_type ts, len_type n, const scalar& alpha, char* B)
+{
+    char value[16];
+    alpha.to(value);
+
+    auto head = stream_head(ts, n, B);
+    if (head < 0 || (n-head)*ts < cache_line_size)
+    {
+        for (len_type i = 0;i < n;i++) memcpy(B+i*ts, value, ts);
+        return;
+    }
+
+    for (len_type i = 0;i < head;i++) memcpy(B+i*ts, value, ts);
+    B += head*ts;
+    n -= head;
+
+    /*
+     * Every 16-byte chunk starts on an element boundary, so the same
+     * pattern is stored to each.
+     */
+    char pattern[16];
+    for (len_type i = 0;i < 16;i += ts) memcpy(pattern+i, value, ts);
+    auto pattern_v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pattern));
+
+    auto body = (n*ts)/16;
+    for (len_type i = 0;i < body;i++)
+        _mm_stream_si128(reinterpret_cast<__m128i*>(B+i*16), pattern_v);
+
+    for (len_type i = body*16/ts;i < n;i++) memcpy(B+i*ts, value, ts);
+}
+
+void stream_fence()
+{
+    _mm_sfence();
+}
+
+#else
+
+void stream_copy(len_type ts, len_type n, const char* A, char* B)
+{
+    memcpy(B, A, n*ts);
+}
+
+void stream_set(len_type ts, len_type n, const scalar& alpha, char* B)
+{
+    char value[16];
+    alpha.to(value);
+    for (len_type i = 0;i < n;i++) memcpy(B+i*ts, value, ts);
+}
+
+void stream_fence() {}
+
+#endif
+
+}
+}
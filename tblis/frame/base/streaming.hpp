@@ -0,0 +1,52 @@
+#ifndef _TBLIS_STREAMING_HPP_
+#define _TBLIS_STREAMING_HPP_
+
+#include "basic_types.h"
+
+namespace tblis
+{
+namespace internal
+{
+
+/*
+ * The cache line size assumed throughout (e.g. when blocking scatter
+ * vectors).
+ */
+constexpr len_type cache_line_size = 64;
+
+/*
+ * Output tensors of at least this many bytes are written with non-temporal
+ * (streaming) stores when their old contents are not needed. Streaming is
+ * off (0) by default until the threshold has been tuned, and may be enabled
+ * by setting TBLIS_STREAMING_THRESHOLD to a size in bytes, e.g. twice the
+ * size of the last-level cache.
+ */
+extern len_type streaming_threshold;
+
+inline bool use_streaming(len_type bytes)
+{
+    return streaming_threshold > 0 && bytes >= streaming_threshold;
+}
+
+/*
+ * Copy n contiguous elements of size ts from A to B, using streaming stores
+ * for the cache lines of B which are written in full.
+ */
+void stream_copy(len_type ts, len_type n, const char* A, char* B);
+
+/*
+ * Set n contiguous elements of B to alpha, using streaming stores for the
+ * cache lines of B which are written in full.
+ */
+void stream_set(len_type ts, len_type n, const scalar& alpha, char* B);
+
+/*
+ * Order the streaming stores issued by this thread before any subsequent
+ * stores, so that they are visible to other threads after a barrier.
+ */
+void stream_fence();
+
+}
+}
+
+#endif
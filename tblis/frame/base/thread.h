@@ -32,7 +32,26 @@ using tci::partition_2x2;
 
 extern communicator single;
 
+/*
+ * Deprecated: the cumulative flop count, as in the flops field of
+ * tblis_get_cumulative_stats (and reset along with it by tblis_reset_stats).
+ */
 extern std::atomic<long> flops;
+
+namespace internal
+{
+
+struct call_stats;
+
+/*
+ * The statistics of the operation running on the calling thread (see
+ * stats.hpp), which parallelize_if passes on to the threads it spawns.
+ */
+call_stats* get_active_stats();
+void set_active_stats(call_stats* stats);
+
+}
+
 extern len_type inout_ratio;
 extern int outer_threading;
 
@@ -441,6 +460,71 @@ void reduce(const communicator& comm, T& value)
 #endif
 }
 
+/*
+ * Compensated (Kahan) summation: the total is sum - comp, where comp is the
+ * rounding error accumulated in sum.
+ */
+template <typename T>
+void kahan_add(T& sum, T& comp, T val)
+{
+    auto y = val - comp;
+    auto t = sum + y;
+    comp = (t - sum) - y;
+    sum = t;
+}
+
+/*
+ * Sum the compensated partial sums of each thread, leaving the total
+ * in sum and comp on the master thread.
+ */
+template <typename T>
+void reduce(const communicator& comm, T& sum, T& comp)
+{
+#if TCI_USE_OPENMP_THREADS || TCI_USE_PTHREADS_THREADS || TCI_USE_WINDOWS_THREADS
+    if (comm.num_threads() == 1)
+    {
+#endif
+
+        return;
+
+#if TCI_USE_OPENMP_THREADS || TCI_USE_PTHREADS_THREADS || TCI_USE_WINDOWS_THREADS
+    }
+
+    std::vector<std::pair<T,T>> vals;
+    if (comm.master()) vals.resize(comm.num_threads());
+
+    comm.broadcast(
+    [&](std::vector<std::pair<T,T>>& vals)
+    {
+        vals[comm.thread_num()] = {sum, comp};
+    },
+    vals);
+
+    if (comm.master())
+    {
+        for (unsigned i = 1;i < comm.num_threads();i++)
+        {
+            kahan_add(sum, comp, vals[i].first);
+            kahan_add(sum, comp, T(-vals[i].second));
+        }
+    }
+
+    comm.barrier();
+#endif
+}
+
+inline void reduce(type_t type, const communicator& comm, tblis_scalar& sum, tblis_scalar& comp)
+{
+    switch (type)
+    {
+        case TYPE_FLOAT:    reduce(comm, sum.data.s, comp.data.s); break;
+        case TYPE_DOUBLE:   reduce(comm, sum.data.d, comp.data.d); break;
+        case TYPE_SCOMPLEX: reduce(comm, sum.data.c, comp.data.c); break;
+        case TYPE_DCOMPLEX: reduce(comm, sum.data.z, comp.data.z); break;
+        default: break;
+    }
+}
+
 template <typename T>
 void reduce(const communicator& comm, reduce_t op, std::atomic<atomic_reducer_helper<T>>& pair)
 {
@@ -523,12 +607,17 @@ void parallelize_if(const Func& f, const tblis_comm* _comm, Args&&... args)
     }
     else
     {
+        auto stats = internal::get_active_stats();
+
         parallelize
         (
             [&,f](const communicator& comm) mutable
             {
+                auto prev = internal::get_active_stats();
+                internal::set_active_stats(stats);
                 f(comm, args...);
                 comm.barrier();
+                internal::set_active_stats(prev);
             },
             tblis_get_num_threads()
         );
@@ -5,10 +5,17 @@ namespace tblis
 
 kerid_t GEMM_BSMTC_UKR = -1;
 kerid_t PACKM_BSMTC_UKR = -1;
+kerid_t PACKM_BSMTC_BF16_UKR = -1;
+kerid_t PACKM_BSMTC_F16_UKR = -1;
+kerid_t KAHAN_DOT_KER = -1;
+kerid_t KAHAN_SUM_KER = -1;
+kerid_t MAP_KER = -1;
 kerid_t MULT_KER = -1;
 kerid_t REDUCE_KER = -1;
+kerid_t REDUCE_MULTI_KER = -1;
 kerid_t SHIFT_KER = -1;
 kerid_t TRANS_KER = -1;
+kerid_t ZIP_KER = -1;
 kerid_t MRT_BSZ = -1;
 kerid_t NRT_BSZ = -1;
 kerid_t KE_BSZ = -1;
@@ -18,12 +25,19 @@ err_t register_plugin()
     bli_init();
 
     if (auto err = bli_gks_register_ukr2(&PACKM_BSMTC_UKR); err != BLIS_SUCCESS) return err;
+    if (auto err = bli_gks_register_ukr(&PACKM_BSMTC_BF16_UKR); err != BLIS_SUCCESS) return err;
+    if (auto err = bli_gks_register_ukr(&PACKM_BSMTC_F16_UKR); err != BLIS_SUCCESS) return err;
     if (auto err = bli_gks_register_ukr(&GEMM_BSMTC_UKR); err != BLIS_SUCCESS) return err;
 
+    if (auto err = bli_gks_register_ukr(&KAHAN_DOT_KER); err != BLIS_SUCCESS) return err;
+    if (auto err = bli_gks_register_ukr(&KAHAN_SUM_KER); err != BLIS_SUCCESS) return err;
+    if (auto err = bli_gks_register_ukr(&MAP_KER); err != BLIS_SUCCESS) return err;
     if (auto err = bli_gks_register_ukr(&MULT_KER); err != BLIS_SUCCESS) return err;
     if (auto err = bli_gks_register_ukr(&REDUCE_KER); err != BLIS_SUCCESS) return err;
+    if (auto err = bli_gks_register_ukr(&REDUCE_MULTI_KER); err != BLIS_SUCCESS) return err;
     if (auto err = bli_gks_register_ukr(&SHIFT_KER); err != BLIS_SUCCESS) return err;
     if (auto err = bli_gks_register_ukr(&TRANS_KER); err != BLIS_SUCCESS) return err;
+    if (auto err = bli_gks_register_ukr(&ZIP_KER); err != BLIS_SUCCESS) return err;
 
     if (auto err = bli_gks_register_blksz(&MRT_BSZ); err != BLIS_SUCCESS) return err;
     if (auto err = bli_gks_register_blksz(&NRT_BSZ); err != BLIS_SUCCESS) return err;
@@ -19,10 +19,17 @@ namespace tblis
 
 extern kerid_t GEMM_BSMTC_UKR;
 extern kerid_t PACKM_BSMTC_UKR;
+extern kerid_t PACKM_BSMTC_BF16_UKR;
+extern kerid_t PACKM_BSMTC_F16_UKR;
+extern kerid_t KAHAN_DOT_KER;
+extern kerid_t KAHAN_SUM_KER;
+extern kerid_t MAP_KER;
 extern kerid_t MULT_KER;
 extern kerid_t REDUCE_KER;
+extern kerid_t REDUCE_MULTI_KER;
 extern kerid_t SHIFT_KER;
 extern kerid_t TRANS_KER;
+extern kerid_t ZIP_KER;
 extern kerid_t MRT_BSZ;
 extern kerid_t NRT_BSZ;
 extern kerid_t KE_BSZ;
@@ -69,6 +76,31 @@ using packm_bsmtc_ft = void(*)
             void*  p_,       stride_type  ldp
     );
 
+using kahan_dot_ft = void(*)
+    (
+            len_type n,
+            bool     conj_A, const void* A_, stride_type inc_A,
+            bool     conj_B, const void* B_, stride_type inc_B,
+            void*    sum_,
+            void*    comp_
+    );
+
+using kahan_sum_ft = void(*)
+    (
+            len_type n,
+      const void*    A_, stride_type inc_A,
+            void*    sum_,
+            void*    comp_
+    );
+
+using map_ft = void(*)
+    (
+            map_t    op,
+            len_type n,
+      const void*    alpha_, bool conj_A, const void* A_, stride_type inc_A,
+      const void*     beta_, bool conj_B,       void* B_, stride_type inc_B
+    );
+
 using mult_ft = void(*)
     (
             len_type n,
@@ -86,6 +118,15 @@ using reduce_ft = void(*)
             len_type& idx_
     );
 
+using reduce_multi_ft = void(*)
+    (
+            unsigned  ops,
+            len_type  n,
+      const void*     A_, stride_type inc_A,
+            void*     value_,
+            len_type* idx_
+    );
+
 using shift_ft = void(*)
     (
             len_type n,
@@ -103,6 +144,15 @@ using trans_ft = void(*)
       const void*    beta_,
             bool     conj_B,       void* B_, stride_type rs_B, stride_type cs_B);
 
+using zip_ft = void(*)
+    (
+            zip_t    op,
+            len_type n,
+      const void*    alpha_, bool conj_A, const void* A_, stride_type inc_A,
+      const void*     beta_, bool conj_B, const void* B_, stride_type inc_B,
+      const void*    gamma_, bool conj_C,       void* C_, stride_type inc_C
+    );
+
 //
 // Registration and intialization function prototypes.
 //
@@ -47,11 +47,18 @@ inline void_fp ptr(T* f)
 //
 
 extern func2_t TBLIS_REF_KERNEL_FPA(packm_bsmtc);
+extern func_t  TBLIS_REF_KERNEL_FPA(packm_bsmtc_bf16);
+extern func_t  TBLIS_REF_KERNEL_FPA(packm_bsmtc_f16);
 extern func_t  TBLIS_REF_KERNEL_FPA(gemm_bsmtc);
+extern func_t  TBLIS_REF_KERNEL_FPA(kahan_dot);
+extern func_t  TBLIS_REF_KERNEL_FPA(kahan_sum);
+extern func_t  TBLIS_REF_KERNEL_FPA(map);
 extern func_t  TBLIS_REF_KERNEL_FPA(mult);
 extern func_t  TBLIS_REF_KERNEL_FPA(reduce);
+extern func_t  TBLIS_REF_KERNEL_FPA(reduce_multi);
 extern func_t  TBLIS_REF_KERNEL_FPA(shift);
 extern func_t  TBLIS_REF_KERNEL_FPA(trans);
+extern func_t  TBLIS_REF_KERNEL_FPA(zip);
 
 //
 // Kernel and blocksize IDs
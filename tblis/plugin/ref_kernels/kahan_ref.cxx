@@ -0,0 +1,201 @@
+#include "../bli_plugin_tblis.h"
+#include "../kernel.hpp"
+
+/*
+ * Compensated summation depends on the exact order of the floating point
+ * operations, which the -funsafe-math-optimizations -ffp-contract=fast in the
+ * reference kernel flags would allow the compiler to undo. GCC only inlines
+ * between functions with the same floating point options, so every function
+ * in the inner loops carries TBLIS_KAHAN_PRECISE and the complex types are
+ * handled as pairs of reals instead of through the std::complex operators.
+ */
+#if defined(__clang__)
+#pragma float_control(precise, on)
+#pragma clang fp contract(off)
+#define TBLIS_KAHAN_PRECISE
+#elif defined(__GNUC__)
+#define TBLIS_KAHAN_PRECISE __attribute__((optimize("no-unsafe-math-optimizations","fp-contract=off")))
+#else
+#define TBLIS_KAHAN_PRECISE
+#endif
+
+namespace tblis
+{
+
+/*
+ * The number of independent compensated sums, which lets the unit-stride
+ * loops vectorize without reassociating any sum, and is enough to hide the
+ * latency of the four dependent additions in each step.
+ */
+constexpr int KAHAN_LANES = 32;
+
+template <typename R>
+TBLIS_KAHAN_PRECISE
+static void kahan_step(R& sum, R& comp, R val)
+{
+    auto y = val - comp;
+    auto t = sum + y;
+    comp = (t - sum) - y;
+    sum = t;
+}
+
+/*
+ * sum - comp += sum_i x(i), where each term has N real parts, each lane
+ * accumulates every KAHAN_LANES-th term, and the lanes are then added in with
+ * their own compensation terms.
+ */
+template <int N, typename R, typename Terms>
+TBLIS_KAHAN_PRECISE
+static void kahan_lanes(len_type n, const Terms& x, R* sum, R* comp)
+{
+    R lane_sum[KAHAN_LANES][N] = {};
+    R lane_comp[KAHAN_LANES][N] = {};
+
+    len_type i = 0;
+    for (;i+KAHAN_LANES <= n;i += KAHAN_LANES)
+    {
+        #pragma omp simd
+        for (int l = 0;l < KAHAN_LANES;l++)
+        {
+            R term[N];
+            x(i+l, term);
+            for (int p = 0;p < N;p++)
+                kahan_step(lane_sum[l][p], lane_comp[l][p], term[p]);
+        }
+    }
+
+    for (;i < n;i++)
+    {
+        R term[N];
+        x(i, term);
+        for (int p = 0;p < N;p++)
+            kahan_step(sum[p], comp[p], term[p]);
+    }
+
+    for (int l = 0;l < KAHAN_LANES;l++)
+    for (int p = 0;p < N;p++)
+    {
+        kahan_step(sum[p], comp[p], lane_sum[l][p]);
+        kahan_step(sum[p], comp[p], R(-lane_comp[l][p]));
+    }
+}
+
+template <int N, typename R>
+struct kahan_terms
+{
+    const R* TBLIS_RESTRICT A;
+    stride_type inc_A;
+
+    TBLIS_KAHAN_PRECISE
+    void operator()(len_type i, R (&term)[N]) const
+    {
+        for (int p = 0;p < N;p++)
+            term[p] = A[i*inc_A+p];
+    }
+};
+
+template <typename T>
+TBLIS_KAHAN_PRECISE
+void TBLIS_REF_KERNEL(kahan_sum)
+    (
+            len_type n,
+      const void*    A_, stride_type inc_A,
+            void*    sum_,
+            void*    comp_
+    )
+{
+    using R = real_type_t<T>;
+    constexpr int N = is_complex_v<T> ? 2 : 1;
+
+    const R* A = static_cast<const R*>(A_);
+
+    auto sum = static_cast<R*>(sum_);
+    auto comp = static_cast<R*>(comp_);
+
+    if (inc_A == 1)
+        kahan_lanes<N>(n, kahan_terms<N,R>{A, N}, sum, comp);
+    else
+        kahan_lanes<N>(n, kahan_terms<N,R>{A, N*inc_A}, sum, comp);
+}
+
+TBLIS_INIT_REF_KERNEL(kahan_sum)
+
+/*
+ * The products for kahan_dot. They are rounded as usual; only their
+ * accumulation is compensated.
+ */
+template <int N, bool ConjA, bool ConjB, typename R>
+struct kahan_products
+{
+    const R* TBLIS_RESTRICT A;
+    stride_type inc_A;
+    const R* TBLIS_RESTRICT B;
+    stride_type inc_B;
+
+    TBLIS_KAHAN_PRECISE
+    void operator()(len_type i, R (&term)[N]) const
+    {
+        if constexpr (N == 1)
+        {
+            term[0] = A[i*inc_A]*B[i*inc_B];
+        }
+        else
+        {
+            R ar = A[i*inc_A];
+            R ai = ConjA ? -A[i*inc_A+1] : A[i*inc_A+1];
+            R br = B[i*inc_B];
+            R bi = ConjB ? -B[i*inc_B+1] : B[i*inc_B+1];
+            term[0] = ar*br - ai*bi;
+            term[1] = ar*bi + ai*br;
+        }
+    }
+};
+
+template <bool ConjA, bool ConjB, int N, typename R>
+TBLIS_KAHAN_PRECISE
+static void kahan_dot_conj(len_type n, const R* A, stride_type inc_A,
+                                       const R* B, stride_type inc_B,
+                           R* sum, R* comp)
+{
+    if (inc_A == 1 && inc_B == 1)
+        kahan_lanes<N>(n, kahan_products<N,ConjA,ConjB,R>{A, N, B, N}, sum, comp);
+    else
+        kahan_lanes<N>(n, kahan_products<N,ConjA,ConjB,R>{A, N*inc_A, B, N*inc_B}, sum, comp);
+}
+
+template <typename T>
+TBLIS_KAHAN_PRECISE
+void TBLIS_REF_KERNEL(kahan_dot)
+    (
+            len_type n,
+            bool     conj_A, const void* A_, stride_type inc_A,
+            bool     conj_B, const void* B_, stride_type inc_B,
+            void*    sum_,
+            void*    comp_
+    )
+{
+    using R = real_type_t<T>;
+    constexpr int N = is_complex_v<T> ? 2 : 1;
+
+    const R* A = static_cast<const R*>(A_);
+    const R* B = static_cast<const R*>(B_);
+
+    auto sum = static_cast<R*>(sum_);
+    auto comp = static_cast<R*>(comp_);
+
+    conj_A = is_complex_v<T> && conj_A;
+    conj_B = is_complex_v<T> && conj_B;
+
+    if (conj_A && conj_B)
+        kahan_dot_conj< true, true,N>(n, A, inc_A, B, inc_B, sum, comp);
+    else if (conj_A)
+        kahan_dot_conj< true,false,N>(n, A, inc_A, B, inc_B, sum, comp);
+    else if (conj_B)
+        kahan_dot_conj<false, true,N>(n, A, inc_A, B, inc_B, sum, comp);
+    else
+        kahan_dot_conj<false,false,N>(n, A, inc_A, B, inc_B, sum, comp);
+}
+
+TBLIS_INIT_REF_KERNEL(kahan_dot)
+
+}
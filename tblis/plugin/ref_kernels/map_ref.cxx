@@ -0,0 +1,227 @@
+#include "../bli_plugin_tblis.h"
+#include "../kernel.hpp"
+
+namespace tblis
+{
+
+/*
+ * B = f(alpha*A) + beta*B, with the conjugations fixed at compile time so
+ * that the unit-stride loops vectorize. The helpers have internal linkage
+ * since this file is compiled once per configuration.
+ */
+template <bool ConjA, bool ConjB, typename T, typename Func>
+static void map_loop(const Func& f, len_type n,
+                     T alpha, const T* TBLIS_RESTRICT A, stride_type inc_A,
+                     T  beta,       T* TBLIS_RESTRICT B, stride_type inc_B)
+{
+    if (beta == T(0))
+    {
+        if (inc_A == 1 && inc_B == 1)
+        {
+            #pragma omp simd
+            for (len_type i = 0;i < n;i++)
+                B[i] = f(alpha*conj(ConjA, A[i]));
+        }
+        else
+        {
+            for (len_type i = 0;i < n;i++)
+                B[i*inc_B] = f(alpha*conj(ConjA, A[i*inc_A]));
+        }
+    }
+    else
+    {
+        if (inc_A == 1 && inc_B == 1)
+        {
+            #pragma omp simd
+            for (len_type i = 0;i < n;i++)
+                B[i] = f(alpha*conj(ConjA, A[i])) + beta*conj(ConjB, B[i]);
+        }
+        else
+        {
+            for (len_type i = 0;i < n;i++)
+                B[i*inc_B] = f(alpha*conj(ConjA, A[i*inc_A])) +
+                              beta*conj(ConjB, B[i*inc_B]);
+        }
+    }
+}
+
+template <typename T, typename Func>
+static void map_conj(const Func& f, len_type n,
+                     T alpha, bool conj_A, const T* A, stride_type inc_A,
+                     T  beta, bool conj_B,       T* B, stride_type inc_B)
+{
+    conj_A = is_complex_v<T> && conj_A;
+    conj_B = is_complex_v<T> && conj_B && beta != T(0);
+
+    if (conj_A && conj_B)
+        map_loop< true, true>(f, n, alpha, A, inc_A, beta, B, inc_B);
+    else if (conj_A)
+        map_loop< true,false>(f, n, alpha, A, inc_A, beta, B, inc_B);
+    else if (conj_B)
+        map_loop<false, true>(f, n, alpha, A, inc_A, beta, B, inc_B);
+    else
+        map_loop<false,false>(f, n, alpha, A, inc_A, beta, B, inc_B);
+}
+
+template <typename T>
+void TBLIS_REF_KERNEL(map)
+    (
+            map_t    op,
+            len_type n,
+      const void*    alpha_, bool conj_A, const void* A_, stride_type inc_A,
+      const void*     beta_, bool conj_B,       void* B_, stride_type inc_B
+    )
+{
+    T alpha = *static_cast<const T*>(alpha_);
+    T beta  = *static_cast<const T*>(beta_ );
+
+    const T* A = static_cast<const T*>(A_);
+          T* B = static_cast<      T*>(B_);
+
+    switch (op)
+    {
+        case MAP_RECIPROCAL:
+            map_conj([](T a) { return T(1)/a; },
+                     n, alpha, conj_A, A, inc_A, beta, conj_B, B, inc_B);
+            break;
+        case MAP_SQRT:
+            map_conj([](T a) { return std::sqrt(a); },
+                     n, alpha, conj_A, A, inc_A, beta, conj_B, B, inc_B);
+            break;
+        case MAP_EXP:
+            map_conj([](T a) { return std::exp(a); },
+                     n, alpha, conj_A, A, inc_A, beta, conj_B, B, inc_B);
+            break;
+        case MAP_LOG:
+            map_conj([](T a) { return std::log(a); },
+                     n, alpha, conj_A, A, inc_A, beta, conj_B, B, inc_B);
+            break;
+        case MAP_ABS:
+            map_conj([](T a) { return T(std::abs(a)); },
+                     n, alpha, conj_A, A, inc_A, beta, conj_B, B, inc_B);
+            break;
+        case MAP_SQUARE:
+            map_conj([](T a) { return a*a; },
+                     n, alpha, conj_A, A, inc_A, beta, conj_B, B, inc_B);
+            break;
+    }
+}
+
+TBLIS_INIT_REF_KERNEL(map)
+
+/*
+ * C = f(alpha*A, beta*B) + gamma*C, as for map_loop.
+ */
+template <bool ConjA, bool ConjB, bool ConjC, typename T, typename Func>
+static void zip_loop(const Func& f, len_type n,
+                     T alpha, const T* TBLIS_RESTRICT A, stride_type inc_A,
+                     T  beta, const T* TBLIS_RESTRICT B, stride_type inc_B,
+                     T gamma,       T* TBLIS_RESTRICT C, stride_type inc_C)
+{
+    if (gamma == T(0))
+    {
+        if (inc_A == 1 && inc_B == 1 && inc_C == 1)
+        {
+            #pragma omp simd
+            for (len_type i = 0;i < n;i++)
+                C[i] = f(alpha*conj(ConjA, A[i]), beta*conj(ConjB, B[i]));
+        }
+        else
+        {
+            for (len_type i = 0;i < n;i++)
+                C[i*inc_C] = f(alpha*conj(ConjA, A[i*inc_A]),
+                                beta*conj(ConjB, B[i*inc_B]));
+        }
+    }
+    else
+    {
+        if (inc_A == 1 && inc_B == 1 && inc_C == 1)
+        {
+            #pragma omp simd
+            for (len_type i = 0;i < n;i++)
+                C[i] = f(alpha*conj(ConjA, A[i]), beta*conj(ConjB, B[i])) +
+                       gamma*conj(ConjC, C[i]);
+        }
+        else
+        {
+            for (len_type i = 0;i < n;i++)
+                C[i*inc_C] = f(alpha*conj(ConjA, A[i*inc_A]),
+                                beta*conj(ConjB, B[i*inc_B])) +
+                             gamma*conj(ConjC, C[i*inc_C]);
+        }
+    }
+}
+
+template <typename T, typename Func>
+static void zip_conj(const Func& f, len_type n,
+                     T alpha, bool conj_A, const T* A, stride_type inc_A,
+                     T  beta, bool conj_B, const T* B, stride_type inc_B,
+                     T gamma, bool conj_C,       T* C, stride_type inc_C)
+{
+    conj_A = is_complex_v<T> && conj_A;
+    conj_B = is_complex_v<T> && conj_B;
+    conj_C = is_complex_v<T> && conj_C && gamma != T(0);
+
+    /*
+     * Only the output conjugation is kept separate; conjugated inputs are
+     * rare enough to share one instantiation.
+     */
+    if (conj_A || conj_B)
+    {
+        auto g = [&](T a, T b) { return f(conj(conj_A, a), conj(conj_B, b)); };
+
+        if (conj_C)
+            zip_loop<false,false, true>(g, n, conj(conj_A, alpha), A, inc_A,
+                                              conj(conj_B,  beta), B, inc_B, gamma, C, inc_C);
+        else
+            zip_loop<false,false,false>(g, n, conj(conj_A, alpha), A, inc_A,
+                                              conj(conj_B,  beta), B, inc_B, gamma, C, inc_C);
+    }
+    else if (conj_C)
+        zip_loop<false,false, true>(f, n, alpha, A, inc_A, beta, B, inc_B, gamma, C, inc_C);
+    else
+        zip_loop<false,false,false>(f, n, alpha, A, inc_A, beta, B, inc_B, gamma, C, inc_C);
+}
+
+template <typename T>
+void TBLIS_REF_KERNEL(zip)
+    (
+            zip_t    op,
+            len_type n,
+      const void*    alpha_, bool conj_A, const void* A_, stride_type inc_A,
+      const void*     beta_, bool conj_B, const void* B_, stride_type inc_B,
+      const void*    gamma_, bool conj_C,       void* C_, stride_type inc_C
+    )
+{
+    T alpha = *static_cast<const T*>(alpha_);
+    T beta  = *static_cast<const T*>(beta_ );
+    T gamma = *static_cast<const T*>(gamma_);
+
+    const T* A = static_cast<const T*>(A_);
+    const T* B = static_cast<const T*>(B_);
+          T* C = static_cast<      T*>(C_);
+
+    switch (op)
+    {
+        case ZIP_MUL:
+            zip_conj([](T a, T b) { return a*b; },
+                     n, alpha, conj_A, A, inc_A, beta, conj_B, B, inc_B, gamma, conj_C, C, inc_C);
+            break;
+        case ZIP_DIV:
+            zip_conj([](T a, T b) { return a/b; },
+                     n, alpha, conj_A, A, inc_A, beta, conj_B, B, inc_B, gamma, conj_C, C, inc_C);
+            break;
+        case ZIP_MAX:
+            zip_conj([](T a, T b) { return std::real(a) < std::real(b) ? b : a; },
+                     n, alpha, conj_A, A, inc_A, beta, conj_B, B, inc_B, gamma, conj_C, C, inc_C);
+            break;
+        case ZIP_MIN:
+            zip_conj([](T a, T b) { return std::real(b) < std::real(a) ? b : a; },
+                     n, alpha, conj_A, A, inc_A, beta, conj_B, B, inc_B, gamma, conj_C, C, inc_C);
+            break;
+    }
+}
+
+TBLIS_INIT_REF_KERNEL(zip)
+
+}
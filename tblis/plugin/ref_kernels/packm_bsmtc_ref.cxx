@@ -422,4 +422,18 @@ void TBLIS_REF_KERNEL(packm_bsmtc)
 
 TBLIS_INIT_REF_KERNEL2(packm_bsmtc);
 
+/*
+ * Half precision sources, indexed by the (real) type of the packed panels.
+ */
+#define TBLIS_INIT_REF_KERNEL_HALF_(func, T) func_t PASTECH(func,_fpa) = [] \
+{ \
+    func_t f; \
+    bli_func_init(&f, ptr(TBLIS_REF_KERNEL(packm_bsmtc)<T,float>), \
+                      ptr(TBLIS_REF_KERNEL(packm_bsmtc)<T,double>), nullptr, nullptr); \
+    return f; \
+}();
+
+TBLIS_INIT_REF_KERNEL_HALF_(TBLIS_REF_KERNEL(packm_bsmtc_bf16), bfloat16)
+TBLIS_INIT_REF_KERNEL_HALF_(TBLIS_REF_KERNEL(packm_bsmtc_f16), float16)
+
 }
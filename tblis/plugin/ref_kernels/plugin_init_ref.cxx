@@ -11,12 +11,19 @@ void PASTEMAC(plugin_init,BLIS_CNAME_INFIX,BLIS_REF_SUFFIX)()
     auto cntx = const_cast<cntx_t*>(bli_gks_lookup_id(PASTECH(BLIS_ARCH,BLIS_CNAME_UPPER_INFIX)));
 
     bli_cntx_set_ukr2(PACKM_BSMTC_UKR, &TBLIS_REF_KERNEL_FPA(packm_bsmtc), cntx);
+    bli_cntx_set_ukr(PACKM_BSMTC_BF16_UKR, &TBLIS_REF_KERNEL_FPA(packm_bsmtc_bf16), cntx);
+    bli_cntx_set_ukr(PACKM_BSMTC_F16_UKR, &TBLIS_REF_KERNEL_FPA(packm_bsmtc_f16), cntx);
     bli_cntx_set_ukr(GEMM_BSMTC_UKR, &TBLIS_REF_KERNEL_FPA(gemm_bsmtc), cntx);
 
+    bli_cntx_set_ukr(KAHAN_DOT_KER, &TBLIS_REF_KERNEL_FPA(kahan_dot), cntx);
+    bli_cntx_set_ukr(KAHAN_SUM_KER, &TBLIS_REF_KERNEL_FPA(kahan_sum), cntx);
+    bli_cntx_set_ukr(MAP_KER, &TBLIS_REF_KERNEL_FPA(map), cntx);
     bli_cntx_set_ukr(MULT_KER, &TBLIS_REF_KERNEL_FPA(mult), cntx);
     bli_cntx_set_ukr(REDUCE_KER, &TBLIS_REF_KERNEL_FPA(reduce), cntx);
+    bli_cntx_set_ukr(REDUCE_MULTI_KER, &TBLIS_REF_KERNEL_FPA(reduce_multi), cntx);
     bli_cntx_set_ukr(SHIFT_KER, &TBLIS_REF_KERNEL_FPA(shift), cntx);
     bli_cntx_set_ukr(TRANS_KER, &TBLIS_REF_KERNEL_FPA(trans), cntx);
+    bli_cntx_set_ukr(ZIP_KER, &TBLIS_REF_KERNEL_FPA(zip), cntx);
 
     blksz_t mrt;
     bli_blksz_init_easy(&mrt, BLIS_MRT_s, BLIS_MRT_d, BLIS_MRT_c, BLIS_MRT_z);
@@ -106,4 +106,154 @@ void TBLIS_REF_KERNEL(reduce)
 
 TBLIS_INIT_REF_KERNEL(reduce)
 
+/*
+ * The body of reduce_multi, with the statistics which need the real parts
+ * (SUM, MAX, MIN), the absolute values (SUM_ABS, MAX_ABS, MIN_ABS) and the
+ * squared norms (NORM_2) each computed only if requested.
+ */
+template <bool Real, bool Abs, bool Norm2, typename T>
+static void reduce_multi_chunks(unsigned ops, len_type n,
+                                const T* TBLIS_RESTRICT A, stride_type inc_A,
+                                T* TBLIS_RESTRICT value, len_type* idx)
+{
+    typedef real_type_t<T> R;
+    typedef std::numeric_limits<R> limits;
+
+    constexpr len_type NC = 256;
+
+    auto want = [&](reduce_t op) { return (ops >> op) & 1; };
+
+    /*
+     * Each chunk is reduced to its sums and extreme values with vectorizable
+     * loops. The position of an extreme value is only searched for (while
+     * the chunk is still in cache) if the chunk improves on it.
+     */
+    for (len_type i0 = 0;i0 < n;i0 += NC)
+    {
+        auto nc = std::min(n-i0, NC);
+        auto A0 = A + i0*inc_A;
+
+        R sum_re = R(), sum_im = R(), sum_abs = R(), sum_norm2 = R();
+        R max_re = limits::lowest(), min_re = limits::max();
+        R max_abs = R(), min_abs = limits::max();
+
+        auto chunk = [&](stride_type inc)
+        {
+            #pragma omp simd reduction(+:sum_re,sum_im,sum_abs,sum_norm2) \
+                             reduction(max:max_re,max_abs) reduction(min:min_re,min_abs)
+            for (len_type i = 0;i < nc;i++)
+            {
+                auto a = A0[i*inc];
+
+                if constexpr (Real)
+                {
+                    auto re = std::real(a);
+                    sum_re += re;
+                    sum_im += std::imag(a);
+                    max_re = std::max(max_re, re);
+                    min_re = std::min(min_re, re);
+                }
+
+                if constexpr (Abs)
+                {
+                    auto ab = std::abs(a);
+                    sum_abs += ab;
+                    max_abs = std::max(max_abs, ab);
+                    min_abs = std::min(min_abs, ab);
+                }
+
+                if constexpr (Norm2)
+                    sum_norm2 += norm2(a);
+            }
+        };
+
+        if (inc_A == 1) chunk(1);
+        else chunk(inc_A);
+
+        if constexpr (Real)
+        {
+            if constexpr (is_complex_v<T>)
+                value[REDUCE_SUM] += T(sum_re, sum_im);
+            else
+                value[REDUCE_SUM] += sum_re;
+        }
+
+        if constexpr (Abs)
+            value[REDUCE_SUM_ABS] += sum_abs;
+
+        if constexpr (Norm2)
+            value[REDUCE_NORM_2] += sum_norm2;
+
+        auto find = [&](reduce_t op, auto key, R target, bool take_abs)
+        {
+            for (len_type i = 0;i < nc;i++)
+            {
+                if (key(A0[i*inc_A]) == target)
+                {
+                    value[op] = take_abs ? T(target) : A0[i*inc_A];
+                    idx[op] = (i0+i)*inc_A;
+                    return;
+                }
+            }
+        };
+
+        auto real_part = [](T a) { return R(std::real(a)); };
+        auto abs_value = [](T a) { return R(std::abs(a)); };
+
+        if constexpr (Real)
+        {
+            if (want(REDUCE_MAX) && max_re > std::real(value[REDUCE_MAX]))
+                find(REDUCE_MAX, real_part, max_re, false);
+
+            if (want(REDUCE_MIN) && min_re < std::real(value[REDUCE_MIN]))
+                find(REDUCE_MIN, real_part, min_re, false);
+        }
+
+        if constexpr (Abs)
+        {
+            if (want(REDUCE_MAX_ABS) && max_abs > std::real(value[REDUCE_MAX_ABS]))
+                find(REDUCE_MAX_ABS, abs_value, max_abs, true);
+
+            if (want(REDUCE_MIN_ABS) && min_abs < std::real(value[REDUCE_MIN_ABS]))
+                find(REDUCE_MIN_ABS, abs_value, min_abs, true);
+        }
+    }
+}
+
+template <typename T>
+void TBLIS_REF_KERNEL(reduce_multi)
+    (
+            unsigned  ops,
+            len_type  n,
+      const void*     A_, stride_type inc_A,
+            void*     value_,
+            len_type* idx
+    )
+{
+    typedef void (*chunks_t)(unsigned, len_type, const T*, stride_type, T*, len_type*);
+
+    static constexpr chunks_t chunks[] =
+    {
+        reduce_multi_chunks<false,false,false,T>,
+        reduce_multi_chunks<false,false, true,T>,
+        reduce_multi_chunks<false, true,false,T>,
+        reduce_multi_chunks<false, true, true,T>,
+        reduce_multi_chunks< true,false,false,T>,
+        reduce_multi_chunks< true,false, true,T>,
+        reduce_multi_chunks< true, true,false,T>,
+        reduce_multi_chunks< true, true, true,T>,
+    };
+
+    auto want = [&](reduce_t op) { return (ops >> op) & 1; };
+
+    auto want_real = want(REDUCE_SUM) || want(REDUCE_MAX) || want(REDUCE_MIN);
+    auto want_abs = want(REDUCE_SUM_ABS) || want(REDUCE_MAX_ABS) || want(REDUCE_MIN_ABS);
+    auto want_norm2 = want(REDUCE_NORM_2);
+
+    chunks[4*want_real + 2*want_abs + want_norm2](ops, n, static_cast<const T*>(A_), inc_A,
+                                                  static_cast<T*>(value_), idx);
+}
+
+TBLIS_INIT_REF_KERNEL(reduce_multi)
+
 }
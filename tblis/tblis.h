@@ -1,15 +1,23 @@
 #ifndef _TBLIS_HPP_
 #define _TBLIS_HPP_
 
+#include "tblis/frame/base/async.h"
 #include "tblis/frame/base/basic_types.h"
+#include "tblis/frame/base/stats.h"
 #include "tblis/frame/base/thread.h"
 
 #include "tblis/frame/1t/add.h"
 #include "tblis/frame/1t/dot.h"
+#include "tblis/frame/1t/map.h"
+#include "tblis/frame/1t/permute.h"
 #include "tblis/frame/1t/reduce.h"
 #include "tblis/frame/1t/scale.h"
 #include "tblis/frame/1t/set.h"
 
+#include "tblis/frame/3t/antisym.h"
+#include "tblis/frame/3t/block_sparse.h"
+#include "tblis/frame/3t/csf.h"
+#include "tblis/frame/3t/einsum.h"
 #include "tblis/frame/3t/mult.h"
 
 #endif
@@ -46,6 +46,30 @@ REPLICATED_TEMPLATED_TEST_CASE(dot, R, T, all_types)
     check("ZERO", calc_val, neps);
 }
 
+REPLICATED_TEMPLATED_TEST_CASE(dot_compensated, R, T, all_types)
+{
+    typedef real_type_t<T> U;
+
+    /*
+     * As for reduce_compensated, with the terms formed as products.
+     */
+    len_type n = random_number(100000, 200000);
+    U tiny = numeric_limits<U>::epsilon()/4;
+
+    marray<T> A({n}), B({n});
+    A = T(tiny);
+    A.data()[0] = T(1);
+    B = T(1);
+    label_vector idx_A = {'a'};
+
+    T ref_val = T(1) + T(U(n-1)*tiny);
+
+    compensated_sum_guard compensated(true);
+    T calc_val = dot<T>(A, idx_A, B, idx_A);
+
+    check("COMPENSATED", ref_val, calc_val, 1);
+}
+
 REPLICATED_TEMPLATED_TEST_CASE(dpd_dot, R, T, all_types)
 {
     dpd_marray<T> A, B;
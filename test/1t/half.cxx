@@ -0,0 +1,79 @@
+#include "../test.hpp"
+
+typedef types<bfloat16, float16> half_types;
+
+/*
+ * The ratio of the rounding error of H to that of float.
+ */
+template <typename H>
+constexpr float half_ulps = std::is_same_v<H,bfloat16> ? 1 << 16 : 1 << 13;
+
+/*
+ * Rounds A to H, storing the rounded values in both A and A_h.
+ */
+template <typename H>
+void round_to_half(marray<float>& A, marray<H>& A_h)
+{
+    A_h.reset(A.lengths());
+    for (auto i : range(prod(A.lengths())))
+        A.data()[i] = A_h.data()[i] = H(A.data()[i]);
+}
+
+template <typename H>
+float half_error(const marray<float>& A, const marray<H>& A_h)
+{
+    marray<float> E(A);
+    for (auto i : range(prod(A.lengths())))
+        E.data()[i] -= float(A_h.data()[i]);
+    return reduce<float>(REDUCE_NORM_2, E);
+}
+
+REPLICATED_TEMPLATED_TEST_CASE(half, R, H, half_types)
+{
+    marray<float> A, B;
+    marray<H> A_h, B_h;
+
+    random_tensor(100, A);
+    label_vector idx_A = range<label_type>('a', static_cast<label_type>('a'+A.dimension()));
+
+    B.reset(A);
+    randomize_tensor(B);
+
+    round_to_half(A, A_h);
+    round_to_half(B, B_h);
+
+    TENSOR_INFO(A);
+
+    auto neps = prod(A.lengths());
+
+    float scale(10.0*random_unit<float>());
+
+    /*
+     * The values are exact in float, so the results only differ by the
+     * rounding of the output to half precision.
+     */
+    add(scale, A, idx_A, scale, B, idx_A);
+    add(scale, A_h, idx_A, scale, B_h, idx_A);
+    check("ADD", half_error(B, B_h), scale*half_ulps<H>*neps);
+
+    /*
+     * Float and half precision operands may be mixed.
+     */
+    round_to_half(B, B_h);
+    add(scale, A, idx_A, scale, B, idx_A);
+    add(scale, A, idx_A, scale, B_h, idx_A);
+    check("ADD MIXED", half_error(B, B_h), scale*half_ulps<H>*neps);
+
+    round_to_half(B, B_h);
+    tblis::scale(scale, B, idx_A);
+    tblis::scale(scale, B_h, idx_A);
+    check("SCALE", half_error(B, B_h), scale*half_ulps<H>*neps);
+
+    float ref_val = reduce<float>(REDUCE_SUM, A, idx_A);
+    float calc_val = reduce<float>(REDUCE_SUM, A_h, idx_A);
+    check("REDUCE_SUM", ref_val, calc_val, neps);
+
+    auto ref_max = reduce<float>(REDUCE_MAX_ABS, A, idx_A);
+    auto calc_max = reduce<float>(REDUCE_MAX_ABS, A_h, idx_A);
+    check("REDUCE_MAX_ABS", ref_max.idx, calc_max.idx, ref_max.value, calc_max.value, neps);
+}
@@ -0,0 +1,193 @@
+#include "../test.hpp"
+
+/*
+ * Creates a random elementwise operation, where each tensor has a storage
+ * size of N or fewer elements. All possibilities are sampled uniformly.
+ */
+template <typename T>
+void random_map(stride_type N, T&& A, label_vector& idx_A,
+                               T&& B, label_vector& idx_B)
+{
+    auto ndim_A = random_number(1,8);
+
+    random_tensors(N,
+                   0, 0,
+                   ndim_A,
+                   A, idx_A,
+                   B, idx_B);
+}
+
+REPLICATED_TEMPLATED_TEST_CASE(map, R, T, all_types)
+{
+    marray<T> A, B, C, D;
+    label_vector idx_A, idx_B;
+
+    random_map(1000, A, idx_A, B, idx_B);
+
+    TENSOR_INFO(A);
+    TENSOR_INFO(B);
+
+    auto neps = prod(A.lengths());
+
+    C.reset(B);
+    D.reset(B);
+    tblis::map(MAP_SQUARE, A, idx_A, C, idx_B);
+    tblis::map([](auto a) { return a*a; }, A, idx_A, D, idx_B);
+    add(T(-1), D, T(1), C);
+    T error = reduce<T>(REDUCE_NORM_2, C);
+    check("FUNCTOR", error, neps);
+
+    C.reset(B);
+    D.reset(B);
+    tblis::map(MAP_SQUARE, A, idx_A, C, idx_B);
+    tblis::zip(ZIP_MUL, A, idx_A, A, idx_A, D, idx_B);
+    add(T(-1), D, T(1), C);
+    error = reduce<T>(REDUCE_NORM_2, C);
+    check("SQUARE", error, neps);
+
+    C.reset(B);
+    D.reset(B);
+    tblis::map(MAP_RECIPROCAL, A, idx_A, C, idx_B);
+    tblis::zip(ZIP_MUL, A, idx_A, C, idx_B, D, idx_B);
+    C = T(1);
+    add(T(-1), C, T(1), D);
+    error = reduce<T>(REDUCE_NORM_2, D);
+    check("RECIPROCAL", error, neps);
+
+    C.reset(B);
+    tblis::zip(ZIP_DIV, A, idx_A, A, idx_A, C, idx_B);
+    D = T(1);
+    add(T(-1), D, T(1), C);
+    error = reduce<T>(REDUCE_NORM_2, C);
+    check("DIV", error, neps);
+
+    C.reset(B);
+    D.reset(B);
+    tblis::map(MAP_ABS, A, idx_A, C, idx_B);
+    tblis::map(MAP_LOG, C, idx_B, D, idx_B);
+    tblis::map(MAP_EXP, D, idx_B, B, idx_B);
+    add(T(-1), C, T(1), B);
+    error = reduce<T>(REDUCE_NORM_2, B);
+    check("LOG", error, neps);
+
+    D.reset(C);
+    tblis::map(MAP_SQRT, C, idx_B, D, idx_B);
+    tblis::map(MAP_SQUARE, D, idx_B, B, idx_B);
+    add(T(-1), C, T(1), B);
+    error = reduce<T>(REDUCE_NORM_2, B);
+    check("SQRT", error, neps);
+
+    randomize_tensor(B);
+    C.reset(B);
+    tblis::zip(ZIP_MAX, A, idx_A, B, idx_B, C, idx_B);
+    tblis::zip(ZIP_MIN, T(1), A, idx_A, T(1), B, idx_B, T(1), C, idx_B);
+    add(T(-1), A, idx_A, T(1), C, idx_B);
+    add(T(-1), B, T(1), C);
+    error = reduce<T>(REDUCE_NORM_2, C);
+    check("MAX+MIN", error, neps);
+}
+
+REPLICATED_TEMPLATED_TEST_CASE(dpd_map, R, T, all_types)
+{
+    dpd_marray<T> A, B, C;
+
+    random_tensor(100, A);
+    label_vector idx_A = range<label_type>('a', static_cast<label_type>('a'+A.dimension()));
+
+    DPD_TENSOR_INFO(A);
+
+    auto NA = dpd_marray<T>::size(A.irrep(), A.lengths());
+
+    B.reset(A);
+    tblis::map<T>(MAP_SQUARE, T(1), A, idx_A, T(0), B, idx_A);
+    C.reset(A);
+    tblis::zip<T>([](auto a, auto b) { return a*b; },
+                  T(1), A, idx_A, T(1), A, idx_A, T(0), C, idx_A);
+    add<T>(T(-1), B, idx_A, T(1), C, idx_A);
+    T error = reduce<T>(REDUCE_NORM_2, C, idx_A);
+    check("SQUARE", error, NA);
+
+    C.reset(A);
+    tblis::zip<T>(ZIP_DIV, T(1), A, idx_A, T(1), A, idx_A, T(0), C, idx_A);
+    tblis::shift<T>(T(-1), T(1), C, idx_A);
+    error = reduce<T>(REDUCE_NORM_2, C, idx_A);
+    check("DIV", error, NA);
+}
+
+REPLICATED_TEMPLATED_TEST_CASE(indexed_map, R, T, all_types)
+{
+    indexed_marray<T> A, B, C;
+
+    random_tensor(100, A);
+    label_vector idx_A = range<label_type>('a', static_cast<label_type>('a'+A.dimension()));
+
+    INDEXED_TENSOR_INFO(A);
+
+    auto NA = prod(A.lengths());
+
+    for (auto& f : A.factors()) f = T(1);
+
+    B.reset(A);
+    tblis::map<T>(MAP_SQUARE, T(1), A, idx_A, T(0), B, idx_A);
+    C.reset(A);
+    tblis::zip<T>([](auto a, auto b) { return a*b; },
+                  T(1), A, idx_A, T(1), A, idx_A, T(0), C, idx_A);
+    add<T>(T(-1), B, idx_A, T(1), C, idx_A);
+    T error = reduce<T>(REDUCE_NORM_2, C, idx_A);
+    check("SQUARE", error, NA);
+
+    C.reset(A);
+    tblis::zip<T>(ZIP_DIV, T(1), A, idx_A, T(1), A, idx_A, T(0), C, idx_A);
+    tblis::shift<T>(T(-1), T(1), C, idx_A);
+    error = reduce<T>(REDUCE_NORM_2, C, idx_A);
+    check("DIV", error, NA);
+
+    /*
+     * The output factors are taken into account: with a factor of 2 the
+     * stored quotients are 1/2.
+     */
+    C.reset(A);
+    for (auto& f : C.factors()) f = T(2);
+    tblis::zip<T>(ZIP_DIV, T(1), A, idx_A, T(1), A, idx_A, T(0), C, idx_A);
+    for (auto& f : C.factors()) f = T(1);
+    tblis::shift<T>(T(-0.5), T(1), C, idx_A);
+    error = reduce<T>(REDUCE_NORM_2, C, idx_A);
+    check("FACTOR", error, NA);
+}
+
+REPLICATED_TEMPLATED_TEST_CASE(indexed_dpd_map, R, T, all_types)
+{
+    indexed_dpd_marray<T> A, B, C;
+
+    random_tensor(100, A);
+    label_vector idx_A = range<label_type>('a', static_cast<label_type>('a'+A.dimension()));
+
+    INDEXED_DPD_TENSOR_INFO(A);
+
+    auto NA = dpd_marray<T>::size(A.irrep(), A.lengths());
+
+    for (auto& f : A.factors()) f = T(1);
+
+    B.reset(A);
+    tblis::map<T>(MAP_SQUARE, T(1), A, idx_A, T(0), B, idx_A);
+    C.reset(A);
+    tblis::zip<T>([](auto a, auto b) { return a*b; },
+                  T(1), A, idx_A, T(1), A, idx_A, T(0), C, idx_A);
+    add<T>(T(-1), B, idx_A, T(1), C, idx_A);
+    T error = reduce<T>(REDUCE_NORM_2, C, idx_A);
+    check("SQUARE", error, NA);
+
+    C.reset(A);
+    tblis::zip<T>(ZIP_DIV, T(1), A, idx_A, T(1), A, idx_A, T(0), C, idx_A);
+    tblis::shift<T>(T(-1), T(1), C, idx_A);
+    error = reduce<T>(REDUCE_NORM_2, C, idx_A);
+    check("DIV", error, NA);
+
+    C.reset(A);
+    for (auto& f : C.factors()) f = T(2);
+    tblis::zip<T>(ZIP_DIV, T(1), A, idx_A, T(1), A, idx_A, T(0), C, idx_A);
+    for (auto& f : C.factors()) f = T(1);
+    tblis::shift<T>(T(-0.5), T(1), C, idx_A);
+    error = reduce<T>(REDUCE_NORM_2, C, idx_A);
+    check("FACTOR", error, NA);
+}
@@ -11,6 +11,11 @@ static std::map<reduce_t, string> ops =
  {REDUCE_NORM_2, "REDUCE_NORM_2"}
 };
 
+static const unsigned all_ops = reduce_ops(REDUCE_SUM, REDUCE_SUM_ABS,
+                                           REDUCE_MAX, REDUCE_MAX_ABS,
+                                           REDUCE_MIN, REDUCE_MIN_ABS,
+                                           REDUCE_NORM_2);
+
 template <typename T>
 void reduce_ref(reduce_t op, len_type n, const T* A, T& value, len_type& idx)
 {
@@ -85,11 +90,43 @@ REPLICATED_TEMPLATED_TEST_CASE(reduce, R, T, all_types)
         check(op.second, ref_idx, blas_idx, ref_val, blas_val, NA);
     }
 
+    auto multi = reduce_multi<T>(all_ops, A, idx_A);
+
+    for (auto op : ops)
+    {
+        reduce(op.first, A, idx_A, ref_val, ref_idx);
+        check("MULTI " + op.second, ref_idx, multi.idx[op.first], ref_val, multi[op.first], NA);
+    }
+
     A = T(1);
     reduce(REDUCE_SUM, A, idx_A, ref_val, ref_idx);
     check("COUNT", ref_val, NA, NA);
 }
 
+REPLICATED_TEMPLATED_TEST_CASE(reduce_compensated, R, T, all_types)
+{
+    typedef real_type_t<T> U;
+
+    /*
+     * One followed by many terms of a quarter of an ulp of one, which a
+     * naive sum mostly drops. The exact sum rounds only once.
+     */
+    len_type n = random_number(100000, 200000);
+    U tiny = numeric_limits<U>::epsilon()/4;
+
+    marray<T> A({n});
+    A = T(tiny);
+    A.data()[0] = T(1);
+    label_vector idx_A = {'a'};
+
+    T ref_val = T(1) + T(U(n-1)*tiny);
+
+    compensated_sum_guard compensated(true);
+    T calc_val = reduce<T>(REDUCE_SUM, A, idx_A);
+
+    check("COMPENSATED", ref_val, calc_val, 1);
+}
+
 REPLICATED_TEMPLATED_TEST_CASE(dpd_reduce, R, T, all_types)
 {
     dpd_marray<T> A;
@@ -114,6 +151,14 @@ REPLICATED_TEMPLATED_TEST_CASE(dpd_reduce, R, T, all_types)
 
         check(op.second, ref_idx, calc_idx, ref_val, calc_val, NA);
     }
+
+    auto multi = reduce_multi<T>(all_ops, A, idx_A);
+
+    for (auto op : ops)
+    {
+        reduce<T>(op.first, A, idx_A, ref_val, ref_idx);
+        check("MULTI " + op.second, ref_idx, multi.idx[op.first], ref_val, multi[op.first], NA);
+    }
 }
 
 REPLICATED_TEMPLATED_TEST_CASE(indexed_reduce, R, T, all_types)
@@ -140,6 +185,14 @@ REPLICATED_TEMPLATED_TEST_CASE(indexed_reduce, R, T, all_types)
 
         check(op.second, ref_idx, calc_idx, ref_val, calc_val, NA);
     }
+
+    auto multi = reduce_multi<T>(all_ops, A, idx_A);
+
+    for (auto op : ops)
+    {
+        reduce<T>(op.first, A, idx_A, ref_val, ref_idx);
+        check("MULTI " + op.second, ref_idx, multi.idx[op.first], ref_val, multi[op.first], NA);
+    }
 }
 
 REPLICATED_TEMPLATED_TEST_CASE(indexed_dpd_reduce, R, T, all_types)
@@ -166,4 +219,12 @@ REPLICATED_TEMPLATED_TEST_CASE(indexed_dpd_reduce, R, T, all_types)
 
         check(op.second, ref_idx, calc_idx, ref_val, calc_val, NA);
     }
+
+    auto multi = reduce_multi<T>(all_ops, A, idx_A);
+
+    for (auto op : ops)
+    {
+        reduce<T>(op.first, A, idx_A, ref_val, ref_idx);
+        check("MULTI " + op.second, ref_idx, multi.idx[op.first], ref_val, multi[op.first], NA);
+    }
 }
@@ -49,7 +49,7 @@ REPLICATED_TEMPLATED_TEST_CASE(trace, R, T, all_types)
 
 REPLICATED_TEMPLATED_TEST_CASE(dpd_trace, R, T, all_types)
 {
-    dpd_marray<T> A, B, C, D;
+    dpd_marray<T> A, B, C, D, E;
     label_vector idx_A, idx_B;
 
     random_trace(1000, A, idx_A, B, idx_B);
@@ -69,8 +69,21 @@ REPLICATED_TEMPLATED_TEST_CASE(dpd_trace, R, T, all_types)
     D.reset(B);
     add<T>(scale, A, idx_A, scale, D, idx_B);
 
+    dpd_impl = dpd_impl_t::FULL;
+    auto limit = dpd_full_memory_limit;
+    dpd_full_memory_limit = 64*sizeof(T);
+    E.reset(B);
+    add<T>(scale, A, idx_A, scale, E, idx_B);
+    dpd_full_memory_limit = limit;
+    dpd_impl = dpd_impl_t::BLOCKED;
+
+    add<T>(T(-1), C, idx_B, T(1), E, idx_B);
+    T error = reduce<T>(REDUCE_NORM_2, E, idx_B);
+
+    check("TILED", error, scale*neps);
+
     add<T>(T(-1), C, idx_B, T(1), D, idx_B);
-    T error = reduce<T>(REDUCE_NORM_2, D, idx_B);
+    error = reduce<T>(REDUCE_NORM_2, D, idx_B);
 
     check("BLOCKED", error, scale*neps);
 }
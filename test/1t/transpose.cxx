@@ -1,5 +1,7 @@
 #include "../test.hpp"
 
+#include "tblis/frame/base/streaming.hpp"
+
 /*
  * Creates a random tensor transpose operation, where each tensor
  * has a storage size of N or fewer elements. All possibilities are sampled
@@ -163,3 +165,145 @@ REPLICATED_TEMPLATED_TEST_CASE(indexed_dpd_transpose, R, T, all_types)
 
     check("BLOCKED", error, scale*neps);
 }
+
+REPLICATED_TEMPLATED_TEST_CASE(add_n, R, T, all_types)
+{
+    marray<T> A, B, C, D;
+    label_vector idx_A, idx_B;
+
+    random_transpose(1000, A, idx_A, B, idx_B);
+
+    TENSOR_INFO(A);
+    TENSOR_INFO(B);
+
+    /*
+     * W is missing the first index of B, so it is replicated rather than
+     * fused.
+     */
+    marray<T> X(A.lengths()), W(len_vector(B.lengths().begin()+1, B.lengths().end()));
+    label_vector idx_W(idx_B.begin()+1, idx_B.end());
+    randomize_tensor(X);
+    randomize_tensor(W);
+    randomize_tensor(B);
+
+    auto neps = prod(B.lengths());
+
+    T a(10.0*random_unit<T>());
+    T b(10.0*random_unit<T>());
+    T c(10.0*random_unit<T>());
+    T d(10.0*random_unit<T>());
+
+    C.reset(B);
+    add(a, A, idx_A, d, C, idx_B);
+    add(b, X, idx_A, T(1), C, idx_B);
+    add(c, B, idx_B, T(1), C, idx_B);
+
+    D.reset(B);
+    add({{a, A, idx_A}, {b, X, idx_A}, {c, B, idx_B}}, d, D, idx_B);
+
+    add(T(-1), C, idx_B, T(1), D, idx_B);
+    T error = reduce<T>(REDUCE_NORM_2, D, idx_B);
+    check("FUSED", error, std::abs(a+b+c+d)*neps);
+
+    C.reset(B);
+    add(a, A, idx_A, T(0), C, idx_B);
+    add(b, W, idx_W, T(1), C, idx_B);
+
+    D.reset(B);
+    add({{a, A, idx_A}, {b, W, idx_W}}, T(0), D, idx_B);
+
+    add(T(-1), C, idx_B, T(1), D, idx_B);
+    error = reduce<T>(REDUCE_NORM_2, D, idx_B);
+    check("UNFUSED", error, std::abs(a+b)*neps);
+}
+
+REPLICATED_TEMPLATED_TEST_CASE(streaming_transpose, R, T, all_types)
+{
+    marray<T> A, B, C;
+    label_vector idx_A, idx_B;
+
+    random_transpose(1000, A, idx_A, B, idx_B);
+
+    TENSOR_INFO(A);
+    TENSOR_INFO(B);
+
+    auto neps = prod(A.lengths());
+
+    T scale(10.0*random_unit<T>());
+    T value(random_unit<T>());
+
+    add(scale, A, idx_A, T(0), B, idx_B);
+    C.reset(B);
+
+    /*
+     * Force streaming stores for every write to B.
+     */
+    auto threshold = streaming_threshold;
+    streaming_threshold = 1;
+
+    randomize_tensor(B);
+    add(scale, A, idx_A, T(0), B, idx_B);
+
+    streaming_threshold = threshold;
+
+    add(T(-1), C, idx_B, T(1), B, idx_B);
+    T error = reduce<T>(REDUCE_NORM_2, B, idx_B);
+    check("STREAMING", error, scale*neps);
+
+    streaming_threshold = 1;
+    set(value, B, idx_B);
+    streaming_threshold = threshold;
+
+    shift(-value, B, idx_B);
+    error = reduce<T>(REDUCE_NORM_2, B, idx_B);
+    check("STREAMING SET", error, neps);
+}
+
+REPLICATED_TEMPLATED_TEST_CASE(permute_in_place, R, T, all_types)
+{
+    marray<T> A, B, C;
+    label_vector idx_A, idx_B;
+
+    random_transpose(1000, A, idx_A, B, idx_B);
+
+    /*
+     * Also permute a larger tensor whose unit-stride dimension moves, so
+     * that the tiled transpose is used.
+     */
+    auto tiled = random_number(0,1);
+    if (tiled)
+    {
+        A.reset({64, 3, 48});
+        B.reset({48, 64, 3});
+        idx_A = {'a','b','c'};
+        idx_B = {'c','a','b'};
+    }
+
+    randomize_tensor(A);
+
+    TENSOR_INFO(A);
+    TENSOR_INFO(B);
+
+    auto neps = prod(A.lengths());
+
+    T scale(10.0*random_unit<T>());
+
+    add(scale, A, idx_A, T(0), B, idx_B);
+
+    C.reset(A);
+    tblis_tensor C_(C.data(), C.dimension(), C.lengths().data(), C.strides().data());
+    C_.scalar = scale;
+    stride_vector stride_D(C.dimension());
+    tblis_tensor_permute(nullptr, nullptr, &C_, idx_A.data(), idx_B.data(), stride_D.data());
+
+    /*
+     * C now holds B, with the same storage order as A.
+     */
+    tblis_tensor B_(B.data(), B.dimension(), B.lengths().data(), B.strides().data());
+    tblis_tensor D_(C.data(), B.dimension(), B.lengths().data(), stride_D.data());
+    B_.scalar = T(-1);
+    tblis_tensor_add(nullptr, nullptr, &B_, idx_B.data(), &D_, idx_B.data());
+
+    T error = reduce<T>(REDUCE_NORM_2, C);
+    check(tiled ? "TILED" : "PERMUTE", error, scale*neps);
+}
@@ -0,0 +1,153 @@
+#include "../test.hpp"
+
+/*
+ * Antisymmetrize A over each pair of labels in pairs.
+ */
+template <typename T>
+static void antisymmetrize(marray<T>& A, const label_vector& idx_A,
+                           const std::vector<std::pair<label_type,label_type>>& pairs)
+{
+    for (auto& p : pairs)
+    {
+        marray<T> B(A);
+
+        auto idx_B = idx_A;
+        for (auto& i : idx_B)
+        {
+            if (i == p.first) i = p.second;
+            else if (i == p.second) i = p.first;
+        }
+
+        add(T(-1), B, idx_B, T(1), A, idx_A);
+    }
+}
+
+static len_type binomial2(len_type n)
+{
+    return n*(n-1)/2;
+}
+
+REPLICATED_TEMPLATED_TEST_CASE(antisym, R, T, all_types)
+{
+    auto n = random_number(2,5);
+    auto np = binomial2(n);
+
+    marray<T> A({n, n, n, n});
+    marray<T> B({n, n, n, n});
+    marray<T> E;
+
+    randomize_tensor(A);
+    randomize_tensor(B);
+
+    label_vector idx_A{'i','j','a','b'};
+    label_vector idx_B{'a','b','k','l'};
+    label_vector idx_C{'i','j','k','l'};
+
+    antisymmetrize(A, idx_A, {{'i','j'}, {'a','b'}});
+    antisymmetrize(B, idx_B, {{'a','b'}, {'k','l'}});
+
+    TENSOR_INFO(A);
+    TENSOR_INFO(B);
+
+    marray<T> Ap({np, np});
+    marray<T> Bp({np, np});
+
+    antisym_tensor A_(Ap, {2, 2}, {n, n});
+    antisym_tensor B_(Bp, {2, 2}, {n, n});
+
+    pack_antisym(A, idx_A, A_, idx_A);
+    pack_antisym(B, idx_B, B_, idx_B);
+
+    E.reset(A);
+    unpack_antisym(A_, idx_A, E, idx_A);
+
+    add(T(-1), A, T(1), E);
+    T error = reduce<T>(REDUCE_NORM_2, E);
+
+    check("PACK", error, prod(A.lengths()));
+
+    T scale(10.0*random_unit<T>());
+
+    /*
+     * Both groups of A and B are kept intact, and the contracted group is
+     * summed in packed form.
+     */
+    marray<T> Cp({np, np});
+    marray<T> Dp({np, np});
+    randomize_tensor(Cp);
+    Dp.reset(Cp);
+
+    antisym_tensor C_(Cp, {2, 2}, {n, n});
+    antisym_tensor D_(Dp, {2, 2}, {n, n});
+
+    marray<T> C({n, n, n, n});
+    mult(T(1), A, idx_A, B, idx_B, T(0), C, idx_C);
+    pack_antisym(C, idx_C, D_, idx_C);
+    add(scale, Cp, scale, Dp);
+
+    mult_antisym(scale, A_, idx_A, B_, idx_B, scale, C_, idx_C);
+
+    add(T(-1), Dp, T(1), Cp);
+    error = reduce<T>(REDUCE_NORM_2, Cp);
+
+    auto neps = (n*n+1)*np*np;
+    check("INTACT", error, scale*neps);
+
+    /*
+     * Contracting a single index of each group breaks the groups of A and
+     * B, whose unique elements are then gathered by block offsets, as are
+     * those of the new group of C.
+     */
+    auto idx_Bs = label_vector{'a','c','k','l'};
+    auto idx_D = label_vector{'i','j','b','c','k','l'};
+
+    marray<T> D({n, n, n, n, n, n});
+    mult(T(1), A, idx_A, B, idx_Bs, T(0), D, idx_D);
+
+    marray<T> Ep({np, np, np});
+    marray<T> Fp({np, np, np});
+    randomize_tensor(Ep);
+    Fp.reset(Ep);
+
+    antisym_tensor E_(Ep, {2, 2, 2}, {n, n, n});
+    antisym_tensor F_(Fp, {2, 2, 2}, {n, n, n});
+
+    pack_antisym(D, idx_D, F_, idx_D);
+    add(scale, Ep, scale, Fp);
+
+    mult_antisym(scale, A_, idx_A, B_, idx_Bs, scale, E_, idx_D);
+
+    add(T(-1), Fp, T(1), Ep);
+    error = reduce<T>(REDUCE_NORM_2, Ep);
+
+    neps = (n+1)*np*np*np;
+    check("BROKEN", error, scale*neps);
+
+    /*
+     * Pairing indices of A and B in the groups of C breaks every group but
+     * the contracted one, and some indices are looped over instead.
+     */
+    auto idx_Cs = label_vector{'i','k','j','l'};
+
+    marray<T> G({n, n, n, n});
+    mult(T(1), A, idx_A, B, idx_B, T(0), G, idx_Cs);
+
+    marray<T> Gp({np, np});
+    marray<T> Hp({np, np});
+    randomize_tensor(Gp);
+    Hp.reset(Gp);
+
+    antisym_tensor G_(Gp, {2, 2}, {n, n});
+    antisym_tensor H_(Hp, {2, 2}, {n, n});
+
+    pack_antisym(G, idx_Cs, H_, idx_Cs);
+    add(scale, Gp, scale, Hp);
+
+    mult_antisym(scale, A_, idx_A, B_, idx_B, scale, G_, idx_Cs);
+
+    add(T(-1), Hp, T(1), Gp);
+    error = reduce<T>(REDUCE_NORM_2, Gp);
+
+    neps = (n*n+1)*np*np;
+    check("SPLIT", error, scale*neps);
+}
@@ -0,0 +1,141 @@
+#include "../test.hpp"
+
+static len_vector random_partition()
+{
+    len_vector block_len(random_number(1,3));
+    for (auto& len : block_len) len = random_number(1,4);
+    return block_len;
+}
+
+/*
+ * A random subset of the blocks of a tensor with the given partitions.
+ */
+static std::vector<len_vector> random_blocks(const std::vector<len_vector>& block_len)
+{
+    std::vector<len_vector> blocks;
+    len_vector coord(block_len.size());
+
+    while (true)
+    {
+        if (random_number(0,1)) blocks.push_back(coord);
+
+        auto i = 0;
+        for (;i < block_len.size();i++)
+        {
+            if (++coord[i] < block_len[i].size()) break;
+            coord[i] = 0;
+        }
+        if (i == block_len.size()) break;
+    }
+
+    return blocks;
+}
+
+template <typename T>
+static void randomize_blocks(block_sparse_tensor& A)
+{
+    auto data = reinterpret_cast<T*>(A.data_buf.data());
+    for (auto i : range(A.data_buf.size()/sizeof(T)))
+        data[i] = random_unit<T>();
+}
+
+/*
+ * Copy between the stored blocks of A and the corresponding slices of the
+ * dense tensor D.
+ */
+template <typename T>
+static void copy_blocks(block_sparse_tensor& A, marray<T>& D, bool to_dense)
+{
+    label_vector idx;
+    for (auto i : range(A.ndim)) idx.push_back('a'+i);
+
+    for (auto b : range(A.nnz_block))
+    {
+        stride_type off = 0;
+        for (auto i : range(A.ndim))
+        for (auto j : range(A.block_idx[b*A.ndim+i]))
+            off += A.block_len[i][j]*D.stride(i);
+
+        auto S = A.block(b);
+        tblis_tensor V(D.data()+off, A.ndim, S.len, D.strides().data());
+
+        if (to_dense)
+        {
+            V.scalar = T(0);
+            tblis_tensor_add(nullptr, nullptr, &S, idx.data(), &V, idx.data());
+        }
+        else
+        {
+            S.scalar = T(0);
+            tblis_tensor_add(nullptr, nullptr, &V, idx.data(), &S, idx.data());
+        }
+    }
+}
+
+template <typename T>
+static marray<T> to_dense(block_sparse_tensor& A)
+{
+    len_vector len;
+    for (auto i : range(A.ndim))
+    {
+        len_type n = 0;
+        for (auto l : A.block_len_buf[i]) n += l;
+        len.push_back(n);
+    }
+
+    marray<T> D(len);
+    copy_blocks(A, D, true);
+    return D;
+}
+
+REPLICATED_TEMPLATED_TEST_CASE(block_sparse, R, T, all_types)
+{
+    auto part_i = random_partition();
+    auto part_j = random_partition();
+    auto part_k = random_partition();
+    auto part_b = random_partition();
+
+    std::vector<len_vector> len_A{part_i, part_k, part_b};
+    std::vector<len_vector> len_B{part_k, part_j, part_b};
+    std::vector<len_vector> len_C{part_i, part_j, part_b};
+
+    block_sparse_tensor A(type_tag<T>::value, len_A, random_blocks(len_A));
+    block_sparse_tensor B(type_tag<T>::value, len_B, random_blocks(len_B));
+    block_sparse_tensor C(type_tag<T>::value, len_C, random_blocks(len_C));
+
+    randomize_blocks<T>(A);
+    randomize_blocks<T>(B);
+    randomize_blocks<T>(C);
+
+    label_vector idx_A{'i','k','b'};
+    label_vector idx_B{'k','j','b'};
+    label_vector idx_C{'i','j','b'};
+
+    INFO_OR_PRINT("nnz_block A = " << A.nnz_block);
+    INFO_OR_PRINT("nnz_block B = " << B.nnz_block);
+    INFO_OR_PRINT("nnz_block C = " << C.nnz_block);
+
+    auto A_full = to_dense<T>(A);
+    auto B_full = to_dense<T>(B);
+    auto C_full = to_dense<T>(C);
+
+    T scale(10.0*random_unit<T>());
+
+    mult(scale, A_full, idx_A, B_full, idx_B, scale, C_full, idx_C);
+    mult_block_sparse(scale, A, idx_A, B, idx_B, scale, C, idx_C);
+
+    /*
+     * Only the stored blocks of C are computed, so compare against the
+     * same blocks of the dense result.
+     */
+    auto E = to_dense<T>(C);
+    copy_blocks(C, C_full, false);
+    auto F = to_dense<T>(C);
+
+    add(T(-1), E, T(1), F);
+
+    auto neps = (A_full.length(1)+1)*prod(F.lengths());
+    T error = reduce<T>(REDUCE_NORM_2, F);
+
+    check("BLOCK_SPARSE", error, scale*neps);
+}
@@ -0,0 +1,145 @@
+#include "../test.hpp"
+
+/*
+ * A random sparse tensor with about density*prod(len) non-zeros, both in CSF
+ * form and as the equivalent dense tensor.
+ */
+template <typename T>
+static csf_tensor random_csf(const len_vector& len, double density, marray<T>& D)
+{
+    D.reset(len);
+
+    std::vector<len_vector> coords;
+    std::vector<T> values;
+
+    len_vector coord(len.size());
+    for (auto n : range(stl_ext::prod(len)))
+    {
+        auto m = n;
+        for (auto i : range(len.size()))
+        {
+            coord[i] = m % len[i];
+            m /= len[i];
+        }
+
+        if (random_number(0.0, 1.0) >= density) continue;
+
+        T value = random_unit<T>();
+        coords.push_back(coord);
+        values.push_back(value);
+
+        stride_type off = 0;
+        for (auto i : range(len.size()))
+            off += coord[i]*D.stride(i);
+        D.data()[off] = value;
+    }
+
+    /*
+     * Shuffle the non-zeros so that they are not already in CSF order.
+     */
+    for (auto i : range(coords.size()))
+    {
+        auto j = random_number<size_t>(i, coords.size()-1);
+        swap(coords[i], coords[j]);
+        swap(values[i], values[j]);
+    }
+
+    return csf_tensor(len, coords, values);
+}
+
+REPLICATED_TEMPLATED_TEST_CASE(csf, R, T, all_types)
+{
+    auto n_i = random_number(1,8);
+    auto n_j = random_number(1,8);
+    auto n_k = random_number(1,8);
+    auto n_b = random_number(1,3);
+    auto n_r = random_number(1,8);
+
+    T scale(10.0*random_unit<T>());
+
+    /*
+     * Each case has a different mix of contracted, free, and batch indices
+     * at the levels of the sparse tensor.
+     */
+    std::vector<std::tuple<label_vector,label_vector,label_vector>> cases =
+    {
+        {{'i','j','k'}, {'k','r'}, {'i','j','r'}},
+        {{'i','j','k'}, {'j','k','r'}, {'i','r'}},
+        {{'k','i','j'}, {'k','r'}, {'r','j','i'}},
+        {{'k','j','i'}, {'j','k','r'}, {'i','r'}},
+        {{'i','b','k'}, {'k','r','b'}, {'r','i','b'}},
+        {{'j','k'}, {'j','k','r'}, {'r'}},
+        {{'i','k'}, {'k'}, {'i'}},
+    };
+
+    auto length = [&](label_type l) -> len_type
+    {
+        switch (l)
+        {
+            case 'i': return n_i;
+            case 'j': return n_j;
+            case 'k': return n_k;
+            case 'b': return n_b;
+            default:  return n_r;
+        }
+    };
+
+    for (auto& [idx_A, idx_B, idx_C] : cases)
+    {
+        len_vector len_A, len_B, len_C;
+        for (auto l : idx_A) len_A.push_back(length(l));
+        for (auto l : idx_B) len_B.push_back(length(l));
+        for (auto l : idx_C) len_C.push_back(length(l));
+
+        marray<T> A_full, B(len_B), C(len_C), D;
+        auto A = random_csf(len_A, 0.2, A_full);
+        randomize_tensor(B);
+        randomize_tensor(C);
+        D.reset(C);
+
+        INFO_OR_PRINT("idx_A = " << idx_A);
+        INFO_OR_PRINT("idx_B = " << idx_B);
+        INFO_OR_PRINT("idx_C = " << idx_C);
+        INFO_OR_PRINT("nnz   = " << A.num_nonzeros());
+
+        mult(scale, A_full, idx_A, B, idx_B, scale, D, idx_C);
+        mult(scale, A, idx_A, B, idx_B, scale, C, idx_C);
+
+        add(T(-1), D, T(1), C);
+        T error = reduce<T>(REDUCE_NORM_2, C);
+
+        auto neps = (prod(len_A)+1)*prod(len_C);
+        check("CSF", error, scale*neps);
+    }
+
+    /*
+     * With several threads, the top-level fibers of a contracted index all
+     * write the same part of C and must not be divided among the threads.
+     */
+    auto nt = tblis_get_num_threads();
+    tblis_set_num_threads(4);
+
+    {
+        label_vector idx_A{'k','i','j'}, idx_B{'k','r'}, idx_C{'r','j','i'};
+        len_vector len_A{16, n_i, n_j}, len_B{16, n_r}, len_C{n_r, n_j, n_i};
+
+        marray<T> A_full, B(len_B), C(len_C), D;
+        auto A = random_csf(len_A, 0.5, A_full);
+        randomize_tensor(B);
+        randomize_tensor(C);
+        D.reset(C);
+
+        INFO_OR_PRINT("nnz   = " << A.num_nonzeros());
+
+        mult(scale, A_full, idx_A, B, idx_B, scale, D, idx_C);
+        mult(scale, A, idx_A, B, idx_B, scale, C, idx_C);
+
+        add(T(-1), D, T(1), C);
+        T error = reduce<T>(REDUCE_NORM_2, C);
+
+        auto neps = (prod(len_A)+1)*prod(len_C);
+        check("CSF THREADED", error, scale*neps);
+    }
+
+    tblis_set_num_threads(nt);
+}
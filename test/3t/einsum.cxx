@@ -0,0 +1,104 @@
+#include "../test.hpp"
+
+REPLICATED_TEMPLATED_TEST_CASE(einsum, R, T, all_types)
+{
+    auto ni = random_number(1,10);
+    auto nj = random_number(1,10);
+    auto nk = random_number(1,10);
+    auto nl = random_number(1,10);
+    auto nb = random_number(1,4);
+    auto np = random_number(1,4);
+
+    marray<T> A({ni, nb, nj});
+    marray<T> B({nj, nk, nb});
+    marray<T> C({ni, nl, nb});
+    marray<T> D({nk, nl, np});
+    marray<T> AB({ni, nb, nk});
+    marray<T> Dp({nk, nl});
+    marray<T> E, F;
+
+    randomize_tensor(A);
+    randomize_tensor(B);
+    randomize_tensor(C);
+    randomize_tensor(D);
+
+    label_vector idx_A{'i','b','j'};
+    label_vector idx_B{'j','k','b'};
+    label_vector idx_C{'i','l','b'};
+    label_vector idx_D{'k','l','p'};
+    label_vector idx_AB{'i','b','k'};
+    label_vector idx_Dp{'k','l'};
+
+    TENSOR_INFO(A);
+    TENSOR_INFO(B);
+    TENSOR_INFO(C);
+    TENSOR_INFO(D);
+
+    auto neps = (nj*nk*np+1)*prod(C.lengths());
+
+    T scale(10.0*random_unit<T>());
+
+    mult(T(1), A, idx_A, B, idx_B, T(0), AB, idx_AB);
+    add(T(1), D, idx_D, T(0), Dp, idx_Dp);
+
+    E.reset(C);
+    mult(scale, AB, idx_AB, Dp, idx_Dp, scale, E, idx_C);
+
+    auto search = einsum_search;
+
+    einsum_search = EINSUM_GREEDY;
+    F.reset(C);
+    einsum(scale, {A, B, D}, {idx_A, idx_B, idx_D}, scale, F, idx_C);
+
+    add(T(-1), E, T(1), F);
+    T error = reduce<T>(REDUCE_NORM_2, F);
+
+    check("GREEDY", error, scale*neps);
+
+    einsum_search = EINSUM_OPTIMAL;
+    F.reset(C);
+    einsum(scale, {A, B, D}, {idx_A, idx_B, idx_D}, scale, F, idx_C);
+
+    add(T(-1), E, T(1), F);
+    error = reduce<T>(REDUCE_NORM_2, F);
+
+    check("OPTIMAL", error, scale*neps);
+
+    /*
+     * A second call with the same shapes is served from the path cache.
+     */
+    F.reset(C);
+    einsum(scale, {A, B, D}, {idx_A, idx_B, idx_D}, scale, F, idx_C);
+
+    add(T(-1), E, T(1), F);
+    error = reduce<T>(REDUCE_NORM_2, F);
+
+    check("CACHED", error, scale*neps);
+
+    einsum_clear_cache();
+    einsum_search = search;
+}
+
+TEST_CASE("einsum_path")
+{
+    /*
+     * For the chain (10x100)(100x2)(2x100) contracting the first pair is
+     * cheapest, while for (10x2)(2x100)(100x10) it is the last pair.
+     */
+    std::map<label_type,len_type> len1{{'i',10},{'j',100},{'k',2},{'l',100}};
+    std::vector<label_vector> idx_ops{{'i','j'},{'j','k'},{'k','l'}};
+    label_vector idx_C{'i','l'};
+
+    for (auto search : {EINSUM_GREEDY, EINSUM_OPTIMAL})
+    {
+        auto path = einsum_find_path(idx_ops, idx_C, len1, search);
+        REQUIRE(path.size() == 2);
+        REQUIRE(path[0] == std::make_pair(0, 1));
+    }
+
+    std::map<label_type,len_type> len2{{'i',10},{'j',2},{'k',100},{'l',10}};
+
+    auto path = einsum_find_path(idx_ops, idx_C, len2, EINSUM_OPTIMAL);
+    REQUIRE(path.size() == 2);
+    REQUIRE(path[0] == std::make_pair(1, 2));
+}
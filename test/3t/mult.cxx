@@ -78,6 +78,467 @@ REPLICATED_TEMPLATED_TEST_CASE(mult, R, T, all_types)
     error = reduce<T>(REDUCE_NORM_2, E);
 
     check("BLIS", error, scale*neps);
+
+    auto threshold = small_gemm_threshold;
+
+    small_gemm_threshold = 0;
+    E.reset(C);
+    mult(scale, A, idx_A, B, idx_B, scale, E, idx_C);
+
+    add(-1, D, 1, E);
+    error = reduce<T>(REDUCE_NORM_2, E);
+
+    check("BLIS (no small path)", error, scale*neps);
+
+    small_gemm_threshold = std::numeric_limits<len_type>::max();
+    E.reset(C);
+    mult(scale, A, idx_A, B, idx_B, scale, E, idx_C);
+
+    add(-1, D, 1, E);
+    error = reduce<T>(REDUCE_NORM_2, E);
+
+    check("BLIS (small path)", error, scale*neps);
+
+    small_gemm_threshold = threshold;
+}
+
+REPLICATED_TEMPLATED_TEST_CASE(mult_async, R, T, all_types)
+{
+    marray<T> A, B, C, D, E;
+    label_vector idx_A, idx_B, idx_C;
+
+    T scale(10.0*random_unit<T>());
+
+    random_mult(N, A, idx_A, B, idx_B, C, idx_C);
+
+    TENSOR_INFO(A);
+    TENSOR_INFO(B);
+    TENSOR_INFO(C);
+
+    auto idx_AB = exclusion(intersection(idx_A, idx_B), idx_C);
+    auto neps = (prod(select_from(A.lengths(), idx_A, idx_AB))+1)*prod(C.lengths());
+
+    D.reset(C);
+    mult(scale, A, idx_A, B, idx_B, scale, D, idx_C);
+
+    /*
+     * The add writes E, which the mult also writes, so it must wait for
+     * the mult to complete.
+     */
+    E.reset(C);
+    auto f1 = mult_async(scale, A, idx_A, B, idx_B, scale, E, idx_C);
+    auto f2 = add_async(T(-1), D, idx_C, T(1), E, idx_C);
+
+    f2.wait();
+    REQUIRE(f1.ready());
+
+    T error = reduce<T>(REDUCE_NORM_2, E);
+
+    check("ASYNC", error, scale*neps);
+
+    /*
+     * A detached operation still completes, and wait_all waits for it.
+     */
+    E.reset(C);
+    auto f3 = mult_async(scale, A, idx_A, B, idx_B, scale, E, idx_C);
+    f3.detach();
+    tblis_async_wait_all();
+
+    add(T(-1), D, idx_C, T(1), E, idx_C);
+    error = reduce<T>(REDUCE_NORM_2, E);
+
+    check("DETACHED", error, scale*neps);
+}
+
+/*
+ * Only complex T has a distinct real type, so only then is the mixed
+ * contraction reached.
+ */
+REPLICATED_TEMPLATED_TEST_CASE(mult_mixed, R, T, complex_types)
+{
+    using U = real_type_t<T>;
+
+    marray<T> A, B, C, D, E;
+    marray<U> A_r;
+    label_vector idx_A, idx_B, idx_C;
+
+    T scale(10.0*random_unit<T>());
+
+    random_mult(N, A, idx_A, B, idx_B, C, idx_C);
+
+    /*
+     * A real tensor, and the same tensor promoted to T for the reference.
+     */
+    A_r.reset(A.lengths());
+    randomize_tensor(A_r);
+    A.reset(A_r.lengths());
+    for (auto i : range(prod(A.lengths())))
+        A.data()[i] = A_r.data()[i];
+
+    TENSOR_INFO(A);
+    TENSOR_INFO(B);
+    TENSOR_INFO(C);
+
+    auto idx_AB = exclusion(intersection(idx_A, idx_B), idx_C);
+    auto neps = (prod(select_from(A.lengths(), idx_A, idx_AB))+1)*prod(C.lengths());
+
+    D.reset(C);
+    mult(scale, A, idx_A, B, idx_B, scale, D, idx_C);
+
+    E.reset(C);
+    mult(scale, A_r, idx_A, B, idx_B, scale, E, idx_C);
+
+    add(-1, D, 1, E);
+    T error = reduce<T>(REDUCE_NORM_2, E);
+
+    check("REAL A", error, scale*neps);
+
+    E.reset(C);
+    mult(scale, B, idx_B, A_r, idx_A, scale, E, idx_C);
+
+    add(-1, D, 1, E);
+    error = reduce<T>(REDUCE_NORM_2, E);
+
+    check("REAL B", error, scale*neps);
+
+    D.reset(C);
+    mult(T(2), A, idx_A, B, idx_B, T(-1), D, idx_C);
+
+    E.reset(C);
+    mult(T(2), A_r, idx_A, B, idx_B, T(-1), E, idx_C);
+
+    add(-1, D, 1, E);
+    error = reduce<T>(REDUCE_NORM_2, E);
+
+    check("REAL SCALARS", error, neps);
+
+    /*
+     * A conjugated complex operand and a complex beta take the path which
+     * scales C before and after the real contraction.
+     */
+    T beta(random_unit<T>());
+
+    marray<T> B_c(B);
+    B_c.for_each_element([](T& e) { e = tblis::conj(e); });
+
+    D.reset(C);
+    mult(scale, A, idx_A, B_c, idx_B, beta, D, idx_C);
+
+    tensor_wrapper B_w(B);
+    B_w.conj = true;
+
+    E.reset(C);
+    mult(scale, A_r, idx_A, B_w, idx_B, beta, E, idx_C);
+
+    add(-1, D, 1, E);
+    error = reduce<T>(REDUCE_NORM_2, E);
+
+    check("CONJ COMPLEX BETA", error, scale*neps);
+}
+
+REPLICATED_TEMPLATED_TEST_CASE(mult_prec, R, T, all_types)
+{
+    using S = std::conditional_t<is_complex_v<T>, scomplex, float>;
+    using W = std::conditional_t<is_complex_v<T>, dcomplex, double>;
+
+    marray<W> A, B, C, D, E;
+    marray<S> A_s, B_s, E_s;
+    label_vector idx_A, idx_B, idx_C;
+
+    W scale(10.0*random_unit<W>());
+
+    random_mult(N, A, idx_A, B, idx_B, C, idx_C);
+
+    /*
+     * Round A and B to single precision, so that the double precision
+     * reference sees exactly the same inputs.
+     */
+    A_s.reset(A.lengths());
+    B_s.reset(B.lengths());
+    for (auto i : range(prod(A.lengths())))
+        A.data()[i] = A_s.data()[i] = S(A.data()[i]);
+    for (auto i : range(prod(B.lengths())))
+        B.data()[i] = B_s.data()[i] = S(B.data()[i]);
+
+    TENSOR_INFO(A);
+    TENSOR_INFO(B);
+    TENSOR_INFO(C);
+
+    auto idx_AB = exclusion(intersection(idx_A, idx_B), idx_C);
+    auto neps = (prod(select_from(A.lengths(), idx_A, idx_AB))+1)*prod(C.lengths());
+
+    D.reset(C);
+    mult(scale, A, idx_A, B, idx_B, scale, D, idx_C);
+
+    /*
+     * The products of single precision numbers are exact in double
+     * precision, so accumulating them in double is as accurate as the
+     * reference.
+     */
+    E.reset(C);
+    mult(scale, A_s, idx_A, B_s, idx_B, scale, E, idx_C, type_tag<W>::value);
+
+    add(-1, D, 1, E);
+    W error = reduce<W>(REDUCE_NORM_2, E);
+
+    check("SINGLE TO DOUBLE", error, scale*neps);
+
+    /*
+     * Packing in single precision is only accurate to single precision.
+     */
+    E.reset(C);
+    mult(scale, A, idx_A, B, idx_B, scale, E, idx_C, type_tag<S>::value);
+
+    add(-1, D, 1, E);
+    S error_s(reduce<W>(REDUCE_NORM_2, E));
+
+    check("DOUBLE TO SINGLE", error_s, scale*neps);
+
+    /*
+     * Single precision storage throughout with double accumulation only
+     * rounds the result.
+     */
+    E_s.reset(C.lengths());
+    for (auto i : range(prod(C.lengths())))
+        E_s.data()[i] = S(C.data()[i]);
+    mult(scale, A_s, idx_A, B_s, idx_B, scale, E_s, idx_C, type_tag<W>::value);
+
+    E.reset(D);
+    for (auto i : range(prod(C.lengths())))
+        E.data()[i] -= W(E_s.data()[i]);
+    error_s = S(reduce<W>(REDUCE_NORM_2, E));
+
+    check("SINGLE STORAGE", error_s, scale*neps);
+}
+
+REPLICATED_TEMPLATED_TEST_CASE(mult_half, R, H, types<bfloat16, float16>)
+{
+    marray<float> A, B, C, D, E;
+    marray<H> A_h, B_h, E_h;
+    label_vector idx_A, idx_B, idx_C;
+
+    float scale(10.0*random_unit<float>());
+
+    random_mult(N, A, idx_A, B, idx_B, C, idx_C);
+
+    /*
+     * Round everything to half precision, so that the float reference sees
+     * exactly the same inputs.
+     */
+    A_h.reset(A.lengths());
+    B_h.reset(B.lengths());
+    E_h.reset(C.lengths());
+    for (auto i : range(prod(A.lengths())))
+        A.data()[i] = A_h.data()[i] = H(A.data()[i]);
+    for (auto i : range(prod(B.lengths())))
+        B.data()[i] = B_h.data()[i] = H(B.data()[i]);
+    for (auto i : range(prod(C.lengths())))
+        C.data()[i] = E_h.data()[i] = H(C.data()[i]);
+
+    TENSOR_INFO(A);
+    TENSOR_INFO(B);
+    TENSOR_INFO(C);
+
+    auto idx_AB = exclusion(intersection(idx_A, idx_B), idx_C);
+    auto neps = (prod(select_from(A.lengths(), idx_A, idx_AB))+1)*prod(C.lengths());
+
+    D.reset(C);
+    mult(scale, A, idx_A, B, idx_B, scale, D, idx_C);
+
+    E.reset(C);
+    mult(scale, A_h, idx_A, B_h, idx_B, scale, E, idx_C);
+
+    add(-1, D, 1, E);
+    float error = reduce<float>(REDUCE_NORM_2, E);
+
+    check("HALF INPUTS", error, scale*neps);
+
+    /*
+     * A half precision output is only accurate to half precision.
+     */
+    mult(scale, A_h, idx_A, B_h, idx_B, scale, E_h, idx_C);
+
+    E.reset(D);
+    for (auto i : range(prod(C.lengths())))
+        E.data()[i] -= float(E_h.data()[i]);
+    error = reduce<float>(REDUCE_NORM_2, E);
+
+    constexpr float half_ulps = std::is_same_v<H,bfloat16> ? 1 << 16 : 1 << 13;
+    check("HALF OUTPUT", error, scale*half_ulps*neps);
+}
+
+REPLICATED_TEMPLATED_TEST_CASE(mult_tiled, R, T, all_types)
+{
+    marray<T> A, B, C, D, E;
+    label_vector idx_A, idx_B, idx_C;
+
+    random_mult(N, A, idx_A, B, idx_B, C, idx_C);
+
+    TENSOR_INFO(A);
+    TENSOR_INFO(B);
+    TENSOR_INFO(C);
+
+    auto idx_AB = exclusion(intersection(idx_A, idx_B), idx_C);
+    auto neps = (prod(select_from(A.lengths(), idx_A, idx_AB))+1)*prod(C.lengths());
+
+    len_vector tile_len;
+    for (auto len : C.lengths())
+        tile_len.push_back(random_number<len_type>(len));
+
+    INFO_OR_PRINT("tile_len = " << tile_len);
+
+    D.reset(C);
+    mult(T(1), A, idx_A, B, idx_B, T(0), D, idx_C);
+
+    /*
+     * Each tile is added into its place in E, so that a missed or repeated
+     * tile shows up as an error.
+     */
+    E.reset(C.lengths());
+    mult_tiled(A, idx_A, B, idx_B, idx_C, tile_len,
+    [&](const communicator&, const tblis_tensor& C_tile, const len_vector& off_C)
+    {
+        auto data_E = E.data();
+        for (auto i : range(E.dimension()))
+        {
+            REQUIRE(off_C[i]+C_tile.len[i] <= C.length(i));
+            data_E += off_C[i]*E.stride(i);
+        }
+
+        tblis_tensor E_tile(data_E, E.dimension(), C_tile.len, E.strides().data());
+        tblis_tensor_add(nullptr, nullptr, &C_tile, idx_C.data(), &E_tile, idx_C.data());
+    });
+
+    add(-1, D, 1, E);
+    T error = reduce<T>(REDUCE_NORM_2, E);
+
+    check("TILED", error, neps);
+
+    E.reset(C);
+    randomize_tensor(E);
+
+    T ref_val = dot<T>(D, idx_C, E, idx_C);
+    T calc_val = mult_dot<T>(A, idx_A, B, idx_B, E, idx_C, tile_len);
+
+    check("MULT_DOT", ref_val, calc_val, neps);
+}
+
+REPLICATED_TEMPLATED_TEST_CASE(mult_stats, R, T, all_types)
+{
+    marray<T> A, B, C;
+    label_vector idx_A, idx_B, idx_C;
+
+    random_mult(N, A, idx_A, B, idx_B, C, idx_C);
+
+    TENSOR_INFO(A);
+    TENSOR_INFO(B);
+    TENSOR_INFO(C);
+
+    auto idx_ABC = intersection(idx_A, idx_B, idx_C);
+    auto idx_AB = exclusion(intersection(idx_A, idx_B), idx_C);
+    auto idx_AC = exclusion(intersection(idx_A, idx_C), idx_B);
+    auto idx_BC = exclusion(intersection(idx_B, idx_C), idx_A);
+
+    auto flops = 2*prod(select_from(A.lengths(), idx_A, idx_ABC))*
+                   prod(select_from(A.lengths(), idx_A, idx_AB))*
+                   prod(select_from(A.lengths(), idx_A, idx_AC))*
+                   prod(select_from(B.lengths(), idx_B, idx_BC));
+
+    tblis_reset_stats();
+
+    impl = BLIS_BASED;
+    mult(T(1), A, idx_A, B, idx_B, T(0), C, idx_C);
+
+    tblis_stats last, cumulative;
+    tblis_get_last_stats(&last);
+    tblis_get_cumulative_stats(&cumulative);
+
+    REQUIRE(last.calls == 1);
+    REQUIRE(last.flops == flops);
+    REQUIRE(last.wall_time >= 0);
+    if (flops > 0) REQUIRE(last.algorithm != ALGORITHM_NONE);
+
+    mult(T(1), A, idx_A, B, idx_B, T(0), C, idx_C);
+    tblis_get_cumulative_stats(&cumulative);
+
+    REQUIRE(cumulative.calls == 2);
+    REQUIRE(cumulative.flops == 2*flops);
+}
+
+REPLICATED_TEMPLATED_TEST_CASE(dpd_mult_stats, R, T, all_types)
+{
+    dpd_marray<T> A, B, C;
+    indexed_marray<T> E, F, G;
+    label_vector idx_A, idx_B, idx_C;
+
+    random_mult(N, A, idx_A, B, idx_B, C, idx_C);
+
+    DPD_TENSOR_INFO(A);
+    DPD_TENSOR_INFO(B);
+    DPD_TENSOR_INFO(C);
+
+    auto idx_ABC = intersection(idx_A, idx_B, idx_C);
+    auto idx_AB = exclusion(intersection(idx_A, idx_B), idx_C);
+    auto idx_AC = exclusion(intersection(idx_A, idx_C), idx_B);
+    auto idx_BC = exclusion(intersection(idx_B, idx_C), idx_A);
+
+    auto size_ABC = group_size(A.lengths(), idx_A, idx_ABC);
+    auto size_AB = group_size(A.lengths(), idx_A, idx_AB);
+    auto size_AC = group_size(A.lengths(), idx_A, idx_AC);
+    auto size_BC = group_size(B.lengths(), idx_B, idx_BC);
+
+    auto nirrep = A.num_irreps();
+    stride_type flops = 0;
+    for (auto irrep_AB : range(nirrep))
+    {
+        auto irrep_ABC = A.irrep()^B.irrep()^C.irrep();
+        auto irrep_AC = A.irrep()^irrep_AB^irrep_ABC;
+        auto irrep_BC = B.irrep()^irrep_AB^irrep_ABC;
+
+        flops += 2*size_ABC[irrep_ABC]*
+                   size_AB[irrep_AB]*
+                   size_AC[irrep_AC]*
+                   size_BC[irrep_BC];
+    }
+
+    tblis_stats last;
+
+    /*
+     * The default path contracts the blocks with its own GEMM rather than
+     * the dense mult, and must count their flops itself.
+     */
+    dpd_impl = dpd_impl_t::BLIS;
+    tblis_reset_stats();
+    mult<T>(T(1), A, idx_A, B, idx_B, T(0), C, idx_C);
+    tblis_get_last_stats(&last);
+
+    REQUIRE(last.calls == 1);
+    if (flops > 0) REQUIRE(last.flops > 0);
+
+    /*
+     * Indexed contractions report their own algorithms.
+     */
+    random_mult(N, E, idx_A, F, idx_B, G, idx_C);
+
+    INDEXED_TENSOR_INFO(E);
+    INDEXED_TENSOR_INFO(F);
+    INDEXED_TENSOR_INFO(G);
+
+    dpd_impl = dpd_impl_t::BLOCKED;
+    tblis_reset_stats();
+    mult<T>(T(1), E, idx_A, F, idx_B, T(0), G, idx_C);
+    tblis_get_last_stats(&last);
+
+    if (last.flops > 0) REQUIRE(last.algorithm == ALGORITHM_INDEXED_BLOCKED);
+
+    dpd_impl = dpd_impl_t::FULL;
+    tblis_reset_stats();
+    mult<T>(T(1), E, idx_A, F, idx_B, T(0), G, idx_C);
+    tblis_get_last_stats(&last);
+
+    if (last.flops > 0) REQUIRE(last.algorithm == ALGORITHM_INDEXED_FULL);
+
+    dpd_impl = dpd_impl_t::BLIS;
 }
 
 REPLICATED_TEMPLATED_TEST_CASE(dpd_mult, R, T, all_types)
@@ -127,9 +588,13 @@ REPLICATED_TEMPLATED_TEST_CASE(dpd_mult, R, T, all_types)
     }
 
     dpd_impl = dpd_impl_t::BLOCKED;
+    tblis_reset_stats();
     D.reset(C);
     mult<T>(scale, A, idx_A, B, idx_B, scale, D, idx_C);
 
+    tblis_stats unscreened;
+    tblis_get_last_stats(&unscreened);
+
     dpd_impl = dpd_impl_t::FULL;
     E.reset(C);
     mult<T>(scale, A, idx_A, B, idx_B, scale, E, idx_C);
@@ -138,6 +603,74 @@ REPLICATED_TEMPLATED_TEST_CASE(dpd_mult, R, T, all_types)
     T error = reduce<T>(REDUCE_NORM_2, E, idx_C);
 
     check("BLOCKED", error, scale*neps);
+
+    auto limit = dpd_full_memory_limit;
+    dpd_full_memory_limit = 1024*sizeof(T);
+    E.reset(C);
+    mult<T>(scale, A, idx_A, B, idx_B, scale, E, idx_C);
+    dpd_full_memory_limit = limit;
+
+    add<T>(T(-1), D, idx_C, T(1), E, idx_C);
+    error = reduce<T>(REDUCE_NORM_2, E, idx_C);
+
+    check("TILED", error, scale*neps);
+
+    /*
+     * With an enormous tolerance every block pair is screened out and only
+     * the scaling of C remains.
+     */
+    dpd_impl = dpd_impl_t::BLOCKED;
+    auto tol = block_screening_tol;
+    block_screening_tol = 1e300;
+    tblis_reset_stats();
+    E.reset(C);
+    mult<T>(scale, A, idx_A, B, idx_B, scale, E, idx_C);
+    block_screening_tol = tol;
+
+    tblis_stats last;
+    tblis_get_last_stats(&last);
+    if (unscreened.flops > 0) REQUIRE(last.block_pairs > 0);
+    REQUIRE(last.block_pairs_skipped == last.block_pairs);
+
+    add<T>(-scale, C, idx_C, T(1), E, idx_C);
+    error = reduce<T>(REDUCE_NORM_2, E, idx_C);
+
+    check("SCREENED", error, scale*neps);
+
+    /*
+     * A block-diagonal product with two irreps has one block pair per
+     * irrep. With one block of A zeroed and the smallest positive
+     * tolerance, exactly that pair is skipped and the result is unchanged.
+     */
+    std::vector<len_type> len_i{2, 3}, len_k{3, 4};
+    label_vector idx_A2{'i','k'}, idx_B2{'k','j'}, idx_C2{'i','j'};
+
+    dpd_marray<T> A2, B2, C2, D2, E2;
+    A2.reset(0, 2, std::vector<std::vector<len_type>>{len_i, len_k});
+    B2.reset(0, 2, std::vector<std::vector<len_type>>{len_k, len_i});
+    C2.reset(0, 2, std::vector<std::vector<len_type>>{len_i, len_i});
+    randomize_tensor(A2);
+    randomize_tensor(B2);
+    randomize_tensor(C2);
+    A2(irrep_vector{1, 1}).for_each_element([](T& e) { e = T(0); });
+
+    D2.reset(C2);
+    mult<T>(scale, A2, idx_A2, B2, idx_B2, scale, D2, idx_C2);
+
+    block_screening_tol = std::numeric_limits<double>::min();
+    tblis_reset_stats();
+    E2.reset(C2);
+    mult<T>(scale, A2, idx_A2, B2, idx_B2, scale, E2, idx_C2);
+    block_screening_tol = tol;
+
+    tblis_get_last_stats(&last);
+    REQUIRE(last.block_pairs == 2);
+    REQUIRE(last.block_pairs_skipped == 1);
+
+    add<T>(T(-1), D2, idx_C2, T(1), E2, idx_C2);
+    error = reduce<T>(REDUCE_NORM_2, E2, idx_C2);
+
+    check("PARTIALLY SCREENED", error, scale*(4+1)*(2*2 + 3*3));
 }
 
 REPLICATED_TEMPLATED_TEST_CASE(indexed_mult, R, T, all_types)
@@ -170,6 +703,37 @@ REPLICATED_TEMPLATED_TEST_CASE(indexed_mult, R, T, all_types)
     T error = reduce<T>(REDUCE_NORM_2, E, idx_C);
 
     check("BLOCKED", error, scale*neps);
+
+    /*
+     * The second call reuses the cached sort orders of the index sets.
+     */
+    dpd_impl = dpd_impl_t::BLOCKED;
+    auto cache_size = group_indices_cache_size;
+    group_indices_cache_size = 16;
+    for (auto i : range(2))
+    {
+        E.reset(C);
+        mult<T>(scale, A, idx_A, B, idx_B, scale, E, idx_C);
+
+        for (auto& f : E.factors()) f = T(1);
+        add<T>(T(-1), D, idx_C, T(1), E, idx_C);
+        error = reduce<T>(REDUCE_NORM_2, E, idx_C);
+
+        check(i ? "CACHED" : "CACHE MISS", error, scale*neps);
+    }
+    group_indices_cache_size = cache_size;
+
+    auto ratio = gallop_match_ratio;
+    gallop_match_ratio = 1;
+    E.reset(C);
+    mult<T>(scale, A, idx_A, B, idx_B, scale, E, idx_C);
+    gallop_match_ratio = ratio;
+
+    for (auto& f : E.factors()) f = T(1);
+    add<T>(T(-1), D, idx_C, T(1), E, idx_C);
+    error = reduce<T>(REDUCE_NORM_2, E, idx_C);
+
+    check("GALLOPING", error, scale*neps);
 }
 
 REPLICATED_TEMPLATED_TEST_CASE(indexed_dpd_mult, R, T, all_types)
@@ -219,9 +783,13 @@ REPLICATED_TEMPLATED_TEST_CASE(indexed_dpd_mult, R, T, all_types)
     }
 
     dpd_impl = dpd_impl_t::BLOCKED;
+    tblis_reset_stats();
     D.reset(C);
     mult<T>(scale, A, idx_A, B, idx_B, scale, D, idx_C);
 
+    tblis_stats unscreened;
+    tblis_get_last_stats(&unscreened);
+
     dpd_impl = dpd_impl_t::FULL;
     E.reset(C);
     mult<T>(scale, A, idx_A, B, idx_B, scale, E, idx_C);
@@ -232,4 +800,84 @@ REPLICATED_TEMPLATED_TEST_CASE(indexed_dpd_mult, R, T, all_types)
     T error = reduce<T>(REDUCE_NORM_2, E, idx_C);
 
     check("BLOCKED", error, scale*neps);
+
+    dpd_impl = dpd_impl_t::BLOCKED;
+    auto ratio = gallop_match_ratio;
+    gallop_match_ratio = 1;
+    E.reset(C);
+    mult<T>(scale, A, idx_A, B, idx_B, scale, E, idx_C);
+    gallop_match_ratio = ratio;
+
+    for (auto& f : E.factors()) f = T(1);
+    add<T>(T(-1), D, idx_C, T(1), E, idx_C);
+    error = reduce<T>(REDUCE_NORM_2, E, idx_C);
+
+    check("GALLOPING", error, scale*neps);
+
+    /*
+     * With the smallest positive tolerance only the block pairs with a
+     * zero factor are skipped, which leaves the result unchanged.
+     */
+    auto tol = block_screening_tol;
+    block_screening_tol = std::numeric_limits<double>::min();
+    tblis_reset_stats();
+    E.reset(C);
+    mult<T>(scale, A, idx_A, B, idx_B, scale, E, idx_C);
+
+    tblis_stats last;
+    tblis_get_last_stats(&last);
+    if (unscreened.flops > 0) REQUIRE(last.block_pairs > 0);
+    REQUIRE(last.block_pairs_skipped <= last.block_pairs);
+
+    for (auto& f : E.factors()) f = T(1);
+    add<T>(T(-1), D, idx_C, T(1), E, idx_C);
+    error = reduce<T>(REDUCE_NORM_2, E, idx_C);
+
+    check("SCREENED ZERO FACTORS", error, scale*neps);
+
+    /*
+     * With an enormous tolerance every block pair is skipped.
+     */
+    block_screening_tol = 1e300;
+    tblis_reset_stats();
+    E.reset(C);
+    mult<T>(scale, A, idx_A, B, idx_B, scale, E, idx_C);
+    block_screening_tol = tol;
+
+    tblis_get_last_stats(&last);
+    if (unscreened.flops > 0) REQUIRE(last.block_pairs > 0);
+    REQUIRE(last.block_pairs_skipped == last.block_pairs);
+
+    /*
+     * The empty irrep-0 block of i starts at the same address as its
+     * neighbour, and in a self-contraction the sub-blocks of A and B
+     * coincide. Neither may share a cached norm with a different block.
+     */
+    std::vector<len_type> len_i{0, 3}, len_k{3, 4}, len_l{1, 1};
+    label_vector idx_A2{'i','k','l'}, idx_B2{'j','k','l'}, idx_C2{'i','j','l'};
+    matrix<len_type> idxs{1, 1};
+    idxs[0][0] = 0;
+
+    indexed_dpd_marray<T> A2, C2, D2, E2;
+    A2.reset(0, 2, std::vector<std::vector<len_type>>{len_i, len_k, len_l}, irrep_vector{0}, idxs);
+    C2.reset(0, 2, std::vector<std::vector<len_type>>{len_i, len_i, len_l}, irrep_vector{0}, idxs);
+    randomize_tensor(A2);
+    randomize_tensor(C2);
+
+    D2.reset(C2);
+    mult<T>(scale, A2, idx_A2, A2, idx_B2, scale, D2, idx_C2);
+
+    block_screening_tol = std::numeric_limits<double>::min();
+    E2.reset(C2);
+    mult<T>(scale, A2, idx_A2, A2, idx_B2, scale, E2, idx_C2);
+    block_screening_tol = tol;
+
+    for (auto& f : E2.factors()) f = T(1);
+    for (auto& f : D2.factors()) f = T(1);
+    add<T>(T(-1), D2, idx_C2, T(1), E2, idx_C2);
+    error = reduce<T>(REDUCE_NORM_2, E2, idx_C2);
+
+    check("SCREENED SELF CONTRACTION", error, scale*(4+1)*3*3);
+
+    dpd_impl = dpd_impl_t::BLIS;
 }
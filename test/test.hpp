@@ -29,6 +29,8 @@
 
 #include "tblis/frame/3t/dense/mult.hpp"
 #include "tblis/frame/3t/dpd/mult.hpp"
+#include "tblis/frame/1t/indexed/util.hpp"
+#include "tblis/frame/3t/einsum.hpp"
 
 #include <catch2/catch_all.hpp>
 
@@ -173,6 +175,22 @@ void randomize_tensor(T& t)
     t.for_each_element([](U& e) { e = random_unit<U>(); });
 }
 
+/*
+ * Turn compensated summation on or off for the lifetime of the guard, and
+ * restore the previous (global) setting afterwards even if a check throws.
+ */
+struct compensated_sum_guard
+{
+    int previous = tblis_get_compensated_sum();
+
+    compensated_sum_guard(int enabled) { tblis_set_compensated_sum(enabled); }
+
+    ~compensated_sum_guard() { tblis_set_compensated_sum(previous); }
+
+    compensated_sum_guard(const compensated_sum_guard&) = delete;
+    compensated_sum_guard& operator=(const compensated_sum_guard&) = delete;
+};
+
 template <typename T> const string& type_name();
 
 template <typename... Types> struct types;
@@ -247,6 +265,7 @@ constexpr static int ulp_factor = 32;
 extern stride_type N;
 extern int R;
 typedef types<float, double, scomplex, dcomplex> all_types;
+typedef types<scomplex, dcomplex> complex_types;
 
 enum index_type
 {